@@ -25,11 +25,20 @@ if not exist build mkdir build
 pushd build
 
 set src_dir=/I../codebase/src /I../src
-set CFLAGS=/nologo /std:c++17 /Od /Z7 /W4 /FC /utf-8 %src_dir% /DBUILD_DEBUG=1 /wd4100 /wd4457 /wd4200 /wd4505 /wd4201 /wd4042
+set COMMON_CFLAGS=/nologo /std:c++17 /Z7 /W4 /FC /utf-8 %src_dir% /wd4100 /wd4457 /wd4200 /wd4505 /wd4201 /wd4042
 set LFLAGS=/incremental:no
-set libs=gdi32.lib
 
-:: Compile HLSL offline.
+:: Scoped timers and Chrome trace export, see src/profile.h.
+if "%profile%"=="1" set COMMON_CFLAGS=%COMMON_CFLAGS% /DPROFILE_ENABLED=1
+set CFLAGS=%COMMON_CFLAGS% /Od /DBUILD_DEBUG=1
+set BENCH_CFLAGS=%COMMON_CFLAGS% /O2 /DBUILD_DEBUG=0
+set libs=gdi32.lib shell32.lib
+
+:: Compile HLSL offline. Also done whenever a shader header is missing, so
+:: the headers main.cpp includes always come from fxc.
+for %%h in (shader_vs shader_ps panel_vs panel_ps glyph_vs glyph_ps) do (
+    if not exist ..\src\shaders\%%h.h set hlsl=1
+)
 if "%hlsl%"=="1" (
     if not exist ../src/shaders mkdir ../src/shaders
     call fxc /nologo /T vs_5_0 /E vs_main /O3 /WX /Fh ../src/shaders/shader_vs.h /Qstrip_reflect /Qstrip_debug /Qstrip_priv ../src/hlsl/shader.hlsl
@@ -37,9 +46,17 @@ if "%hlsl%"=="1" (
 
     call fxc /nologo /T vs_5_0 /E panel_vs_main /O3 /WX /Fh ../src/shaders/panel_vs.h /Qstrip_reflect /Qstrip_debug /Qstrip_priv ../src/hlsl/panel.hlsl
     call fxc /nologo /T ps_5_0 /E panel_ps_main /O3 /WX /Fh ../src/shaders/panel_ps.h /Qstrip_reflect /Qstrip_debug /Qstrip_priv ../src/hlsl/panel.hlsl
+
+    call fxc /nologo /T vs_5_0 /E glyph_vs_main /O3 /WX /Fh ../src/shaders/glyph_vs.h /Qstrip_reflect /Qstrip_debug /Qstrip_priv ../src/hlsl/glyph.hlsl
+    call fxc /nologo /T ps_5_0 /E glyph_ps_main /O3 /WX /Fh ../src/shaders/glyph_ps.h /Qstrip_reflect /Qstrip_debug /Qstrip_priv ../src/hlsl/glyph.hlsl
 )
 
 :: Compile main.cpp
 call cl ..\src\main.cpp /Fe:main.exe %CFLAGS% /link %LFLAGS% %libs%
 
+:: Compile bench.cpp, optimized. Results are JSON on stdout: bench.exe > bench.json
+if "%bench%"=="1" (
+    call cl ..\src\bench.cpp /Fe:bench.exe %BENCH_CFLAGS% /link %LFLAGS% %libs%
+)
+
 popd
@@ -0,0 +1,2591 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+/* --------------------------------------
+   @Note: Headless benchmarks of the text engine's stages.
+
+   Everything runs over the synthetic font backend and the software
+   compositor, so the numbers come out the same way off Windows. The corpora
+   are fixed: the multilingual test texts, an ASCII log from a fixed seed,
+   one very long line made of both, and a document of --document-mb
+   megabytes of the same lines.
+
+   Every benchmark runs BENCH_WARMUP_COUNT samples that aren't kept and then
+   --samples that are, and reports the time per item of those as
+   percentiles. Results go to stdout as JSON, progress to stderr.
+
+   check/text_buffer_random_edits and check/paragraph_invalidation edit a
+   Text_Buffer at random next to a plain array of the same text.
+   check/trace_round_trip records the synthetic backend's answers to
+   bench_round_trip.ftrc in the working directory and replays them.
+
+   --replay adds the replay/ benchmarks over a trace recorded with
+   main.exe --trace-capture: the recorded texts shaped, cached, packed and
+   laid out again through the trace's answers instead of the synthetic
+   backend's.
+
+     bench [--filter <substring>] [--samples <count>] [--threads <count>] [--document-mb <size>] [--replay <trace>]
+   --------------------------------------- */
+
+#if defined(_WIN32)
+#  define OS_WINDOWS
+#endif
+#include "include/codebase.h"
+#if defined(OS_WINDOWS)
+#  include <shellapi.h> // CommandLineToArgvW
+#endif
+
+//------------------------------------
+// Note: [.h]
+#define STB_DS_IMPLEMENTATION
+#define STBDS_ASSERT
+#include "third_party/stb_ds.h"
+
+#include "simple_text.h"
+#include "text_source.h"
+#include "job.h"
+#include "profile.h"
+#include "text_buffer.h"
+#include "word_cache.h"
+#include "layout.h"
+#include "label.h"
+#include "terminal_grid.h"
+#include "font_backend.h"
+#include "font_trace.h"
+#include "glyph_atlas.h"
+#include "render.h"
+#include "soft_render.h"
+#include "text_render.h"
+#include "engine.h"
+
+//------------------------------------
+// Note: [.cpp]
+#include "simple_text.cpp"
+#include "text_source.cpp"
+#include "job.cpp"
+#include "profile.cpp"
+#include "text_buffer.cpp"
+#include "word_cache.cpp"
+#include "layout.cpp"
+#include "label.cpp"
+#include "terminal_grid.cpp"
+#include "font_backend.cpp"
+#include "font_trace.cpp"
+#include "glyph_atlas.cpp"
+#include "render.cpp"
+#include "soft_render.cpp"
+#include "text_render.cpp"
+#include "engine.cpp"
+
+//------------------------------------
+// Note: Sample texts.
+#include "test_texts.h"
+
+#define BENCH_DEFAULT_SAMPLE_COUNT  31
+#define BENCH_MAX_SAMPLE_COUNT      1024
+#define BENCH_WARMUP_COUNT          3
+#define BENCH_DEFAULT_DOCUMENT_MB   16
+#define BENCH_SEED                  0x9e3779b97f4a7c15ull
+
+#define BENCH_LOG_LINE_COUNT        8192
+#define BENCH_LONG_LINE_LENGTH      (512*1024)  // UTF-16 code units, a megabyte.
+#define BENCH_GLYPH_KEY_COUNT       65536
+#define BENCH_DISTINCT_GLYPH_COUNT  4096
+#define BENCH_INSERT_COUNT          16384
+#define BENCH_PACK_COUNT            2048
+#define BENCH_BLIT_SIZE             32          // px, square glyphs.
+#define BENCH_WRAP_WIDTH_COUNT      32
+#define BENCH_LABEL_COUNT           10000
+#define BENCH_SCROLL_LINE_COUNT     1024
+#define BENCH_JOB_COUNT             4096
+#define BENCH_PARALLEL_FOR_COUNT    (4*1024*1024)
+#define BENCH_READ_LOOKUP_COUNT     (1024*1024) // per thread.
+#define BENCH_TEXT_BUFFER_MB        100
+#define BENCH_MIDDLE_INSERT_COUNT   64          // per sample.
+#define BENCH_EDIT_COUNT            4096
+#define BENCH_EDIT_ROUND_COUNT      256
+#define BENCH_TERMINAL_COLUMN_COUNT 300
+#define BENCH_TERMINAL_ROW_COUNT    100
+#define BENCH_TERMINAL_UPDATE_COUNT 16          // per sample, 1% of the cells written before each.
+
+// @Note: FNV-1a of check/soft_render_frame's pixels. Only update it for a
+// change that's meant to move pixels, after looking at the new frame.
+#define BENCH_SOFT_RENDER_FRAME_HASH 0x4d65544ad95c2f99ull
+
+#define BENCH_ROUND_TRIP_TRACE_PATH "bench_round_trip.ftrc"
+#define BENCH_ROUND_TRIP_LOG_COUNT  64          // log lines, after every multilingual text.
+#define BENCH_WORD_CACHE_ENTRY_COUNT 4096
+
+#define BENCH_TARGET_WIDTH          1280
+#define BENCH_TARGET_HEIGHT         720
+#define BENCH_PT_PER_EM             20.0f
+#define BENCH_PX_PER_INCH           96.0f
+
+// Runs one sample. Returns the timer ticks of the part that's measured, so
+// setup a sample needs stays out of it.
+typedef U64 Bench_Proc(void *user_data);
+
+typedef struct Bench_Result Bench_Result;
+struct Bench_Result
+{
+    char *name;
+    char *unit;
+    U64 items_per_sample;
+    U32 sample_count;
+
+    // ns per item over the samples.
+    F64 min_ns;
+    F64 p50_ns;
+    F64 p90_ns;
+    F64 p99_ns;
+    F64 max_ns;
+    F64 mean_ns;
+};
+
+typedef struct Bench_Metric Bench_Metric;
+struct Bench_Metric
+{
+    char *name;
+    char *unit;
+    F64 value;
+};
+
+typedef struct Bench_Check Bench_Check;
+struct Bench_Check
+{
+    char *name;
+    B32 passed;
+};
+
+typedef struct Bench_Text Bench_Text;
+struct Bench_Text
+{
+    U16 *text;
+    U32 length;
+};
+
+typedef struct Bench_Corpus Bench_Corpus;
+struct Bench_Corpus
+{
+    Bench_Text *multilingual;           // stb_ds array, a paragraph per test text.
+    Bench_Text *log;                    // stb_ds array, a line each.
+    U64 multilingual_length;            // UTF-16 code units, summed.
+    U64 log_length;
+    Bench_Text long_line;
+
+    U16 *document;                      // UTF-16LE, lines of both.
+    U64 document_size;                  // bytes.
+    U16 *paragraphs;                    // UTF-16LE, the test texts and a screenful of log.
+    U64 paragraphs_size;
+};
+
+typedef struct Bench Bench;
+struct Bench
+{
+    Arena *arena;
+    char *filter;                       // or NULL.
+    U32 sample_count;
+    U32 thread_count;                   // 0 for one per processor.
+    U64 document_mb;
+    char *replay_path;                  // or NULL.
+    F64 ns_per_tick;
+
+    Bench_Result *results;              // stb_ds arrays.
+    Bench_Metric *metrics;
+    Bench_Check *checks;
+};
+
+// What the benchmark procs work on. Set up once; a proc that changes any
+// of it puts it back.
+typedef struct Bench_Fixture Bench_Fixture;
+struct Bench_Fixture
+{
+    Bench *bench;
+    Bench_Corpus *corpus;
+    Arena *arena;                       // cleared by procs that need a scratch.
+
+    Synthetic_Font synthetic_font;
+    Font_Backend backend;
+    wchar_t *family;
+    F32 px_per_em;
+    U64 face;
+
+    Glyph_Atlas_Key *glyph_keys;        // BENCH_GLYPH_KEY_COUNT of BENCH_DISTINCT_GLYPH_COUNT glyphs.
+    Glyph_Cel *glyph_cels;
+    Glyph_Atlas warm_atlas;             // holds every key.
+    U32 *pack_sizes;                    // width, height pairs.
+    Font_Glyph_Bitmap blit_glyph;
+    Bitmap blit_target;
+
+    // The long line, shaped.
+    F32 *long_advances;
+    U32 *long_positions;
+    U8 *long_breaks;
+    U32 *long_run_glyph_counts;
+    F32 *long_run_heights_px;
+    U32 long_run_count;
+    U32 long_glyph_count;
+    Layout_Paragraph long_paragraph;
+    S32 *prefix_sums;
+    Layout_Wrap long_wrap;
+
+    Text_Source paragraph_source;
+    Engine engine;                      // over paragraph_source.
+    Arena *frame_arena;
+    Renderer renderer;
+    U64 frame_glyph_count;
+    Label *labels;
+    Label_Glyphs label_glyphs;
+    Bitmap target;
+
+    Text_Source document_source;
+    Engine document_engine;             // over document_source.
+    U64 scroll_line;
+
+    Job_System *jobs;
+    U32 *parallel_for_values;
+    volatile S64 parallel_for_sum;
+};
+
+// A trace replayed. The document is the texts that were mapped in the first
+// text's family and size, a line each, like the paragraph cache mapped them.
+typedef struct Bench_Replay Bench_Replay;
+struct Bench_Replay
+{
+    Bench_Fixture *fixture;
+    Font_Trace_Replay trace;
+    Font_Backend backend;
+    U64 char_count;                     // of all the texts.
+
+    U16 *document;                      // stb_ds array, UTF-16LE.
+    Text_Source source;
+    Engine_Config cold_config;
+    Engine engine;                      // over source, warm.
+    U64 frame_glyph_count;
+};
+
+// What a backend answered for check/trace_round_trip's texts, in order.
+typedef struct Bench_Trace_Answers Bench_Trace_Answers;
+struct Bench_Trace_Answers
+{
+    Font_Run **runs;                    // stb_ds array, font_map_text() of each text.
+    U32 *glyph_text_positions;          // stb_ds array, of every text.
+    U8 *breaks;                         // stb_ds array, of every text.
+    Font_Metrics *metrics;              // stb_ds array, a run each.
+    Font_Glyph_Bitmap *boxes;           // stb_ds array, a glyph each, without pixels.
+};
+
+// One test text shaped word by word through a Word_Cache of its own, the way
+// dwrite_shape_words() does, with the synthetic backend shaping the misses.
+typedef struct Bench_Word_Cache Bench_Word_Cache;
+struct Bench_Word_Cache
+{
+    Bench_Fixture *fixture;
+    Bench_Text text;
+    Word_Cache cache;
+    Font_Run run;                       // face and size of the fixture's.
+    U32 *glyph_text_positions;          // stb_ds array.
+};
+
+// A terminal grid of its own, over its own font and atlas, so its glyphs
+// don't land in the fixture's.
+typedef struct Bench_Terminal Bench_Terminal;
+struct Bench_Terminal
+{
+    Synthetic_Font synthetic_font;
+    Font_Backend backend;
+    Glyph_Atlas atlas;
+    Terminal_Font font;
+    Terminal_Grid grid;
+
+    U64 random;
+    U64 update_count;
+    U64 shaped_row_count;               // summed over the updates.
+    U64 rebuilt_cell_count;
+};
+
+typedef struct Bench_Read_Task Bench_Read_Task;
+struct Bench_Read_Task
+{
+    Bench_Fixture *fixture;
+    Job_System *jobs;
+    U32 thread_count;
+};
+
+// -------------------------------------
+// @Note: Data
+global volatile U64 bench_sink;         // results the optimizer mustn't drop.
+
+// -----------------------------------------
+// @Note: Harness
+
+function U64
+bench_random(U64 *state)
+{
+    // xorshift64*
+    U64 x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x*0x2545f4914f6cdd1dull;
+}
+
+function F64
+bench_percentile(F64 *sorted, U32 count, F64 percentile)
+{
+    // Nearest rank.
+    U32 rank = (U32)ceil(percentile/100.0*(F64)count);
+    U32 index = clamp(1u, rank, count) - 1;
+    return sorted[index];
+}
+
+function B32
+bench_is_selected(Bench *bench, char *name)
+{
+    B32 result = (! bench->filter || strstr(name, bench->filter));
+    return result;
+}
+
+function void
+bench_run(Bench *bench, char *name, char *unit, U64 items_per_sample, Bench_Proc *proc, void *user_data)
+{
+    if (! bench_is_selected(bench, name))
+    { return; }
+
+    fprintf(stderr, "%-40s", name);
+
+    for (U32 wi = 0; wi < BENCH_WARMUP_COUNT; ++wi)
+    { proc(user_data); }
+
+    F64 samples[BENCH_MAX_SAMPLE_COUNT];
+    U32 sample_count = bench->sample_count;
+    F64 total = 0.0;
+    for (U32 si = 0; si < sample_count; ++si)
+    {
+        U64 ticks = proc(user_data);
+        F64 ns = (F64)ticks*bench->ns_per_tick / (F64)max(items_per_sample, (U64)1);
+
+        // Insertion sort, the samples are few.
+        U32 at = si;
+        for (; at > 0 && samples[at - 1] > ns; --at)
+        { samples[at] = samples[at - 1]; }
+        samples[at] = ns;
+        total += ns;
+    }
+
+    Bench_Result result = {};
+    {
+        result.name             = name;
+        result.unit             = unit;
+        result.items_per_sample = items_per_sample;
+        result.sample_count     = sample_count;
+        result.min_ns           = samples[0];
+        result.p50_ns           = bench_percentile(samples, sample_count, 50.0);
+        result.p90_ns           = bench_percentile(samples, sample_count, 90.0);
+        result.p99_ns           = bench_percentile(samples, sample_count, 99.0);
+        result.max_ns           = samples[sample_count - 1];
+        result.mean_ns          = total / (F64)sample_count;
+    }
+    arrput(bench->results, result);
+
+    fprintf(stderr, " %12.3f ns/%s (p50)\n", result.p50_ns, unit);
+}
+
+function void
+bench_check(Bench *bench, char *name, B32 passed)
+{
+    Bench_Check check = {name, passed};
+    arrput(bench->checks, check);
+    fprintf(stderr, "%-40s %s\n", name, (passed) ? "passed" : "FAILED");
+}
+
+function void
+bench_metric(Bench *bench, char *name, char *unit, F64 value)
+{
+    Bench_Metric metric = {name, unit, value};
+    arrput(bench->metrics, metric);
+    fprintf(stderr, "%-40s %12.3f %s\n", name, value, unit);
+}
+
+function char *
+bench_format(Arena *arena, char *format, U32 value)
+{
+    int length = snprintf(NULL, 0, format, value);
+    char *result = push_array(arena, char, length + 1);
+    snprintf(result, length + 1, format, value);
+    return result;
+}
+
+function void
+bench_parse_arguments(Bench *bench, int argc, char **argv)
+{
+    for (int ai = 1; ai < argc; ++ai)
+    {
+        char *argument = argv[ai];
+        char *value = (ai + 1 < argc) ? argv[ai + 1] : NULL;
+        if (! value)
+        { break; }
+
+        if (strcmp(argument, "--filter") == 0)
+        { bench->filter = value; ++ai; }
+        else if (strcmp(argument, "--samples") == 0)
+        { bench->sample_count = clamp(1u, (U32)strtoul(value, NULL, 10), (U32)BENCH_MAX_SAMPLE_COUNT); ++ai; }
+        else if (strcmp(argument, "--threads") == 0)
+        { bench->thread_count = (U32)strtoul(value, NULL, 10); ++ai; }
+        else if (strcmp(argument, "--document-mb") == 0)
+        { bench->document_mb = max((U64)strtoull(value, NULL, 10), (U64)1); ++ai; }
+        else if (strcmp(argument, "--replay") == 0)
+        { bench->replay_path = value; ++ai; }
+    }
+}
+
+// @Note: The entry point is the codebase's, so the arguments are fetched
+// from the OS.
+function void
+bench_parse_command_line(Bench *bench)
+{
+#if defined(OS_WINDOWS)
+    int argc = 0;
+    wchar_t **wide_argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (wide_argv)
+    {
+        char **argv = push_array(bench->arena, char *, argc);
+        for (int ai = 0; ai < argc; ++ai)
+        {
+            int length = WideCharToMultiByte(CP_UTF8, 0, wide_argv[ai], -1, NULL, 0, NULL, NULL);
+            argv[ai] = push_array(bench->arena, char, length);
+            WideCharToMultiByte(CP_UTF8, 0, wide_argv[ai], -1, argv[ai], length, NULL, NULL);
+        }
+        LocalFree(wide_argv);
+        bench_parse_arguments(bench, argc, argv);
+    }
+#else
+    // NUL-separated.
+    int file = open("/proc/self/cmdline", O_RDONLY);
+    if (file >= 0)
+    {
+        U64 capacity = KB(64);
+        char *data = push_array(bench->arena, char, capacity + 1);
+        U64 size = 0;
+        for (ssize_t n; size < capacity && (n = read(file, data + size, capacity - size)) > 0;)
+        { size += (U64)n; }
+        close(file);
+
+        char **argv = push_array(bench->arena, char *, size + 1);
+        int argc = 0;
+        for (U64 at = 0; at < size; at += strlen(data + at) + 1)
+        { argv[argc++] = data + at; }
+        bench_parse_arguments(bench, argc, argv);
+    }
+#endif
+}
+
+function void
+bench_write_json(Bench *bench)
+{
+    printf("{\n");
+    printf("  \"samples\": %u,\n", bench->sample_count);
+    printf("  \"threads\": %u,\n", bench->thread_count);
+    printf("  \"document_mb\": %llu,\n", (unsigned long long)bench->document_mb);
+
+    printf("  \"benchmarks\": [");
+    for (U32 ri = 0; ri < arrlenu(bench->results); ++ri)
+    {
+        Bench_Result *r = bench->results + ri;
+        printf("%s\n    {\"name\": \"%s\", \"unit\": \"%s\", \"items_per_sample\": %llu, \"samples\": %u, "
+               "\"ns_per_item\": {\"min\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f, \"mean\": %.4f}, "
+               "\"items_per_second_p50\": %.1f}",
+               (ri) ? "," : "", r->name, r->unit, (unsigned long long)r->items_per_sample, r->sample_count,
+               r->min_ns, r->p50_ns, r->p90_ns, r->p99_ns, r->max_ns, r->mean_ns,
+               (r->p50_ns > 0.0) ? 1e9 / r->p50_ns : 0.0);
+    }
+    printf("\n  ],\n");
+
+    printf("  \"metrics\": [");
+    for (U32 mi = 0; mi < arrlenu(bench->metrics); ++mi)
+    {
+        Bench_Metric *m = bench->metrics + mi;
+        printf("%s\n    {\"name\": \"%s\", \"unit\": \"%s\", \"value\": %.4f}", (mi) ? "," : "", m->name, m->unit, m->value);
+    }
+    printf("\n  ],\n");
+
+    printf("  \"checks\": [");
+    for (U32 ci = 0; ci < arrlenu(bench->checks); ++ci)
+    {
+        Bench_Check *c = bench->checks + ci;
+        printf("%s\n    {\"name\": \"%s\", \"passed\": %s}", (ci) ? "," : "", c->name, (c->passed) ? "true" : "false");
+    }
+    printf("\n  ]\n");
+    printf("}\n");
+}
+
+// -----------------------------------------
+// @Note: Corpora
+
+// wchar_t is UTF-32 off Windows.
+function Bench_Text
+bench_text_from_wide(Arena *arena, wchar_t *wide)
+{
+    U32 length = 0;
+    for (wchar_t *at = wide; *at; ++at)
+    { length += ((U32)*at >= 0x10000) ? 2 : 1; }
+
+    Bench_Text result = {};
+    result.text   = push_array(arena, U16, length + 1);
+    result.length = length;
+
+    U32 i = 0;
+    for (wchar_t *at = wide; *at; ++at)
+    {
+        U32 c = (U32)*at;
+        if (c >= 0x10000)
+        {
+            result.text[i++] = (U16)(0xd800 + ((c - 0x10000) >> 10));
+            result.text[i++] = (U16)(0xdc00 + ((c - 0x10000) & 0x3ff));
+        }
+        else
+        { result.text[i++] = (U16)c; }
+    }
+    return result;
+}
+
+function Bench_Text
+bench_log_line(Arena *arena, U64 *random)
+{
+    char *levels[] = {"INFO ", "INFO ", "INFO ", "DEBUG", "WARN ", "ERROR"};
+    char *methods[] = {"GET", "GET", "POST", "PUT", "DELETE"};
+
+    char line[256];
+    U64 r = bench_random(random);
+    int length = snprintf(line, sizeof(line), "2025-03-%02u %02u:%02u:%02u.%03u %s [worker-%u] %s /api/v1/items/%u status=%u elapsed=%ums bytes=%u",
+                          (U32)(r % 28) + 1, (U32)(r >> 8) % 24, (U32)(r >> 16) % 60, (U32)(r >> 24) % 60, (U32)(r >> 32) % 1000,
+                          levels[(r >> 42) % array_count(levels)], (U32)(r >> 45) % 16, methods[(r >> 50) % array_count(methods)],
+                          (U32)bench_random(random) % 100000, ((r >> 54) % 8) ? 200u : 404u, (U32)(r >> 57) % 120, (U32)bench_random(random) % 65536);
+
+    Bench_Text result = {};
+    result.text   = push_array(arena, U16, length + 1);
+    result.length = (U32)length;
+    for (int i = 0; i < length; ++i)
+    { result.text[i] = (U16)(U8)line[i]; }
+    return result;
+}
+
+// Lines, each followed by a newline, for a Text_Source.
+function void
+bench_append_line(U16 **document, Bench_Text line)
+{
+    U64 at = arrlenu(*document);
+    arrsetlen(*document, at + line.length + 1);
+    memory_copy(*document + at, line.text, line.length*sizeof(U16));
+    (*document)[at + line.length] = '\n';
+}
+
+function void
+bench_build_corpus(Bench *bench, Bench_Corpus *corpus)
+{
+    *corpus = {};
+    U64 random = BENCH_SEED;
+
+    for (U32 ti = 0; ti < array_count(test_texts); ++ti)
+    {
+        Bench_Text text = bench_text_from_wide(bench->arena, test_texts[ti]);
+        arrput(corpus->multilingual, text);
+        corpus->multilingual_length += text.length;
+    }
+
+    for (U32 li = 0; li < BENCH_LOG_LINE_COUNT; ++li)
+    {
+        Bench_Text line = bench_log_line(bench->arena, &random);
+        arrput(corpus->log, line);
+        corpus->log_length += line.length;
+    }
+
+    // Both, alternating, with the paragraphs' spaces as the only breaks.
+    {
+        U16 *text = push_array(bench->arena, U16, BENCH_LONG_LINE_LENGTH);
+        U32 length = 0;
+        for (U32 i = 0; length < BENCH_LONG_LINE_LENGTH; ++i)
+        {
+            Bench_Text part = (i % 2) ? corpus->log[i % BENCH_LOG_LINE_COUNT] : corpus->multilingual[(i/2) % arrlenu(corpus->multilingual)];
+            U32 count = min(part.length, (U32)BENCH_LONG_LINE_LENGTH - length);
+            memory_copy(text + length, part.text, count*sizeof(U16));
+            length += count;
+        }
+        corpus->long_line.text   = text;
+        corpus->long_line.length = length;
+    }
+
+    {
+        U16 *paragraphs = NULL;
+        for (U32 ti = 0; ti < arrlenu(corpus->multilingual); ++ti)
+        {
+            bench_append_line(&paragraphs, corpus->multilingual[ti]);
+            for (U32 li = 0; li < 4; ++li)
+            { bench_append_line(&paragraphs, corpus->log[ti*4 + li]); }
+        }
+        corpus->paragraphs      = paragraphs;
+        corpus->paragraphs_size = arrlenu(paragraphs)*sizeof(U16);
+    }
+
+    // A test text every eight lines.
+    {
+        U64 size = bench->document_mb << 20;
+        U16 *document = NULL;
+        arrsetcap(document, size/sizeof(U16) + 1024);
+        for (U64 i = 0; arrlenu(document)*sizeof(U16) < size; ++i)
+        {
+            Bench_Text line = (i % 8) ? corpus->log[i % BENCH_LOG_LINE_COUNT] : corpus->multilingual[(i/8) % arrlenu(corpus->multilingual)];
+            bench_append_line(&document, line);
+        }
+        corpus->document      = document;
+        corpus->document_size = arrlenu(document)*sizeof(U16);
+    }
+}
+
+// -----------------------------------------
+// @Note: Text
+
+function U64
+bench_simple_scan_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    Bench_Corpus *corpus = f->corpus;
+
+    U64 begin = os_read_timer();
+    U64 simple_count = 0;
+    for (U32 li = 0; li < arrlenu(corpus->log); ++li)
+    {
+        Bench_Text line = corpus->log[li];
+        for (U32 at = 0; at < line.length;)
+        {
+            U32 length = simple_text_scan(line.text + at, line.length - at);
+            simple_count += length;
+            at += max(length, 1u);
+        }
+    }
+    U64 end = os_read_timer();
+
+    bench_sink += simple_count;
+    return end - begin;
+}
+
+function U64
+bench_text_source_index_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    Bench_Corpus *corpus = f->corpus;
+
+    Text_Source source = {};
+    U64 begin = os_read_timer();
+    text_source_open_memory(&source, (U8 *)corpus->document, corpus->document_size, TEXT_ENCODING_UTF16LE);
+    U64 end = os_read_timer();
+
+    bench_sink += source.line_count;
+    text_source_close(&source);
+    return end - begin;
+}
+
+// @Note: Typing into the middle of a big document: the pieces split are the
+// ones in the middle, the rest of the treap is only walked.
+function U64
+bench_text_buffer_insert_proc(void *user_data)
+{
+    Text_Buffer *buffer = (Text_Buffer *)user_data;
+    U16 text[] = {'i', 'n', 's', 'e', 'r', 't', 'e', 'd', '\n'};
+
+    U64 begin = os_read_timer();
+    for (U32 i = 0; i < BENCH_MIDDLE_INSERT_COUNT; ++i)
+    { text_buffer_insert(buffer, text_buffer_length(buffer)/2, text, array_count(text)); }
+    U64 end = os_read_timer();
+
+    text_buffer_clear_changes(buffer);
+    return end - begin;
+}
+
+// @Note: Paragraphs of the document in order, through the paragraph cache,
+// like scrolling down without ever coming back.
+function U64
+bench_scroll_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    Paragraph_Cache *cache = &f->document_engine.paragraph_cache;
+    U64 line_count = f->document_source.line_count;
+
+    U64 begin = os_read_timer();
+    F32 height_px = 0.0f;
+    for (U32 i = 0; i < BENCH_SCROLL_LINE_COUNT; ++i)
+    {
+        Shaped_Paragraph *sp = paragraph_cache_get(cache, f->scroll_line, (F32)BENCH_TARGET_WIDTH);
+        height_px += sp->wrap.height_px;
+        f->scroll_line = (f->scroll_line + 1) % line_count;
+    }
+    U64 end = os_read_timer();
+
+    bench_sink += (U64)height_px;
+    return end - begin;
+}
+
+// -----------------------------------------
+// @Note: Glyph atlas
+
+function U64
+bench_glyph_lookup_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    U64 begin = os_read_timer();
+    B32 found = glyph_atlas_fill_lock_free(&f->warm_atlas, f->glyph_keys, BENCH_GLYPH_KEY_COUNT, f->glyph_cels);
+    U64 end = os_read_timer();
+
+    assume(found);
+    return end - begin;
+}
+
+// @Note: Lookup and insert of glyphs that all miss, into a fresh table.
+function U64
+bench_glyph_insert_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    Glyph_Atlas atlas = {};
+    glyph_atlas_init(&atlas, &f->backend, NULL, 64, 64, BENCH_INSERT_COUNT*2);
+
+    U64 begin = os_read_timer();
+    job_mutex_lock(&atlas.write_mutex);
+    for (U32 gi = 0; gi < BENCH_INSERT_COUNT; ++gi)
+    {
+        U64 face = f->face + (gi >> 16);
+        U16 glyph_index = (U16)gi;
+        U64 hash = glyph_atlas_hash(face, f->px_per_em, glyph_index);
+        if (! glyph_atlas_lookup(&atlas, face, f->px_per_em, glyph_index, hash))
+        { glyph_atlas_insert(&atlas, face, f->px_per_em, glyph_index, hash); }
+    }
+    job_mutex_unlock(&atlas.write_mutex);
+    U64 end = os_read_timer();
+
+    bench_sink += atlas.occupied_count;
+    glyph_atlas_release(&atlas);
+    return end - begin;
+}
+
+// @Note: Random sizes, so later ones can find no room. Those are timed too.
+function U64
+bench_atlas_pack_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    Glyph_Atlas atlas = {};
+    glyph_atlas_init(&atlas, &f->backend, NULL, 2048, 2048, 64);
+
+    U64 begin = os_read_timer();
+    U32 packed_count = 0;
+    for (U32 pi = 0; pi < BENCH_PACK_COUNT; ++pi)
+    {
+        U32 x = 0;
+        U32 y = 0;
+        packed_count += glyph_atlas_pack(&atlas, f->pack_sizes[pi*2 + 0], f->pack_sizes[pi*2 + 1], &x, &y);
+    }
+    U64 end = os_read_timer();
+
+    bench_sink += packed_count;
+    glyph_atlas_release(&atlas);
+    return end - begin;
+}
+
+function U64
+bench_atlas_blit_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    U32 columns = f->blit_target.width / BENCH_BLIT_SIZE;
+    U32 rows    = f->blit_target.height / BENCH_BLIT_SIZE;
+
+    U64 begin = os_read_timer();
+    for (U32 row = 0; row < rows; ++row)
+    {
+        for (U32 column = 0; column < columns; ++column)
+        { glyph_atlas_blit(&f->blit_target, column*BENCH_BLIT_SIZE, row*BENCH_BLIT_SIZE, &f->blit_glyph); }
+    }
+    U64 end = os_read_timer();
+
+    bench_sink += f->blit_target.data[f->blit_target.pitch*7 + 13];
+    return end - begin;
+}
+
+function void
+bench_read_range_proc(void *user_data, U32 worker_index, U64 begin, U64 end)
+{
+    Bench_Read_Task *task = (Bench_Read_Task *)user_data;
+    Bench_Fixture *f = task->fixture;
+
+    Temporary_Arena scratch = scratch_begin();
+    Glyph_Cel *cels = push_array(scratch.arena, Glyph_Cel, BENCH_GLYPH_KEY_COUNT);
+    for (U64 ti = begin; ti < end; ++ti)
+    {
+        // Each task starts somewhere else in the keys, so they don't walk the table in lockstep.
+        U32 offset = (U32)(ti*7919) % BENCH_GLYPH_KEY_COUNT;
+        for (U32 done = 0; done < BENCH_READ_LOOKUP_COUNT;)
+        {
+            U32 count = min((U32)BENCH_GLYPH_KEY_COUNT - offset, (U32)BENCH_READ_LOOKUP_COUNT - done);
+            B32 found = glyph_atlas_fill_lock_free(&f->warm_atlas, f->glyph_keys + offset, count, cels);
+            assume(found);
+            done += count;
+            offset = 0;
+        }
+    }
+    scratch_end(scratch);
+}
+
+// @Note: A task of BENCH_READ_LOOKUP_COUNT lookups per thread, all at once.
+function U64
+bench_read_scaling_proc(void *user_data)
+{
+    Bench_Read_Task *task = (Bench_Read_Task *)user_data;
+
+    U64 begin = os_read_timer();
+    job_parallel_for(task->jobs, task->thread_count, 1, bench_read_range_proc, task);
+    U64 end = os_read_timer();
+
+    return end - begin;
+}
+
+// -----------------------------------------
+// @Note: Shaping and layout
+
+function U64
+bench_shape_texts(Bench_Fixture *f, Bench_Text *texts, U32 text_count)
+{
+    U64 begin = os_read_timer();
+    U64 glyph_count = 0;
+    for (U32 ti = 0; ti < text_count; ++ti)
+    {
+        U32 *glyph_text_positions = NULL;
+        Font_Run *runs = font_map_text(&f->backend, NULL, f->family, BENCH_PT_PER_EM, texts[ti].text, texts[ti].length, &glyph_text_positions);
+        glyph_count += arrlenu(glyph_text_positions);
+        font_free_runs(runs);
+        arrfree(glyph_text_positions);
+    }
+    U64 end = os_read_timer();
+
+    bench_sink += glyph_count;
+    return end - begin;
+}
+
+function U64
+bench_shape_multilingual_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    return bench_shape_texts(f, f->corpus->multilingual, (U32)arrlenu(f->corpus->multilingual));
+}
+
+function U64
+bench_shape_log_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    return bench_shape_texts(f, f->corpus->log, (U32)arrlenu(f->corpus->log));
+}
+
+function U64
+bench_line_break_texts(Bench_Fixture *f, Bench_Text *texts, U32 text_count)
+{
+    Font_Backend *backend = &f->backend;
+
+    U64 begin = os_read_timer();
+    U64 sum = 0;
+    for (U32 ti = 0; ti < text_count; ++ti)
+    {
+        U8 *breaks = backend->analyze_breaks(backend->user_data, texts[ti].text, texts[ti].length);
+        sum += breaks[texts[ti].length/2];
+        arrfree(breaks);
+    }
+    U64 end = os_read_timer();
+
+    bench_sink += sum;
+    return end - begin;
+}
+
+function U64
+bench_line_break_multilingual_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    return bench_line_break_texts(f, f->corpus->multilingual, (U32)arrlenu(f->corpus->multilingual));
+}
+
+function U64
+bench_line_break_log_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    return bench_line_break_texts(f, f->corpus->log, (U32)arrlenu(f->corpus->log));
+}
+
+// @Note: The test text labelled label, e.g. L"Korean->", or an empty one.
+function Bench_Text
+bench_find_test_text(Bench_Corpus *corpus, wchar_t *label)
+{
+    Bench_Text result = {};
+    for (U32 ti = 0; ti < arrlenu(corpus->multilingual) && ! result.text; ++ti)
+    {
+        Bench_Text text = corpus->multilingual[ti];
+        U32 at = 0;
+        while (at < text.length && text.text[at] == ' ')
+        { ++at; }
+
+        U32 li = 0;
+        while (label[li] && at + li < text.length && text.text[at + li] == (U16)label[li])
+        { ++li; }
+        if (! label[li])
+        { result = text; }
+    }
+    return result;
+}
+
+function void
+bench_word_cache_shape(Bench_Word_Cache *wc)
+{
+    Bench_Fixture *f = wc->fixture;
+    Font_Run *run = &wc->run;
+    U16 *text = wc->text.text;
+    U32 text_length = wc->text.length;
+
+    arrsetlen(run->glyph_indices, 0);
+    arrsetlen(run->glyph_advances, 0);
+    arrsetlen(wc->glyph_text_positions, 0);
+
+    U32 at = 0;
+    while (at < text_length)
+    {
+        U16 *word = text + at;
+        U32 word_length = word_cache_next_word_length(word, text_length - at);
+
+        if (word_length > WORD_CACHE_MAX_WORD_LENGTH)
+        {
+            wc->cache.stats.uncacheable_count += 1;
+            synthetic_font_shape(&f->synthetic_font, run, word, word_length, at, &wc->glyph_text_positions);
+        }
+        else
+        {
+            Word_Cache_Key key = {};
+            {
+                key.face        = run->face;
+                key.em_size     = run->em_size_px;
+                key.text        = word;
+                key.text_length = word_length;
+            }
+            U64 hash = word_cache_hash(key);
+
+            Word_Cache_Entry *entry = word_cache_lookup(&wc->cache, key, hash);
+            if (entry)
+            {
+                for (U32 gi = 0; gi < entry->glyph_count; ++gi)
+                {
+                    arrput(run->glyph_indices, entry->glyph_indices[gi]);
+                    arrput(run->glyph_advances, entry->glyph_advances[gi]);
+                    arrput(wc->glyph_text_positions, at + entry->glyph_clusters[gi]);
+                }
+            }
+            else
+            {
+                U32 glyph_count = (U32)arrlenu(run->glyph_indices);
+
+                U64 begin = os_read_timer();
+                synthetic_font_shape(&f->synthetic_font, run, word, word_length, at, &wc->glyph_text_positions);
+                U64 end = os_read_timer();
+
+                U32 glyph_count_add = (U32)arrlenu(run->glyph_indices) - glyph_count;
+                Word_Cache_Entry *inserted = word_cache_insert(&wc->cache, key, hash,
+                                                               run->glyph_indices + glyph_count, run->glyph_advances + glyph_count, glyph_count_add,
+                                                               end - begin);
+                for (U32 gi = 0; gi < glyph_count_add; ++gi)
+                { inserted->glyph_clusters[gi] = (U16)(wc->glyph_text_positions[glyph_count + gi] - at); }
+            }
+        }
+
+        at += word_length;
+    }
+}
+
+function U64
+bench_word_cache_shape_proc(void *user_data)
+{
+    Bench_Word_Cache *wc = (Bench_Word_Cache *)user_data;
+    U64 begin = os_read_timer();
+    bench_word_cache_shape(wc);
+    U64 end = os_read_timer();
+    bench_sink += arrlenu(wc->run.glyph_indices);
+    return end - begin;
+}
+
+function U64
+bench_word_cache_uncached_proc(void *user_data)
+{
+    Bench_Word_Cache *wc = (Bench_Word_Cache *)user_data;
+    Font_Run *run = &wc->run;
+    arrsetlen(run->glyph_indices, 0);
+    arrsetlen(run->glyph_advances, 0);
+    arrsetlen(wc->glyph_text_positions, 0);
+
+    U64 begin = os_read_timer();
+    synthetic_font_shape(&wc->fixture->synthetic_font, run, wc->text.text, wc->text.length, 0, &wc->glyph_text_positions);
+    U64 end = os_read_timer();
+    bench_sink += arrlenu(run->glyph_indices);
+    return end - begin;
+}
+
+function U64
+bench_layout_build_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    arena_clear(f->arena);
+
+    U64 begin = os_read_timer();
+    Layout_Paragraph paragraph = layout_build_paragraph(f->arena, f->long_advances, f->long_positions, f->long_glyph_count,
+                                                        f->long_breaks, f->corpus->long_line.length,
+                                                        f->long_run_glyph_counts, f->long_run_heights_px, f->long_run_count);
+    U64 end = os_read_timer();
+
+    bench_sink += paragraph.break_count;
+    return end - begin;
+}
+
+function U64
+bench_prefix_sum_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    U64 begin = os_read_timer();
+    layout_prefix_sum_26_6(f->long_advances, f->long_glyph_count, f->prefix_sums);
+    U64 end = os_read_timer();
+
+    bench_sink += (U64)f->prefix_sums[f->long_glyph_count];
+    return end - begin;
+}
+
+function U64
+bench_prefix_sum_scalar_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    U64 begin = os_read_timer();
+    layout_prefix_sum_26_6_scalar(f->long_advances, f->long_glyph_count, f->prefix_sums);
+    U64 end = os_read_timer();
+
+    bench_sink += (U64)f->prefix_sums[f->long_glyph_count];
+    return end - begin;
+}
+
+// @Note: A live resize of the megabyte line, a wrap per width.
+function U64
+bench_wrap_resize_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    U64 begin = os_read_timer();
+    for (U32 wi = 0; wi < BENCH_WRAP_WIDTH_COUNT; ++wi)
+    {
+        F32 width_px = 200.0f + (F32)wi*50.0f;
+        layout_wrap(&f->long_paragraph, width_px, &f->long_wrap);
+    }
+    U64 end = os_read_timer();
+
+    bench_sink += arrlenu(f->long_wrap.lines);
+    return end - begin;
+}
+
+// -----------------------------------------
+// @Note: Vertices and compositing
+
+// Paragraphs of the paragraph source from the top, until the container is full.
+function void
+bench_build_frame(Bench_Fixture *f, Engine *engine, Renderer *r)
+{
+    V2 container_origin_px  = V2{40.0f, (F32)BENCH_TARGET_HEIGHT - 20.0f};
+    F32 container_width_px  = (F32)BENCH_TARGET_WIDTH - 80.0f;
+    F32 container_height_px = (F32)BENCH_TARGET_HEIGHT - 40.0f;
+
+    render_set_state(r, Render_State{0, RENDER_SHADER_GLYPH, RENDER_BLEND_MAX, 0, RENDER_CLIP_NONE});
+
+    F32 y_px = 0.0f;
+    for (U64 line = 0; line < paragraph_cache_line_count(&engine->paragraph_cache) && y_px < container_height_px; ++line)
+    {
+        Shaped_Paragraph *sp = paragraph_cache_get(&engine->paragraph_cache, line, container_width_px);
+        render_paragraph(r, &engine->glyph_atlas, sp, y_px, container_origin_px, container_width_px, container_height_px);
+        y_px += sp->wrap.height_px;
+    }
+
+    render_build_batches(r);
+}
+
+function U64
+bench_vertices_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    Renderer r = {};
+    arena_clear(f->arena);
+
+    U64 begin = os_read_timer();
+    render_begin_frame(&r, f->arena);
+    bench_build_frame(f, &f->engine, &r);
+    U64 end = os_read_timer();
+
+    assume(r.instance_count == f->frame_glyph_count);
+    return end - begin;
+}
+
+function U64
+bench_label_layout_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    U64 begin = os_read_timer();
+    label_layout_batch(&f->engine.label_cache, f->labels, BENCH_LABEL_COUNT, &f->label_glyphs);
+    U64 end = os_read_timer();
+
+    bench_sink += f->label_glyphs.count;
+    return end - begin;
+}
+
+function U64
+bench_soft_clear_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    Renderer r = {};
+    arena_clear(f->arena);
+    render_begin_frame(&r, f->arena);
+    render_build_batches(&r);
+
+    U64 begin = os_read_timer();
+    soft_render_frame(&r, &f->target, &f->engine.glyph_atlas.bitmap, 1, SOFT_RENDER_CLEAR_COLOR, 1, NULL);
+    U64 end = os_read_timer();
+
+    return end - begin;
+}
+
+function U64
+bench_soft_text_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    U64 begin = os_read_timer();
+    soft_render_frame(&f->renderer, &f->target, &f->engine.glyph_atlas.bitmap, 1, SOFT_RENDER_CLEAR_COLOR, 1, NULL);
+    U64 end = os_read_timer();
+
+    return end - begin;
+}
+
+// -----------------------------------------
+// @Note: Terminal grid
+
+// @Note: Like the terminal demo: 1% of the cells get a random character,
+// some of which make ligatures with their neighbours, then an update.
+function U64
+bench_terminal_update_proc(void *user_data)
+{
+    Bench_Terminal *terminal = (Bench_Terminal *)user_data;
+    Terminal_Grid *grid = &terminal->grid;
+    U16 alphabet[] = {'a', 'b', 'c', '-', '>', '=', '!', '<', '|', ' '};
+    U32 cell_count = grid->column_count*grid->row_count;
+
+    U64 begin = os_read_timer();
+    for (U32 ui = 0; ui < BENCH_TERMINAL_UPDATE_COUNT; ++ui)
+    {
+        for (U32 i = 0; i < cell_count/100; ++i)
+        {
+            U64 r = bench_random(&terminal->random);
+            U32 cell = (U32)(r % cell_count);
+            U16 c = alphabet[(r >> 32) % array_count(alphabet)];
+            terminal_grid_write(grid, cell / grid->column_count, cell % grid->column_count, &c, 1);
+        }
+        terminal_grid_update(grid);
+
+        terminal->update_count       += 1;
+        terminal->shaped_row_count   += grid->shaped_row_count;
+        terminal->rebuilt_cell_count += grid->rebuilt_cell_count;
+    }
+    U64 end = os_read_timer();
+
+    return end - begin;
+}
+
+// -----------------------------------------
+// @Note: Job system
+
+function void
+bench_empty_job_proc(void *user_data, U32 worker_index)
+{
+}
+
+function U64
+bench_job_submit_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    Temporary_Arena scratch = scratch_begin();
+    Job *jobs = push_array(scratch.arena, Job, BENCH_JOB_COUNT);
+    for (U32 ji = 0; ji < BENCH_JOB_COUNT; ++ji)
+    { jobs[ji].proc = bench_empty_job_proc; }
+
+    U64 begin = os_read_timer();
+    Job_Counter counter = {};
+    job_submit(f->jobs, jobs, BENCH_JOB_COUNT, &counter);
+    job_wait(f->jobs, &counter);
+    U64 end = os_read_timer();
+
+    scratch_end(scratch);
+    return end - begin;
+}
+
+function void
+bench_sum_range_proc(void *user_data, U32 worker_index, U64 begin, U64 end)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+    U64 sum = 0;
+    for (U64 i = begin; i < end; ++i)
+    { sum += f->parallel_for_values[i]; }
+    job_atomic_add(&f->parallel_for_sum, (S64)sum);
+}
+
+function U64
+bench_parallel_for_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    U64 begin = os_read_timer();
+    job_atomic_store(&f->parallel_for_sum, 0);
+    job_parallel_for(f->jobs, BENCH_PARALLEL_FOR_COUNT, 16384, bench_sum_range_proc, f);
+    U64 end = os_read_timer();
+
+    assume(job_atomic_load(&f->parallel_for_sum) == (S64)BENCH_PARALLEL_FOR_COUNT);
+    return end - begin;
+}
+
+// -----------------------------------------
+// @Note: Stats
+
+function U64
+bench_engine_stats_proc(void *user_data)
+{
+    Bench_Fixture *f = (Bench_Fixture *)user_data;
+
+    U64 begin = os_read_timer();
+    Engine_Stats stats = engine_get_stats(&f->engine);
+    U64 end = os_read_timer();
+
+    bench_sink += stats.total_bytes;
+    return end - begin;
+}
+
+// @Note: What the engines hold after everything above ran through them.
+function void
+bench_report_engine_stats(Bench *bench, Bench_Fixture *f)
+{
+    Engine_Stats stats = engine_get_stats(&f->engine);
+    Engine_Stats document_stats = engine_get_stats(&f->document_engine);
+
+    bench_metric(bench, "memory/engine_total", "KB", (F64)stats.total_bytes/1024.0);
+    bench_metric(bench, "memory/scroll_engine_total", "KB", (F64)document_stats.total_bytes/1024.0);
+    bench_metric(bench, "memory/scroll_paragraph_heap", "KB", (F64)document_stats.paragraph_cache.heap_bytes/1024.0);
+    bench_metric(bench, "cache/glyph_hit_rate", "ratio",
+                 engine_hit_rate(stats.glyph_atlas.lookup_count - stats.glyph_atlas.miss_count, stats.glyph_atlas.miss_count));
+    bench_metric(bench, "cache/glyph_probe_length_max", "entries", (F64)stats.glyph_atlas.max_probe_length);
+    bench_metric(bench, "cache/scroll_paragraph_hit_rate", "ratio",
+                 engine_hit_rate(document_stats.paragraph_cache.hit_count, document_stats.paragraph_cache.miss_count));
+
+    char table[4096];
+    engine_format_stats(&stats, table, sizeof(table));
+    fprintf(stderr, "%s", table);
+}
+
+// -----------------------------------------
+// @Note: Replay
+
+function U64
+bench_replay_map_text_proc(void *user_data)
+{
+    Bench_Replay *replay = (Bench_Replay *)user_data;
+    Font_Trace_Text *texts = replay->trace.texts;
+    U32 *glyph_text_positions = NULL;
+
+    U64 begin = os_read_timer();
+    for (U32 ti = 0; ti < arrlenu(texts); ++ti)
+    {
+        Font_Run *runs = font_map_text(&replay->backend, NULL, texts[ti].family, texts[ti].pt_per_em,
+                                       texts[ti].text, texts[ti].length, &glyph_text_positions);
+        bench_sink += arrlenu(runs);
+        font_free_runs(runs);
+        arrsetlen(glyph_text_positions, 0);
+    }
+    U64 end = os_read_timer();
+
+    arrfree(glyph_text_positions);
+    return end - begin;
+}
+
+// @Note: Every paragraph of the document through a new engine: shaped, laid
+// out, and its glyphs rasterized and packed.
+function U64
+bench_replay_paragraphs_cold_proc(void *user_data)
+{
+    Bench_Replay *replay = (Bench_Replay *)user_data;
+    Engine engine = {};
+    engine_init(&engine, &replay->cold_config);
+
+    U64 begin = os_read_timer();
+    for (U64 line = 0; line < replay->source.line_count; ++line)
+    {
+        Shaped_Paragraph *sp = paragraph_cache_get(&engine.paragraph_cache, line, (F32)BENCH_TARGET_WIDTH);
+
+        Temporary_Arena scratch = scratch_begin();
+        for (U32 ri = 0; ri < arrlenu(sp->runs); ++ri)
+        {
+            Font_Run *run = sp->runs + ri;
+            Glyph_Atlas_Key *keys = push_array(scratch.arena, Glyph_Atlas_Key, run->glyph_count);
+            Glyph_Cel *cels       = push_array(scratch.arena, Glyph_Cel, run->glyph_count);
+            for (U32 gi = 0; gi < run->glyph_count; ++gi)
+            {
+                Glyph_Atlas_Key *key = keys + gi;
+                *key = {};
+                key->face        = run->face;
+                key->em_size_px  = run->em_size_px;
+                key->glyph_index = run->glyph_indices[gi];
+            }
+            glyph_atlas_fill(&engine.glyph_atlas, keys, run->glyph_count, cels);
+        }
+        scratch_end(scratch);
+    }
+    U64 end = os_read_timer();
+
+    engine_release(&engine);
+    return end - begin;
+}
+
+function U64
+bench_replay_frame_proc(void *user_data)
+{
+    Bench_Replay *replay = (Bench_Replay *)user_data;
+    Bench_Fixture *f = replay->fixture;
+
+    Renderer r = {};
+    arena_clear(f->arena);
+
+    U64 begin = os_read_timer();
+    render_begin_frame(&r, f->arena);
+    bench_build_frame(f, &replay->engine, &r);
+    U64 end = os_read_timer();
+
+    assume(r.instance_count == replay->frame_glyph_count);
+    return end - begin;
+}
+
+function void
+bench_run_replay(Bench *bench, Bench_Fixture *f)
+{
+    Bench_Replay *replay = push_struct(bench->arena, Bench_Replay);
+    replay->fixture = f;
+
+    fprintf(stderr, "loading %s...\n", bench->replay_path);
+    B32 loaded = font_trace_replay_load(&replay->trace, bench->replay_path);
+    bench_check(bench, "check/replay_loaded", loaded && arrlenu(replay->trace.texts));
+    if (! loaded || ! arrlenu(replay->trace.texts))
+    {
+        font_trace_replay_release(&replay->trace);
+        return;
+    }
+
+    Font_Trace_Text *texts = replay->trace.texts;
+    Font_Trace_Text *base  = texts;
+    replay->backend = font_trace_replay_backend(&replay->trace);
+    for (U32 ti = 0; ti < arrlenu(texts); ++ti)
+    {
+        Font_Trace_Text *text = texts + ti;
+        replay->char_count += text->length;
+
+        B32 has_newline = false;
+        for (U32 i = 0; i < text->length && ! has_newline; ++i)
+        { has_newline = (text->text[i] == '\n'); }
+
+        if (text->family == base->family && text->pt_per_em == base->pt_per_em && ! has_newline)
+        { bench_append_line(&replay->document, Bench_Text{text->text, text->length}); }
+    }
+    text_source_open_memory(&replay->source, (U8 *)replay->document, arrlenu(replay->document)*sizeof(U16), TEXT_ENCODING_UTF16LE);
+
+    // Room for a whole trace's worth of glyphs and paragraphs, so nothing is evicted.
+    replay->cold_config = engine_default_config(replay->backend, &replay->source, base->family, base->pt_per_em);
+    replay->cold_config.atlas_width        = 2048;
+    replay->cold_config.atlas_height       = 2048;
+    replay->cold_config.atlas_entry_count  = 65536;
+    replay->cold_config.paragraph_capacity = (U32)clamp((U64)256, replay->source.line_count, (U64)65536);
+
+    Engine_Config config = engine_default_config(replay->backend, &replay->source, base->family, base->pt_per_em);
+    engine_init(&replay->engine, &config);
+    {
+        Renderer r = {};
+        arena_clear(f->arena);
+        render_begin_frame(&r, f->arena);
+        bench_build_frame(f, &replay->engine, &r);
+        replay->frame_glyph_count = r.instance_count;
+    }
+
+    bench_run(bench, "replay/map_text",               "char",  replay->char_count, bench_replay_map_text_proc, replay);
+    bench_run(bench, "replay/paragraphs_cold",        "paragraph", replay->source.line_count, bench_replay_paragraphs_cold_proc, replay);
+    bench_run(bench, "replay/frame_vertices",         "glyph", replay->frame_glyph_count, bench_replay_frame_proc, replay);
+
+    // @Note: Misses are answered by the synthetic backend, so they time
+    // something other than what was recorded.
+    bench_metric(bench, "replay/text_count", "texts", (F64)arrlenu(texts));
+    bench_metric(bench, "replay/trace_size", "KB", (F64)replay->trace.size/1024.0);
+    bench_metric(bench, "replay/miss_count", "answers", (F64)font_trace_replay_miss_count(&replay->trace));
+
+    engine_release(&replay->engine);
+    text_source_close(&replay->source);
+    arrfree(replay->document);
+    font_trace_replay_release(&replay->trace);
+}
+
+// -----------------------------------------
+// @Note: Checks
+
+// @Note: The paragraphs and a last line of units with a 0x0A byte that
+// aren't '\n', opened once as UTF-16LE and once byte-swapped behind a
+// UTF-16BE BOM. Both have to index and read back the same lines.
+function B32
+bench_check_text_source_utf16be(Bench_Fixture *f)
+{
+    Bench_Corpus *corpus = f->corpus;
+    U16 last_line[] = {'\n', 0x010a, 'x', 0x0a0a, 0x0a00, 0x010a};
+
+    U16 *little = NULL;
+    for (U64 i = 0; i < corpus->paragraphs_size/sizeof(U16); ++i)
+    { arrput(little, corpus->paragraphs[i]); }
+    for (U32 i = 0; i < array_count(last_line); ++i)
+    { arrput(little, last_line[i]); }
+
+    U64 unit_count = arrlenu(little);
+    U8 *big = NULL;
+    arrsetlen(big, 2 + unit_count*2);
+    big[0] = 0xfe;
+    big[1] = 0xff;
+    for (U64 i = 0; i < unit_count; ++i)
+    {
+        big[2 + i*2]     = (U8)(little[i] >> 8);
+        big[2 + i*2 + 1] = (U8)(little[i] & 0xff);
+    }
+
+    Text_Source sources[2] = {};
+    text_source_open_memory(sources + 0, (U8 *)little, unit_count*sizeof(U16), TEXT_ENCODING_UTF16LE);
+    text_source_open_memory(sources + 1, big, arrlenu(big), TEXT_ENCODING_UTF8);
+
+    B32 result = (sources[1].encoding == TEXT_ENCODING_UTF16BE &&
+                  sources[0].line_count == sources[1].line_count && sources[0].line_count > 1);
+    Arena *arena = arena_alloc();
+    for (U64 line = 0; result && line < sources[0].line_count; ++line)
+    {
+        U32 lengths[2] = {};
+        U16 *a = text_source_get_line(sources + 0, arena, line, lengths + 0);
+        U16 *b = text_source_get_line(sources + 1, arena, line, lengths + 1);
+        result = (lengths[0] == lengths[1] && memory_equal(a, b, lengths[0]*sizeof(U16)));
+        arena_clear(arena);
+    }
+    arena_release(arena);
+
+    text_source_close(sources + 0);
+    text_source_close(sources + 1);
+    arrfree(little);
+    arrfree(big);
+    return result;
+}
+
+// @Note: A soft hyphen in a word of 'a's, at every place the SSE2 loop and
+// the scalar tail can meet it. The span has to end before it, with the
+// character in front handed back like at any other span end.
+function B32
+bench_check_simple_text_soft_hyphen(Bench_Fixture *f)
+{
+    U16 word[32];
+    B32 result = ! simple_text_is_simple_char(0xad);
+    for (U32 at = 0; result && at < array_count(word); ++at)
+    {
+        for (U32 i = 0; i < array_count(word); ++i)
+        { word[i] = 'a'; }
+        word[at] = 0xad;
+
+        U32 expected = (at) ? at - 1 : 0;
+        result = (simple_text_scan(word, array_count(word)) == expected);
+    }
+    return result;
+}
+
+// @Note: A GSUB/GPOS table cut short in each way the parser can tell. Each
+// has to count as having shaping features, so the face stays off the fast
+// path; a well-formed empty FeatureList doesn't.
+function B32
+bench_check_simple_text_malformed_features(Bench_Fixture *f)
+{
+    U8 table[16] = {};
+    B32 result = simple_text_has_shaping_features(table, 8);
+
+    table[6] = 0xff; // FeatureList past the end.
+    result = (result && simple_text_has_shaping_features(table, sizeof(table)));
+
+    table[6]  = 0;
+    table[7]  = 10;
+    table[10] = 0x01; // 256 features in 6 bytes.
+    result = (result && simple_text_has_shaping_features(table, sizeof(table)));
+
+    table[10] = 0;
+    result = (result && ! simple_text_has_shaping_features(table, sizeof(table)));
+    return result;
+}
+
+function B32
+bench_check_prefix_sum(Bench_Fixture *f)
+{
+    Temporary_Arena scratch = scratch_begin();
+    S32 *simd   = push_array(scratch.arena, S32, f->long_glyph_count + 1);
+    S32 *scalar = push_array(scratch.arena, S32, f->long_glyph_count + 1);
+    layout_prefix_sum_26_6(f->long_advances, f->long_glyph_count, simd);
+    layout_prefix_sum_26_6_scalar(f->long_advances, f->long_glyph_count, scalar);
+    B32 result = memory_equal(simd, scalar, (f->long_glyph_count + 1)*sizeof(S32));
+    scratch_end(scratch);
+    return result;
+}
+
+// @Note: A paragraph long and wide enough to run past LAYOUT_MAX_X_PX, with
+// a few advances no font should give. The vector sum has to match the
+// scalar one, and both a sum in S64 clamped the same way: saturated, never
+// wrapped.
+function B32
+bench_check_prefix_sum_saturates(Bench_Fixture *f)
+{
+    Temporary_Arena scratch = scratch_begin();
+    U32 count = 72*1024;
+    F32 *advances = push_array(scratch.arena, F32, count);
+    S32 *simd     = push_array(scratch.arena, S32, count + 1);
+    S32 *scalar   = push_array(scratch.arena, S32, count + 1);
+
+    U64 random = BENCH_SEED;
+    for (U32 i = 0; i < count; ++i)
+    { advances[i] = 240.0f + (F32)(bench_random(&random) % 4096)/64.0f; }
+    advances[5]  = NAN;
+    advances[17] = INFINITY;
+    advances[18] = -INFINITY;
+    advances[40] = 1e30f;
+    advances[count - 3] = -1e30f;
+
+    layout_prefix_sum_26_6(advances, count, simd);
+    layout_prefix_sum_26_6_scalar(advances, count, scalar);
+    B32 result = memory_equal(simd, scalar, (count + 1)*sizeof(S32));
+
+    S64 x = 0;
+    for (U32 i = 0; result && i < count; ++i)
+    {
+        F32 advance = advances[i];
+        advance = (advance > -LAYOUT_MAX_ADVANCE_PX) ? advance : -LAYOUT_MAX_ADVANCE_PX;
+        advance = (advance < LAYOUT_MAX_ADVANCE_PX) ? advance : LAYOUT_MAX_ADVANCE_PX;
+        x = clamp((S64)-LAYOUT_MAX_X_26_6, x + (S64)nearbyintf(advance*64.0f), (S64)LAYOUT_MAX_X_26_6);
+        result = (simd[i + 1] == x);
+    }
+    result = (result && simd[count - 4] == LAYOUT_MAX_X_26_6);
+
+    scratch_end(scratch);
+    return result;
+}
+
+// @Note: Per channel max(d, round(s*c/255)), in plain integers. Ties can't
+// happen: 2*s*c is even and 255 is odd.
+function U32
+bench_max_pixel(U32 dst, U32 src, U32 color)
+{
+    U32 result = 0;
+    for (U32 shift = 0; shift < 32; shift += 8)
+    {
+        U32 d = (dst >> shift) & 0xff;
+        U32 x = (((src >> shift) & 0xff)*((color >> shift) & 0xff)*2 + 255) / 510;
+        result |= max(d, x) << shift;
+    }
+    return result;
+}
+
+// @Note: soft_render_max_span() has an AVX2, an SSE2 and a scalar loop, and
+// which ones run depends on the count. Random counts, unaligned starts and
+// colors, white included for its own path, against bench_max_pixel().
+function B32
+bench_check_soft_render_max_span(Bench_Fixture *f)
+{
+    U32 dst[80];
+    U32 src[80];
+    U32 expected[80];
+
+    U64 random = BENCH_SEED;
+    B32 result = true;
+    for (U32 trial = 0; result && trial < 4096; ++trial)
+    {
+        U32 count  = (U32)(bench_random(&random) % 72);
+        U32 offset = (U32)(bench_random(&random) % 8);
+        U32 color  = (U32)bench_random(&random);
+        if (trial % 4 == 0)
+        { color = GLYPH_COLOR_WHITE; }
+        else if (trial % 4 == 1)
+        { color |= 0xff000000; }
+
+        for (U32 i = 0; i < array_count(dst); ++i)
+        {
+            dst[i] = (U32)bench_random(&random);
+            src[i] = (U32)bench_random(&random);
+            expected[i] = (i >= offset && i < offset + count) ? bench_max_pixel(dst[i], src[i], color) : dst[i];
+        }
+
+        soft_render_max_span(dst + offset, src + offset, count, color);
+        result = memory_equal(dst, expected, sizeof(dst));
+    }
+    return result;
+}
+
+// @Note: A clipped glyph keeps exactly the texels whose centers are in the
+// clip, min inclusive and max exclusive. Clip edges land on quarter pixels,
+// so texel centers fall right on them too. Drawn through the compositor,
+// with every texel a different color.
+function B32
+bench_check_soft_render_glyph_clip(Bench_Fixture *f)
+{
+    U32 size = 64;
+    Bitmap atlas = {};
+    atlas.width  = size;
+    atlas.height = size;
+    atlas.pitch  = size*4;
+    atlas.data   = push_array(f->arena, U8, atlas.pitch*atlas.height);
+    for (U32 i = 0; i < size*size; ++i)
+    { ((U32 *)atlas.data)[i] = 0xff000000 | (i + 1); }
+
+    Bitmap target = {};
+    target.width  = size;
+    target.height = size;
+    target.pitch  = size*4;
+    target.data   = push_array(f->arena, U8, target.pitch*target.height);
+
+    U64 random = BENCH_SEED;
+    B32 result = true;
+    for (U32 trial = 0; result && trial < 1024; ++trial)
+    {
+        Glyph_Instance glyph = {};
+        glyph.width   = (U16)(1 + bench_random(&random) % 24);
+        glyph.height  = (U16)(1 + bench_random(&random) % 24);
+        glyph.atlas_x = (U16)(bench_random(&random) % (size - glyph.width));
+        glyph.atlas_y = (U16)(bench_random(&random) % (size - glyph.height));
+        glyph.min_px  = V2{(F32)(8 + bench_random(&random) % 24), (F32)(8 + bench_random(&random) % 24)};
+        glyph.color   = GLYPH_COLOR_WHITE;
+
+        AABB2 clip = {};
+        clip.min = V2{glyph.min_px.x - 2.0f + (F32)(bench_random(&random) % 64)*0.25f, glyph.min_px.y - 2.0f + (F32)(bench_random(&random) % 64)*0.25f};
+        clip.max = V2{clip.min.x + (F32)(bench_random(&random) % 96)*0.25f, clip.min.y + (F32)(bench_random(&random) % 96)*0.25f};
+
+        Arena *arena = arena_alloc();
+        Renderer r = {};
+        render_begin_frame(&r, arena);
+        render_set_state(&r, Render_State{0, RENDER_SHADER_GLYPH, RENDER_BLEND_MAX, 0, RENDER_CLIP_NONE});
+        render_glyph_instance_clipped(&r, glyph, clip);
+        render_build_batches(&r);
+        soft_render_frame(&r, &target, &atlas, 1, 0, 1, NULL);
+        arena_release(arena);
+
+        // Pixel rows count down from the top, glyph rows up from min_px.
+        for (U32 y = 0; result && y < size; ++y)
+        {
+            for (U32 x = 0; result && x < size; ++x)
+            {
+                F32 center_x = (F32)x + 0.5f;
+                F32 center_y = (F32)(size - 1 - y) + 0.5f;
+                S32 column = (S32)x - (S32)glyph.min_px.x;
+                S32 row    = (S32)(size - 1 - y) - (S32)glyph.min_px.y;
+
+                U32 expected = 0;
+                if (column >= 0 && column < glyph.width && row >= 0 && row < glyph.height &&
+                    center_x >= clip.min.x && center_x < clip.max.x && center_y >= clip.min.y && center_y < clip.max.y)
+                { expected = ((U32 *)atlas.data)[(glyph.atlas_y + glyph.height - 1 - row)*size + glyph.atlas_x + column]; }
+
+                result = (((U32 *)(target.data + y*target.pitch))[x] == expected);
+            }
+        }
+    }
+    return result;
+}
+
+// @Note: A fixed frame: a panel, and the paragraph source through a fresh
+// engine, clipped to its container and scissored to a box with edges on
+// half and quarter pixels. The same pixels have to come out on one thread
+// and on four, and they have to match the checked-in hash.
+function B32
+bench_check_soft_render_frame(Bench_Fixture *f)
+{
+    Synthetic_Font font = {};
+    Engine engine = {};
+    Engine_Config config = engine_default_config(synthetic_font_backend(&font, BENCH_PX_PER_INCH), &f->paragraph_source, f->family, BENCH_PT_PER_EM);
+    engine_init(&engine, &config);
+
+    F32 w = (F32)BENCH_TARGET_WIDTH;
+    F32 h = (F32)BENCH_TARGET_HEIGHT;
+    V2 container_origin_px  = V2{40.0f, h - 20.0f};
+    F32 container_width_px  = w - 80.0f;
+    F32 container_height_px = h - 40.0f;
+
+    Arena *arena = arena_alloc();
+    Renderer r = {};
+    render_begin_frame(&r, arena);
+
+    render_set_state(&r, Render_State{0, RENDER_SHADER_PANEL, RENDER_BLEND_ALPHA, 0, RENDER_CLIP_NONE});
+    render_quad_px_min_max(&r, V2{20.0f, 10.0f}, V2{w - 20.0f, h - 10.0f});
+
+    AABB2 scissor = AABB2{V2{100.25f, 60.5f}, V2{w - 100.75f, h - 60.5f}};
+    render_set_state(&r, Render_State{1, RENDER_SHADER_GLYPH, RENDER_BLEND_MAX, 0, scissor});
+    F32 y_px = 0.0f;
+    for (U64 line = 0; line < paragraph_cache_line_count(&engine.paragraph_cache) && y_px < container_height_px; ++line)
+    {
+        Shaped_Paragraph *sp = paragraph_cache_get(&engine.paragraph_cache, line, container_width_px);
+        render_paragraph(&r, &engine.glyph_atlas, sp, y_px, container_origin_px, container_width_px, container_height_px);
+        y_px += sp->wrap.height_px;
+    }
+    render_build_batches(&r);
+
+    U64 hashes[2] = {};
+    for (U32 pass = 0; pass < 2; ++pass)
+    {
+        Bitmap target = {};
+        target.width  = BENCH_TARGET_WIDTH;
+        target.height = BENCH_TARGET_HEIGHT;
+        target.pitch  = BENCH_TARGET_WIDTH*4;
+        target.data   = push_array(f->arena, U8, target.pitch*target.height);
+        soft_render_frame(&r, &target, &engine.glyph_atlas.bitmap, 1, SOFT_RENDER_CLEAR_COLOR, (pass == 0) ? 1 : 4, NULL);
+
+        // FNV-1a.
+        U64 hash = 0xcbf29ce484222325ull;
+        for (U32 i = 0; i < target.pitch*target.height; ++i)
+        { hash = (hash ^ target.data[i])*0x100000001b3ull; }
+        hashes[pass] = hash;
+    }
+    fprintf(stderr, "%-40s %016llx\n", "check/soft_render_frame hash", (unsigned long long)hashes[0]);
+
+    B32 result = (r.instance_count > 0 && hashes[0] == hashes[1] && hashes[0] == BENCH_SOFT_RENDER_FRAME_HASH);
+
+    arena_release(arena);
+    engine_release(&engine);
+    return result;
+}
+
+// @Note: Renders the paragraph source with two fresh engines, one shaping,
+// wrapping and rasterizing on the job system and one on this thread alone,
+// and compares the pixels.
+function B32
+bench_check_parallel_matches_serial(Bench_Fixture *f)
+{
+    Bitmap targets[2] = {};
+    U64 instance_counts[2] = {};
+    for (U32 pass = 0; pass < 2; ++pass)
+    {
+        Synthetic_Font font = {};
+        Engine engine = {};
+        Engine_Config config = engine_default_config(synthetic_font_backend(&font, BENCH_PX_PER_INCH), &f->paragraph_source, f->family, BENCH_PT_PER_EM);
+        config.jobs = (pass == 0) ? f->jobs : NULL;
+        engine_init(&engine, &config);
+
+        if (config.jobs)
+        { paragraph_cache_prefetch(&engine.paragraph_cache, 0, f->paragraph_source.line_count, (F32)BENCH_TARGET_WIDTH - 80.0f); }
+
+        Arena *arena = arena_alloc();
+        Renderer r = {};
+        render_begin_frame(&r, arena);
+        bench_build_frame(f, &engine, &r);
+        instance_counts[pass] = r.instance_count;
+
+        Bitmap *target = targets + pass;
+        target->width  = BENCH_TARGET_WIDTH;
+        target->height = BENCH_TARGET_HEIGHT;
+        target->pitch  = BENCH_TARGET_WIDTH*4;
+        target->data   = push_array(f->arena, U8, target->pitch*target->height);
+        soft_render_frame(&r, target, &engine.glyph_atlas.bitmap, 1, SOFT_RENDER_CLEAR_COLOR, 1, NULL);
+
+        arena_release(arena);
+        engine_release(&engine);
+    }
+
+    B32 result = (instance_counts[0] == instance_counts[1] && instance_counts[0] > 0 &&
+                  memory_equal(targets[0].data, targets[1].data, targets[0].pitch*targets[0].height));
+    return result;
+}
+
+// @Note: check/trace_round_trip's texts: the multilingual ones and a few
+// log lines.
+function Bench_Text
+bench_round_trip_text(Bench_Corpus *corpus, U32 index)
+{
+    U32 multilingual_count = (U32)arrlenu(corpus->multilingual);
+    Bench_Text result = (index < multilingual_count) ? corpus->multilingual[index] : corpus->log[index - multilingual_count];
+    return result;
+}
+
+function void
+bench_trace_answer(Bench_Fixture *f, Font_Backend *backend, Bench_Trace_Answers *out)
+{
+    Arena *arena = arena_alloc();
+    U32 text_count = (U32)arrlenu(f->corpus->multilingual) + BENCH_ROUND_TRIP_LOG_COUNT;
+    for (U32 ti = 0; ti < text_count; ++ti)
+    {
+        Bench_Text text = bench_round_trip_text(f->corpus, ti);
+        Font_Run *runs = font_map_text(backend, NULL, f->family, BENCH_PT_PER_EM, text.text, text.length, &out->glyph_text_positions);
+        arrput(out->runs, runs);
+
+        U8 *breaks = backend->analyze_breaks(backend->user_data, text.text, text.length);
+        for (U32 i = 0; i < text.length; ++i)
+        { arrput(out->breaks, breaks[i]); }
+        arrfree(breaks);
+
+        for (U32 ri = 0; ri < arrlenu(runs); ++ri)
+        {
+            Font_Run *run = runs + ri;
+            arrput(out->metrics, backend->get_metrics(backend->user_data, run->face, run->em_size_px));
+            for (U32 gi = 0; gi < run->glyph_count; ++gi)
+            {
+                Font_Glyph_Bitmap box = {};
+                backend->rasterize(backend->user_data, arena, run->face, run->em_size_px, run->glyph_indices[gi], &box);
+                box.rgb = NULL;
+                arrput(out->boxes, box);
+            }
+            arena_clear(arena);
+        }
+    }
+    arena_release(arena);
+}
+
+function void
+bench_trace_answers_release(Bench_Trace_Answers *answers)
+{
+    for (U32 ti = 0; ti < arrlenu(answers->runs); ++ti)
+    { font_free_runs(answers->runs[ti]); }
+    arrfree(answers->runs);
+    arrfree(answers->glyph_text_positions);
+    arrfree(answers->breaks);
+    arrfree(answers->metrics);
+    arrfree(answers->boxes);
+    *answers = {};
+}
+
+function B32
+bench_trace_answers_equal(Bench_Trace_Answers *a, Bench_Trace_Answers *b)
+{
+    B32 result = (arrlenu(a->runs) == arrlenu(b->runs) &&
+                  arrlenu(a->glyph_text_positions) == arrlenu(b->glyph_text_positions) &&
+                  arrlenu(a->breaks) == arrlenu(b->breaks) &&
+                  arrlenu(a->metrics) == arrlenu(b->metrics) &&
+                  arrlenu(a->boxes) == arrlenu(b->boxes));
+    result = (result &&
+              memory_equal(a->glyph_text_positions, b->glyph_text_positions, arrlenu(a->glyph_text_positions)*sizeof(U32)) &&
+              memory_equal(a->breaks, b->breaks, arrlenu(a->breaks)) &&
+              memory_equal(a->metrics, b->metrics, arrlenu(a->metrics)*sizeof(Font_Metrics)) &&
+              memory_equal(a->boxes, b->boxes, arrlenu(a->boxes)*sizeof(Font_Glyph_Bitmap)));
+    for (U32 ti = 0; result && ti < arrlenu(a->runs); ++ti)
+    {
+        Font_Run *runs_a = a->runs[ti];
+        Font_Run *runs_b = b->runs[ti];
+        result = (arrlenu(runs_a) == arrlenu(runs_b));
+        for (U32 ri = 0; result && ri < arrlenu(runs_a); ++ri)
+        {
+            Font_Run *run_a = runs_a + ri;
+            Font_Run *run_b = runs_b + ri;
+            result = (run_a->face == run_b->face && run_a->em_size_px == run_b->em_size_px &&
+                      run_a->glyph_count == run_b->glyph_count &&
+                      memory_equal(run_a->glyph_indices, run_b->glyph_indices, run_a->glyph_count*sizeof(U16)) &&
+                      memory_equal(run_a->glyph_advances, run_b->glyph_advances, run_a->glyph_count*sizeof(F32)));
+        }
+    }
+    return result;
+}
+
+// @Note: Records the synthetic backend's answers to BENCH_ROUND_TRIP_TRACE_PATH
+// and loads the trace into replay.
+function B32
+bench_record_round_trip_trace(Bench_Fixture *f, Bench_Trace_Answers *recorded, Font_Trace_Replay *replay)
+{
+    Synthetic_Font font = {};
+    Arena *arena = arena_alloc();
+    Font_Trace_Recorder *recorder = push_struct(arena, Font_Trace_Recorder);
+    B32 result = font_trace_recorder_init(recorder, synthetic_font_backend(&font, BENCH_PX_PER_INCH), BENCH_ROUND_TRIP_TRACE_PATH);
+    if (result)
+    {
+        Font_Backend backend = font_trace_recorder_backend(recorder);
+        bench_trace_answer(f, &backend, recorded);
+        result = (! recorder->writer.failed);
+        backend.release(backend.user_data);
+    }
+    arena_release(arena);
+
+    result = (result && font_trace_replay_load(replay, BENCH_ROUND_TRIP_TRACE_PATH));
+    return result;
+}
+
+// @Note: Everything recorded comes back the same from the trace, and nothing
+// falls through to the replayer's synthetic backend.
+function B32
+bench_check_trace_round_trip(Bench_Fixture *f)
+{
+    Bench_Trace_Answers recorded = {};
+    Bench_Trace_Answers replayed = {};
+    Font_Trace_Replay replay = {};
+    B32 result = bench_record_round_trip_trace(f, &recorded, &replay);
+    if (result)
+    {
+        Font_Backend backend = font_trace_replay_backend(&replay);
+        bench_trace_answer(f, &backend, &replayed);
+        result = (font_trace_replay_miss_count(&replay) == 0 && arrlenu(recorded.boxes) > 0 &&
+                  bench_trace_answers_equal(&recorded, &replayed));
+        font_trace_replay_release(&replay);
+    }
+    bench_trace_answers_release(&recorded);
+    bench_trace_answers_release(&replayed);
+    return result;
+}
+
+// @Note: Every answer's first count set to 0xffffffff, which no answer has
+// the room for. Each is either rejected and answered again by the synthetic
+// backend, or ignored the way a bad count already was: resolve's length and
+// the breaks' length are checked against the text.
+function B32
+bench_check_trace_rejects_corrupt(Bench_Fixture *f)
+{
+    Bench_Trace_Answers recorded = {};
+    Bench_Trace_Answers replayed = {};
+    Font_Trace_Replay replay = {};
+    B32 result = bench_record_round_trip_trace(f, &recorded, &replay);
+    if (result)
+    {
+        U32 corrupt_count = 0xffffffff;
+        for (U32 si = 0; si < arrlenu(replay.answers.slots); ++si)
+        {
+            Font_Trace_Slot *slot = replay.answers.slots + si;
+            if (slot->key && slot->size >= sizeof(U32))
+            { memory_copy(replay.data + slot->offset, &corrupt_count, sizeof(corrupt_count)); }
+        }
+
+        Font_Backend backend = font_trace_replay_backend(&replay);
+        bench_trace_answer(f, &backend, &replayed);
+        result = (replay.miss_counts[FONT_TRACE_RECORD_SHAPE] > 0 &&
+                  replay.miss_counts[FONT_TRACE_RECORD_BREAKS] > 0 &&
+                  arrlenu(replayed.runs) == arrlenu(recorded.runs));
+        font_trace_replay_release(&replay);
+    }
+    bench_trace_answers_release(&recorded);
+    bench_trace_answers_release(&replayed);
+    return result;
+}
+
+// @Note: One random insert or delete, the same on the buffer and on a plain
+// array of the text. Inserts come from a few code units that include
+// newlines, '\r' and a surrogate pair; offsets are any code unit, so pairs
+// and CRLFs get split. False if the change record isn't what the edit did.
+function B32
+bench_text_buffer_random_edit(Text_Buffer *buffer, U16 **reference, U64 *random)
+{
+    local_persist U16 alphabet[] = {'a', 'b', ' ', '\n', '\n', '\r', 0xe9, 0xd83d, 0xde00};
+
+    U64 length = arrlenu(*reference);
+    U64 r = bench_random(random);
+    B32 insert = ((r & 3) || length == 0);
+
+    U64 offset = (r >> 8) % (length + 1);
+    U64 delete_length = 0;
+    if (! insert)
+    {
+        delete_length = ((r >> 40) % 16) ? (r >> 44) % 32 : (r >> 44) % 1024;
+        delete_length = max(min(delete_length, length), (U64)1);
+        offset = min(offset, length - delete_length);
+    }
+
+    Text_Buffer_Change expected = {};
+    expected.offset = offset;
+    for (U64 i = 0; i < offset; ++i)
+    { expected.first_line += ((*reference)[i] == '\n'); }
+
+    if (insert)
+    {
+        U16 text[16];
+        U64 text_length = 1 + (r >> 40) % array_count(text);
+        for (U64 i = 0; i < text_length; ++i)
+        {
+            text[i] = alphabet[bench_random(random) % array_count(alphabet)];
+            expected.inserted_newlines += (text[i] == '\n');
+        }
+        expected.inserted = text_length;
+
+        text_buffer_insert(buffer, offset, text, text_length);
+        arrinsn(*reference, offset, text_length);
+        memory_copy(*reference + offset, text, text_length*sizeof(U16));
+    }
+    else
+    {
+        for (U64 i = offset; i < offset + delete_length; ++i)
+        { expected.removed_newlines += ((*reference)[i] == '\n'); }
+        expected.removed = delete_length;
+
+        text_buffer_delete(buffer, offset, delete_length);
+        arrdeln(*reference, offset, delete_length);
+    }
+
+    U64 change_count = arrlenu(buffer->changes);
+    B32 result = (change_count > 0 && memory_equal(buffer->changes + change_count - 1, &expected, sizeof(expected)));
+    return result;
+}
+
+// @Note: Compares everything the buffer reads back with the reference:
+// the whole text, random slices and their line numbers, and each line's
+// start, ends and text.
+function B32
+bench_text_buffer_matches(Text_Buffer *buffer, U16 *reference, U64 *random)
+{
+    Temporary_Arena scratch = scratch_begin();
+    U64 length = arrlenu(reference);
+
+    U16 *copy = push_array(scratch.arena, U16, length + 1);
+    B32 result = (text_buffer_length(buffer) == length &&
+                  text_buffer_copy(buffer, 0, length, copy) == length &&
+                  memory_equal(copy, reference, length*sizeof(U16)));
+
+    for (U32 i = 0; result && i < 64; ++i)
+    {
+        U64 offset = bench_random(random) % (length + 1);
+        U64 count  = min(bench_random(random) % 256, length - offset);
+        U64 line = 0;
+        for (U64 at = 0; at < offset; ++at)
+        { line += (reference[at] == '\n'); }
+        result = (text_buffer_copy(buffer, offset, count, copy) == count &&
+                  memory_equal(copy, reference + offset, count*sizeof(U16)) &&
+                  text_buffer_line_of_offset(buffer, offset) == line);
+    }
+
+    U64 line = 0;
+    U64 line_begin = 0;
+    for (U64 at = 0; result && at <= length; ++at)
+    {
+        if (at < length && reference[at] != '\n')
+        { continue; }
+
+        // Both ends of the line are in it.
+        result = (text_buffer_line_of_offset(buffer, line_begin) == line && text_buffer_line_of_offset(buffer, at) == line);
+
+        // [line_begin, at) is the line, without its newline.
+        U64 expected_length = min(at - line_begin, (U64)TEXT_SOURCE_MAX_LINE_LENGTH);
+        if (expected_length && reference[line_begin + expected_length - 1] == '\r')
+        { expected_length -= 1; }
+
+        U32 text_length = 0;
+        U16 *text = text_buffer_get_line(buffer, scratch.arena, line, &text_length);
+        result = (result && text_buffer_line_start(buffer, line) == line_begin &&
+                  text_length == expected_length && text[text_length] == 0 &&
+                  memory_equal(text, reference + line_begin, expected_length*sizeof(U16)));
+
+        line += 1;
+        line_begin = at + 1;
+    }
+    result = (result && text_buffer_line_count(buffer) == line);
+
+    scratch_end(scratch);
+    return result;
+}
+
+// @Note: Random edits over the paragraph text, each one's change record
+// checked as it's made and the whole buffer every so often.
+function B32
+bench_check_text_buffer_edits(Bench_Fixture *f)
+{
+    Bench_Corpus *corpus = f->corpus;
+    U64 length = corpus->paragraphs_size/sizeof(U16);
+
+    U16 *reference = NULL;
+    arrsetlen(reference, length);
+    memory_copy(reference, corpus->paragraphs, length*sizeof(U16));
+
+    Text_Buffer buffer = {};
+    text_buffer_init(&buffer, corpus->paragraphs, length);
+
+    U64 random = BENCH_SEED;
+    B32 result = bench_text_buffer_matches(&buffer, reference, &random);
+    for (U32 ei = 0; result && ei < BENCH_EDIT_COUNT; ++ei)
+    {
+        result = bench_text_buffer_random_edit(&buffer, &reference, &random);
+        text_buffer_clear_changes(&buffer);
+        if (result && (ei % 64) == 63)
+        { result = bench_text_buffer_matches(&buffer, reference, &random); }
+    }
+    result = (result && bench_text_buffer_matches(&buffer, reference, &random));
+
+    text_buffer_release(&buffer);
+    arrfree(reference);
+    return result;
+}
+
+// @Note: A paragraph cache over a buffer being edited. After each round of
+// edits and paragraph_cache_apply_changes(), every paragraph still cached
+// has to be what shaping its line anew gives.
+function B32
+bench_check_paragraph_invalidation(Bench_Fixture *f)
+{
+    Bench_Corpus *corpus = f->corpus;
+    U64 length = corpus->paragraphs_size/sizeof(U16);
+
+    U16 *reference = NULL;
+    arrsetlen(reference, length);
+    memory_copy(reference, corpus->paragraphs, length*sizeof(U16));
+
+    Text_Buffer buffer = {};
+    text_buffer_init(&buffer, corpus->paragraphs, length);
+
+    Synthetic_Font font = {};
+    Font_Backend backend = synthetic_font_backend(&font, BENCH_PX_PER_INCH);
+    Paragraph_Cache cache = {};
+    paragraph_cache_init(&cache, 1024, &f->paragraph_source, &backend, NULL, f->family, BENCH_PT_PER_EM);
+    paragraph_cache_set_buffer(&cache, &buffer);
+
+    Shaped_Paragraph fresh = {};
+    fresh.arena = arena_alloc();
+
+    U64 random = BENCH_SEED;
+    U64 kept_count = 0;
+    B32 result = true;
+    for (U32 round = 0; result && round < BENCH_EDIT_ROUND_COUNT; ++round)
+    {
+        paragraph_cache_prefetch(&cache, 0, paragraph_cache_line_count(&cache), (F32)BENCH_TARGET_WIDTH);
+
+        U32 edit_count = 1 + (U32)(bench_random(&random) % 4);
+        for (U32 ei = 0; result && ei < edit_count; ++ei)
+        { result = bench_text_buffer_random_edit(&buffer, &reference, &random); }
+        paragraph_cache_apply_changes(&cache, buffer.changes, arrlenu(buffer.changes));
+        text_buffer_clear_changes(&buffer);
+
+        dll_for(cache.sentinel, sp)
+        {
+            if (! result || sp->line == (U64)-1)
+            { continue; }
+
+            kept_count += 1;
+            result = (sp->line < text_buffer_line_count(&buffer));
+            if (! result)
+            { break; }
+
+            paragraph_cache_shape(&cache, &fresh, sp->line);
+            result = (arrlenu(sp->runs) == arrlenu(fresh.runs) && sp->paragraph.glyph_count == fresh.paragraph.glyph_count);
+            for (U32 ri = 0; result && ri < arrlenu(sp->runs); ++ri)
+            {
+                Font_Run *a = sp->runs + ri;
+                Font_Run *b = fresh.runs + ri;
+                result = (a->face == b->face && a->glyph_count == b->glyph_count &&
+                          memory_equal(a->glyph_indices, b->glyph_indices, a->glyph_count*sizeof(U16)));
+            }
+
+            font_free_runs(fresh.runs);
+            fresh.runs = NULL;
+            arena_clear(fresh.arena);
+        }
+    }
+
+    // Both have to have happened, or the check didn't check much.
+    result = (result && kept_count > 0 && cache.invalidation_count > 0);
+
+    arena_release(fresh.arena);
+    paragraph_cache_release(&cache);
+    text_buffer_release(&buffer);
+    arrfree(reference);
+    return result;
+}
+
+// -----------------------------------------
+// @Note: Fixture
+
+function void
+bench_init_fixture(Bench_Fixture *f, Bench *bench, Bench_Corpus *corpus, Job_System *jobs)
+{
+    *f = {};
+    f->bench     = bench;
+    f->corpus    = corpus;
+    f->arena     = arena_alloc();
+    f->jobs      = jobs;
+    f->family    = L"Fira Code";
+    f->backend   = synthetic_font_backend(&f->synthetic_font, BENCH_PX_PER_INCH);
+    f->px_per_em = font_px_per_em(&f->backend, BENCH_PT_PER_EM);
+    {
+        U16 a = 'a';
+        f->backend.resolve(f->backend.user_data, f->family, &a, 1, &f->face);
+    }
+
+    U64 random = BENCH_SEED;
+
+    // Glyph keys, and an atlas holding all of them.
+    f->glyph_keys = push_array(bench->arena, Glyph_Atlas_Key, BENCH_GLYPH_KEY_COUNT);
+    f->glyph_cels = push_array(bench->arena, Glyph_Cel, BENCH_GLYPH_KEY_COUNT);
+    for (U32 ki = 0; ki < BENCH_GLYPH_KEY_COUNT; ++ki)
+    {
+        Glyph_Atlas_Key key = {};
+        key.face        = f->face;
+        key.em_size_px  = f->px_per_em;
+        key.glyph_index = (U16)(bench_random(&random) % BENCH_DISTINCT_GLYPH_COUNT);
+        f->glyph_keys[ki] = key;
+    }
+    glyph_atlas_init(&f->warm_atlas, &f->backend, NULL, 2048, 2048, BENCH_DISTINCT_GLYPH_COUNT*2);
+    glyph_atlas_fill(&f->warm_atlas, f->glyph_keys, BENCH_GLYPH_KEY_COUNT, f->glyph_cels);
+
+    f->pack_sizes = push_array(bench->arena, U32, BENCH_PACK_COUNT*2);
+    for (U32 pi = 0; pi < BENCH_PACK_COUNT*2; ++pi)
+    { f->pack_sizes[pi] = 4 + (U32)(bench_random(&random) % 36); }
+
+    {
+        Font_Glyph_Bitmap *glyph = &f->blit_glyph;
+        glyph->width  = BENCH_BLIT_SIZE;
+        glyph->height = BENCH_BLIT_SIZE;
+        glyph->rgb    = push_array(bench->arena, U8, BENCH_BLIT_SIZE*BENCH_BLIT_SIZE*3);
+        for (U32 i = 0; i < BENCH_BLIT_SIZE*BENCH_BLIT_SIZE*3; ++i)
+        { glyph->rgb[i] = (U8)bench_random(&random); }
+
+        f->blit_target.width  = 1024;
+        f->blit_target.height = 1024;
+        f->blit_target.pitch  = 1024*4;
+        f->blit_target.data   = push_array(bench->arena, U8, f->blit_target.pitch*f->blit_target.height);
+    }
+
+    // The long line, shaped and laid out once, like paragraph_cache_shape() does.
+    {
+        Bench_Text line = corpus->long_line;
+        Font_Run *runs = font_map_text(&f->backend, NULL, f->family, BENCH_PT_PER_EM, line.text, line.length, &f->long_positions);
+        f->long_run_count        = (U32)arrlenu(runs);
+        f->long_run_glyph_counts = push_array(bench->arena, U32, f->long_run_count);
+        f->long_run_heights_px   = push_array(bench->arena, F32, f->long_run_count);
+        for (U32 ri = 0; ri < f->long_run_count; ++ri)
+        {
+            Font_Run *run = runs + ri;
+            for (U32 gi = 0; gi < run->glyph_count; ++gi)
+            { arrput(f->long_advances, run->glyph_advances[gi]); }
+            f->long_run_glyph_counts[ri] = run->glyph_count;
+            f->long_run_heights_px[ri]   = f->backend.get_metrics(f->backend.user_data, run->face, run->em_size_px).advance_height_px;
+        }
+        font_free_runs(runs);
+
+        f->long_glyph_count = (U32)arrlenu(f->long_advances);
+        f->long_breaks      = f->backend.analyze_breaks(f->backend.user_data, line.text, line.length);
+        f->prefix_sums      = push_array(bench->arena, S32, f->long_glyph_count + 1);
+        f->long_paragraph   = layout_build_paragraph(bench->arena, f->long_advances, f->long_positions, f->long_glyph_count,
+                                                     f->long_breaks, line.length,
+                                                     f->long_run_glyph_counts, f->long_run_heights_px, f->long_run_count);
+    }
+
+    // The paragraph source through an engine, with everything in view shaped
+    // and rasterized already, and a frame of it.
+    {
+        text_source_open_memory(&f->paragraph_source, (U8 *)corpus->paragraphs, corpus->paragraphs_size, TEXT_ENCODING_UTF16LE);
+
+        Engine_Config config = engine_default_config(f->backend, &f->paragraph_source, f->family, BENCH_PT_PER_EM);
+        engine_init(&f->engine, &config);
+
+        f->frame_arena = arena_alloc();
+        render_begin_frame(&f->renderer, f->frame_arena);
+        bench_build_frame(f, &f->engine, &f->renderer);
+        f->frame_glyph_count = f->renderer.instance_count;
+
+        f->target.width  = BENCH_TARGET_WIDTH;
+        f->target.height = BENCH_TARGET_HEIGHT;
+        f->target.pitch  = BENCH_TARGET_WIDTH*4;
+        f->target.data   = push_array(bench->arena, U8, f->target.pitch*f->target.height);
+    }
+
+    // Rows of key and value labels, a thousand distinct texts.
+    {
+        f->labels = push_array(bench->arena, Label, BENCH_LABEL_COUNT);
+        for (U32 li = 0; li < BENCH_LABEL_COUNT; ++li)
+        {
+            char buffer[32];
+            int length = (li % 2) ? snprintf(buffer, sizeof(buffer), "%.3f", (F64)(li % 1000)*0.125)
+                                  : snprintf(buffer, sizeof(buffer), "property_%u", li % 1000);
+            U16 text[32];
+            for (int i = 0; i < length; ++i)
+            { text[i] = (U16)buffer[i]; }
+
+            F32 top_px = (F32)BENCH_TARGET_HEIGHT - (F32)((li/2) % 40)*18.0f;
+            F32 left_px = 10.0f + (F32)(li % 2)*160.0f;
+            Label *label = f->labels + li;
+            label->text    = label_string_make(bench->arena, text, (U32)length);
+            label->style   = Label_Style{f->family, BENCH_PT_PER_EM*0.75f};
+            label->rect_px = AABB2{V2{left_px, top_px - 18.0f}, V2{left_px + 150.0f, top_px}};
+        }
+    }
+
+    // The document, with a paragraph cache small enough to miss on every line.
+    {
+        text_source_open_memory(&f->document_source, (U8 *)corpus->document, corpus->document_size, TEXT_ENCODING_UTF16LE);
+
+        Synthetic_Font *font = push_struct(bench->arena, Synthetic_Font);
+        Engine_Config config = engine_default_config(synthetic_font_backend(font, BENCH_PX_PER_INCH), &f->document_source, f->family, BENCH_PT_PER_EM);
+        config.paragraph_capacity = 256;
+        engine_init(&f->document_engine, &config);
+    }
+
+    f->parallel_for_values = push_array(bench->arena, U32, BENCH_PARALLEL_FOR_COUNT);
+    for (U32 i = 0; i < BENCH_PARALLEL_FOR_COUNT; ++i)
+    { f->parallel_for_values[i] = 1; }
+}
+
+function void
+bench_release_fixture(Bench_Fixture *f)
+{
+    engine_release(&f->document_engine);
+    text_source_close(&f->document_source);
+
+    label_glyphs_free(&f->label_glyphs);
+    arena_release(f->frame_arena);
+    engine_release(&f->engine);
+    text_source_close(&f->paragraph_source);
+
+    arrfree(f->long_wrap.lines);
+    arrfree(f->long_breaks);
+    arrfree(f->long_advances);
+    arrfree(f->long_positions);
+    glyph_atlas_release(&f->warm_atlas);
+    arena_release(f->arena);
+    *f = {};
+}
+
+// -----------------------------------------
+// @Note: Suite
+
+// @Note: Lookup throughput with 1, 2, 4... threads reading the same table,
+// and how close each is to the single thread's times the thread count.
+function void
+bench_run_read_scaling(Bench *bench, Bench_Fixture *f)
+{
+    U32 max_thread_count = (bench->thread_count) ? bench->thread_count : text_source_get_processor_count();
+    max_thread_count = min(max_thread_count, (U32)JOB_MAX_WORKER_COUNT);
+
+    F64 single_ns = 0.0;
+    for (U32 thread_count = 1; thread_count <= max_thread_count; thread_count *= 2)
+    {
+        char *name = bench_format(bench->arena, "glyph_atlas/read_scaling/threads_%u", thread_count);
+        if (! bench_is_selected(bench, name))
+        { continue; }
+
+        Job_System jobs = {};
+        job_system_init(&jobs, thread_count);
+
+        Bench_Read_Task task = {f, &jobs, thread_count};
+        bench_run(bench, name, "lookup", (U64)BENCH_READ_LOOKUP_COUNT*thread_count, bench_read_scaling_proc, &task);
+        job_system_release(&jobs);
+
+        F64 ns = bench->results[arrlenu(bench->results) - 1].p50_ns;
+        if (thread_count == 1)
+        { single_ns = ns; }
+        else if (single_ns > 0.0)
+        {
+            char *efficiency_name = bench_format(bench->arena, "glyph_atlas/read_scaling/efficiency_threads_%u", thread_count);
+            bench_metric(bench, efficiency_name, "ratio", single_ns / (ns*(F64)thread_count));
+        }
+    }
+}
+
+// @Note: The document for this one is BENCH_TEXT_BUFFER_MB of log lines,
+// built only when it's selected.
+function void
+bench_run_text_buffer(Bench *bench, Bench_Fixture *f)
+{
+    char *name = "text_buffer/insert_middle_100mb";
+    if (! bench_is_selected(bench, name))
+    { return; }
+
+    Bench_Corpus *corpus = f->corpus;
+    U16 *text = NULL;
+    for (U64 li = 0; arrlenu(text)*sizeof(U16) < MB(BENCH_TEXT_BUFFER_MB); ++li)
+    { bench_append_line(&text, corpus->log[li % arrlenu(corpus->log)]); }
+
+    Text_Buffer buffer = {};
+    text_buffer_init(&buffer, text, arrlenu(text));
+    bench_run(bench, name, "insert", BENCH_MIDDLE_INSERT_COUNT, bench_text_buffer_insert_proc, &buffer);
+
+    text_buffer_release(&buffer);
+    arrfree(text);
+}
+
+// @Note: Also reports what an update redid on average, which is what the
+// dirty rows and the glyph diff are there to keep small.
+// @Note: The word cache over the test texts it was meant for. The hit rate
+// and the shaping time saved are from one pass through an empty cache, so
+// they're what repeated words within the text are worth. Misses are shaped
+// by the synthetic backend, which is far cheaper than DWrite, so the time
+// saved is a lower bound; the timed runs are a warm cache against shaping
+// every word.
+function void
+bench_run_word_cache(Bench *bench, Bench_Fixture *f)
+{
+    wchar_t *labels[] = {L"Korean->", L"Sinhala->", L"Armenian->"};
+    char *names[][4] =
+    {
+        {"word_cache/korean_hit_rate",   "word_cache/korean_saved_shape_time",   "word_cache/shape_korean",   "word_cache/shape_korean_uncached"},
+        {"word_cache/sinhala_hit_rate",  "word_cache/sinhala_saved_shape_time",  "word_cache/shape_sinhala",  "word_cache/shape_sinhala_uncached"},
+        {"word_cache/armenian_hit_rate", "word_cache/armenian_saved_shape_time", "word_cache/shape_armenian", "word_cache/shape_armenian_uncached"},
+    };
+
+    if (! bench_is_selected(bench, "word_cache/"))
+    { return; }
+
+    for (U32 li = 0; li < array_count(labels); ++li)
+    {
+        Bench_Word_Cache wc = {};
+        wc.fixture        = f;
+        wc.text           = bench_find_test_text(f->corpus, labels[li]);
+        wc.run.face       = f->face;
+        wc.run.em_size_px = f->px_per_em;
+        if (! wc.text.text)
+        { continue; }
+
+        word_cache_init(&wc.cache, BENCH_WORD_CACHE_ENTRY_COUNT);
+        bench_word_cache_shape(&wc);
+        bench_metric(bench, names[li][0], "%", 100.0*word_cache_hit_rate(wc.cache.stats));
+        bench_metric(bench, names[li][1], "us", (F64)wc.cache.stats.saved_shape_ticks*bench->ns_per_tick/1000.0);
+
+        bench_run(bench, names[li][2], "char", wc.text.length, bench_word_cache_shape_proc, &wc);
+        bench_run(bench, names[li][3], "char", wc.text.length, bench_word_cache_uncached_proc, &wc);
+
+        word_cache_release(&wc.cache);
+        arrfree(wc.run.glyph_indices);
+        arrfree(wc.run.glyph_advances);
+        arrfree(wc.glyph_text_positions);
+    }
+}
+
+function void
+bench_run_terminal(Bench *bench, Bench_Fixture *f)
+{
+    char *name = "terminal/update_300x100_churn_1pct";
+    if (! bench_is_selected(bench, name))
+    { return; }
+
+    Bench_Terminal *terminal = push_struct(bench->arena, Bench_Terminal);
+    terminal->backend = synthetic_font_backend(&terminal->synthetic_font, BENCH_PX_PER_INCH);
+    glyph_atlas_init(&terminal->atlas, &terminal->backend, NULL, 1024, 1024, 1024);
+    terminal->font   = Terminal_Font{&terminal->backend, &terminal->atlas, f->family, BENCH_PT_PER_EM*0.75f};
+    terminal->random = BENCH_SEED;
+    terminal_grid_init_font(&terminal->grid, &terminal->font, BENCH_TERMINAL_COLUMN_COUNT, BENCH_TERMINAL_ROW_COUNT);
+    terminal_grid_update(&terminal->grid);
+
+    bench_run(bench, name, "update", BENCH_TERMINAL_UPDATE_COUNT, bench_terminal_update_proc, terminal);
+
+    F64 update_count = (F64)max(terminal->update_count, (U64)1);
+    bench_metric(bench, "terminal/rows_reshaped_per_update", "row", (F64)terminal->shaped_row_count / update_count);
+    bench_metric(bench, "terminal/cells_rebuilt_per_update", "cell", (F64)terminal->rebuilt_cell_count / update_count);
+
+    terminal_grid_release(&terminal->grid);
+    glyph_atlas_release(&terminal->atlas);
+}
+
+function void
+bench_run_all(Bench *bench, Bench_Fixture *f)
+{
+    Bench_Corpus *corpus = f->corpus;
+
+    bench_run(bench, "text/simple_scan_log",          "char",  corpus->log_length, bench_simple_scan_proc, f);
+    bench_run(bench, "text_source/index_document",    "byte",  corpus->document_size, bench_text_source_index_proc, f);
+    bench_run_text_buffer(bench, f);
+
+    bench_run(bench, "glyph_atlas/lookup_hit",        "glyph", BENCH_GLYPH_KEY_COUNT, bench_glyph_lookup_proc, f);
+    bench_run(bench, "glyph_atlas/insert_miss",       "glyph", BENCH_INSERT_COUNT, bench_glyph_insert_proc, f);
+    bench_run(bench, "glyph_atlas/pack",              "rect",  BENCH_PACK_COUNT, bench_atlas_pack_proc, f);
+    bench_run(bench, "glyph_atlas/blit_rgb_to_rgba",  "pixel", (U64)f->blit_target.width*f->blit_target.height, bench_atlas_blit_proc, f);
+
+    bench_run(bench, "shape/multilingual",            "char",  corpus->multilingual_length, bench_shape_multilingual_proc, f);
+    bench_run(bench, "shape/log",                     "char",  corpus->log_length, bench_shape_log_proc, f);
+    bench_run(bench, "line_break/multilingual",       "char",  corpus->multilingual_length, bench_line_break_multilingual_proc, f);
+    bench_run(bench, "line_break/log",                "char",  corpus->log_length, bench_line_break_log_proc, f);
+    bench_run_word_cache(bench, f);
+
+    bench_run(bench, "layout/build_paragraph_long",   "glyph", f->long_glyph_count, bench_layout_build_proc, f);
+    bench_run(bench, "layout/prefix_sum",             "glyph", f->long_glyph_count, bench_prefix_sum_proc, f);
+    bench_run(bench, "layout/prefix_sum_scalar",      "glyph", f->long_glyph_count, bench_prefix_sum_scalar_proc, f);
+    bench_run(bench, "layout/wrap_resize_long",       "wrap",  BENCH_WRAP_WIDTH_COUNT, bench_wrap_resize_proc, f);
+    bench_run(bench, "layout/scroll_document",        "line",  BENCH_SCROLL_LINE_COUNT, bench_scroll_proc, f);
+
+    bench_run(bench, "render/paragraph_vertices",     "glyph", f->frame_glyph_count, bench_vertices_proc, f);
+    bench_run(bench, "label/layout_cached",           "label", BENCH_LABEL_COUNT, bench_label_layout_proc, f);
+    bench_run(bench, "soft_render/clear",             "pixel", (U64)BENCH_TARGET_WIDTH*BENCH_TARGET_HEIGHT, bench_soft_clear_proc, f);
+    bench_run(bench, "soft_render/text_frame",        "glyph", f->frame_glyph_count, bench_soft_text_proc, f);
+    bench_run_terminal(bench, f);
+
+    bench_run(bench, "job/submit_wait_empty",         "job",   BENCH_JOB_COUNT, bench_job_submit_proc, f);
+    bench_run(bench, "job/parallel_for_sum",          "element", BENCH_PARALLEL_FOR_COUNT, bench_parallel_for_proc, f);
+
+    bench_run_read_scaling(bench, f);
+
+    bench_run(bench, "stats/engine_get_stats",        "snapshot", 1, bench_engine_stats_proc, f);
+    if (bench_is_selected(bench, "memory/") || bench_is_selected(bench, "cache/"))
+    { bench_report_engine_stats(bench, f); }
+
+    if (bench_is_selected(bench, "check/prefix_sum_bit_exact"))
+    { bench_check(bench, "check/prefix_sum_bit_exact", bench_check_prefix_sum(f)); }
+    if (bench_is_selected(bench, "check/prefix_sum_saturates"))
+    { bench_check(bench, "check/prefix_sum_saturates", bench_check_prefix_sum_saturates(f)); }
+    if (bench_is_selected(bench, "check/parallel_matches_serial"))
+    { bench_check(bench, "check/parallel_matches_serial", bench_check_parallel_matches_serial(f)); }
+    if (bench_is_selected(bench, "check/trace_round_trip"))
+    { bench_check(bench, "check/trace_round_trip", bench_check_trace_round_trip(f)); }
+    if (bench_is_selected(bench, "check/trace_rejects_corrupt"))
+    { bench_check(bench, "check/trace_rejects_corrupt", bench_check_trace_rejects_corrupt(f)); }
+    if (bench_is_selected(bench, "check/soft_render_max_span"))
+    { bench_check(bench, "check/soft_render_max_span", bench_check_soft_render_max_span(f)); }
+    if (bench_is_selected(bench, "check/soft_render_glyph_clip"))
+    { bench_check(bench, "check/soft_render_glyph_clip", bench_check_soft_render_glyph_clip(f)); }
+    if (bench_is_selected(bench, "check/soft_render_frame"))
+    { bench_check(bench, "check/soft_render_frame", bench_check_soft_render_frame(f)); }
+    if (bench_is_selected(bench, "check/text_buffer_random_edits"))
+    { bench_check(bench, "check/text_buffer_random_edits", bench_check_text_buffer_edits(f)); }
+    if (bench_is_selected(bench, "check/paragraph_invalidation"))
+    { bench_check(bench, "check/paragraph_invalidation", bench_check_paragraph_invalidation(f)); }
+    if (bench_is_selected(bench, "check/text_source_utf16be"))
+    { bench_check(bench, "check/text_source_utf16be", bench_check_text_source_utf16be(f)); }
+    if (bench_is_selected(bench, "check/simple_text_soft_hyphen"))
+    { bench_check(bench, "check/simple_text_soft_hyphen", bench_check_simple_text_soft_hyphen(f)); }
+    if (bench_is_selected(bench, "check/simple_text_malformed_features"))
+    { bench_check(bench, "check/simple_text_malformed_features", bench_check_simple_text_malformed_features(f)); }
+}
+
+function int
+main_entry(void)
+{
+    Bench bench = {};
+    bench.arena        = arena_alloc();
+    bench.sample_count = BENCH_DEFAULT_SAMPLE_COUNT;
+    bench.document_mb  = BENCH_DEFAULT_DOCUMENT_MB;
+    bench.ns_per_tick  = 1e9 / (F64)os_query_timer_frequency();
+    bench_parse_command_line(&bench);
+
+#if PROFILE_ENABLED
+    profile_init();
+#endif
+
+    Job_System jobs = {};
+    job_system_init(&jobs, bench.thread_count);
+    bench.thread_count = job_worker_count(&jobs);
+
+    fprintf(stderr, "building corpora...\n");
+    Bench_Corpus corpus = {};
+    bench_build_corpus(&bench, &corpus);
+
+    Bench_Fixture fixture = {};
+    bench_init_fixture(&fixture, &bench, &corpus, &jobs);
+
+    bench_run_all(&bench, &fixture);
+    if (bench.replay_path)
+    { bench_run_replay(&bench, &fixture); }
+    bench_write_json(&bench);
+
+    B32 passed = true;
+    for (U32 ci = 0; ci < arrlenu(bench.checks); ++ci)
+    { passed = (passed && bench.checks[ci].passed); }
+
+    bench_release_fixture(&fixture);
+    job_system_release(&jobs);
+#if PROFILE_ENABLED
+    profile_write_chrome_trace("bench_trace.json");
+    profile_release();
+#endif
+
+    return (passed) ? 0 : 1;
+}
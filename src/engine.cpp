@@ -0,0 +1,150 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function Engine_Config
+engine_default_config(Font_Backend backend, Text_Source *source, wchar_t *base_family, F32 pt_per_em)
+{
+    Engine_Config result = {};
+    result.backend            = backend;
+    result.source             = source;
+    result.base_family        = base_family;
+    result.pt_per_em          = pt_per_em;
+    result.atlas_width        = 1024;
+    result.atlas_height       = 1024;
+    result.atlas_entry_count  = 16384;
+    result.paragraph_capacity = 256;
+    result.label_entry_count  = 16384;
+    return result;
+}
+
+function void
+engine_init(Engine *engine, Engine_Config *config)
+{
+    *engine = {};
+    engine->backend = config->backend;
+    engine->jobs    = config->jobs;
+
+    glyph_atlas_init(&engine->glyph_atlas, &engine->backend, config->jobs,
+                     config->atlas_width, config->atlas_height, config->atlas_entry_count);
+    paragraph_cache_init(&engine->paragraph_cache, config->paragraph_capacity, config->source, &engine->backend, config->jobs,
+                         config->base_family, config->pt_per_em);
+    label_cache_init(&engine->label_cache, config->label_entry_count, font_shape_label, &engine->backend);
+}
+
+// @Note: Gives back everything the engine holds, the backend included. The
+// job system and the text source are the caller's.
+function void
+engine_release(Engine *engine)
+{
+    label_cache_release(&engine->label_cache);
+    paragraph_cache_release(&engine->paragraph_cache);
+    glyph_atlas_release(&engine->glyph_atlas);
+
+    if (engine->backend.release)
+    { engine->backend.release(engine->backend.user_data); }
+
+    *engine = {};
+}
+
+function Engine_Stats
+engine_get_stats(Engine *engine)
+{
+    Engine_Stats result = {};
+    result.glyph_atlas     = glyph_atlas_get_stats(&engine->glyph_atlas);
+    result.paragraph_cache = paragraph_cache_get_stats(&engine->paragraph_cache);
+    result.label_cache     = label_cache_get_stats(&engine->label_cache);
+
+    if (engine->backend.get_stats)
+    { engine->backend.get_stats(engine->backend.user_data, &result.backend); }
+
+    result.total_bytes = (result.glyph_atlas.arena_bytes +
+                          result.paragraph_cache.arena_bytes + result.paragraph_cache.heap_bytes +
+                          result.label_cache.arena_bytes +
+                          result.backend.arena_bytes + result.backend.word_arena_bytes);
+    return result;
+}
+
+function F64
+engine_hit_rate(U64 hit_count, U64 miss_count)
+{
+    U64 lookup_count = hit_count + miss_count;
+    F64 result = (lookup_count) ? (F64)hit_count / (F64)lookup_count : 0.0;
+    return result;
+}
+
+// @Note: Appends to the buffer, truncating at its end.
+function void
+engine_stats_print(char *buffer, U32 size, U32 *used, char *format, ...)
+{
+    if (*used + 1 >= size)
+    { return; }
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer + *used, size - *used, format, args);
+    va_end(args);
+
+    if (length > 0)
+    { *used = min(*used + (U32)length, size - 1); }
+}
+
+// @Note: A row per table, then what doesn't fit in one. Returns the length
+// written.
+function U32
+engine_format_stats(Engine_Stats *stats, char *buffer, U32 size)
+{
+    U32 used = 0;
+    if (size)
+    { buffer[0] = 0; }
+
+    Glyph_Atlas_Stats *atlas = &stats->glyph_atlas;
+    Paragraph_Cache_Stats *paragraphs = &stats->paragraph_cache;
+    Label_Cache_Stats *labels = &stats->label_cache;
+    Font_Backend_Stats *backend = &stats->backend;
+
+    char *row = "  %-12s %9u %9u %7.1f%% %8.2f%% %10.1fKB\n";
+    engine_stats_print(buffer, size, &used, "  %-12s %9s %9s %8s %9s %12s\n", "table", "entries", "capacity", "load", "hit rate", "memory");
+    engine_stats_print(buffer, size, &used, row, "glyphs",
+                       atlas->occupied_count, atlas->entry_count, 100.0*(F64)atlas->occupied_count / (F64)max(atlas->entry_count, 1u),
+                       100.0*engine_hit_rate(atlas->lookup_count - atlas->miss_count, atlas->miss_count), (F64)atlas->arena_bytes/1024.0);
+    engine_stats_print(buffer, size, &used, row, "paragraphs",
+                       paragraphs->count, paragraphs->capacity, 100.0*(F64)paragraphs->count / (F64)max(paragraphs->capacity, 1u),
+                       100.0*engine_hit_rate(paragraphs->hit_count, paragraphs->miss_count), (F64)(paragraphs->arena_bytes + paragraphs->heap_bytes)/1024.0);
+    engine_stats_print(buffer, size, &used, row, "labels",
+                       labels->occupied_count, labels->entry_count, 100.0*(F64)labels->occupied_count / (F64)max(labels->entry_count, 1u),
+                       100.0*engine_hit_rate(labels->hit_count, labels->miss_count), (F64)labels->arena_bytes/1024.0);
+    if (backend->face_capacity)
+    {
+        // Faces aren't looked up in a way that misses.
+        engine_stats_print(buffer, size, &used, "  %-12s %9u %9u %7.1f%% %9s %10.1fKB\n", "faces",
+                           backend->face_count, backend->face_capacity, 100.0*(F64)backend->face_count / (F64)backend->face_capacity,
+                           "-", (F64)backend->arena_bytes/1024.0);
+    }
+    if (backend->word_capacity)
+    {
+        engine_stats_print(buffer, size, &used, row, "words",
+                           backend->word_count, backend->word_capacity, 100.0*(F64)backend->word_count / (F64)backend->word_capacity,
+                           100.0*word_cache_hit_rate(backend->word_cache), (F64)backend->word_arena_bytes/1024.0);
+    }
+
+    F64 bitmap_px = (F64)atlas->bitmap_bytes/4.0;
+    engine_stats_print(buffer, size, &used, "  glyphs: probe avg %.2f max %u, %.1f%% of the atlas packed in %u partitions, %llu without ink\n",
+                       atlas->average_probe_length, atlas->max_probe_length, 100.0*(F64)atlas->packed_px / max(bitmap_px, 1.0),
+                       atlas->partition_count, (unsigned long long)atlas->empty_count);
+    for (U32 fi = 0; fi < min(atlas->face_count, (U32)GLYPH_ATLAS_STATS_MAX_FACE_COUNT); ++fi)
+    {
+        Glyph_Atlas_Face_Stats *face = atlas->faces + fi;
+        engine_stats_print(buffer, size, &used, "    face %016llx: %u glyphs, probe max %u\n",
+                           (unsigned long long)face->face, face->glyph_count, face->max_probe_length);
+    }
+    if (atlas->face_count > GLYPH_ATLAS_STATS_MAX_FACE_COUNT)
+    { engine_stats_print(buffer, size, &used, "    and %u more faces\n", atlas->face_count - GLYPH_ATLAS_STATS_MAX_FACE_COUNT); }
+
+    engine_stats_print(buffer, size, &used, "  paragraphs: %llu glyphs, %llu evictions, %.1fKB in stb_ds arrays; labels: %llu resets\n",
+                       (unsigned long long)paragraphs->glyph_count, (unsigned long long)paragraphs->eviction_count, (F64)paragraphs->heap_bytes/1024.0,
+                       (unsigned long long)labels->reset_count);
+    if (backend->face_capacity)
+    { engine_stats_print(buffer, size, &used, "  faces: probe max %u\n", backend->max_face_probe_length); }
+    engine_stats_print(buffer, size, &used, "  total: %.1fKB\n", (F64)stats->total_bytes/1024.0);
+
+    return used;
+}
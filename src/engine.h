@@ -0,0 +1,71 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef ENGINE_H
+#define ENGINE_H
+
+/* --------------------------------------
+   @Note: One instance of the text pipeline.
+
+   An engine owns a font backend and everything that caches what came out
+   of it: the glyph atlas, the shaped paragraphs of a text source and the
+   labels. Nothing in it is global, so engines don't share any memory and
+   don't contend with one another. There can be one per window, or per
+   tenant, each driven from a thread of its own. The job system and the
+   text source are the only things an engine may share, since neither
+   changes under it.
+
+   Caches point back at the engine's backend, so an engine must not move
+   once it's initialized.
+
+   engine_get_stats() snapshots what every cache holds and how well it's
+   hitting, for sizing them and catching leaks. The counters behind it are
+   kept as the caches are used; the snapshot itself walks the tables, so
+   it's taken once in a while, while nothing else is using the engine.
+   --------------------------------------- */
+
+#include <stdarg.h>
+
+typedef struct Engine_Config Engine_Config;
+struct Engine_Config
+{
+    Font_Backend backend;                   // the engine owns it from engine_init() on.
+    Job_System *jobs;                       // or NULL.
+    Text_Source *source;
+    wchar_t *base_family;
+    F32 pt_per_em;
+
+    U32 atlas_width;
+    U32 atlas_height;
+    U32 atlas_entry_count;
+    U32 paragraph_capacity;
+    U32 label_entry_count;
+};
+
+typedef struct Engine Engine;
+struct Engine
+{
+    Font_Backend backend;
+    Job_System *jobs;
+    Glyph_Atlas glyph_atlas;
+    Paragraph_Cache paragraph_cache;
+    Label_Cache label_cache;
+};
+
+typedef struct Engine_Stats Engine_Stats;
+struct Engine_Stats
+{
+    Glyph_Atlas_Stats glyph_atlas;
+    Paragraph_Cache_Stats paragraph_cache;
+    Label_Cache_Stats label_cache;
+    Font_Backend_Stats backend;             // all 0 if the backend has no get_stats.
+    U64 total_bytes;                        // arenas and stb_ds arrays of all of the above.
+};
+
+function Engine_Config engine_default_config(Font_Backend backend, Text_Source *source, wchar_t *base_family, F32 pt_per_em);
+function void engine_init(Engine *engine, Engine_Config *config);
+function void engine_release(Engine *engine);
+function Engine_Stats engine_get_stats(Engine *engine);
+function F64 engine_hit_rate(U64 hit_count, U64 miss_count);
+function void engine_stats_print(char *buffer, U32 size, U32 *used, char *format, ...);
+function U32 engine_format_stats(Engine_Stats *stats, char *buffer, U32 size);
+
+#endif // ENGINE_H
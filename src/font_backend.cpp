@@ -0,0 +1,391 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function F32
+font_px_per_em(Font_Backend *backend, F32 pt_per_em)
+{
+    F32 result = pt_per_em*backend->px_per_inch/72.0f;
+    return result;
+}
+
+function void
+font_shape_runs_proc(void *user_data, U32 worker_index, U64 begin, U64 end)
+{
+    Font_Shape_Task *task = (Font_Shape_Task *)user_data;
+    Font_Backend *backend = task->backend;
+
+    for (U64 ri = begin; ri < end; ++ri)
+    {
+        U32 offset = task->run_offsets[ri];
+        U32 run_length = task->run_offsets[ri + 1] - offset;
+        backend->shape(backend->user_data, task->runs + ri, task->text + offset, run_length, offset, task->run_glyph_text_positions + ri);
+    }
+}
+
+// @Note: Splits the text into runs of one face each and shapes them. Free
+// the result with font_free_runs(). The runs are shaped on the job system
+// if there is one and the backend allows it, otherwise in order right here.
+function Font_Run *
+font_map_text(Font_Backend *backend, Job_System *jobs, wchar_t *family, F32 pt_per_em, U16 *text, U32 text_length, U32 **glyph_text_positions)
+{
+    profile_scope(PROFILE_STAGE_SHAPE);
+
+    if (backend->begin_map_text)
+    { backend->begin_map_text(backend->user_data, family, pt_per_em, text, text_length); }
+
+    Font_Run *result = NULL;
+    U32 *run_offsets = NULL;
+    F32 px_per_em = font_px_per_em(backend, pt_per_em);
+
+    U32 offset = 0;
+    while (offset < text_length)
+    {
+        U64 face = 0;
+        U32 run_length = backend->resolve(backend->user_data, family, text + offset, text_length - offset, &face);
+        assume(run_length);
+
+        Font_Run run = {};
+        run.face       = face;
+        run.em_size_px = px_per_em;
+        arrput(result, run);
+        arrput(run_offsets, offset);
+
+        offset += run_length;
+    }
+    arrput(run_offsets, text_length);
+
+    U32 run_count = (U32)arrlenu(result);
+    if (jobs && backend->can_shape_concurrently && run_count > 1)
+    {
+        Font_Shape_Task task = {};
+        task.backend     = backend;
+        task.text        = text;
+        task.runs        = result;
+        task.run_offsets = run_offsets;
+        arrsetlen(task.run_glyph_text_positions, run_count);
+        for (U32 ri = 0; ri < run_count; ++ri)
+        { task.run_glyph_text_positions[ri] = NULL; }
+
+        job_parallel_for(jobs, run_count, 1, font_shape_runs_proc, &task);
+
+        for (U32 ri = 0; ri < run_count; ++ri)
+        {
+            U32 *positions = task.run_glyph_text_positions[ri];
+            for (U32 i = 0; i < arrlenu(positions); ++i)
+            { arrput(*glyph_text_positions, positions[i]); }
+            arrfree(positions);
+        }
+        arrfree(task.run_glyph_text_positions);
+    }
+    else
+    {
+        for (U32 ri = 0; ri < run_count; ++ri)
+        {
+            backend->shape(backend->user_data, result + ri, text + run_offsets[ri], run_offsets[ri + 1] - run_offsets[ri],
+                           run_offsets[ri], glyph_text_positions);
+        }
+    }
+
+    for (U32 ri = 0; ri < run_count; ++ri)
+    {
+        result[ri].glyph_count = (U32)arrlenu(result[ri].glyph_indices);
+        assert(arrlenu(result[ri].glyph_advances) == result[ri].glyph_count);
+    }
+
+    arrfree(run_offsets);
+    return result;
+}
+
+function void
+font_free_runs(Font_Run *runs)
+{
+    for (U32 ri = 0; ri < arrlenu(runs); ++ri)
+    {
+        arrfree(runs[ri].glyph_indices);
+        arrfree(runs[ri].glyph_advances);
+    }
+    arrfree(runs);
+}
+
+// @Note: Label_Shape_Proc, user_data is the Font_Backend. Shapes through the
+// same path as paragraphs and flattens the runs into the arena.
+function void
+font_shape_label(void *user_data, Arena *arena, Label_Style style, U16 *text, U32 text_length, Label_Shaped *out)
+{
+    Font_Backend *backend = (Font_Backend *)user_data;
+
+    U32 *glyph_text_positions = NULL;
+    Font_Run *runs = NULL;
+    if (text_length)
+    { runs = font_map_text(backend, NULL, style.family, style.pt_per_em, text, text_length, &glyph_text_positions); }
+
+    U32 run_count = (U32)arrlenu(runs);
+    U32 glyph_count = 0;
+    for (U32 ri = 0; ri < run_count; ++ri)
+    { glyph_count += runs[ri].glyph_count; }
+
+    *out = {};
+    out->glyph_count      = glyph_count;
+    out->glyph_indices    = push_array(arena, U16, glyph_count);
+    out->x_px             = push_array(arena, F32, glyph_count + 1);
+    out->run_count        = run_count;
+    out->run_first_glyphs = push_array(arena, U32, run_count + 1);
+    out->run_faces        = push_array(arena, U64, run_count);
+    out->run_em_sizes_px  = push_array(arena, F32, run_count);
+
+    Temporary_Arena scratch = scratch_begin();
+    F32 *advances = push_array(scratch.arena, F32, glyph_count);
+    S32 *x_26_6 = push_array(scratch.arena, S32, glyph_count + 1);
+
+    U32 gi = 0;
+    for (U32 ri = 0; ri < run_count; ++ri)
+    {
+        Font_Run run = runs[ri];
+        out->run_first_glyphs[ri] = gi;
+        out->run_faces[ri]        = run.face;
+        out->run_em_sizes_px[ri]  = run.em_size_px;
+
+        Font_Metrics metrics = backend->get_metrics(backend->user_data, run.face, run.em_size_px);
+        out->height_px = max(out->height_px, metrics.advance_height_px);
+
+        for (U32 i = 0; i < run.glyph_count; ++i, ++gi)
+        {
+            out->glyph_indices[gi] = run.glyph_indices[i];
+            advances[gi] = run.glyph_advances[i];
+        }
+    }
+    out->run_first_glyphs[run_count] = glyph_count;
+
+    layout_prefix_sum_26_6(advances, glyph_count, x_26_6);
+    layout_f32_from_26_6(x_26_6, glyph_count + 1, out->x_px);
+    scratch_end(scratch);
+
+    font_free_runs(runs);
+    arrfree(glyph_text_positions);
+}
+
+// -----------------------------------------
+// @Note: Synthetic backend
+
+function U32
+synthetic_font_hash(U32 x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352d;
+    x ^= x >> 15;
+    x *= 0x846ca68b;
+    x ^= x >> 16;
+    return x;
+}
+
+// CJK, Hangul, full-width forms and everything astral go to the wide face.
+function B32
+synthetic_font_is_wide(U32 codepoint)
+{
+    B32 result = ((codepoint >= 0x1100 && codepoint < 0x1200) ||
+                  (codepoint >= 0x2e80 && codepoint < 0xa4d0) ||
+                  (codepoint >= 0xac00 && codepoint < 0xd7a4) ||
+                  (codepoint >= 0xf900 && codepoint < 0xfb00) ||
+                  (codepoint >= 0xff00 && codepoint < 0xff61) ||
+                  (codepoint >= 0x10000));
+    return result;
+}
+
+// Code point at text[at]. A lone surrogate is taken as it is.
+function U32
+synthetic_font_decode(U16 *text, U32 text_length, U32 at, U32 *out_length)
+{
+    U32 result = text[at];
+    *out_length = 1;
+    if (result >= 0xd800 && result < 0xdc00 && at + 1 < text_length &&
+        text[at + 1] >= 0xdc00 && text[at + 1] < 0xe000)
+    {
+        result = 0x10000 + ((result - 0xd800) << 10) + (text[at + 1] - 0xdc00);
+        *out_length = 2;
+    }
+    return result;
+}
+
+// @Note: Glyph indices are code points + 1, so space is glyph 33.
+function F32
+synthetic_font_advance_em(U64 face, U16 glyph_index)
+{
+    F32 result = 1.0f;
+    if (! (face & 1))
+    {
+        if (glyph_index == ' ' + 1)
+        { result = 0.25f; }
+        else
+        { result = 0.40f + (F32)(synthetic_font_hash(glyph_index) % 32) / 100.0f; }
+    }
+    return result;
+}
+
+// @Note: The family picks the face pair by name, so a face is the same from
+// run to run. Bit 0 tells the wide face from the narrow one.
+function U32
+synthetic_font_resolve(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face)
+{
+    Synthetic_Font *font = (Synthetic_Font *)user_data;
+    job_atomic_add(&font->resolve_count, 1);
+
+    U64 family_hash = 0xcbf29ce484222325ull;
+    for (wchar_t *at = family; at && *at; ++at)
+    {
+        family_hash ^= (U64)*at;
+        family_hash *= 0x100000001b3ull;
+    }
+
+    U32 unit_count = 0;
+    B32 is_wide = synthetic_font_is_wide(synthetic_font_decode(text, text_length, 0, &unit_count));
+
+    U32 result = unit_count;
+    while (result < text_length)
+    {
+        U32 codepoint = synthetic_font_decode(text, text_length, result, &unit_count);
+        if (synthetic_font_is_wide(codepoint) != is_wide)
+        { break; }
+        result += unit_count;
+    }
+
+    *out_face = (family_hash & ~3ull) | 2 | (U64)is_wide;
+    return result;
+}
+
+function void
+synthetic_font_shape(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions)
+{
+    Synthetic_Font *font = (Synthetic_Font *)user_data;
+    job_atomic_add(&font->shape_count, 1);
+
+    U32 at = 0;
+    while (at < text_length)
+    {
+        U32 unit_count = 0;
+        U32 codepoint = synthetic_font_decode(text, text_length, at, &unit_count);
+        U16 glyph_index = (U16)(1 + (codepoint % 0xfffe));
+
+        arrput(run->glyph_indices, glyph_index);
+        arrput(run->glyph_advances, synthetic_font_advance_em(run->face, glyph_index)*run->em_size_px);
+        arrput(*glyph_text_positions, text_position + at);
+
+        at += unit_count;
+    }
+}
+
+function Font_Metrics
+synthetic_font_get_metrics(void *user_data, U64 face, F32 em_size_px)
+{
+    Font_Metrics result = {};
+    result.du_per_em         = SYNTHETIC_FONT_DU_PER_EM;
+    result.advance_height_px = 1.25f*em_size_px;
+    return result;
+}
+
+// @Note: Breaks after whitespace and on either side of a wide character,
+// and must break after a newline.
+function U8 *
+synthetic_font_analyze_breaks(void *user_data, U16 *text, U32 text_length)
+{
+    U8 *result = NULL;
+    arrsetlen(result, text_length);
+
+    for (U32 i = 0; i < text_length; ++i)
+    {
+        U16 c = text[i];
+        U8 flags = 0;
+
+        B32 is_whitespace = (c == ' ' || c == '\t' || c == 0x3000);
+        if (is_whitespace)
+        { flags |= LAYOUT_BREAK_WHITESPACE; }
+
+        if (i > 0)
+        {
+            U16 prev = text[i - 1];
+            B32 is_trail_surrogate = (c >= 0xdc00 && c < 0xe000);
+            if (prev == '\n')
+            {
+                flags |= LAYOUT_BREAK_MUST;
+            }
+            else if (! is_trail_surrogate && ! is_whitespace &&
+                     ((result[i - 1] & LAYOUT_BREAK_WHITESPACE) ||
+                      synthetic_font_is_wide(prev) || (prev >= 0xd800 && prev < 0xe000) ||
+                      synthetic_font_is_wide(c) || (c >= 0xd800 && c < 0xdc00)))
+            {
+                flags |= LAYOUT_BREAK_CAN;
+            }
+        }
+
+        result[i] = flags;
+    }
+
+    return result;
+}
+
+// @Note: An ink box inside the advance, x-height or ascender tall and now
+// and then with a descender, drawn as an outline with a stem somewhere
+// inside. Side edges are half covered in one channel, like ClearType fringes.
+function void
+synthetic_font_rasterize(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out)
+{
+    Synthetic_Font *font = (Synthetic_Font *)user_data;
+    job_atomic_add(&font->rasterize_count, 1);
+
+    *out = {};
+
+    U32 hash = synthetic_font_hash(glyph_index);
+    F32 advance_px = synthetic_font_advance_em(face, glyph_index)*em_size_px;
+    if (glyph_index == ' ' + 1 || advance_px < 2.0f)
+    { return; }
+
+    S32 ascent = 0;
+    S32 descent = 0;
+    if (face & 1)
+    {
+        ascent  = (S32)(0.80f*em_size_px + 0.5f);
+        descent = (S32)(0.10f*em_size_px + 0.5f);
+    }
+    else
+    {
+        ascent  = (S32)(((hash & 1) ? 0.70f : 0.50f)*em_size_px + 0.5f);
+        descent = ((hash >> 1) % 4 == 0) ? (S32)(0.20f*em_size_px + 0.5f) : 0;
+    }
+
+    out->left   = (S32)(0.1f*advance_px + 0.5f);
+    out->top    = -ascent;
+    out->width  = max((U32)(0.8f*advance_px + 0.5f), 1u);
+    out->height = (U32)max(ascent + descent, 1);
+    out->rgb    = push_array(arena, U8, out->width*out->height*3);
+
+    U32 w = out->width;
+    U32 h = out->height;
+    U32 stem_x = (hash >> 8) % w;
+    for (U32 y = 0; y < h; ++y)
+    {
+        for (U32 x = 0; x < w; ++x)
+        {
+            B32 is_edge = (x == 0 || y == 0 || x == w - 1 || y == h - 1);
+            U8 coverage = (is_edge || x == stem_x) ? 0xff : 0x00;
+
+            U8 *px = out->rgb + (y*w + x)*3;
+            px[0] = (x == 0) ? coverage/2 : coverage;
+            px[1] = coverage;
+            px[2] = (x == w - 1) ? coverage/2 : coverage;
+        }
+    }
+}
+
+function Font_Backend
+synthetic_font_backend(Synthetic_Font *font, F32 px_per_inch)
+{
+    Font_Backend result = {};
+    result.user_data                  = font;
+    result.px_per_inch                = px_per_inch;
+    result.can_shape_concurrently     = true;
+    result.can_rasterize_concurrently = true;
+    result.resolve                    = synthetic_font_resolve;
+    result.shape                      = synthetic_font_shape;
+    result.get_metrics                = synthetic_font_get_metrics;
+    result.analyze_breaks             = synthetic_font_analyze_breaks;
+    result.rasterize                  = synthetic_font_rasterize;
+    return result;
+}
@@ -0,0 +1,157 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef FONT_BACKEND_H
+#define FONT_BACKEND_H
+
+/* --------------------------------------
+   @Note: What the text pipeline needs from a font system.
+
+   Four stages: resolve a family (with fallback) to the face that covers a
+   piece of text, shape text in one face, get a face's metrics and rasterize
+   a glyph. Line breaking analysis comes along since it's the same analyzer
+   on DirectWrite. Everything above (paragraph and label layout, the word
+   and glyph caches, the atlas) only goes through a Font_Backend, so it runs
+   the same on any backend.
+
+   win32_dwrite.cpp implements it with DirectWrite. The synthetic backend
+   here needs no font files at all: faces, glyphs, advances and bitmaps are
+   made up from the code points, deterministically, so the rest of the
+   pipeline can be measured the same way on every machine.
+   --------------------------------------- */
+
+// A run of glyphs in one face. Arrays are stb_ds.
+typedef struct Font_Run Font_Run;
+struct Font_Run
+{
+    U64 face;                   // opaque, handed out by the backend.
+    F32 em_size_px;
+    U32 glyph_count;
+    U16 *glyph_indices;
+    F32 *glyph_advances;        // px.
+};
+
+typedef struct Font_Metrics Font_Metrics;
+struct Font_Metrics
+{
+    F32 du_per_em;
+    F32 advance_height_px;      // ascent + descent + line gap.
+};
+
+// @Note: Ink of one glyph, ClearType coverage, 3 bytes per px. The box is
+// relative to the baseline origin with y going down, like DWrite's
+// GetAlphaTextureBounds(). Empty glyphs have a width or height of 0.
+typedef struct Font_Glyph_Bitmap Font_Glyph_Bitmap;
+struct Font_Glyph_Bitmap
+{
+    S32 left;
+    S32 top;
+    U32 width;
+    U32 height;
+    U8 *rgb;
+};
+
+// Called with what font_map_text() was given, before any of it is resolved.
+typedef void Font_Map_Text_Proc(void *user_data, wchar_t *family, F32 pt_per_em, U16 *text, U32 text_length);
+
+// Length of the longest prefix of text that one face covers, and that face.
+typedef U32 Font_Resolve_Proc(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face);
+
+// Appends the glyphs of text to the run, in the run's face and size, and the
+// text position of each glyph's cluster to glyph_text_positions. The text
+// starts at text_position of the paragraph.
+typedef void Font_Shape_Proc(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions);
+
+typedef Font_Metrics Font_Get_Metrics_Proc(void *user_data, U64 face, F32 em_size_px);
+
+// One LAYOUT_BREAK_* flag set per code unit, stb_ds array.
+typedef U8 *Font_Analyze_Breaks_Proc(void *user_data, U16 *text, U32 text_length);
+
+// The bitmap is allocated from the arena.
+typedef void Font_Rasterize_Proc(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out);
+
+// Frees whatever the backend holds, once its owner is done with it.
+typedef void Font_Release_Proc(void *user_data);
+
+// What the backend holds on to. Whatever it doesn't keep stays 0.
+typedef struct Font_Backend_Stats Font_Backend_Stats;
+struct Font_Backend_Stats
+{
+    U32 face_count;
+    U32 face_capacity;                      // of its face table.
+    U32 max_face_probe_length;
+    U64 arena_bytes;
+
+    Word_Cache_Stats word_cache;
+    U32 word_count;
+    U32 word_capacity;
+    U64 word_arena_bytes;
+};
+
+// Called while nothing is shaping or rasterizing through the backend.
+typedef void Font_Get_Stats_Proc(void *user_data, Font_Backend_Stats *out);
+
+typedef struct Font_Backend Font_Backend;
+struct Font_Backend
+{
+    void *user_data;
+    F32 px_per_inch;
+
+    // Whether the procs may be called from several threads at once.
+    B32 can_shape_concurrently;             // resolve and get_metrics always come from one.
+    B32 can_rasterize_concurrently;
+
+    Font_Map_Text_Proc *begin_map_text;     // or NULL.
+    Font_Resolve_Proc *resolve;
+    Font_Shape_Proc *shape;
+    Font_Get_Metrics_Proc *get_metrics;
+    Font_Analyze_Breaks_Proc *analyze_breaks;
+    Font_Rasterize_Proc *rasterize;
+    Font_Release_Proc *release;             // or NULL.
+    Font_Get_Stats_Proc *get_stats;         // or NULL.
+};
+
+// -----------------------------------------
+// @Note: Synthetic backend.
+//
+// Every family has a narrow face for most text and a wide one, its
+// "fallback", for CJK and astral code points, so paragraphs get more than
+// one run like they do with real fonts. A glyph per code point, 1:1, with
+// advances and ink boxes made up from a hash of it.
+#define SYNTHETIC_FONT_DU_PER_EM 2048.0f
+
+typedef struct Synthetic_Font Synthetic_Font;
+struct Synthetic_Font
+{
+    volatile S64 resolve_count;
+    volatile S64 shape_count;
+    volatile S64 rasterize_count;
+};
+
+// Runs of font_map_text() being shaped on a job system.
+typedef struct Font_Shape_Task Font_Shape_Task;
+struct Font_Shape_Task
+{
+    Font_Backend *backend;
+    U16 *text;
+    Font_Run *runs;
+    U32 *run_offsets;           // run_count+1 entries.
+    U32 **run_glyph_text_positions;
+};
+
+function F32 font_px_per_em(Font_Backend *backend, F32 pt_per_em);
+function void font_shape_runs_proc(void *user_data, U32 worker_index, U64 begin, U64 end);
+function Font_Run *font_map_text(Font_Backend *backend, Job_System *jobs, wchar_t *family, F32 pt_per_em, U16 *text, U32 text_length, U32 **glyph_text_positions);
+function void font_free_runs(Font_Run *runs);
+function void font_shape_label(void *user_data, Arena *arena, Label_Style style, U16 *text, U32 text_length, Label_Shaped *out);
+
+function U32 synthetic_font_hash(U32 x);
+function B32 synthetic_font_is_wide(U32 codepoint);
+function U32 synthetic_font_decode(U16 *text, U32 text_length, U32 at, U32 *out_length);
+function F32 synthetic_font_advance_em(U64 face, U16 glyph_index);
+function U32 synthetic_font_resolve(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face);
+function void synthetic_font_shape(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions);
+function Font_Metrics synthetic_font_get_metrics(void *user_data, U64 face, F32 em_size_px);
+function U8 *synthetic_font_analyze_breaks(void *user_data, U16 *text, U32 text_length);
+function void synthetic_font_rasterize(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out);
+function Font_Backend synthetic_font_backend(Synthetic_Font *font, F32 px_per_inch);
+
+#endif // FONT_BACKEND_H
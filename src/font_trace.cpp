@@ -0,0 +1,849 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+// -----------------------------------------
+// @Note: Writing and reading
+
+// FNV-1a.
+function U64
+font_trace_hash(U64 hash, void *data, U64 size)
+{
+    U8 *bytes = (U8 *)data;
+    for (U64 i = 0; i < size; ++i)
+    {
+        hash ^= (U64)bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// @Note: As UTF-16 code units, so a family hashes the same where wchar_t is
+// 32 bits wide.
+function U64
+font_trace_hash_family(U64 hash, wchar_t *family)
+{
+    for (wchar_t *at = family; at && *at; ++at)
+    {
+        U16 unit = (U16)*at;
+        hash = font_trace_hash(hash, &unit, sizeof(unit));
+    }
+    return hash;
+}
+
+function U64
+font_trace_key(U64 hash)
+{
+    U64 result = (hash) ? hash : 1;
+    return result;
+}
+
+function U32
+font_trace_family_length(wchar_t *family)
+{
+    U32 result = 0;
+    while (family && family[result])
+    { ++result; }
+    return result;
+}
+
+function void
+font_trace_table_insert(Font_Trace_Table *table, U64 key, U64 offset, U32 size)
+{
+    U32 capacity = (U32)arrlenu(table->slots);
+    if ((table->count + 1)*4 > capacity*3)
+    {
+        Font_Trace_Slot *old_slots = table->slots;
+        U32 new_capacity = (capacity) ? capacity*2 : 256;
+
+        table->slots = NULL;
+        arrsetlen(table->slots, new_capacity);
+        for (U32 si = 0; si < new_capacity; ++si)
+        { table->slots[si] = {}; }
+        table->count = 0;
+
+        for (U32 si = 0; si < capacity; ++si)
+        {
+            if (old_slots[si].key)
+            { font_trace_table_insert(table, old_slots[si].key, old_slots[si].offset, old_slots[si].size); }
+        }
+        arrfree(old_slots);
+        capacity = new_capacity;
+    }
+
+    U32 mask = capacity - 1;
+    for (U32 si = (U32)key & mask;; si = (si + 1) & mask)
+    {
+        Font_Trace_Slot *slot = table->slots + si;
+        if (! slot->key)
+        {
+            slot->key    = key;
+            slot->offset = offset;
+            slot->size   = size;
+            table->count += 1;
+            break;
+        }
+        if (slot->key == key)
+        { break; }
+    }
+}
+
+function Font_Trace_Slot *
+font_trace_table_find(Font_Trace_Table *table, U64 key)
+{
+    Font_Trace_Slot *result = NULL;
+    U32 capacity = (U32)arrlenu(table->slots);
+    if (capacity)
+    {
+        U32 mask = capacity - 1;
+        for (U32 si = (U32)key & mask;; si = (si + 1) & mask)
+        {
+            Font_Trace_Slot *slot = table->slots + si;
+            if (slot->key == key)
+            {
+                result = slot;
+                break;
+            }
+            if (! slot->key)
+            { break; }
+        }
+    }
+    return result;
+}
+
+function B32
+font_trace_writer_open(Font_Trace_Writer *writer, char *path)
+{
+    writer->failed = false;
+    writer->used   = 0;
+
+#if defined(OS_WINDOWS)
+    Temporary_Arena scratch = scratch_begin();
+    int wide_length = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    wchar_t *wide_path = push_array(scratch.arena, wchar_t, wide_length);
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path, wide_length);
+
+    writer->file = CreateFileW(wide_path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    scratch_end(scratch);
+    B32 result = (writer->file != INVALID_HANDLE_VALUE);
+#else
+    writer->file = open(path, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    B32 result = (writer->file >= 0);
+#endif
+
+    return result;
+}
+
+function void
+font_trace_writer_flush(Font_Trace_Writer *writer)
+{
+    if (writer->used && ! writer->failed)
+    {
+#if defined(OS_WINDOWS)
+        DWORD written = 0;
+        if (! WriteFile(writer->file, writer->buffer, writer->used, &written, NULL) || written != writer->used)
+        { writer->failed = true; }
+#else
+        if (write(writer->file, writer->buffer, writer->used) != (ssize_t)writer->used)
+        { writer->failed = true; }
+#endif
+    }
+    writer->used = 0;
+}
+
+function void
+font_trace_writer_close(Font_Trace_Writer *writer)
+{
+    font_trace_writer_flush(writer);
+#if defined(OS_WINDOWS)
+    CloseHandle(writer->file);
+#else
+    close(writer->file);
+#endif
+}
+
+function void
+font_trace_write(Font_Trace_Writer *writer, void *data, U32 size)
+{
+    U8 *bytes = (U8 *)data;
+    while (size)
+    {
+        if (writer->used == sizeof(writer->buffer))
+        { font_trace_writer_flush(writer); }
+
+        U32 chunk = min(size, (U32)sizeof(writer->buffer) - writer->used);
+        memory_copy(writer->buffer + writer->used, bytes, chunk);
+        writer->used += chunk;
+        bytes        += chunk;
+        size         -= chunk;
+    }
+}
+
+// @Note: The whole file, or NULL if it can't be read.
+function U8 *
+font_trace_read_file(Arena *arena, char *path, U64 *out_size)
+{
+    U8 *result = NULL;
+    *out_size = 0;
+
+#if defined(OS_WINDOWS)
+    Temporary_Arena scratch = scratch_begin();
+    int wide_length = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    wchar_t *wide_path = push_array(scratch.arena, wchar_t, wide_length);
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path, wide_length);
+
+    HANDLE file = CreateFileW(wide_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    scratch_end(scratch);
+
+    LARGE_INTEGER file_size = {};
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &file_size))
+    {
+        U64 size = (U64)file_size.QuadPart;
+        U8 *data = push_array(arena, U8, size + 1);
+        U64 done = 0;
+        while (done < size)
+        {
+            DWORD chunk = (DWORD)min(size - done, (U64)MB(64));
+            DWORD n = 0;
+            if (! ReadFile(file, data + done, chunk, &n, NULL) || ! n)
+            { break; }
+            done += n;
+        }
+        if (done == size)
+        {
+            result = data;
+            *out_size = size;
+        }
+    }
+    if (file != INVALID_HANDLE_VALUE)
+    { CloseHandle(file); }
+#else
+    int file = open(path, O_RDONLY);
+    struct stat st = {};
+    if (file >= 0 && fstat(file, &st) == 0)
+    {
+        U64 size = (U64)st.st_size;
+        U8 *data = push_array(arena, U8, size + 1);
+        U64 done = 0;
+        for (ssize_t n; done < size && (n = read(file, data + done, size - done)) > 0;)
+        { done += (U64)n; }
+        if (done == size)
+        {
+            result = data;
+            *out_size = size;
+        }
+    }
+    if (file >= 0)
+    { close(file); }
+#endif
+
+    return result;
+}
+
+// -----------------------------------------
+// @Note: Recorder
+
+// @Note: Under the recorder's mutex. The payload is written right after.
+function void
+font_trace_begin_record(Font_Trace_Recorder *recorder, Font_Trace_Record_Kind kind, U32 size)
+{
+    U8 kind_byte = (U8)kind;
+    font_trace_write(&recorder->writer, &kind_byte, sizeof(kind_byte));
+    font_trace_write(&recorder->writer, &size, sizeof(size));
+    recorder->record_count += 1;
+}
+
+// @Note: Under the recorder's mutex. True the first time a key is seen.
+function B32
+font_trace_should_record(Font_Trace_Recorder *recorder, U64 key)
+{
+    B32 result = (font_trace_table_find(&recorder->recorded, key) == NULL);
+    if (result)
+    { font_trace_table_insert(&recorder->recorded, key, 0, 0); }
+    return result;
+}
+
+// @Note: Font_Map_Text_Proc. Every text is recorded, repeats included, so a
+// replay maps the same texts in the same order.
+function void
+font_trace_record_map_text(void *user_data, wchar_t *family, F32 pt_per_em, U16 *text, U32 text_length)
+{
+    Font_Trace_Recorder *recorder = (Font_Trace_Recorder *)user_data;
+    if (recorder->inner.begin_map_text)
+    { recorder->inner.begin_map_text(recorder->inner.user_data, family, pt_per_em, text, text_length); }
+
+    U32 family_length = font_trace_family_length(family);
+    U32 size = sizeof(F32) + sizeof(U32) + family_length*sizeof(U16) + sizeof(U32) + text_length*sizeof(U16);
+
+    job_mutex_lock(&recorder->mutex);
+    font_trace_begin_record(recorder, FONT_TRACE_RECORD_TEXT, size);
+    font_trace_write(&recorder->writer, &pt_per_em, sizeof(pt_per_em));
+    font_trace_write(&recorder->writer, &family_length, sizeof(family_length));
+    for (U32 i = 0; i < family_length; ++i)
+    {
+        U16 unit = (U16)family[i];
+        font_trace_write(&recorder->writer, &unit, sizeof(unit));
+    }
+    font_trace_write(&recorder->writer, &text_length, sizeof(text_length));
+    font_trace_write(&recorder->writer, text, text_length*sizeof(U16));
+    job_mutex_unlock(&recorder->mutex);
+}
+
+function U32
+font_trace_record_resolve(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face)
+{
+    Font_Trace_Recorder *recorder = (Font_Trace_Recorder *)user_data;
+    U32 result = recorder->inner.resolve(recorder->inner.user_data, family, text, text_length, out_face);
+
+    U32 kind = FONT_TRACE_RECORD_RESOLVE;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash_family(hash, family);
+    hash = font_trace_hash(hash, text, text_length*sizeof(U16));
+    U64 key = font_trace_key(hash);
+
+    job_mutex_lock(&recorder->mutex);
+    if (font_trace_should_record(recorder, key))
+    {
+        font_trace_begin_record(recorder, FONT_TRACE_RECORD_RESOLVE, sizeof(key) + sizeof(result) + sizeof(*out_face));
+        font_trace_write(&recorder->writer, &key, sizeof(key));
+        font_trace_write(&recorder->writer, &result, sizeof(result));
+        font_trace_write(&recorder->writer, out_face, sizeof(*out_face));
+    }
+    job_mutex_unlock(&recorder->mutex);
+
+    return result;
+}
+
+// @Note: Clusters are recorded relative to the run's text, so a run shapes
+// the same wherever it is in a paragraph.
+function void
+font_trace_record_shape(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions)
+{
+    Font_Trace_Recorder *recorder = (Font_Trace_Recorder *)user_data;
+    U32 first_glyph    = (U32)arrlenu(run->glyph_indices);
+    U32 first_position = (U32)arrlenu(*glyph_text_positions);
+    recorder->inner.shape(recorder->inner.user_data, run, text, text_length, text_position, glyph_text_positions);
+
+    U32 glyph_count = (U32)arrlenu(run->glyph_indices) - first_glyph;
+    assert((U32)arrlenu(*glyph_text_positions) - first_position == glyph_count);
+
+    U32 kind = FONT_TRACE_RECORD_SHAPE;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash(hash, &run->face, sizeof(run->face));
+    hash = font_trace_hash(hash, &run->em_size_px, sizeof(run->em_size_px));
+    hash = font_trace_hash(hash, text, text_length*sizeof(U16));
+    U64 key = font_trace_key(hash);
+
+    job_mutex_lock(&recorder->mutex);
+    if (font_trace_should_record(recorder, key))
+    {
+        U32 size = sizeof(key) + sizeof(glyph_count) + glyph_count*(sizeof(U16) + sizeof(F32) + sizeof(U32));
+        font_trace_begin_record(recorder, FONT_TRACE_RECORD_SHAPE, size);
+        font_trace_write(&recorder->writer, &key, sizeof(key));
+        font_trace_write(&recorder->writer, &glyph_count, sizeof(glyph_count));
+        font_trace_write(&recorder->writer, run->glyph_indices + first_glyph, glyph_count*sizeof(U16));
+        font_trace_write(&recorder->writer, run->glyph_advances + first_glyph, glyph_count*sizeof(F32));
+        for (U32 gi = 0; gi < glyph_count; ++gi)
+        {
+            U32 cluster = (*glyph_text_positions)[first_position + gi] - text_position;
+            font_trace_write(&recorder->writer, &cluster, sizeof(cluster));
+        }
+    }
+    job_mutex_unlock(&recorder->mutex);
+}
+
+function Font_Metrics
+font_trace_record_get_metrics(void *user_data, U64 face, F32 em_size_px)
+{
+    Font_Trace_Recorder *recorder = (Font_Trace_Recorder *)user_data;
+    Font_Metrics result = recorder->inner.get_metrics(recorder->inner.user_data, face, em_size_px);
+
+    U32 kind = FONT_TRACE_RECORD_METRICS;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash(hash, &face, sizeof(face));
+    hash = font_trace_hash(hash, &em_size_px, sizeof(em_size_px));
+    U64 key = font_trace_key(hash);
+
+    job_mutex_lock(&recorder->mutex);
+    if (font_trace_should_record(recorder, key))
+    {
+        font_trace_begin_record(recorder, FONT_TRACE_RECORD_METRICS, sizeof(key) + 2*sizeof(F32));
+        font_trace_write(&recorder->writer, &key, sizeof(key));
+        font_trace_write(&recorder->writer, &result.du_per_em, sizeof(F32));
+        font_trace_write(&recorder->writer, &result.advance_height_px, sizeof(F32));
+    }
+    job_mutex_unlock(&recorder->mutex);
+
+    return result;
+}
+
+function U8 *
+font_trace_record_analyze_breaks(void *user_data, U16 *text, U32 text_length)
+{
+    Font_Trace_Recorder *recorder = (Font_Trace_Recorder *)user_data;
+    U8 *result = recorder->inner.analyze_breaks(recorder->inner.user_data, text, text_length);
+    assert(arrlenu(result) == text_length);
+
+    U32 kind = FONT_TRACE_RECORD_BREAKS;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash(hash, text, text_length*sizeof(U16));
+    U64 key = font_trace_key(hash);
+
+    job_mutex_lock(&recorder->mutex);
+    if (font_trace_should_record(recorder, key))
+    {
+        font_trace_begin_record(recorder, FONT_TRACE_RECORD_BREAKS, sizeof(key) + sizeof(text_length) + text_length);
+        font_trace_write(&recorder->writer, &key, sizeof(key));
+        font_trace_write(&recorder->writer, &text_length, sizeof(text_length));
+        font_trace_write(&recorder->writer, result, text_length);
+    }
+    job_mutex_unlock(&recorder->mutex);
+
+    return result;
+}
+
+function void
+font_trace_record_rasterize(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out)
+{
+    Font_Trace_Recorder *recorder = (Font_Trace_Recorder *)user_data;
+    recorder->inner.rasterize(recorder->inner.user_data, arena, face, em_size_px, glyph_index, out);
+
+    U32 kind = FONT_TRACE_RECORD_RASTER;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash(hash, &face, sizeof(face));
+    hash = font_trace_hash(hash, &em_size_px, sizeof(em_size_px));
+    hash = font_trace_hash(hash, &glyph_index, sizeof(glyph_index));
+    U64 key = font_trace_key(hash);
+
+    job_mutex_lock(&recorder->mutex);
+    if (font_trace_should_record(recorder, key))
+    {
+        font_trace_begin_record(recorder, FONT_TRACE_RECORD_RASTER, sizeof(key) + 4*sizeof(U32));
+        font_trace_write(&recorder->writer, &key, sizeof(key));
+        font_trace_write(&recorder->writer, &out->left, sizeof(out->left));
+        font_trace_write(&recorder->writer, &out->top, sizeof(out->top));
+        font_trace_write(&recorder->writer, &out->width, sizeof(out->width));
+        font_trace_write(&recorder->writer, &out->height, sizeof(out->height));
+    }
+    job_mutex_unlock(&recorder->mutex);
+}
+
+// @Note: Finishes the trace and releases the inner backend.
+function void
+font_trace_record_release(void *user_data)
+{
+    Font_Trace_Recorder *recorder = (Font_Trace_Recorder *)user_data;
+    font_trace_writer_close(&recorder->writer);
+    arrfree(recorder->recorded.slots);
+    recorder->recorded = {};
+    job_mutex_release(&recorder->mutex);
+
+    if (recorder->inner.release)
+    { recorder->inner.release(recorder->inner.user_data); }
+    recorder->inner = {};
+}
+
+function void
+font_trace_record_get_stats(void *user_data, Font_Backend_Stats *out)
+{
+    Font_Trace_Recorder *recorder = (Font_Trace_Recorder *)user_data;
+    *out = {};
+    if (recorder->inner.get_stats)
+    { recorder->inner.get_stats(recorder->inner.user_data, out); }
+}
+
+// @Note: The recorder owns inner once this succeeds. If the trace can't be
+// created, inner is still the caller's.
+function B32
+font_trace_recorder_init(Font_Trace_Recorder *recorder, Font_Backend inner, char *path)
+{
+    recorder->inner        = inner;
+    recorder->recorded     = {};
+    recorder->record_count = 0;
+    job_mutex_init(&recorder->mutex);
+
+    B32 result = font_trace_writer_open(&recorder->writer, path);
+    if (result)
+    {
+        Font_Trace_Header header = {};
+        header.magic       = FONT_TRACE_MAGIC;
+        header.version     = FONT_TRACE_VERSION;
+        header.px_per_inch = inner.px_per_inch;
+        font_trace_write(&recorder->writer, &header, sizeof(header));
+    }
+    else
+    {
+        job_mutex_release(&recorder->mutex);
+        recorder->inner = {};
+    }
+    return result;
+}
+
+function Font_Backend
+font_trace_recorder_backend(Font_Trace_Recorder *recorder)
+{
+    Font_Backend result = recorder->inner;
+    result.user_data      = recorder;
+    result.begin_map_text = font_trace_record_map_text;
+    result.resolve        = font_trace_record_resolve;
+    result.shape          = font_trace_record_shape;
+    result.get_metrics    = font_trace_record_get_metrics;
+    result.analyze_breaks = font_trace_record_analyze_breaks;
+    result.rasterize      = font_trace_record_rasterize;
+    result.release        = font_trace_record_release;
+    result.get_stats      = font_trace_record_get_stats;
+    return result;
+}
+
+// -----------------------------------------
+// @Note: Replay
+
+function wchar_t *
+font_trace_intern_family(Font_Trace_Replay *replay, U16 *family, U32 family_length)
+{
+    for (U32 fi = 0; fi < arrlenu(replay->families); ++fi)
+    {
+        wchar_t *existing = replay->families[fi];
+        U32 existing_length = font_trace_family_length(existing);
+        B32 is_equal = (existing_length == family_length);
+        for (U32 i = 0; is_equal && i < family_length; ++i)
+        { is_equal = ((U16)existing[i] == family[i]); }
+
+        if (is_equal)
+        { return existing; }
+    }
+
+    wchar_t *result = push_array(replay->arena, wchar_t, family_length + 1);
+    for (U32 i = 0; i < family_length; ++i)
+    { result[i] = (wchar_t)family[i]; }
+    result[family_length] = 0;
+    arrput(replay->families, result);
+    return result;
+}
+
+// @Note: Reads the whole trace. Stops at the first record that doesn't fit,
+// so a trace cut short by a crash still replays what it has.
+function B32
+font_trace_replay_load(Font_Trace_Replay *replay, char *path)
+{
+    *replay = {};
+    replay->arena = arena_alloc();
+    replay->data  = font_trace_read_file(replay->arena, path, &replay->size);
+
+    Font_Trace_Header header = {};
+    B32 result = (replay->data && replay->size >= sizeof(header));
+    if (result)
+    {
+        memory_copy(&header, replay->data, sizeof(header));
+        result = (header.magic == FONT_TRACE_MAGIC && header.version == FONT_TRACE_VERSION);
+    }
+
+    if (result)
+    {
+        replay->px_per_inch = header.px_per_inch;
+
+        U64 at = sizeof(header);
+        while (at + 5 <= replay->size)
+        {
+            U8 kind = replay->data[at];
+            U32 size = 0;
+            memory_copy(&size, replay->data + at + 1, sizeof(size));
+            U64 payload = at + 5;
+            if (payload + size > replay->size)
+            { break; }
+
+            U8 *p = replay->data + payload;
+            if (kind == FONT_TRACE_RECORD_TEXT && size >= 3*sizeof(U32))
+            {
+                Font_Trace_Text text = {};
+                U32 family_length = 0;
+                memory_copy(&text.pt_per_em, p, sizeof(F32));
+                memory_copy(&family_length, p + 4, sizeof(U32));
+
+                U64 text_at = 8 + (U64)family_length*sizeof(U16);
+                if (text_at + sizeof(U32) <= size)
+                {
+                    Temporary_Arena scratch = scratch_begin();
+                    U16 *family = push_array(scratch.arena, U16, family_length + 1);
+                    memory_copy(family, p + 8, family_length*sizeof(U16));
+                    text.family = font_trace_intern_family(replay, family, family_length);
+                    scratch_end(scratch);
+
+                    memory_copy(&text.length, p + text_at, sizeof(U32));
+                    if (text_at + sizeof(U32) + (U64)text.length*sizeof(U16) <= size)
+                    {
+                        text.text = push_array(replay->arena, U16, text.length + 1);
+                        memory_copy(text.text, p + text_at + sizeof(U32), text.length*sizeof(U16));
+                        arrput(replay->texts, text);
+                    }
+                }
+            }
+            else if (kind > FONT_TRACE_RECORD_TEXT && kind < FONT_TRACE_RECORD_KIND_COUNT && size >= sizeof(U64))
+            {
+                U64 key = 0;
+                memory_copy(&key, p, sizeof(key));
+                font_trace_table_insert(&replay->answers, key, payload + sizeof(key), size - (U32)sizeof(key));
+            }
+
+            at = payload + size;
+        }
+    }
+
+    if (! result)
+    { font_trace_replay_release(replay); }
+    return result;
+}
+
+// @Note: The answer recorded for key, or NULL after counting a miss. An
+// answer shorter than min_size is a miss too. *out_size is the answer's size.
+function U8 *
+font_trace_replay_find(Font_Trace_Replay *replay, Font_Trace_Record_Kind kind, U64 key, U32 min_size, U32 *out_size)
+{
+    U8 *result = NULL;
+    *out_size = 0;
+    Font_Trace_Slot *slot = font_trace_table_find(&replay->answers, key);
+    if (slot && slot->size >= min_size)
+    {
+        result = replay->data + slot->offset;
+        *out_size = slot->size;
+    }
+    else
+    { font_trace_replay_reject(replay, kind); }
+    return result;
+}
+
+// @Note: For an answer whose counts don't fit its size. Answered by the
+// synthetic backend like any other miss.
+function void
+font_trace_replay_reject(Font_Trace_Replay *replay, Font_Trace_Record_Kind kind)
+{
+    job_atomic_add(&replay->miss_counts[kind], 1);
+}
+
+function U32
+font_trace_replay_resolve(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face)
+{
+    Font_Trace_Replay *replay = (Font_Trace_Replay *)user_data;
+
+    U32 kind = FONT_TRACE_RECORD_RESOLVE;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash_family(hash, family);
+    hash = font_trace_hash(hash, text, text_length*sizeof(U16));
+
+    U32 result = 0;
+    U32 answer_size = 0;
+    U8 *answer = font_trace_replay_find(replay, FONT_TRACE_RECORD_RESOLVE, font_trace_key(hash),
+                                        sizeof(result) + sizeof(*out_face), &answer_size);
+    if (answer)
+    {
+        memory_copy(&result, answer, sizeof(result));
+        memory_copy(out_face, answer + sizeof(result), sizeof(*out_face));
+    }
+    if (! result || result > text_length)
+    { result = synthetic_font_resolve(&replay->fallback, family, text, text_length, out_face); }
+    return result;
+}
+
+function void
+font_trace_replay_shape(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions)
+{
+    Font_Trace_Replay *replay = (Font_Trace_Replay *)user_data;
+
+    U32 kind = FONT_TRACE_RECORD_SHAPE;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash(hash, &run->face, sizeof(run->face));
+    hash = font_trace_hash(hash, &run->em_size_px, sizeof(run->em_size_px));
+    hash = font_trace_hash(hash, text, text_length*sizeof(U16));
+
+    U32 answer_size = 0;
+    U8 *answer = font_trace_replay_find(replay, FONT_TRACE_RECORD_SHAPE, font_trace_key(hash), sizeof(U32), &answer_size);
+    U32 glyph_count = 0;
+    if (answer)
+    {
+        memory_copy(&glyph_count, answer, sizeof(glyph_count));
+        U64 glyphs_size = (U64)glyph_count*(sizeof(U16) + sizeof(F32) + sizeof(U32));
+        if (glyphs_size > answer_size - sizeof(U32))
+        {
+            font_trace_replay_reject(replay, FONT_TRACE_RECORD_SHAPE);
+            answer = NULL;
+        }
+    }
+
+    if (answer)
+    {
+        U8 *indices  = answer + sizeof(U32);
+        U8 *advances = indices + glyph_count*sizeof(U16);
+        U8 *clusters = advances + glyph_count*sizeof(F32);
+
+        for (U32 gi = 0; gi < glyph_count; ++gi)
+        {
+            U16 glyph_index = 0;
+            F32 advance     = 0.0f;
+            U32 cluster     = 0;
+            memory_copy(&glyph_index, indices + gi*sizeof(U16), sizeof(U16));
+            memory_copy(&advance, advances + gi*sizeof(F32), sizeof(F32));
+            memory_copy(&cluster, clusters + gi*sizeof(U32), sizeof(U32));
+
+            arrput(run->glyph_indices, glyph_index);
+            arrput(run->glyph_advances, advance);
+            arrput(*glyph_text_positions, text_position + min(cluster, text_length - 1));
+        }
+    }
+    else
+    {
+        synthetic_font_shape(&replay->fallback, run, text, text_length, text_position, glyph_text_positions);
+    }
+}
+
+function Font_Metrics
+font_trace_replay_get_metrics(void *user_data, U64 face, F32 em_size_px)
+{
+    Font_Trace_Replay *replay = (Font_Trace_Replay *)user_data;
+
+    U32 kind = FONT_TRACE_RECORD_METRICS;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash(hash, &face, sizeof(face));
+    hash = font_trace_hash(hash, &em_size_px, sizeof(em_size_px));
+
+    Font_Metrics result = {};
+    U32 answer_size = 0;
+    U8 *answer = font_trace_replay_find(replay, FONT_TRACE_RECORD_METRICS, font_trace_key(hash), 2*sizeof(F32), &answer_size);
+    if (answer)
+    {
+        memory_copy(&result.du_per_em, answer, sizeof(F32));
+        memory_copy(&result.advance_height_px, answer + sizeof(F32), sizeof(F32));
+    }
+    else
+    {
+        result = synthetic_font_get_metrics(&replay->fallback, face, em_size_px);
+    }
+    return result;
+}
+
+function U8 *
+font_trace_replay_analyze_breaks(void *user_data, U16 *text, U32 text_length)
+{
+    Font_Trace_Replay *replay = (Font_Trace_Replay *)user_data;
+
+    U32 kind = FONT_TRACE_RECORD_BREAKS;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash(hash, text, text_length*sizeof(U16));
+
+    U8 *result = NULL;
+    U32 answer_size = 0;
+    U8 *answer = font_trace_replay_find(replay, FONT_TRACE_RECORD_BREAKS, font_trace_key(hash), sizeof(U32), &answer_size);
+    U32 length = 0;
+    if (answer)
+    {
+        memory_copy(&length, answer, sizeof(length));
+        if (length != text_length || (U64)length > answer_size - sizeof(length))
+        {
+            font_trace_replay_reject(replay, FONT_TRACE_RECORD_BREAKS);
+            answer = NULL;
+        }
+    }
+
+    if (answer)
+    {
+        arrsetlen(result, text_length);
+        memory_copy(result, answer + sizeof(length), text_length);
+    }
+    else
+    {
+        result = synthetic_font_analyze_breaks(&replay->fallback, text, text_length);
+    }
+    return result;
+}
+
+// @Note: The recorded ink box, drawn as an outline.
+function void
+font_trace_replay_rasterize(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out)
+{
+    Font_Trace_Replay *replay = (Font_Trace_Replay *)user_data;
+
+    U32 kind = FONT_TRACE_RECORD_RASTER;
+    U64 hash = font_trace_hash(0xcbf29ce484222325ull, &kind, sizeof(kind));
+    hash = font_trace_hash(hash, &face, sizeof(face));
+    hash = font_trace_hash(hash, &em_size_px, sizeof(em_size_px));
+    hash = font_trace_hash(hash, &glyph_index, sizeof(glyph_index));
+
+    U32 answer_size = 0;
+    U8 *answer = font_trace_replay_find(replay, FONT_TRACE_RECORD_RASTER, font_trace_key(hash), 4*sizeof(U32), &answer_size);
+    if (answer)
+    {
+        *out = {};
+        memory_copy(&out->left, answer, sizeof(S32));
+        memory_copy(&out->top, answer + 4, sizeof(S32));
+        memory_copy(&out->width, answer + 8, sizeof(U32));
+        memory_copy(&out->height, answer + 12, sizeof(U32));
+        if (out->width > FONT_TRACE_MAX_GLYPH_PX || out->height > FONT_TRACE_MAX_GLYPH_PX)
+        {
+            font_trace_replay_reject(replay, FONT_TRACE_RECORD_RASTER);
+            answer = NULL;
+        }
+    }
+    if (! answer)
+    {
+        synthetic_font_rasterize(&replay->fallback, arena, face, em_size_px, glyph_index, out);
+        return;
+    }
+
+    if (! out->width || ! out->height)
+    {
+        out->width  = 0;
+        out->height = 0;
+        return;
+    }
+
+    U32 w = out->width;
+    U32 h = out->height;
+    out->rgb = push_array(arena, U8, w*h*3);
+    for (U32 y = 0; y < h; ++y)
+    {
+        for (U32 x = 0; x < w; ++x)
+        {
+            B32 is_edge = (x == 0 || y == 0 || x == w - 1 || y == h - 1);
+            U8 coverage = (is_edge) ? 0xff : 0x00;
+
+            U8 *px = out->rgb + (y*w + x)*3;
+            px[0] = coverage;
+            px[1] = coverage;
+            px[2] = coverage;
+        }
+    }
+}
+
+function void
+font_trace_replay_release(Font_Trace_Replay *replay)
+{
+    arrfree(replay->answers.slots);
+    arrfree(replay->texts);
+    arrfree(replay->families);
+    if (replay->arena)
+    { arena_release(replay->arena); }
+    *replay = {};
+}
+
+// @Note: Not released by its owner; see the note in font_trace.h.
+function Font_Backend
+font_trace_replay_backend(Font_Trace_Replay *replay)
+{
+    Font_Backend result = {};
+    result.user_data                  = replay;
+    result.px_per_inch                = replay->px_per_inch;
+    result.can_shape_concurrently     = true;
+    result.can_rasterize_concurrently = true;
+    result.resolve                    = font_trace_replay_resolve;
+    result.shape                      = font_trace_replay_shape;
+    result.get_metrics                = font_trace_replay_get_metrics;
+    result.analyze_breaks             = font_trace_replay_analyze_breaks;
+    result.rasterize                  = font_trace_replay_rasterize;
+    return result;
+}
+
+function U64
+font_trace_replay_miss_count(Font_Trace_Replay *replay)
+{
+    U64 result = 0;
+    for (U32 ki = 0; ki < FONT_TRACE_RECORD_KIND_COUNT; ++ki)
+    { result += (U64)job_atomic_load(&replay->miss_counts[ki]); }
+    return result;
+}
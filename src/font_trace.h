@@ -0,0 +1,161 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef FONT_TRACE_H
+#define FONT_TRACE_H
+
+/* --------------------------------------
+   @Note: Recording what a Font_Backend answered, and answering from it.
+
+   The recorder is a Font_Backend around another one. Every call is passed
+   through, and what went in and came out is appended to a trace file:
+   every text font_map_text() maps (family, size, text), each face it
+   resolves to, each run's glyph indices, advances and clusters, face
+   metrics, line breaks and the ink box of every glyph rasterized. Pixels
+   aren't kept, and an answer is recorded only the first time it's given,
+   so a trace stays small.
+
+   The replayer is a Font_Backend over a trace. It answers from the trace
+   and draws an outline of the recorded box as a glyph's ink, so customer
+   text can be shaped, cached, packed and laid out the way it was, on any
+   OS and without its fonts. What the trace doesn't have is answered by the
+   synthetic backend and counted as a miss. Nothing in it changes once it's
+   loaded, so any number of engines may share one; like the synthetic
+   backend's, it's released by whoever loaded it, not by an engine.
+
+   Answers are keyed by a hash of the inputs, texts included; the same
+   question gets the same answer. The trace is a header and then records,
+   each a kind, a size and that many bytes, little-endian and unaligned.
+   A trace is read from disk, so every count in an answer is checked
+   against the record's size; an answer that doesn't fit is a miss.
+   --------------------------------------- */
+
+#define FONT_TRACE_MAGIC        0x43525446u // "FTRC"
+#define FONT_TRACE_VERSION      1
+#define FONT_TRACE_BUFFER_SIZE  KB(64)
+#define FONT_TRACE_MAX_GLYPH_PX 4096        // a wider or taller ink box is taken as corrupt.
+
+typedef enum Font_Trace_Record_Kind
+{
+    FONT_TRACE_RECORD_TEXT = 1,             // pt_per_em, family, text.
+    FONT_TRACE_RECORD_RESOLVE,              // key, length, face.
+    FONT_TRACE_RECORD_SHAPE,                // key, glyph count, indices, advances, clusters.
+    FONT_TRACE_RECORD_METRICS,              // key, du_per_em, advance_height_px.
+    FONT_TRACE_RECORD_BREAKS,               // key, length, flags.
+    FONT_TRACE_RECORD_RASTER,               // key, left, top, width, height.
+    FONT_TRACE_RECORD_KIND_COUNT,
+} Font_Trace_Record_Kind;
+
+typedef struct Font_Trace_Header Font_Trace_Header;
+struct Font_Trace_Header
+{
+    U32 magic;
+    U32 version;
+    F32 px_per_inch;
+};
+
+// Open addressing, keys are never 0. Grows when 3/4 full.
+typedef struct Font_Trace_Slot Font_Trace_Slot;
+struct Font_Trace_Slot
+{
+    U64 key;
+    U64 offset;                             // of the answer in the trace, for the replayer.
+    U32 size;                               // of the answer, key excluded.
+};
+
+typedef struct Font_Trace_Table Font_Trace_Table;
+struct Font_Trace_Table
+{
+    U32 count;
+    Font_Trace_Slot *slots;                 // stb_ds array, a power of two long.
+};
+
+typedef struct Font_Trace_Writer Font_Trace_Writer;
+struct Font_Trace_Writer
+{
+#if defined(OS_WINDOWS)
+    HANDLE file;
+#else
+    int file;
+#endif
+    B32 failed;
+    U32 used;
+    U8 buffer[FONT_TRACE_BUFFER_SIZE];
+};
+
+typedef struct Font_Trace_Recorder Font_Trace_Recorder;
+struct Font_Trace_Recorder
+{
+    Font_Backend inner;                     // owned, released with the recorder.
+    Job_Mutex mutex;                        // the writer and the table.
+    Font_Trace_Writer writer;
+    Font_Trace_Table recorded;              // keys of answers already in the trace.
+    U64 record_count;
+};
+
+// A text font_map_text() was given while the trace was recorded.
+typedef struct Font_Trace_Text Font_Trace_Text;
+struct Font_Trace_Text
+{
+    wchar_t *family;                        // interned, so equal families are equal pointers.
+    F32 pt_per_em;
+    U16 *text;
+    U32 length;
+};
+
+typedef struct Font_Trace_Replay Font_Trace_Replay;
+struct Font_Trace_Replay
+{
+    Arena *arena;
+    U8 *data;
+    U64 size;
+    F32 px_per_inch;
+
+    Font_Trace_Table answers;
+    Font_Trace_Text *texts;                 // stb_ds array, in the order they were mapped.
+    wchar_t **families;                     // stb_ds array.
+
+    Synthetic_Font fallback;
+    volatile S64 miss_counts[FONT_TRACE_RECORD_KIND_COUNT];
+};
+
+// Writing and reading
+function U64 font_trace_hash(U64 hash, void *data, U64 size);
+function U64 font_trace_hash_family(U64 hash, wchar_t *family);
+function U64 font_trace_key(U64 hash);
+function U32 font_trace_family_length(wchar_t *family);
+function void font_trace_table_insert(Font_Trace_Table *table, U64 key, U64 offset, U32 size);
+function Font_Trace_Slot *font_trace_table_find(Font_Trace_Table *table, U64 key);
+function B32 font_trace_writer_open(Font_Trace_Writer *writer, char *path);
+function void font_trace_writer_flush(Font_Trace_Writer *writer);
+function void font_trace_writer_close(Font_Trace_Writer *writer);
+function void font_trace_write(Font_Trace_Writer *writer, void *data, U32 size);
+function U8 *font_trace_read_file(Arena *arena, char *path, U64 *out_size);
+
+// Recorder
+function void font_trace_begin_record(Font_Trace_Recorder *recorder, Font_Trace_Record_Kind kind, U32 size);
+function B32 font_trace_should_record(Font_Trace_Recorder *recorder, U64 key);
+function void font_trace_record_map_text(void *user_data, wchar_t *family, F32 pt_per_em, U16 *text, U32 text_length);
+function U32 font_trace_record_resolve(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face);
+function void font_trace_record_shape(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions);
+function Font_Metrics font_trace_record_get_metrics(void *user_data, U64 face, F32 em_size_px);
+function U8 *font_trace_record_analyze_breaks(void *user_data, U16 *text, U32 text_length);
+function void font_trace_record_rasterize(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out);
+function void font_trace_record_release(void *user_data);
+function void font_trace_record_get_stats(void *user_data, Font_Backend_Stats *out);
+function B32 font_trace_recorder_init(Font_Trace_Recorder *recorder, Font_Backend inner, char *path);
+function Font_Backend font_trace_recorder_backend(Font_Trace_Recorder *recorder);
+
+// Replay
+function wchar_t *font_trace_intern_family(Font_Trace_Replay *replay, U16 *family, U32 family_length);
+function B32 font_trace_replay_load(Font_Trace_Replay *replay, char *path);
+function U8 *font_trace_replay_find(Font_Trace_Replay *replay, Font_Trace_Record_Kind kind, U64 key, U32 min_size, U32 *out_size);
+function void font_trace_replay_reject(Font_Trace_Replay *replay, Font_Trace_Record_Kind kind);
+function U32 font_trace_replay_resolve(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face);
+function void font_trace_replay_shape(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions);
+function Font_Metrics font_trace_replay_get_metrics(void *user_data, U64 face, F32 em_size_px);
+function U8 *font_trace_replay_analyze_breaks(void *user_data, U16 *text, U32 text_length);
+function void font_trace_replay_rasterize(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out);
+function void font_trace_replay_release(Font_Trace_Replay *replay);
+function Font_Backend font_trace_replay_backend(Font_Trace_Replay *replay);
+function U64 font_trace_replay_miss_count(Font_Trace_Replay *replay);
+
+#endif // FONT_TRACE_H
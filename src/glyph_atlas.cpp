@@ -0,0 +1,424 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function void
+glyph_atlas_init(Glyph_Atlas *atlas, Font_Backend *backend, Job_System *jobs, U32 width, U32 height, U32 entry_count)
+{
+    *atlas = {};
+    atlas->arena   = arena_alloc();
+    atlas->backend = backend;
+    atlas->jobs    = jobs;
+    job_mutex_init(&atlas->write_mutex);
+
+    if (jobs && backend->can_rasterize_concurrently)
+    {
+        for (U32 wi = 0; wi < job_worker_count(jobs); ++wi)
+        { atlas->raster_arenas[wi] = arena_alloc(); }
+    }
+
+    atlas->bitmap.width  = width;
+    atlas->bitmap.height = height;
+    atlas->bitmap.pitch  = (width << 2);
+    atlas->bitmap.data   = (U8 *)push_size(atlas->arena, atlas->bitmap.pitch*atlas->bitmap.height);
+
+    atlas->partition_sentinel = push_struct(atlas->arena, Glyph_Atlas_Bin);
+    {
+        Glyph_Atlas_Bin *head = push_struct(atlas->arena, Glyph_Atlas_Bin);
+        {
+            head->prev = atlas->partition_sentinel;
+            head->next = atlas->partition_sentinel;
+            head->occupied = false;
+            head->x = 0;
+            head->y = 0;
+            head->w = width;
+            head->h = height;
+        }
+        atlas->partition_sentinel->prev = head;
+        atlas->partition_sentinel->next = head;
+    }
+
+    atlas->entry_count = entry_count;
+    atlas->entries     = push_array(atlas->arena, Glyph_Atlas_Entry, entry_count);
+}
+
+function void
+glyph_atlas_release(Glyph_Atlas *atlas)
+{
+    for (U32 wi = 0; wi < JOB_MAX_WORKER_COUNT && atlas->raster_arenas[wi]; ++wi)
+    { arena_release(atlas->raster_arenas[wi]); }
+
+    job_mutex_release(&atlas->write_mutex);
+    arena_release(atlas->arena);
+    *atlas = {};
+}
+
+// @Note: Pixels of glyphs placed up to this generation are in the bitmap.
+// Read it before copying the bitmap, a copy may have some of the next ones.
+function U64
+glyph_atlas_get_generation(Glyph_Atlas *atlas)
+{
+    U64 result = (U64)job_atomic_load(&atlas->generation);
+    return result;
+}
+
+function U64
+glyph_atlas_hash(U64 face, F32 em_size_px, U16 glyph_index)
+{
+    U32 size_bits;
+    memory_copy(&size_bits, &em_size_px, sizeof(size_bits));
+
+    U64 result = 0xcbf29ce484222325ull;
+    U64 parts[] = {face, size_bits, glyph_index};
+    for (U32 i = 0; i < array_count(parts); ++i)
+    {
+        result ^= parts[i];
+        result *= 0x100000001b3ull;
+        result ^= (result >> 29);
+    }
+    return result;
+}
+
+// @Note: Linear probing, nothing is ever removed, so the first empty slot
+// ends the search. Safe without the write mutex; the entry found may still
+// be PENDING.
+function Glyph_Atlas_Entry *
+glyph_atlas_lookup(Glyph_Atlas *atlas, U64 face, F32 em_size_px, U16 glyph_index, U64 hash)
+{
+    U64 entry_count = atlas->entry_count;
+    U64 home_position = (hash % entry_count);
+
+    for (U64 i = 0; i < entry_count; ++i)
+    {
+        Glyph_Atlas_Entry *entry = atlas->entries + ((home_position + i) % entry_count);
+        if (job_atomic_load(&entry->state) == GLYPH_ATLAS_ENTRY_EMPTY)
+        { break; }
+
+        if (entry->glyph_index == glyph_index && entry->face == face && entry->em_size_px == em_size_px)
+        { return entry; }
+    }
+
+    return NULL;
+}
+
+// @Note: First fit. The partition taken is split into the rest of its row,
+// the rest of its column and the corner, and moved to the end of the list so
+// the free ones come first.
+function B32
+glyph_atlas_pack(Glyph_Atlas *atlas, U32 width, U32 height, U32 *out_x, U32 *out_y)
+{
+    Glyph_Atlas_Bin *sentinel = atlas->partition_sentinel;
+
+    dll_for(sentinel, partition)
+    {
+        if (! partition->occupied)
+        {
+            U32 w1 = partition->w;
+            U32 h1 = partition->h;
+            U32 w2 = width;
+            U32 h2 = height;
+
+            if (w1 >= w2 && h1 >= h2)
+            {
+                U32 x1 = partition->x;
+                U32 y1 = partition->y;
+
+                U32 dx[3] = {w2, 0, w2};
+                U32 dy[3] = {0, h2, h2};
+                U32 nw[3] = {w1-w2, w2, w1-w2};
+                U32 nh[3] = {h2, h1-h2, h1-h2};
+
+                for (U32 npi = 0; npi < 3; ++npi)
+                {
+                    Glyph_Atlas_Bin *new_partition = push_struct(atlas->arena, Glyph_Atlas_Bin);
+                    new_partition->occupied = false;
+                    new_partition->x = x1 + dx[npi];
+                    new_partition->y = y1 + dy[npi];
+                    new_partition->w = nw[npi];
+                    new_partition->h = nh[npi];
+                    dll_append(sentinel, new_partition);
+                }
+
+                partition->occupied = true;
+                partition->w = w2;
+                partition->h = h2;
+
+                partition->prev->next = partition->next;
+                partition->next->prev = partition->prev;
+                partition->prev = sentinel->prev;
+                partition->next = sentinel;
+                sentinel->prev->next = partition;
+                sentinel->prev = partition;
+
+                *out_x = x1;
+                *out_y = y1;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// @Note: Takes a slot for a glyph not in the table, PENDING until
+// glyph_atlas_place(). Under the write mutex.
+function Glyph_Atlas_Entry *
+glyph_atlas_insert(Glyph_Atlas *atlas, U64 face, F32 em_size_px, U16 glyph_index, U64 hash)
+{
+    assume((atlas->occupied_count + 1)*4 <= atlas->entry_count*3);
+
+    Glyph_Atlas_Entry *result = NULL;
+    U64 home_position = (hash % atlas->entry_count);
+    for (U64 i = 0; i < atlas->entry_count; ++i)
+    {
+        Glyph_Atlas_Entry *slot = atlas->entries + ((home_position + i) % atlas->entry_count);
+        if (job_atomic_load(&slot->state) == GLYPH_ATLAS_ENTRY_EMPTY)
+        {
+            slot->face         = face;
+            slot->em_size_px   = em_size_px;
+            slot->glyph_index  = glyph_index;
+            slot->cel          = {};
+            slot->cel.is_empty = true;
+            job_atomic_store(&slot->state, GLYPH_ATLAS_ENTRY_PENDING);
+            atlas->occupied_count += 1;
+            result = slot;
+            break;
+        }
+    }
+    return result;
+}
+
+// @Note: RGB to RGBA, opaque.
+function void
+glyph_atlas_blit(Bitmap *bitmap, U32 x, U32 y, Font_Glyph_Bitmap *glyph)
+{
+    for (U32 r = 0; r < glyph->height; ++r)
+    {
+        for (U32 c = 0; c < glyph->width; ++c)
+        {
+            U8 *dst = bitmap->data + (y+r)*bitmap->pitch + (x+c)*4;
+            U8 *src = glyph->rgb + (r*glyph->width + c)*3;
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 0xff;
+        }
+    }
+}
+
+// @Note: Packs a rasterized glyph into the atlas, gives the entry its cel
+// and publishes it. Under the write mutex.
+function void
+glyph_atlas_place(Glyph_Atlas *atlas, Glyph_Atlas_Entry *entry, Font_Glyph_Bitmap *glyph)
+{
+    profile_scope(PROFILE_STAGE_PACK);
+
+    Glyph_Cel cel = {};
+    cel.is_empty = true;
+
+    if (glyph->width && glyph->height)
+    {
+        Bitmap *bitmap = &atlas->bitmap;
+
+        U32 margin = 1;
+        U32 x1 = 0;
+        U32 y1 = 0;
+        B32 fit = glyph_atlas_pack(atlas, glyph->width + 2*margin, glyph->height + 2*margin, &x1, &y1);
+        if (! fit)
+        { assume(! "Couldn't fit in the atlas"); }
+        atlas->packed_px += (glyph->width + 2*margin)*(glyph->height + 2*margin);
+
+        glyph_atlas_blit(bitmap, x1 + margin, y1 + margin, glyph);
+
+        cel.is_empty     = false;
+        cel.uv_min       = {(F32)(x1 + margin) / (F32)bitmap->width, (F32)(y1 + margin) / (F32)bitmap->height};
+        cel.uv_max       = {(F32)(x1 + margin + glyph->width) / (F32)bitmap->width, (F32)(y1 + margin + glyph->height) / (F32)bitmap->height};
+        cel.width_px     = (F32)glyph->width;
+        cel.height_px    = (F32)glyph->height;
+        cel.offset_px.x  = (F32)glyph->left;
+        cel.offset_px.y  = (F32)-glyph->top;
+        cel.atlas_x      = (U16)(x1 + margin);
+        cel.atlas_y      = (U16)(y1 + margin);
+    }
+
+    entry->cel = cel;
+    job_atomic_store(&entry->state, GLYPH_ATLAS_ENTRY_READY);
+
+    if (! cel.is_empty)
+    { job_atomic_add(&atlas->generation, 1); }
+    else
+    { atlas->empty_count += 1; }
+}
+
+function void
+glyph_atlas_raster_proc(void *user_data, U32 worker_index, U64 begin, U64 end)
+{
+    Glyph_Atlas_Raster_Task *task = (Glyph_Atlas_Raster_Task *)user_data;
+    Glyph_Atlas *atlas = task->atlas;
+    Font_Backend *backend = atlas->backend;
+    Arena *arena = atlas->raster_arenas[worker_index];
+
+    for (U64 mi = begin; mi < end; ++mi)
+    {
+        profile_scope(PROFILE_STAGE_RASTERIZE);
+        Glyph_Atlas_Entry *entry = task->entries[mi];
+        backend->rasterize(backend->user_data, arena, entry->face, entry->em_size_px, entry->glyph_index, task->bitmaps + mi);
+    }
+}
+
+// @Note: The read side of glyph_atlas_fill(). False on the first glyph
+// that isn't READY, with out_cels filled up to it.
+function B32
+glyph_atlas_fill_lock_free(Glyph_Atlas *atlas, Glyph_Atlas_Key *keys, U32 key_count, Glyph_Cel *out_cels)
+{
+    for (U32 ki = 0; ki < key_count; ++ki)
+    {
+        Glyph_Atlas_Key key = keys[ki];
+        U64 hash = glyph_atlas_hash(key.face, key.em_size_px, key.glyph_index);
+        Glyph_Atlas_Entry *entry = glyph_atlas_lookup(atlas, key.face, key.em_size_px, key.glyph_index, hash);
+        if (! entry || job_atomic_load(&entry->state) != GLYPH_ATLAS_ENTRY_READY)
+        { return false; }
+
+        out_cels[ki] = entry->cel;
+    }
+    return true;
+}
+
+// @Note: The cels of a set of glyphs. If any is missing, the rest is done
+// under the write mutex: misses are inserted as they're found, so a glyph
+// that repeats is rasterized once, and then rasterized all together before
+// they're packed in order. Nothing PENDING is left once the mutex is let go,
+// so entries found under it are READY.
+function void
+glyph_atlas_fill(Glyph_Atlas *atlas, Glyph_Atlas_Key *keys, U32 key_count, Glyph_Cel *out_cels)
+{
+    job_atomic_add(&atlas->lookup_count, key_count);
+
+    if (glyph_atlas_fill_lock_free(atlas, keys, key_count, out_cels))
+    { return; }
+
+    job_mutex_lock(&atlas->write_mutex);
+    Temporary_Arena scratch = scratch_begin();
+
+    Glyph_Atlas_Entry **entries = push_array(scratch.arena, Glyph_Atlas_Entry *, key_count);
+    Glyph_Atlas_Entry **misses = push_array(scratch.arena, Glyph_Atlas_Entry *, key_count);
+    U32 miss_count = 0;
+
+    for (U32 ki = 0; ki < key_count; ++ki)
+    {
+        Glyph_Atlas_Key key = keys[ki];
+        U64 hash = glyph_atlas_hash(key.face, key.em_size_px, key.glyph_index);
+        Glyph_Atlas_Entry *entry = glyph_atlas_lookup(atlas, key.face, key.em_size_px, key.glyph_index, hash);
+        if (! entry)
+        {
+            entry = glyph_atlas_insert(atlas, key.face, key.em_size_px, key.glyph_index, hash);
+            misses[miss_count++] = entry;
+        }
+        entries[ki] = entry;
+    }
+
+    if (miss_count)
+    {
+        Font_Backend *backend = atlas->backend;
+        Font_Glyph_Bitmap *bitmaps = push_array(scratch.arena, Font_Glyph_Bitmap, miss_count);
+
+        if (miss_count > 1 && atlas->raster_arenas[0])
+        {
+            Glyph_Atlas_Raster_Task task = {atlas, misses, bitmaps};
+            job_parallel_for(atlas->jobs, miss_count, 1, glyph_atlas_raster_proc, &task);
+        }
+        else
+        {
+            for (U32 mi = 0; mi < miss_count; ++mi)
+            {
+                profile_scope(PROFILE_STAGE_RASTERIZE);
+                Glyph_Atlas_Entry *entry = misses[mi];
+                backend->rasterize(backend->user_data, scratch.arena, entry->face, entry->em_size_px, entry->glyph_index, bitmaps + mi);
+            }
+        }
+
+        for (U32 mi = 0; mi < miss_count; ++mi)
+        { glyph_atlas_place(atlas, misses[mi], bitmaps + mi); }
+        atlas->miss_count += miss_count;
+
+        for (U32 wi = 0; wi < JOB_MAX_WORKER_COUNT && atlas->raster_arenas[wi]; ++wi)
+        { arena_clear(atlas->raster_arenas[wi]); }
+    }
+
+    for (U32 ki = 0; ki < key_count; ++ki)
+    { out_cels[ki] = entries[ki]->cel; }
+
+    scratch_end(scratch);
+    job_mutex_unlock(&atlas->write_mutex);
+}
+
+// @Note: Looks the glyph up and rasterizes it into the atlas on a miss.
+// Called only for glyphs that are about to be drawn.
+function Glyph_Cel
+glyph_atlas_get(Glyph_Atlas *atlas, U64 face, F32 em_size_px, U16 glyph_index)
+{
+    Glyph_Atlas_Key key = {face, em_size_px, glyph_index};
+    Glyph_Cel result = {};
+    glyph_atlas_fill(atlas, &key, 1, &result);
+    return result;
+}
+
+// @Note: A snapshot, taken under the write mutex. Walks the whole table, so
+// it's for a stats report, not for every frame.
+function Glyph_Atlas_Stats
+glyph_atlas_get_stats(Glyph_Atlas *atlas)
+{
+    Glyph_Atlas_Stats result = {};
+
+    job_mutex_lock(&atlas->write_mutex);
+
+    result.lookup_count   = (U64)job_atomic_load(&atlas->lookup_count);
+    result.miss_count     = atlas->miss_count;
+    result.empty_count    = atlas->empty_count;
+    result.entry_count    = atlas->entry_count;
+    result.occupied_count = atlas->occupied_count;
+    result.bitmap_bytes   = (U64)atlas->bitmap.pitch*atlas->bitmap.height;
+    result.packed_px      = atlas->packed_px;
+    result.arena_bytes    = arena_pos(atlas->arena);
+
+    dll_for(atlas->partition_sentinel, partition)
+    { result.partition_count += 1; }
+
+    U64 probe_sum = 0;
+    for (U32 ei = 0; ei < atlas->entry_count; ++ei)
+    {
+        Glyph_Atlas_Entry *entry = atlas->entries + ei;
+        if (job_atomic_load(&entry->state) == GLYPH_ATLAS_ENTRY_EMPTY)
+        { continue; }
+
+        U32 home_position = (U32)(glyph_atlas_hash(entry->face, entry->em_size_px, entry->glyph_index) % atlas->entry_count);
+        U32 probe_length = (ei + atlas->entry_count - home_position) % atlas->entry_count + 1;
+        probe_sum += probe_length;
+        result.max_probe_length = max(result.max_probe_length, probe_length);
+
+        // A handful of faces at most, so a linear search is fine.
+        U32 fi = 0;
+        U32 listed_count = min(result.face_count, (U32)GLYPH_ATLAS_STATS_MAX_FACE_COUNT);
+        while (fi < listed_count && result.faces[fi].face != entry->face)
+        { ++fi; }
+
+        if (fi == listed_count)
+        {
+            result.face_count += 1;
+            if (fi < GLYPH_ATLAS_STATS_MAX_FACE_COUNT)
+            { result.faces[fi].face = entry->face; }
+        }
+
+        if (fi < GLYPH_ATLAS_STATS_MAX_FACE_COUNT)
+        {
+            Glyph_Atlas_Face_Stats *face = result.faces + fi;
+            face->glyph_count     += 1;
+            face->max_probe_length = max(face->max_probe_length, probe_length);
+        }
+    }
+
+    job_mutex_unlock(&atlas->write_mutex);
+
+    if (result.occupied_count)
+    { result.average_probe_length = (F32)((F64)probe_sum / (F64)result.occupied_count); }
+
+    return result;
+}
@@ -0,0 +1,153 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+/* --------------------------------------
+   @Note: Glyph cache and the atlas it packs into.
+
+   Glyphs are looked up by (face, size, glyph index) and rasterized by the
+   Font_Backend on a miss. The bitmap goes into the first free partition
+   of the atlas that fits it; the partition is split into what's left to
+   the right, below, and below-right. Nothing is ever evicted.
+
+   Misses that come together, like those of a line of text, are
+   rasterized together, on the job system if the atlas has one and the
+   backend allows it. Only packing and copying into the atlas is serial.
+
+   Any number of threads may look glyphs up at once, without locking.
+   An entry's key and cel are written before its state is stored, and
+   entries never move or go away, so a reader that sees an entry READY
+   sees all of it. Misses take the write mutex, one writer at a time. A
+   PENDING entry is a miss being rasterized; readers treat it as a miss
+   and queue up on the mutex behind its writer.
+   --------------------------------------- */
+
+typedef struct Glyph_Cel Glyph_Cel;
+struct Glyph_Cel
+{
+    B32 is_empty;
+    V2  uv_min;
+    V2  uv_max;
+    F32 width_px;
+    F32 height_px;
+    V2  offset_px; // offset of a pen from baseline origin of a glyph in px.
+    U16 atlas_x;   // top-left texel of the ink.
+    U16 atlas_y;
+};
+
+typedef struct Glyph_Atlas_Bin Glyph_Atlas_Bin;
+struct Glyph_Atlas_Bin
+{
+    Glyph_Atlas_Bin *prev;
+    Glyph_Atlas_Bin *next;
+    B32 occupied;
+    U32 x, y, w, h;
+};
+
+typedef struct Glyph_Atlas_Key Glyph_Atlas_Key;
+struct Glyph_Atlas_Key
+{
+    U64 face;
+    F32 em_size_px;
+    U16 glyph_index;
+};
+
+typedef enum Glyph_Atlas_Entry_State
+{
+    GLYPH_ATLAS_ENTRY_EMPTY = 0,
+    GLYPH_ATLAS_ENTRY_PENDING,              // key written, cel not yet.
+    GLYPH_ATLAS_ENTRY_READY,
+} Glyph_Atlas_Entry_State;
+
+typedef struct Glyph_Atlas_Entry Glyph_Atlas_Entry;
+struct Glyph_Atlas_Entry
+{
+    volatile S64 state;                     // Glyph_Atlas_Entry_State.
+    U64 face;
+    F32 em_size_px;
+    U16 glyph_index;
+    Glyph_Cel cel;
+};
+
+typedef struct Glyph_Atlas Glyph_Atlas;
+struct Glyph_Atlas
+{
+    Arena *arena;
+    Font_Backend *backend;
+    Job_System *jobs;                       // or NULL.
+    Arena *raster_arenas[JOB_MAX_WORKER_COUNT]; // per worker, for bitmaps waiting to be packed.
+    Job_Mutex write_mutex;                  // everything below but the entries' reads.
+
+    Bitmap bitmap;                          // RGBA8.
+    Glyph_Atlas_Bin *partition_sentinel;
+    volatile S64 generation;                // bumped whenever a glyph is added.
+
+    U32 entry_count;
+    U32 occupied_count;
+    Glyph_Atlas_Entry *entries;
+
+    // Counters, see glyph_atlas_get_stats().
+    volatile S64 lookup_count;              // added once per glyph_atlas_fill().
+    U64 miss_count;
+    U64 empty_count;                        // misses without ink.
+    U64 packed_px;                          // margins included.
+};
+
+#define GLYPH_ATLAS_STATS_MAX_FACE_COUNT 16
+
+// Glyphs of every face share the one table. A face's share of it, and how
+// far its glyphs ended up from where they hash to.
+typedef struct Glyph_Atlas_Face_Stats Glyph_Atlas_Face_Stats;
+struct Glyph_Atlas_Face_Stats
+{
+    U64 face;
+    U32 glyph_count;
+    U32 max_probe_length;
+};
+
+typedef struct Glyph_Atlas_Stats Glyph_Atlas_Stats;
+struct Glyph_Atlas_Stats
+{
+    U64 lookup_count;
+    U64 miss_count;
+    U64 empty_count;
+
+    U32 entry_count;
+    U32 occupied_count;
+    F32 average_probe_length;               // 1 for an entry in its home slot.
+    U32 max_probe_length;
+
+    U64 bitmap_bytes;
+    U64 packed_px;
+    U32 partition_count;
+    U64 arena_bytes;                        // bitmap, table and partitions.
+
+    U32 face_count;                         // past GLYPH_ATLAS_STATS_MAX_FACE_COUNT, not in faces.
+    Glyph_Atlas_Face_Stats faces[GLYPH_ATLAS_STATS_MAX_FACE_COUNT];
+};
+
+// Misses of one glyph_atlas_fill(), rasterized on the job system.
+typedef struct Glyph_Atlas_Raster_Task Glyph_Atlas_Raster_Task;
+struct Glyph_Atlas_Raster_Task
+{
+    Glyph_Atlas *atlas;
+    Glyph_Atlas_Entry **entries;
+    Font_Glyph_Bitmap *bitmaps;
+};
+
+function void glyph_atlas_init(Glyph_Atlas *atlas, Font_Backend *backend, Job_System *jobs, U32 width, U32 height, U32 entry_count);
+function void glyph_atlas_release(Glyph_Atlas *atlas);
+function U64 glyph_atlas_get_generation(Glyph_Atlas *atlas);
+function U64 glyph_atlas_hash(U64 face, F32 em_size_px, U16 glyph_index);
+function Glyph_Atlas_Entry *glyph_atlas_lookup(Glyph_Atlas *atlas, U64 face, F32 em_size_px, U16 glyph_index, U64 hash);
+function B32 glyph_atlas_pack(Glyph_Atlas *atlas, U32 width, U32 height, U32 *out_x, U32 *out_y);
+function Glyph_Atlas_Entry *glyph_atlas_insert(Glyph_Atlas *atlas, U64 face, F32 em_size_px, U16 glyph_index, U64 hash);
+function void glyph_atlas_blit(Bitmap *bitmap, U32 x, U32 y, Font_Glyph_Bitmap *glyph);
+function void glyph_atlas_place(Glyph_Atlas *atlas, Glyph_Atlas_Entry *entry, Font_Glyph_Bitmap *glyph);
+function void glyph_atlas_raster_proc(void *user_data, U32 worker_index, U64 begin, U64 end);
+function B32 glyph_atlas_fill_lock_free(Glyph_Atlas *atlas, Glyph_Atlas_Key *keys, U32 key_count, Glyph_Cel *out_cels);
+function void glyph_atlas_fill(Glyph_Atlas *atlas, Glyph_Atlas_Key *keys, U32 key_count, Glyph_Cel *out_cels);
+function Glyph_Cel glyph_atlas_get(Glyph_Atlas *atlas, U64 face, F32 em_size_px, U16 glyph_index);
+function Glyph_Atlas_Stats glyph_atlas_get_stats(Glyph_Atlas *atlas);
+
+#endif // GLYPH_ATLAS_H
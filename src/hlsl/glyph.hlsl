@@ -0,0 +1,52 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+cbuffer View_Constants : register(b0)
+{
+    float2 px_to_ndc;       // 2 / viewport size.
+    float2 texel_to_uv;     // 1 / atlas size.
+};
+
+// One instance per glyph, see Glyph_Instance.
+struct VS_Input
+{
+    float2 min_px     : POS;
+    uint4  atlas_rect : RECT;   // x, y, width, height in texels.
+    float4 color      : COLOR;
+    uint   page       : PAGE;
+    uint   vertex_id  : SV_VertexID;
+};
+
+struct VS_Output
+{
+    float4 position : SV_POSITION;
+    float3 uvw      : TEXCOORD;
+    float4 color    : COLOR;
+};
+
+Texture2DArray atlas         : register(t0);
+SamplerState   atlas_sampler : register(s0);
+
+VS_Output
+glyph_vs_main(VS_Input input)
+{
+    // Triangle strip (0,0), (0,1), (1,0), (1,1), clockwise.
+    float2 corner = float2(input.vertex_id >> 1, input.vertex_id & 1);
+    float2 size   = float2(input.atlas_rect.zw);
+
+    // px grow upwards, texels downwards.
+    float2 position_px = input.min_px + corner*size;
+    float2 texel       = float2(input.atlas_rect.xy) + float2(corner.x, 1.0f - corner.y)*size;
+
+    VS_Output output;
+    output.position = float4(position_px*px_to_ndc - 1.0f, 0.0f, 1.0f);
+    output.uvw      = float3(texel*texel_to_uv, (float)input.page);
+    output.color    = input.color;
+    return output;
+}
+
+float4
+glyph_ps_main(VS_Output input) : SV_Target
+{
+    float4 result = atlas.Sample(atlas_sampler, input.uvw)*input.color;
+    return result;
+}
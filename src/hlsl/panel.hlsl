@@ -1,8 +1,15 @@
 // Copyright (c) 2025 Seong Woo Lee. All rights reserved.
 
+// Shared by every vertex shader, see View_Constants in main.cpp.
+cbuffer View_Constants : register(b0)
+{
+    float2 px_to_ndc;       // 2 / viewport size.
+    float2 texel_to_uv;     // 1 / atlas size.
+};
+
 struct VS_Input 
 {
-    float2 position : POS;
+    float2 position : POS;     // px.
     float2 uv       : TEX;
 };
 
@@ -16,7 +23,7 @@ VS_Output
 panel_vs_main(VS_Input input)
 {
     VS_Output output;
-    output.position = float4(input.position, 0.0f, 1.0f);
+    output.position = float4(input.position*px_to_ndc - 1.0f, 0.0f, 1.0f);
     output.uv       = input.uv;
     return output;
 }
@@ -0,0 +1,458 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+// -----------------------------------------
+// @Note: Atomics. Stores and read-modify-writes are sequentially
+// consistent, the deque relies on it. Loads only acquire: a locked load
+// would take the line exclusively and readers of a shared table would
+// keep stealing it from each other.
+
+function S64
+job_atomic_load(volatile S64 *p)
+{
+#if defined(OS_WINDOWS)
+    S64 result = ReadAcquire64(p);
+#else
+    S64 result = __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#endif
+    return result;
+}
+
+function void
+job_atomic_store(volatile S64 *p, S64 value)
+{
+#if defined(OS_WINDOWS)
+    InterlockedExchange64(p, value);
+#else
+    __atomic_store_n(p, value, __ATOMIC_SEQ_CST);
+#endif
+}
+
+// Returns the new value.
+function S64
+job_atomic_add(volatile S64 *p, S64 addend)
+{
+#if defined(OS_WINDOWS)
+    S64 result = InterlockedAdd64(p, addend);
+#else
+    S64 result = __atomic_add_fetch(p, addend, __ATOMIC_SEQ_CST);
+#endif
+    return result;
+}
+
+function B32
+job_atomic_compare_exchange(volatile S64 *p, S64 expected, S64 desired)
+{
+#if defined(OS_WINDOWS)
+    B32 result = (InterlockedCompareExchange64(p, desired, expected) == expected);
+#else
+    B32 result = __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif
+    return result;
+}
+
+function void
+job_pause(void)
+{
+#if defined(OS_WINDOWS)
+    YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+function void
+job_yield(void)
+{
+#if defined(OS_WINDOWS)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+// -----------------------------------------
+// @Note: Mutex
+
+function void
+job_mutex_init(Job_Mutex *mutex)
+{
+#if defined(OS_WINDOWS)
+    InitializeSRWLock(&mutex->lock);
+#else
+    int error = pthread_mutex_init(&mutex->lock, NULL);
+    assume(error == 0);
+#endif
+}
+
+function void
+job_mutex_release(Job_Mutex *mutex)
+{
+#if defined(OS_WINDOWS)
+    // Nothing to release.
+#else
+    pthread_mutex_destroy(&mutex->lock);
+#endif
+}
+
+function void
+job_mutex_lock(Job_Mutex *mutex)
+{
+#if defined(OS_WINDOWS)
+    AcquireSRWLockExclusive(&mutex->lock);
+#else
+    pthread_mutex_lock(&mutex->lock);
+#endif
+}
+
+function void
+job_mutex_unlock(Job_Mutex *mutex)
+{
+#if defined(OS_WINDOWS)
+    ReleaseSRWLockExclusive(&mutex->lock);
+#else
+    pthread_mutex_unlock(&mutex->lock);
+#endif
+}
+
+// -----------------------------------------
+// @Note: Chase-Lev deque, fixed size. The owner pushes and pops at the
+// bottom, thieves take from the top. Only the last job is contended, and
+// the owner and a thief settle it with a CAS on top.
+
+function B32
+job_deque_push(Job_Deque *deque, Job job)
+{
+    S64 bottom = job_atomic_load(&deque->bottom);
+    S64 top    = job_atomic_load(&deque->top);
+    if (bottom - top >= JOB_DEQUE_CAPACITY)
+    { return false; }
+
+    deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)] = job;
+    job_atomic_store(&deque->bottom, bottom + 1);
+    return true;
+}
+
+function B32
+job_deque_pop(Job_Deque *deque, Job *out)
+{
+    S64 bottom = job_atomic_load(&deque->bottom) - 1;
+    job_atomic_store(&deque->bottom, bottom);
+    S64 top = job_atomic_load(&deque->top);
+
+    B32 result = false;
+    if (top <= bottom)
+    {
+        *out = deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)];
+        result = true;
+        if (top == bottom)
+        {
+            // The last one, a thief may be after it too.
+            result = job_atomic_compare_exchange(&deque->top, top, top + 1);
+            job_atomic_store(&deque->bottom, bottom + 1);
+        }
+    }
+    else
+    {
+        job_atomic_store(&deque->bottom, bottom + 1);
+    }
+    return result;
+}
+
+// @Note: The job is read before the CAS. If the owner got to it first, what
+// was read is thrown away with the failed CAS.
+function B32
+job_deque_steal(Job_Deque *deque, Job *out)
+{
+    S64 top    = job_atomic_load(&deque->top);
+    S64 bottom = job_atomic_load(&deque->bottom);
+
+    B32 result = false;
+    if (top < bottom)
+    {
+        Job job = deque->jobs[top & (JOB_DEQUE_CAPACITY - 1)];
+        if (job_atomic_compare_exchange(&deque->top, top, top + 1))
+        {
+            *out = job;
+            result = true;
+        }
+    }
+    return result;
+}
+
+// -----------------------------------------
+// @Note: Workers
+
+function void
+job_run(Job job, U32 worker_index)
+{
+    job.proc(job.user_data, worker_index);
+    if (job.counter)
+    { job_atomic_add(&job.counter->value, -1); }
+}
+
+// Own deque first, then the others', starting past our own.
+function B32
+job_try_run_one(Job_System *system, U32 worker_index)
+{
+    Job job = {};
+    B32 result = job_deque_pop(system->deques + worker_index, &job);
+    for (U32 i = 1; ! result && i < system->worker_count; ++i)
+    {
+        U32 victim = (worker_index + i) % system->worker_count;
+        result = job_deque_steal(system->deques + victim, &job);
+    }
+
+    if (result)
+    { job_run(job, worker_index); }
+    return result;
+}
+
+function void
+job_worker_loop(Job_Worker *worker)
+{
+    Job_System *system = worker->system;
+    job_thread_worker = worker;
+
+    U32 spin_count = 0;
+    while (! job_atomic_load(&system->should_quit))
+    {
+        if (job_try_run_one(system, worker->index))
+        {
+            spin_count = 0;
+            continue;
+        }
+
+        if (++spin_count < JOB_SPIN_COUNT)
+        {
+            job_pause();
+            continue;
+        }
+
+        // Counted as sleeping before the last look, so a submit that the look
+        // misses sees the count and wakes us.
+        job_atomic_add(&system->sleeping_count, 1);
+        B32 found = job_try_run_one(system, worker->index);
+        if (! found && ! job_atomic_load(&system->should_quit))
+        {
+#if defined(OS_WINDOWS)
+            WaitForSingleObject(system->wake_semaphore, INFINITE);
+#else
+            while (sem_wait(&system->wake_semaphore) != 0) {}
+#endif
+        }
+        job_atomic_add(&system->sleeping_count, -1);
+        spin_count = 0;
+    }
+}
+
+#if defined(OS_WINDOWS)
+function DWORD WINAPI
+job_worker_thread_proc(LPVOID param)
+{
+    job_worker_loop((Job_Worker *)param);
+    return 0;
+}
+#else
+function void *
+job_worker_thread_proc(void *param)
+{
+    job_worker_loop((Job_Worker *)param);
+    return NULL;
+}
+#endif
+
+// @Note: thread_count counts the calling thread, 0 for one per processor.
+function void
+job_system_init(Job_System *system, U32 thread_count)
+{
+    *system = {};
+
+    if (! thread_count)
+    { thread_count = text_source_get_processor_count(); }
+    thread_count = clamp(1u, thread_count, (U32)JOB_MAX_WORKER_COUNT);
+
+    system->arena        = arena_alloc();
+    system->worker_count = thread_count;
+    system->deques       = push_array(system->arena, Job_Deque, thread_count);
+
+#if defined(OS_WINDOWS)
+    system->wake_semaphore = CreateSemaphoreW(NULL, 0, JOB_MAX_WORKER_COUNT, NULL);
+    assume(system->wake_semaphore);
+#else
+    int error = sem_init(&system->wake_semaphore, 0, 0);
+    assume(error == 0);
+#endif
+
+    for (U32 wi = 0; wi < thread_count; ++wi)
+    {
+        system->workers[wi].system = system;
+        system->workers[wi].index  = wi;
+    }
+
+    // Worker 0 is whoever drives the system.
+    for (U32 wi = 1; wi < thread_count; ++wi)
+    {
+        Job_Worker *worker = system->workers + wi;
+#if defined(OS_WINDOWS)
+        worker->thread = CreateThread(NULL, 0, job_worker_thread_proc, worker, 0, NULL);
+        assume(worker->thread);
+#else
+        int error = pthread_create(&worker->thread, NULL, job_worker_thread_proc, worker);
+        assume(error == 0);
+#endif
+    }
+}
+
+function void
+job_system_release(Job_System *system)
+{
+    job_atomic_store(&system->should_quit, 1);
+    job_wake(system, system->worker_count);
+
+    for (U32 wi = 1; wi < system->worker_count; ++wi)
+    {
+#if defined(OS_WINDOWS)
+        WaitForSingleObject(system->workers[wi].thread, INFINITE);
+        CloseHandle(system->workers[wi].thread);
+#else
+        pthread_join(system->workers[wi].thread, NULL);
+#endif
+    }
+
+#if defined(OS_WINDOWS)
+    CloseHandle(system->wake_semaphore);
+#else
+    sem_destroy(&system->wake_semaphore);
+#endif
+    arena_release(system->arena);
+    *system = {};
+}
+
+function U32
+job_worker_count(Job_System *system)
+{
+    U32 result = (system) ? system->worker_count : 1;
+    return result;
+}
+
+function U32
+job_current_worker_index(Job_System *system)
+{
+    Job_Worker *worker = job_thread_worker;
+    U32 result = (worker && worker->system == system) ? worker->index : 0;
+    return result;
+}
+
+function void
+job_wake(Job_System *system, U32 job_count)
+{
+    S64 sleeping_count = job_atomic_load(&system->sleeping_count);
+    U32 wake_count = (U32)min((S64)job_count, sleeping_count);
+    if (wake_count)
+    {
+#if defined(OS_WINDOWS)
+        ReleaseSemaphore(system->wake_semaphore, (LONG)wake_count, NULL);
+#else
+        for (U32 i = 0; i < wake_count; ++i)
+        { sem_post(&system->wake_semaphore); }
+#endif
+    }
+}
+
+// @Note: Onto the calling worker's deque. Without a system, or when the
+// deque is full, jobs run right away.
+function void
+job_submit(Job_System *system, Job *jobs, U32 job_count, Job_Counter *counter)
+{
+    if (counter)
+    { job_atomic_add(&counter->value, (S64)job_count); }
+
+    U32 worker_index = job_current_worker_index(system);
+    U32 pushed_count = 0;
+    for (U32 ji = 0; ji < job_count; ++ji)
+    {
+        Job job = jobs[ji];
+        job.counter = counter;
+
+        if (system && job_deque_push(system->deques + worker_index, job))
+        { ++pushed_count; }
+        else
+        { job_run(job, worker_index); }
+    }
+
+    if (pushed_count)
+    { job_wake(system, pushed_count); }
+}
+
+// @Note: Runs jobs, any of them, until the counter is zero.
+function void
+job_wait(Job_System *system, Job_Counter *counter)
+{
+    U32 worker_index = job_current_worker_index(system);
+    U32 spin_count = 0;
+    while (job_atomic_load(&counter->value) > 0)
+    {
+        if (system && job_try_run_one(system, worker_index))
+        {
+            spin_count = 0;
+        }
+        else if (++spin_count < JOB_SPIN_COUNT)
+        {
+            job_pause();
+        }
+        else
+        {
+            job_yield();
+        }
+    }
+}
+
+// -----------------------------------------
+// @Note: Parallel for
+
+function void
+job_range_proc(void *user_data, U32 worker_index)
+{
+    Job_Range *range = (Job_Range *)user_data;
+    range->proc(range->user_data, worker_index, range->begin, range->end);
+}
+
+// @Note: Calls proc over [0, count) in ranges of at least grain, spread over
+// the workers, and returns once all of them are done. Ranges are pushed
+// back to front, so the owner works up from the start while thieves take
+// from the end.
+function void
+job_parallel_for(Job_System *system, U64 count, U64 grain, Job_Range_Proc *proc, void *user_data)
+{
+    if (! count)
+    { return; }
+
+    grain = max(grain, (U64)1);
+    U64 task_count = min((count + grain - 1) / grain, (U64)job_worker_count(system)*4);
+    task_count = min(task_count, (U64)JOB_PARALLEL_FOR_MAX_TASK_COUNT);
+
+    if (task_count <= 1)
+    {
+        proc(user_data, job_current_worker_index(system), 0, count);
+        return;
+    }
+
+    Job_Range ranges[JOB_PARALLEL_FOR_MAX_TASK_COUNT];
+    Job jobs[JOB_PARALLEL_FOR_MAX_TASK_COUNT];
+    for (U64 ti = 0; ti < task_count; ++ti)
+    {
+        U64 ri = task_count - 1 - ti;
+        ranges[ri].proc      = proc;
+        ranges[ri].user_data = user_data;
+        ranges[ri].begin     = count*ri / task_count;
+        ranges[ri].end       = count*(ri + 1) / task_count;
+
+        jobs[ti] = {};
+        jobs[ti].proc      = job_range_proc;
+        jobs[ti].user_data = ranges + ri;
+    }
+
+    Job_Counter counter = {};
+    job_submit(system, jobs, (U32)task_count, &counter);
+    job_wait(system, &counter);
+}
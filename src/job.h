@@ -0,0 +1,156 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef JOB_H
+#define JOB_H
+
+/* --------------------------------------
+   @Note: Work-stealing job system.
+
+   Every worker has a deque of jobs. It pushes and pops its own at the
+   bottom, and when it runs dry it steals from the top of the others'
+   (Chase-Lev), so the oldest and usually biggest pieces of work are the
+   ones that move between threads.
+
+   Worker 0 is whichever thread drives the system from outside: the one
+   that submits the top-level work and waits for it. Only one thread at a
+   time may do that. The other workers are threads of the system's own,
+   which sleep on a semaphore when there's nothing to steal.
+
+   Jobs are counted by a Job_Counter. Submitting adds to it, finishing a
+   job takes one off, and job_wait() returns once it's zero. A wait runs
+   jobs meanwhile instead of blocking, so a job can submit work of its own
+   and wait for it, which is how dependencies are expressed: what depends
+   on a set of jobs waits on their counter.
+
+   Nothing here allocates per job. The deques come from the system's arena
+   and a parallel for keeps its ranges on the caller's stack, since it
+   doesn't return before they're done.
+
+   The atomics and the mutex are also what the caches that are shared
+   between threads are built on.
+   --------------------------------------- */
+
+#if defined(OS_WINDOWS)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#  include <sched.h>
+#  include <semaphore.h>
+#endif
+
+#define JOB_MAX_WORKER_COUNT            32
+#define JOB_DEQUE_CAPACITY              4096    // power of two. Jobs that don't fit run inline.
+#define JOB_PARALLEL_FOR_MAX_TASK_COUNT 256
+#define JOB_SPIN_COUNT                  256     // failed steals before a worker sleeps.
+
+typedef void Job_Proc(void *user_data, U32 worker_index);
+typedef void Job_Range_Proc(void *user_data, U32 worker_index, U64 begin, U64 end);
+
+typedef struct Job_Counter Job_Counter;
+struct Job_Counter
+{
+    volatile S64 value;
+};
+
+typedef struct Job Job;
+struct Job
+{
+    Job_Proc *proc;
+    void *user_data;
+    Job_Counter *counter;
+};
+
+// Top and bottom on lines of their own, thieves write one and the owner the other.
+typedef struct Job_Deque Job_Deque;
+struct Job_Deque
+{
+    volatile S64 top;
+    U8 pad0[56];
+    volatile S64 bottom;
+    U8 pad1[56];
+    Job jobs[JOB_DEQUE_CAPACITY];
+};
+
+typedef struct Job_System Job_System;
+
+typedef struct Job_Worker Job_Worker;
+struct Job_Worker
+{
+    Job_System *system;
+    U32 index;
+#if defined(OS_WINDOWS)
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+};
+
+struct Job_System
+{
+    Arena *arena;
+    U32 worker_count;
+    Job_Deque *deques;                  // one per worker.
+    Job_Worker workers[JOB_MAX_WORKER_COUNT];
+
+    volatile S64 sleeping_count;
+    volatile S64 should_quit;
+#if defined(OS_WINDOWS)
+    HANDLE wake_semaphore;
+#else
+    sem_t wake_semaphore;
+#endif
+};
+
+// For writers to the shared caches. Readers of those don't lock.
+typedef struct Job_Mutex Job_Mutex;
+struct Job_Mutex
+{
+#if defined(OS_WINDOWS)
+    SRWLOCK lock;
+#else
+    pthread_mutex_t lock;
+#endif
+};
+
+// One piece of a parallel for.
+typedef struct Job_Range Job_Range;
+struct Job_Range
+{
+    Job_Range_Proc *proc;
+    void *user_data;
+    U64 begin;
+    U64 end;
+};
+
+function S64 job_atomic_load(volatile S64 *p);
+function void job_atomic_store(volatile S64 *p, S64 value);
+function S64 job_atomic_add(volatile S64 *p, S64 addend);
+function B32 job_atomic_compare_exchange(volatile S64 *p, S64 expected, S64 desired);
+function void job_pause(void);
+function void job_yield(void);
+
+function void job_mutex_init(Job_Mutex *mutex);
+function void job_mutex_release(Job_Mutex *mutex);
+function void job_mutex_lock(Job_Mutex *mutex);
+function void job_mutex_unlock(Job_Mutex *mutex);
+
+function B32 job_deque_push(Job_Deque *deque, Job job);
+function B32 job_deque_pop(Job_Deque *deque, Job *out);
+function B32 job_deque_steal(Job_Deque *deque, Job *out);
+
+function void job_system_init(Job_System *system, U32 thread_count);
+function void job_system_release(Job_System *system);
+function U32 job_worker_count(Job_System *system);
+function U32 job_current_worker_index(Job_System *system);
+function void job_run(Job job, U32 worker_index);
+function B32 job_try_run_one(Job_System *system, U32 worker_index);
+function void job_wake(Job_System *system, U32 job_count);
+function void job_submit(Job_System *system, Job *jobs, U32 job_count, Job_Counter *counter);
+function void job_wait(Job_System *system, Job_Counter *counter);
+function void job_range_proc(void *user_data, U32 worker_index);
+function void job_parallel_for(Job_System *system, U64 count, U64 grain, Job_Range_Proc *proc, void *user_data);
+
+// -------------------------------------
+// @Note: Data
+global thread_local Job_Worker *job_thread_worker;     // NULL on threads not of a system.
+
+#endif // JOB_H
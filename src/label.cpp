@@ -0,0 +1,240 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+// @Note: Short text is copied inline. Long text is copied into the arena,
+// or, without an arena, just pointed at.
+function Label_String
+label_string_make(Arena *arena, U16 *text, U32 text_length)
+{
+    Label_String result = {};
+    result.length = text_length;
+
+    if (text_length <= LABEL_STRING_SMALL_CAPACITY)
+    {
+        memory_copy(result.small, text, text_length*sizeof(U16));
+    }
+    else if (arena)
+    {
+        result.large = push_array(arena, U16, text_length);
+        memory_copy(result.large, text, text_length*sizeof(U16));
+    }
+    else
+    {
+        result.large = text;
+    }
+
+    return result;
+}
+
+function U16 *
+label_string_text(Label_String *string)
+{
+    U16 *result = (string->length <= LABEL_STRING_SMALL_CAPACITY) ? string->small : string->large;
+    return result;
+}
+
+function B32
+label_string_equals(Label_String *a, Label_String *b)
+{
+    B32 result = (a->length == b->length &&
+                  memory_equal(label_string_text(a), label_string_text(b), a->length*sizeof(U16)));
+    return result;
+}
+
+function void
+label_cache_init(Label_Cache *cache, U32 entry_count, Label_Shape_Proc *shape, void *shape_user_data)
+{
+    cache->arena           = arena_alloc();
+    cache->entry_count     = entry_count;
+    cache->occupied_count  = 0;
+    cache->entries         = push_array(cache->arena, Label_Cache_Entry, entry_count);
+    cache->shape           = shape;
+    cache->shape_user_data = shape_user_data;
+    cache->hit_count       = 0;
+    cache->miss_count      = 0;
+    cache->reset_count     = 0;
+}
+
+function void
+label_cache_release(Label_Cache *cache)
+{
+    arena_release(cache->arena);
+    *cache = {};
+}
+
+function void
+label_cache_reset(Label_Cache *cache)
+{
+    arena_clear(cache->arena);
+    cache->occupied_count = 0;
+    cache->entries = push_array(cache->arena, Label_Cache_Entry, cache->entry_count);
+    cache->reset_count += 1;
+}
+
+function U64
+label_hash(Label_String *text, Label_Style style)
+{
+    U64 result = 0xcbf29ce484222325ull;
+
+    U16 *units = label_string_text(text);
+    for (U32 i = 0; i < text->length; ++i)
+    {
+        result ^= units[i];
+        result *= 0x100000001b3ull;
+    }
+
+    U32 size_bits;
+    memory_copy(&size_bits, &style.pt_per_em, sizeof(size_bits));
+
+    U64 extra[] = {u64_from_ptr(style.family), size_bits};
+    for (U32 i = 0; i < array_count(extra); ++i)
+    {
+        result ^= extra[i] + 0x9e3779b97f4a7c15ull + (result << 6) + (result >> 2);
+    }
+
+    return result;
+}
+
+// @Note: Shapes on a miss. Same table discipline as the word cache: linear
+// probing, nothing removed one by one, flushed as a whole at 3/4 load.
+function Label_Shaped *
+label_cache_get(Label_Cache *cache, Label_String *text, Label_Style style)
+{
+    U64 hash = label_hash(text, style);
+    U64 entry_count = cache->entry_count;
+    U64 home_position = (hash % entry_count);
+
+    for (U64 i = 0; i < entry_count; ++i)
+    {
+        Label_Cache_Entry *entry = cache->entries + ((home_position + i) % entry_count);
+        if (! entry->occupied)
+        { break; }
+
+        if (entry->hash == hash &&
+            entry->style.family == style.family && entry->style.pt_per_em == style.pt_per_em &&
+            label_string_equals(&entry->text, text))
+        {
+            cache->hit_count += 1;
+            return &entry->shaped;
+        }
+    }
+
+    cache->miss_count += 1;
+
+    if ((cache->occupied_count + 1)*4 > cache->entry_count*3)
+    { label_cache_reset(cache); }
+
+    Label_Cache_Entry *result = NULL;
+    for (U64 i = 0; i < entry_count; ++i)
+    {
+        Label_Cache_Entry *entry = cache->entries + ((home_position + i) % entry_count);
+        if (! entry->occupied)
+        {
+            result = entry;
+            break;
+        }
+    }
+    assume(result);
+
+    result->occupied = true;
+    result->hash     = hash;
+    result->text     = label_string_make(cache->arena, label_string_text(text), text->length);
+    result->style    = style;
+    cache->shape(cache->shape_user_data, cache->arena, style, label_string_text(&result->text), text->length, &result->shaped);
+
+    cache->occupied_count += 1;
+
+    return &result->shaped;
+}
+
+function Label_Cache_Stats
+label_cache_get_stats(Label_Cache *cache)
+{
+    Label_Cache_Stats result = {};
+    result.hit_count      = cache->hit_count;
+    result.miss_count     = cache->miss_count;
+    result.reset_count    = cache->reset_count;
+    result.entry_count    = cache->entry_count;
+    result.occupied_count = cache->occupied_count;
+    result.arena_bytes    = arena_pos(cache->arena);
+    return result;
+}
+
+// @Note: A batch uses a handful of fonts at most, so a linear search is fine.
+function U32
+label_glyphs_font_index(Label_Glyphs *glyphs, U64 face, F32 em_size_px)
+{
+    U32 font_count = (U32)arrlenu(glyphs->fonts);
+    for (U32 fi = 0; fi < font_count; ++fi)
+    {
+        if (glyphs->fonts[fi].face == face && glyphs->fonts[fi].em_size_px == em_size_px)
+        { return fi; }
+    }
+
+    Label_Font font = {face, em_size_px};
+    arrput(glyphs->fonts, font);
+    return font_count;
+}
+
+// @Note: Labels are laid out on a single line from the top-left of their
+// rect, baseline at the bottom of the line like the paragraph layout. Glyphs
+// whose pen position is past the right edge are dropped; vertical and
+// partial overlap are left to the renderer to clip.
+function void
+label_layout_batch(Label_Cache *cache, Label *labels, U32 label_count, Label_Glyphs *out)
+{
+    out->count = 0;
+    arrsetlen(out->label_first_glyphs, label_count + 1);
+    arrsetlen(out->fonts, 0);
+
+    for (U32 li = 0; li < label_count; ++li)
+    {
+        Label *label = labels + li;
+        out->label_first_glyphs[li] = out->count;
+
+        Label_Shaped *shaped = label_cache_get(cache, &label->text, label->style);
+
+        F32 origin_x_px = label->rect_px.min.x;
+        F32 baseline_y_px = label->rect_px.max.y - shaped->height_px;
+        F32 limit_x_px = label->rect_px.max.x - origin_x_px;
+
+        U32 glyph_count = layout_upper_bound_f32(shaped->x_px, shaped->glyph_count, limit_x_px);
+        if (! glyph_count)
+        { continue; }
+
+        U32 first = out->count;
+        out->count += glyph_count;
+        arrsetlen(out->x_px,          out->count);
+        arrsetlen(out->y_px,          out->count);
+        arrsetlen(out->glyph_indices, out->count);
+        arrsetlen(out->font_indices,  out->count);
+
+        memory_copy(out->glyph_indices + first, shaped->glyph_indices, glyph_count*sizeof(U16));
+        for (U32 gi = 0; gi < glyph_count; ++gi)
+        {
+            out->x_px[first + gi] = origin_x_px + shaped->x_px[gi];
+            out->y_px[first + gi] = baseline_y_px;
+        }
+
+        for (U32 ri = 0; ri < shaped->run_count && shaped->run_first_glyphs[ri] < glyph_count; ++ri)
+        {
+            U32 font_index = label_glyphs_font_index(out, shaped->run_faces[ri], shaped->run_em_sizes_px[ri]);
+            U32 run_end = min(shaped->run_first_glyphs[ri + 1], glyph_count);
+            for (U32 gi = shaped->run_first_glyphs[ri]; gi < run_end; ++gi)
+            { out->font_indices[first + gi] = font_index; }
+        }
+    }
+
+    out->label_first_glyphs[label_count] = out->count;
+}
+
+function void
+label_glyphs_free(Label_Glyphs *glyphs)
+{
+    arrfree(glyphs->x_px);
+    arrfree(glyphs->y_px);
+    arrfree(glyphs->glyph_indices);
+    arrfree(glyphs->font_indices);
+    arrfree(glyphs->label_first_glyphs);
+    arrfree(glyphs->fonts);
+    *glyphs = {};
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef LABEL_H
+#define LABEL_H
+
+/* --------------------------------------
+   @Note: Batched layout of many short, single-line labels.
+
+   UI code (tables, trees, property grids) submits thousands of labels per
+   frame, mostly the same strings as the frame before. Each label is shaped
+   once per (text, style) and kept in a cache. A batch then only hashes
+   every label, finds it in the cache and writes its glyphs out, translated
+   to the label's rect, into one set of flat arrays.
+
+   Strings up to LABEL_STRING_SMALL_CAPACITY code units are stored inline,
+   so neither submitting nor caching a short label allocates.
+
+   Shaping is done by the caller's Label_Shape_Proc, which keeps this file
+   free of any platform code.
+   --------------------------------------- */
+
+#define LABEL_STRING_SMALL_CAPACITY 14
+
+typedef struct Label_String Label_String;
+struct Label_String
+{
+    U32 length;
+    union
+    {
+        U16 small[LABEL_STRING_SMALL_CAPACITY];
+        U16 *large;
+    };
+};
+
+typedef struct Label_Style Label_Style;
+struct Label_Style
+{
+    wchar_t *family;        // compared by pointer.
+    F32 pt_per_em;
+};
+
+typedef struct Label Label;
+struct Label
+{
+    Label_String text;
+    Label_Style style;
+    AABB2 rect_px;          // glyphs past rect_px.max.x are dropped.
+};
+
+// What a shaper hands back. Allocated from the arena it's given.
+typedef struct Label_Shaped Label_Shaped;
+struct Label_Shaped
+{
+    U32 glyph_count;
+    U16 *glyph_indices;
+    F32 *x_px;              // glyph_count+1 pen positions.
+
+    U32 run_count;
+    U32 *run_first_glyphs;  // run_count+1 entries.
+    U64 *run_faces;         // opaque face identity, e.g. pointer.
+    F32 *run_em_sizes_px;
+
+    F32 height_px;
+};
+
+typedef void Label_Shape_Proc(void *user_data, Arena *arena, Label_Style style, U16 *text, U32 text_length, Label_Shaped *out);
+
+typedef struct Label_Cache_Entry Label_Cache_Entry;
+struct Label_Cache_Entry
+{
+    B8 occupied;
+    U64 hash;
+    Label_String text;      // large text points to the cache's own copy.
+    Label_Style style;
+    Label_Shaped shaped;
+};
+
+typedef struct Label_Cache Label_Cache;
+struct Label_Cache
+{
+    Arena *arena;
+    U32 entry_count;
+    U32 occupied_count;
+    Label_Cache_Entry *entries;
+
+    Label_Shape_Proc *shape;
+    void *shape_user_data;
+
+    U64 hit_count;
+    U64 miss_count;
+    U64 reset_count;        // times it filled up and started over.
+};
+
+typedef struct Label_Cache_Stats Label_Cache_Stats;
+struct Label_Cache_Stats
+{
+    U64 hit_count;
+    U64 miss_count;
+    U64 reset_count;
+    U32 entry_count;
+    U32 occupied_count;
+    U64 arena_bytes;
+};
+
+typedef struct Label_Font Label_Font;
+struct Label_Font
+{
+    U64 face;
+    F32 em_size_px;
+};
+
+// @Note: Structure of arrays, one element per glyph. All stb_ds arrays,
+// reused from batch to batch.
+typedef struct Label_Glyphs Label_Glyphs;
+struct Label_Glyphs
+{
+    U32 count;
+    F32 *x_px;              // pen position on the baseline.
+    F32 *y_px;
+    U16 *glyph_indices;
+    U32 *font_indices;      // into fonts.
+
+    U32 *label_first_glyphs; // label_count+1 entries.
+
+    Label_Font *fonts;      // distinct (face, size) of the batch.
+};
+
+function Label_String label_string_make(Arena *arena, U16 *text, U32 text_length);
+function U16 *label_string_text(Label_String *string);
+function B32 label_string_equals(Label_String *a, Label_String *b);
+
+function void label_cache_init(Label_Cache *cache, U32 entry_count, Label_Shape_Proc *shape, void *shape_user_data);
+function void label_cache_release(Label_Cache *cache);
+function void label_cache_reset(Label_Cache *cache);
+function U64 label_hash(Label_String *text, Label_Style style);
+function Label_Shaped *label_cache_get(Label_Cache *cache, Label_String *text, Label_Style style);
+function Label_Cache_Stats label_cache_get_stats(Label_Cache *cache);
+
+function U32 label_glyphs_font_index(Label_Glyphs *glyphs, U64 face, F32 em_size_px);
+function void label_layout_batch(Label_Cache *cache, Label *labels, U32 label_count, Label_Glyphs *out);
+function void label_glyphs_free(Label_Glyphs *glyphs);
+
+#endif // LABEL_H
@@ -0,0 +1,313 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+// @Note: cluster_map maps each code unit to the first glyph of its cluster.
+// This inverts it: every glyph gets the text position of the first code unit
+// of its cluster. Glyphs no code unit points at (e.g. the 2nd glyph of a
+// decomposed cluster) inherit from the glyph before them.
+function void
+layout_text_positions_from_cluster_map(U16 *cluster_map, U32 text_length, U32 text_position,
+                                       U32 *glyph_text_positions, U32 glyph_count)
+{
+    for (U32 gi = 0; gi < glyph_count; ++gi)
+    { glyph_text_positions[gi] = 0xffffffff; }
+
+    for (U32 ti = text_length; ti > 0; --ti)
+    {
+        U32 gi = cluster_map[ti - 1];
+        if (gi < glyph_count)
+        { glyph_text_positions[gi] = text_position + (ti - 1); }
+    }
+
+    for (U32 gi = 0; gi < glyph_count; ++gi)
+    {
+        if (glyph_text_positions[gi] == 0xffffffff)
+        { glyph_text_positions[gi] = (gi) ? glyph_text_positions[gi - 1] : text_position; }
+    }
+}
+
+// @Note: Rounds to nearest, ties to even, same as the vector conversion.
+// Clamped like _mm_max_ps/_mm_min_ps clamp, which is where a NaN ends up.
+function S32
+layout_26_6_from_f32(F32 value)
+{
+    value = (value > -LAYOUT_MAX_ADVANCE_PX) ? value : -LAYOUT_MAX_ADVANCE_PX;
+    value = (value < LAYOUT_MAX_ADVANCE_PX) ? value : LAYOUT_MAX_ADVANCE_PX;
+#if SIMPLE_TEXT_SSE2
+    S32 result = _mm_cvtss_si32(_mm_set_ss(value*64.0f));
+#else
+    S32 result = (S32)nearbyintf(value*64.0f);
+#endif
+    return result;
+}
+
+// @Note: out[0] = 0, out[i+1] = out[i] + advances[i], saturated at
+// +-LAYOUT_MAX_X_26_6. Reference for the vector version below, which must
+// give the exact same result.
+function void
+layout_prefix_sum_26_6_scalar(F32 *advances, U32 count, S32 *out)
+{
+    S32 x = 0;
+    out[0] = 0;
+    for (U32 i = 0; i < count; ++i)
+    {
+        x = clamp(-LAYOUT_MAX_X_26_6, x + layout_26_6_from_f32(advances[i]), LAYOUT_MAX_X_26_6);
+        out[i + 1] = x;
+    }
+}
+
+function void
+layout_prefix_sum_26_6(F32 *advances, U32 count, S32 *out)
+{
+    U32 i = 0;
+    S32 x = 0;
+    out[0] = 0;
+
+#if SIMPLE_TEXT_SSE2
+    __m128 scale = _mm_set1_ps(64.0f);
+    __m128 lo = _mm_set1_ps(-LAYOUT_MAX_ADVANCE_PX);
+    __m128 hi = _mm_set1_ps(LAYOUT_MAX_ADVANCE_PX);
+    __m128i carry = _mm_setzero_si128();
+
+    // A block can't saturate while the pen is this far from the limits, so
+    // it's summed without checks. Past it, the scalar loop takes over.
+    S32 block_limit = LAYOUT_MAX_X_26_6 - 8*LAYOUT_MAX_ADVANCE_26_6;
+    for (; i + 8 <= count && x >= -block_limit && x <= block_limit; i += 8)
+    {
+        __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(advances + i), lo), hi), scale));
+        __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(advances + i + 4), lo), hi), scale));
+
+        // In-register inclusive scans of 4 lanes each, then add what came before.
+        a = _mm_add_epi32(a, _mm_slli_si128(a, 4));
+        b = _mm_add_epi32(b, _mm_slli_si128(b, 4));
+        a = _mm_add_epi32(a, _mm_slli_si128(a, 8));
+        b = _mm_add_epi32(b, _mm_slli_si128(b, 8));
+        a = _mm_add_epi32(a, carry);
+        b = _mm_add_epi32(b, _mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 3, 3)));
+
+        _mm_storeu_si128((__m128i *)(out + i + 1), a);
+        _mm_storeu_si128((__m128i *)(out + i + 5), b);
+        carry = _mm_shuffle_epi32(b, _MM_SHUFFLE(3, 3, 3, 3));
+        x = _mm_cvtsi128_si32(carry);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        x = clamp(-LAYOUT_MAX_X_26_6, x + layout_26_6_from_f32(advances[i]), LAYOUT_MAX_X_26_6);
+        out[i + 1] = x;
+    }
+}
+
+function void
+layout_f32_from_26_6(S32 *values, U32 count, F32 *out)
+{
+    U32 i = 0;
+
+#if SIMPLE_TEXT_SSE2
+    __m128 scale = _mm_set1_ps(1.0f / 64.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128((__m128i *)(values + i)));
+        _mm_storeu_ps(out + i, _mm_mul_ps(v, scale));
+    }
+#endif
+
+    for (; i < count; ++i)
+    { out[i] = (F32)values[i] * (1.0f / 64.0f); }
+}
+
+function Layout_Paragraph
+layout_build_paragraph(Arena *arena,
+                       F32 *advances, U32 *glyph_text_positions, U32 glyph_count,
+                       U8 *text_breaks, U32 text_length,
+                       U32 *run_glyph_counts, F32 *run_heights_px, U32 run_count)
+{
+    profile_scope(PROFILE_STAGE_LAYOUT);
+
+    Layout_Paragraph result = {};
+    result.glyph_count = glyph_count;
+
+    result.run_count        = run_count;
+    result.run_first_glyphs = push_array(arena, U32, run_count + 1);
+    result.run_heights_px   = push_array(arena, F32, run_count);
+    {
+        U32 first_glyph = 0;
+        for (U32 ri = 0; ri < run_count; ++ri)
+        {
+            result.run_first_glyphs[ri] = first_glyph;
+            result.run_heights_px[ri]   = run_heights_px[ri];
+            first_glyph += run_glyph_counts[ri];
+        }
+        result.run_first_glyphs[run_count] = first_glyph;
+        assert(first_glyph == glyph_count);
+    }
+
+    result.x_26_6 = push_array(arena, S32, glyph_count + 1);
+    result.x      = push_array(arena, F32, glyph_count + 1);
+    layout_prefix_sum_26_6(advances, glyph_count, result.x_26_6);
+    layout_f32_from_26_6(result.x_26_6, glyph_count + 1, result.x);
+
+    // Can't have more breaks than cluster boundaries + the end.
+    result.break_glyphs    = push_array(arena, U32, glyph_count + 1);
+    result.break_content_x = push_array(arena, F32, glyph_count + 1);
+    result.break_is_must   = push_array(arena, B8,  glyph_count + 1);
+    result.break_next_must = push_array(arena, U32, glyph_count + 1);
+
+    F32 content_x = 0.0f;
+    for (U32 gi = 0; gi < glyph_count; ++gi)
+    {
+        U32 text_position = glyph_text_positions[gi];
+        U8 flags = (text_position < text_length) ? text_breaks[text_position] : 0;
+
+        B32 is_cluster_start = (gi > 0 && text_position != glyph_text_positions[gi - 1]);
+        if (is_cluster_start && (flags & (LAYOUT_BREAK_CAN|LAYOUT_BREAK_MUST)))
+        {
+            U32 bi = result.break_count++;
+            result.break_glyphs[bi]    = gi;
+            result.break_content_x[bi] = content_x;
+            result.break_is_must[bi]   = (flags & LAYOUT_BREAK_MUST) ? 1 : 0;
+        }
+
+        if (! (flags & LAYOUT_BREAK_WHITESPACE))
+        { content_x = result.x[gi + 1]; }
+    }
+
+    {
+        U32 bi = result.break_count++;
+        result.break_glyphs[bi]    = glyph_count;
+        result.break_content_x[bi] = content_x;
+        result.break_is_must[bi]   = 1;
+    }
+
+    U32 next_must = result.break_count - 1;
+    for (U32 bi = result.break_count; bi > 0; --bi)
+    {
+        if (result.break_is_must[bi - 1])
+        { next_must = bi - 1; }
+        result.break_next_must[bi - 1] = next_must;
+    }
+
+    return result;
+}
+
+// @Note: Index of the first element greater than value.
+function U32
+layout_upper_bound_u32(U32 *values, U32 count, U32 value)
+{
+    U32 lo = 0;
+    U32 hi = count;
+    while (lo < hi)
+    {
+        U32 mid = lo + (hi - lo)/2;
+        if (values[mid] <= value) { lo = mid + 1; }
+        else                      { hi = mid; }
+    }
+    return lo;
+}
+
+function U32
+layout_upper_bound_f32(F32 *values, U32 count, F32 value)
+{
+    U32 lo = 0;
+    U32 hi = count;
+    while (lo < hi)
+    {
+        U32 mid = lo + (hi - lo)/2;
+        if (values[mid] <= value) { lo = mid + 1; }
+        else                      { hi = mid; }
+    }
+    return lo;
+}
+
+function U32
+layout_run_of_glyph(Layout_Paragraph *paragraph, U32 glyph)
+{
+    U32 result = layout_upper_bound_u32(paragraph->run_first_glyphs, paragraph->run_count, glyph) - 1;
+    return result;
+}
+
+// @Note: Tallest face among the runs that overlap [first_glyph, end_glyph).
+function F32
+layout_line_height(Layout_Paragraph *paragraph, U32 first_glyph, U32 end_glyph)
+{
+    F32 result = 0.0f;
+
+    for (U32 ri = layout_run_of_glyph(paragraph, first_glyph);
+         ri < paragraph->run_count && paragraph->run_first_glyphs[ri] < end_glyph;
+         ++ri)
+    {
+        result = max(result, paragraph->run_heights_px[ri]);
+    }
+
+    return result;
+}
+
+function void
+layout_wrap(Layout_Paragraph *paragraph, F32 width_px, Layout_Wrap *wrap)
+{
+    profile_scope(PROFILE_STAGE_LAYOUT);
+
+    arrsetlen(wrap->lines, 0);
+    wrap->width_px  = width_px;
+    wrap->height_px = 0.0f;
+
+    U32 glyph_count = paragraph->glyph_count;
+    U32 start = 0;
+    while (start < glyph_count)
+    {
+        F32 limit_x = paragraph->x[start] + width_px;
+
+        // Candidates are the breaks after start, up to and including the next mandatory one.
+        U32 first = layout_upper_bound_u32(paragraph->break_glyphs, paragraph->break_count, start);
+        U32 last  = paragraph->break_next_must[first];
+
+        U32 fit_count = layout_upper_bound_f32(paragraph->break_content_x + first, last - first + 1, limit_x);
+
+        Layout_Line line = {};
+        line.first_glyph = start;
+
+        U32 end;
+        if (fit_count)
+        {
+            U32 bi = first + fit_count - 1;
+            end = paragraph->break_glyphs[bi];
+            line.width_px = paragraph->break_content_x[bi] - paragraph->x[start];
+        }
+        else
+        {
+            // A single word wider than the line. Break it wherever it stops fitting.
+            U32 fit_end = layout_upper_bound_f32(paragraph->x, glyph_count + 1, limit_x);
+            end = (fit_end) ? fit_end - 1 : 0;
+            end = max(end, start + 1);
+            end = min(end, paragraph->break_glyphs[first]);
+            line.width_px = paragraph->x[end] - paragraph->x[start];
+        }
+
+        line.glyph_count = end - start;
+        line.width_px    = max(line.width_px, 0.0f);
+        line.y_px        = wrap->height_px;
+        line.height_px   = layout_line_height(paragraph, start, end);
+        arrput(wrap->lines, line);
+
+        wrap->height_px += line.height_px;
+
+        start = end;
+    }
+}
+
+// @Note: Index of the first line whose bottom is below y_px, i.e. the first
+// line (partially) visible when the viewport starts at y_px.
+function U32
+layout_first_visible_line(Layout_Wrap *wrap, F32 y_px)
+{
+    U32 lo = 0;
+    U32 hi = (U32)arrlenu(wrap->lines);
+    while (lo < hi)
+    {
+        U32 mid = lo + (hi - lo)/2;
+        Layout_Line line = wrap->lines[mid];
+        if (line.y_px + line.height_px <= y_px) { lo = mid + 1; }
+        else                                    { hi = mid; }
+    }
+    return lo;
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+/* --------------------------------------
+   @Note: Paragraph line breaking.
+
+   Break opportunities are analyzed once per paragraph and stored together
+   with the prefix sum of glyph advances. A line starting at glyph s can
+   then be filled by binary-searching the breaks for the last one whose
+   (trailing-whitespace-trimmed) x fits into s's x + width. Rewrapping at a
+   new width costs O(lines * log(glyphs)) and never walks the glyphs.
+
+   Each wrapped line also records its y offset and height, so a renderer can
+   binary-search the first line inside the viewport and stop after the last
+   one. Per-frame cost then depends on what's visible, not on the document.
+
+   Pen positions are accumulated in 26.6 fixed point with a SIMD prefix sum,
+   so they don't drift over long lines and don't depend on summation order.
+   The float positions are derived from them; dividing by 64 is exact.
+
+   An S32 in 26.6 holds +-2^25 px. Advances are clamped to
+   +-LAYOUT_MAX_ADVANCE_PX (NaN to the negative end) and pen positions
+   saturate at +-LAYOUT_MAX_X_PX, so a paragraph past that, or a backend
+   handing out garbage, gets glyphs piled up at the end instead of a
+   position that silently wraps around.
+   --------------------------------------- */
+
+#define LAYOUT_MAX_ADVANCE_PX   4096.0f
+#define LAYOUT_MAX_X_PX         16777216.0f                             // 2^24.
+#define LAYOUT_MAX_ADVANCE_26_6 ((S32)(LAYOUT_MAX_ADVANCE_PX*64.0f))
+#define LAYOUT_MAX_X_26_6       ((S32)(LAYOUT_MAX_X_PX*64.0f))
+
+// Per UTF-16 code unit, describes the boundary *before* it.
+enum
+{
+    LAYOUT_BREAK_CAN        = (1 << 0),
+    LAYOUT_BREAK_MUST       = (1 << 1),
+    LAYOUT_BREAK_WHITESPACE = (1 << 2), // the code unit itself is whitespace.
+};
+
+typedef struct Layout_Paragraph Layout_Paragraph;
+struct Layout_Paragraph
+{
+    U32 glyph_count;
+    S32 *x_26_6;            // glyph_count+1 pen positions in 26.6 fixed point.
+    F32 *x;                 // the same in px. x[g+1] - x[g] = advance of g.
+
+    U32 break_count;        // last break is always the end of the paragraph.
+    U32 *break_glyphs;      // a line may start at this glyph.
+    F32 *break_content_x;   // where visible content before the break ends.
+    B8  *break_is_must;
+    U32 *break_next_must;   // index of the first mandatory break at or after this one.
+
+    U32 run_count;
+    U32 *run_first_glyphs;  // run_count+1 entries, the last one is glyph_count.
+    F32 *run_heights_px;    // advance height of each run's face.
+};
+
+typedef struct Layout_Line Layout_Line;
+struct Layout_Line
+{
+    U32 first_glyph;
+    U32 glyph_count;
+    F32 width_px;           // without trailing whitespace.
+    F32 y_px;               // top of the line, from the top of the paragraph, growing downwards.
+    F32 height_px;
+};
+
+typedef struct Layout_Wrap Layout_Wrap;
+struct Layout_Wrap
+{
+    F32 width_px;
+    F32 height_px;
+    Layout_Line *lines;     // stb_ds array, reused across rewraps.
+};
+
+function void layout_text_positions_from_cluster_map(U16 *cluster_map, U32 text_length, U32 text_position, U32 *glyph_text_positions, U32 glyph_count);
+function S32 layout_26_6_from_f32(F32 value);
+function void layout_prefix_sum_26_6_scalar(F32 *advances, U32 count, S32 *out);
+function void layout_prefix_sum_26_6(F32 *advances, U32 count, S32 *out);
+function void layout_f32_from_26_6(S32 *values, U32 count, F32 *out);
+function Layout_Paragraph layout_build_paragraph(Arena *arena, F32 *advances, U32 *glyph_text_positions, U32 glyph_count, U8 *text_breaks, U32 text_length, U32 *run_glyph_counts, F32 *run_heights_px, U32 run_count);
+function U32 layout_upper_bound_u32(U32 *values, U32 count, U32 value);
+function U32 layout_upper_bound_f32(F32 *values, U32 count, F32 value);
+function U32 layout_run_of_glyph(Layout_Paragraph *paragraph, U32 glyph);
+function F32 layout_line_height(Layout_Paragraph *paragraph, U32 first_glyph, U32 end_glyph);
+function void layout_wrap(Layout_Paragraph *paragraph, F32 width_px, Layout_Wrap *wrap);
+function U32 layout_first_visible_line(Layout_Wrap *wrap, F32 y_px);
+
+#endif // LAYOUT_H
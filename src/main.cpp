@@ -2,6 +2,7 @@
 
 #define OS_WINDOWS
 #include "include/codebase.h"
+#include <shellapi.h> // CommandLineToArgvW
 
 //------------------------------------
 // Note: [.h]
@@ -9,13 +10,43 @@
 #define STBDS_ASSERT
 #include "third_party/stb_ds.h"
 
+#include "simple_text.h"
+#include "text_source.h"
+#include "job.h"
+#include "profile.h"
+#include "text_buffer.h"
+#include "word_cache.h"
+#include "layout.h"
+#include "label.h"
+#include "terminal_grid.h"
+#include "font_backend.h"
+#include "font_trace.h"
+#include "glyph_atlas.h"
 #include "win32_dwrite.h"
 #include "render.h"
+#include "soft_render.h"
+#include "text_render.h"
+#include "engine.h"
 
 //------------------------------------
 // Note: [.cpp]
+#include "simple_text.cpp"
+#include "text_source.cpp"
+#include "job.cpp"
+#include "profile.cpp"
+#include "text_buffer.cpp"
+#include "word_cache.cpp"
+#include "layout.cpp"
+#include "label.cpp"
+#include "terminal_grid.cpp"
+#include "font_backend.cpp"
+#include "font_trace.cpp"
+#include "glyph_atlas.cpp"
 #include "win32_dwrite.cpp"
 #include "render.cpp"
+#include "soft_render.cpp"
+#include "text_render.cpp"
+#include "engine.cpp"
 
 //------------------------------------
 // Note: Generated HLSL byte code.
@@ -25,6 +56,13 @@
 #include "shaders/panel_vs.h"
 #include "shaders/panel_ps.h"
 
+#include "shaders/glyph_vs.h"
+#include "shaders/glyph_ps.h"
+
+//------------------------------------
+// Note: Sample texts.
+#include "test_texts.h"
+
 #define win32_assume_hr(hr) assume(SUCCEEDED(hr))
 
 global B32 should_accumulate_time = false;
@@ -33,243 +71,646 @@ global B32 should_accumulate_time = false;
 // @Todo: 1. Validate high-dpi.
 //        2. Kerning. Test Case: EB Goromond, "LoTR", Feel like 'T' must be closer to 'o'.
 
-typedef struct Bin Bin;
-struct Bin
+#define INSTANCE_RING_COUNT 65536
+
+// @Note: Layers of the demo, back to front.
+enum
+{
+    RENDER_LAYER_BACKGROUND = 0,
+    RENDER_LAYER_TEXT       = 1,
+};
+
+// @Note: A dynamic buffer filled front to back with NO_OVERWRITE, so draws
+// already issued keep reading what they were given. Only a push that
+// doesn't fit renames the buffer with DISCARD, which the driver serves from
+// a fresh allocation. Neither ever waits on the GPU.
+typedef struct D3d11_Ring D3d11_Ring;
+struct D3d11_Ring
+{
+    ID3D11Buffer *buffer;
+    U32 stride;
+    U32 capacity;           // in elements.
+    U32 cursor;
+    U32 generation;         // bumped on every DISCARD.
+};
+
+// @Note: A draw as issued, kept so that an unchanged frame can issue it
+// again. It's only valid while its ring is still on the same generation.
+typedef struct D3d11_Draw D3d11_Draw;
+struct D3d11_Draw
+{
+    Render_State state;
+    U32 first;              // in the ring.
+    U32 count;              // quads or instances.
+    U32 ring_generation;
+};
+
+typedef struct D3d11_Pipeline D3d11_Pipeline;
+struct D3d11_Pipeline
+{
+    ID3D11VertexShader *vertex_shaders[RENDER_SHADER_COUNT];
+    ID3D11PixelShader *pixel_shaders[RENDER_SHADER_COUNT];
+    ID3D11InputLayout *quad_input_layout;
+    ID3D11InputLayout *instance_input_layout;
+    ID3D11BlendState *blend_states[RENDER_BLEND_COUNT];
+    ID3D11ShaderResourceView *texture_view;         // for textured quads.
+    ID3D11ShaderResourceView *atlas_array_view;     // for glyph instances.
+    ID3D11SamplerState *sampler_state;
+    ID3D11RasterizerState *rasterizer_state;
+    ID3D11Buffer *index_buffer;
+    ID3D11Buffer *view_constant_buffer;
+    ID3D11Texture2D *atlas_texture;
+    U64 uploaded_atlas_generation;
+
+    D3d11_Ring vertex_ring;
+    D3d11_Ring instance_ring;
+
+    D3d11_Draw *draws;      // stb_ds array, of the last frame built.
+
+    B32 has_last_state;
+    Render_State last_state;
+};
+
+// @Note: Everything a frame's output depends on. The text source is read-only,
+// so it doesn't need a generation of its own. The terminal demo changes on
+// its own and isn't covered; frames aren't retained while it's on.
+typedef struct Frame_Key Frame_Key;
+struct Frame_Key
+{
+    U32 window_width;
+    U32 window_height;
+    AABB2 box_container;
+    U64 top_line;
+    F32 top_offset_px;
+    F64 time;
+    U64 atlas_generation;
+};
+
+// @Note: cbuffer View_Constants, bound to every vertex shader.
+typedef struct View_Constants View_Constants;
+struct View_Constants
+{
+    V2 px_to_ndc;
+    V2 texel_to_uv;
+};
+
+// @Note: What the main thread hands to the build stage, sampled right
+// before a build is kicked.
+typedef struct Frame_Input Frame_Input;
+struct Frame_Input
+{
+    U32 window_width;
+    U32 window_height;
+    V2 container_origin_px;
+    F32 container_width_px;
+    F32 container_height_px;
+    F32 scroll_px;                  // wheel movement since the last build.
+    F64 time;
+};
+
+// @Note: A frame as the build stage leaves it for submission. Frames are
+// double-buffered: the worker owns a slot from frame_pipeline_kick() until
+// frame_pipeline_wait() returns, the main thread owns it otherwise.
+typedef struct Frame_Slot Frame_Slot;
+struct Frame_Slot
+{
+    Frame_Input input;
+    Arena *arena;
+    Renderer renderer;
+    Bitmap atlas;                   // the glyph atlas as of this frame, for upload.
+    U64 atlas_generation;
+    Frame_Key key;                  // after the build.
+    F64 build_seconds;
+    U64 arena_high_water;           // bytes, the most a frame built in this slot took.
+};
+
+// @Note: Everything shaping and layout touch. Once the worker is started,
+// only the worker does.
+typedef struct Frame_Builder Frame_Builder;
+struct Frame_Builder
+{
+    Engine *engine;
+    Text_Source *source;
+    F64 counter_frequency_inverse;
+
+    U64 top_line;                   // scroll position: a paragraph,
+    F32 top_offset_px;              // and how far into it.
+
+    // Demos, see frame_build().
+    B32 show_label_demo;
+    wchar_t *base_family;
+    F32 pt_per_em;
+    F32 px_per_inch;
+    Label_Glyphs label_glyphs;
+    Terminal_Grid *terminal;        // or NULL.
+};
+
+// @Note: Frames that take longer than this to build are presented one frame
+// late, overlapped with the next build. Below it, a frame is presented as
+// soon as it's built and latency stays what it was without the worker.
+#define FRAME_BUILD_BUDGET_SECONDS (1.0/120.0)
+
+// @Note: Paragraphs shaped and wrapped together ahead of drawing, enough to
+// keep the workers busy without shaping far below the viewport.
+#define FRAME_PREFETCH_LINE_COUNT 16
+
+typedef struct Frame_Pipeline Frame_Pipeline;
+struct Frame_Pipeline
 {
-    Bin *prev;
-    Bin *next;
-    B32 occupied;
-    U32 x, y, w, h;
+    Frame_Builder *builder;
+    Frame_Slot slots[2];
+    Frame_Slot *building;           // handed to the worker, or NULL.
+
+    HANDLE thread;
+    HANDLE kick_semaphore;
+    HANDLE done_semaphore;
+    B32 should_quit;
 };
 
+function D3d11_Ring
+d3d11_ring_create(U32 stride, U32 capacity)
+{
+    D3d11_Ring result = {};
+    result.stride   = stride;
+    result.capacity = capacity;
+    result.cursor   = capacity;     // the first push discards.
+
+    D3D11_BUFFER_DESC desc = {};
+    {
+        desc.ByteWidth      = stride*capacity;
+        desc.Usage          = D3D11_USAGE_DYNAMIC;
+        desc.BindFlags      = D3D11_BIND_VERTEX_BUFFER;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        desc.MiscFlags      = 0;
+    }
+    win32_assume_hr(d3d11.device->CreateBuffer(&desc, NULL, &result.buffer));
+
+    return result;
+}
+
+// @Note: Maps room for `count` elements, and their first element in the
+// buffer goes to out_first. Whatever was written before a wrap must already
+// be drawn. Unmap before drawing.
+function void *
+d3d11_ring_map(D3d11_Ring *ring, U32 count, U32 *out_first, Render_Stats *stats)
+{
+    assume(count <= ring->capacity);
+
+    D3D11_MAP map_type = D3D11_MAP_WRITE_NO_OVERWRITE;
+    if (ring->cursor + count > ring->capacity)
+    {
+        map_type = D3D11_MAP_WRITE_DISCARD;
+        ring->cursor = 0;
+        ring->generation += 1;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped_subresource = {};
+    win32_assume_hr(d3d11.device_ctx->Map(ring->buffer, 0, map_type, 0, &mapped_subresource));
+
+    void *result = (U8 *)mapped_subresource.pData + ring->cursor*ring->stride;
+    *out_first = ring->cursor;
+    ring->cursor += count;
+    stats->upload_bytes += count*ring->stride;
+    return result;
+}
+
 function void
-dwrite_pack_glyphs_in_run_to_atlas(B32 is_cleartype,
-                                   DWRITE_GLYPH_RUN run,
-                                   DWRITE_RENDERING_MODE1 rendering_mode,
-                                   DWRITE_MEASURING_MODE measuring_mode,
-                                   DWRITE_GRID_FIT_MODE grid_fit_mode,
-                                   Dwrite_Glyph_Table *glyph_table,
-                                   Bitmap atlas,
-                                   Bin *atlas_partition_sentinel,
-                                   Glyph_Cel_Array *glyph_cels)
+d3d11_ring_unmap(D3d11_Ring *ring)
 {
-    HRESULT hr = S_OK;
+    d3d11.device_ctx->Unmap(ring->buffer, 0);
+}
 
-    Temporary_Arena scratch = scratch_begin();
+// @Note: Our px grow upwards, D3D11's rects downwards.
+function D3D11_RECT
+d3d11_scissor_from_clip(AABB2 clip_px, U32 width, U32 height)
+{
+    F32 w = (F32)width;
+    F32 h = (F32)height;
+
+    D3D11_RECT result = {};
+    result.left   = (LONG)max(0.0f, min(w, floorf(clip_px.min.x)));
+    result.right  = (LONG)max(0.0f, min(w, ceilf(clip_px.max.x)));
+    result.top    = (LONG)max(0.0f, min(h, h - ceilf(clip_px.max.y)));
+    result.bottom = (LONG)max(0.0f, min(h, h - floorf(clip_px.min.y)));
+    return result;
+}
 
-    U64 glyph_count = arrlenu(run.glyphIndices);
-    IDWriteFontFace5 *font_face = (IDWriteFontFace5 *)run.fontFace;
+function Frame_Key
+frame_key_make(U32 window_width, U32 window_height, AABB2 box_container, U64 top_line, F32 top_offset_px, F64 time, U64 atlas_generation)
+{
+    Frame_Key result = {};
+    result.window_width     = window_width;
+    result.window_height    = window_height;
+    result.box_container    = box_container;
+    result.top_line         = top_line;
+    result.top_offset_px    = top_offset_px;
+    result.time             = time;
+    result.atlas_generation = atlas_generation;
+    return result;
+}
 
-    Dwrite_Font_Table_Entry *font_entry = dwrite_get_entry_from_font_table(font_face);
-    assert(font_entry);
-    Dwrite_Font_Metrics font_metrics = font_entry->metrics;
+function B32
+frame_key_equals(Frame_Key *a, Frame_Key *b)
+{
+    B32 result = (a->window_width == b->window_width && a->window_height == b->window_height &&
+                  memory_equal(&a->box_container, &b->box_container, sizeof(AABB2)) &&
+                  a->top_line == b->top_line && a->top_offset_px == b->top_offset_px &&
+                  a->time == b->time && a->atlas_generation == b->atlas_generation);
+    return result;
+}
 
-    DWRITE_TEXTURE_TYPE texture_type = (is_cleartype) ? DWRITE_TEXTURE_CLEARTYPE_3x1 : DWRITE_TEXTURE_ALIASED_1x1;
+function void
+d3d11_begin_pass(D3d11_Pipeline *p, U32 width, U32 height)
+{
+    FLOAT background_color[4] = {0.12f, 0.12f, 0.12f, 1.0f};
+    d3d11.device_ctx->ClearRenderTargetView(d3d11.framebuffer_view, background_color);
 
-    // Check if each glyph in the run exists in the inner hash table.
-    for (U32 i = 0; i < glyph_count; ++i)
+    D3D11_VIEWPORT viewport = {};
     {
-        U16 glyph_index = run.glyphIndices[i];
+        viewport.TopLeftX = 0.0f;
+        viewport.TopLeftY = 0.0f;
+        viewport.Width    = (FLOAT)(width);
+        viewport.Height   = (FLOAT)(height);
+        viewport.MinDepth = 0.0f;
+        viewport.MaxDepth = 1.0f;
+    }
+    d3d11.device_ctx->RSSetViewports(1, &viewport);
 
-        Dwrite_Glyph_Table_Entry *entry = dwrite_get_glyph_entry_from_table(*glyph_table, glyph_index);
+    d3d11.device_ctx->OMSetRenderTargets(1, &d3d11.framebuffer_view, NULL/*Depth-Stencil View*/);
+    d3d11.device_ctx->VSSetConstantBuffers(0, 1, &p->view_constant_buffer);
+    d3d11.device_ctx->RSSetState(p->rasterizer_state);
+    d3d11.device_ctx->IASetIndexBuffer(p->index_buffer, DXGI_FORMAT_R16_UINT, 0/*offset*/);
+    d3d11.device_ctx->PSSetSamplers(0, 1, &p->sampler_state);
 
-        if (! entry) // glyph index doesn't exist in the inner-table
-        {
-            // Get single glyph's metrics.
-            DWRITE_GLYPH_METRICS metrics = {};
-            win32_assume_hr(font_face->GetDesignGlyphMetrics(&glyph_index, 1, &metrics, run.isSideways));
+    p->has_last_state = false;
+}
 
-            // CreateGlyphRunAnalysis() doesn't support DWRITE_RENDERING_MODE_OUTLINE.
-            // We won't bother big glyphs. (many hundreds of pt)
-            if (rendering_mode == DWRITE_RENDERING_MODE1_OUTLINE)
-            {
-                rendering_mode = DWRITE_RENDERING_MODE1_NATURAL_SYMMETRIC; 
-            }
+// @Note: Only sets what differs from the draw before.
+function void
+d3d11_issue_draw(D3d11_Pipeline *p, D3d11_Draw *draw, U32 width, U32 height, Render_Stats *stats)
+{
+    Render_State state = draw->state;
+    Render_State last_state = p->last_state;
+    B32 is_instance = (state.shader == RENDER_SHADER_GLYPH);
+    D3d11_Ring *ring = (is_instance) ? &p->instance_ring : &p->vertex_ring;
+
+    B32 is_first = (! p->has_last_state);
+    B32 shader_changed = (is_first || state.shader != last_state.shader);
+    B32 blend_changed  = (is_first || state.blend != last_state.blend);
+    B32 page_changed   = (shader_changed || state.page != last_state.page);
+    B32 clip_changed   = (is_first || ! memory_equal(&state.clip_px, &last_state.clip_px, sizeof(AABB2)));
+
+    if (shader_changed)
+    {
+        UINT stride = ring->stride;
+        UINT offset = 0;
+        d3d11.device_ctx->IASetVertexBuffers(0, 1, &ring->buffer, &stride, &offset);
+        d3d11.device_ctx->IASetInputLayout((is_instance) ? p->instance_input_layout : p->quad_input_layout);
+        d3d11.device_ctx->IASetPrimitiveTopology((is_instance) ? D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP : D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        d3d11.device_ctx->VSSetShader(p->vertex_shaders[state.shader], NULL, 0);
+        d3d11.device_ctx->PSSetShader(p->pixel_shaders[state.shader], NULL, 0);
+    }
+    if (blend_changed)
+    {
+        d3d11.device_ctx->OMSetBlendState(p->blend_states[state.blend], NULL, 0xffffffff);
+    }
+    if (page_changed)
+    {
+        // @Todo: Textured quads only know the one atlas page.
+        assert(state.page == 0);
+        ID3D11ShaderResourceView *view = (is_instance) ? p->atlas_array_view : p->texture_view;
+        d3d11.device_ctx->PSSetShaderResources(0, 1, &view);
+    }
+    if (clip_changed)
+    {
+        D3D11_RECT scissor = d3d11_scissor_from_clip(state.clip_px, width, height);
+        d3d11.device_ctx->RSSetScissorRects(1, &scissor);
+    }
+    if (shader_changed || blend_changed || page_changed || clip_changed)
+    { stats->state_change_count += 1; }
 
-            DWRITE_GLYPH_RUN single_glyph_run = {};
-            {
-                single_glyph_run.fontFace      = font_face;
-                single_glyph_run.fontEmSize    = run.fontEmSize;
-                single_glyph_run.glyphCount    = 1;
-                single_glyph_run.glyphIndices  = &glyph_index;
-                single_glyph_run.glyphAdvances = NULL;
-                single_glyph_run.glyphOffsets  = NULL;
-                single_glyph_run.isSideways    = run.isSideways;
-                single_glyph_run.bidiLevel     = run.bidiLevel;
-            }
+    p->has_last_state = true;
+    p->last_state = state;
 
-            IDWriteGlyphRunAnalysis *analysis = NULL;
-            win32_assume_hr(dwrite.factory->CreateGlyphRunAnalysis(&single_glyph_run,
-                                                                   NULL, // transform
-                                                                   rendering_mode,
-                                                                   measuring_mode,
-                                                                   grid_fit_mode,
-                                                                   is_cleartype ? DWRITE_TEXT_ANTIALIAS_MODE_CLEARTYPE : DWRITE_TEXT_ANTIALIAS_MODE_GRAYSCALE,
-                                                                   0.0f, // baselineOriginX
-                                                                   0.0f, // baselineOriginY
-                                                                   &analysis));
-
-            // @Note: GetAlphaTextureBounds() -> RECT exaplanation.
-            //
-            // bounds.top ------++-----######--+
-            //   (-7)           ||  ############
-            //                  ||####      ####
-            //                  |###       #####
-            //  baseline ______ |###      #####|
-            //   origin        \|############# |
-            //  (= 0,0)         \|###########  |
-            //                  ++-------###---+
-            //                  ##      ###    |
-            // bounds.bottom ---+#########-----+
-            //    (+2)          |              |
-            //             bounds.left     bounds.right
-            //                 (-1)           (+14)
-            //
-
-            RECT bounds = {};
-            hr = analysis->GetAlphaTextureBounds(texture_type, &bounds);
-            if (FAILED(hr))
-            {
-                // @Todo: The font doesn't support DWRITE_TEXTURE_CLEARTYPE_3x1.
-                // Retry with DWRITE_TEXTURE_ALIASED_1x1.
-                assume(! "x");
-            }
+    if (is_instance)
+    { d3d11.device_ctx->DrawInstanced(4, draw->count, 0, draw->first); }
+    else
+    { d3d11.device_ctx->DrawIndexed(draw->count*6, 0/*StartIndexLocation*/, draw->first); }
+    stats->draw_count += 1;
+}
 
-            Glyph_Cel cel = {};
+// @Note: Each batch is gathered into its ring and drawn, in pieces if it's
+// bigger than the ring, and the draws are kept for d3d11_reissue_draws().
+function void
+d3d11_submit_batches(D3d11_Pipeline *p, Renderer *r, U32 width, U32 height)
+{
+    arrsetlen(p->draws, 0);
 
-            if ((bounds.right > bounds.left) && (bounds.bottom > bounds.top))
-            {
-                U32 blackbox_width  = bounds.right - bounds.left;
-                U32 blackbox_height = bounds.bottom - bounds.top;
-
-                U32 margin = 1;
-                U32 bitmap_width  = blackbox_width + 2*margin;
-                U32 bitmap_height = blackbox_height + 2*margin;
-
-                U32 rgb_bitmap_size = (is_cleartype) ? (blackbox_width*3)*blackbox_height : blackbox_width*blackbox_height; 
-                U8 *bitmap_data_rgb = (U8 *)push_size(scratch.arena, rgb_bitmap_size);
-                win32_assume_hr(analysis->CreateAlphaTexture(texture_type, &bounds, bitmap_data_rgb, rgb_bitmap_size));
-
-                B32 fit = false;
-                U32 x1 = 0;
-                U32 y1 = 0;
-                U32 x2 = 0;
-                U32 y2 = 0;
-
-                dll_for(atlas_partition_sentinel, partition)
-                {
-                    if (! partition->occupied)
-                    {
-                        U32 w1 = partition->w;
-                        U32 h1 = partition->h;
-                        U32 w2 = bitmap_width;
-                        U32 h2 = bitmap_height;
-
-                        if (w1 >= w2 && h1 >= h2)
-                        {
-                            fit = true;
-
-                            x1 = partition->x;
-                            y1 = partition->y;
-                            x2 = x1 + w2;
-                            y2 = y1 + h2;
-
-                            U32 dx[3] = {w2, 0, w2};
-                            U32 dy[3] = {0, h2, h2};
-                            U32 nw[3] = {w1-w2, w2, w1-w2};
-                            U32 nh[3] = {h2, h1-h2, h1-h2};
-
-                            for (U32 npi = 0; npi < 3; ++npi)
-                            {
-                                Bin *new_partition = new Bin;
-                                new_partition->occupied = false;
-                                new_partition->x = x1 + dx[npi];
-                                new_partition->y = y1 + dy[npi];
-                                new_partition->w = nw[npi];
-                                new_partition->h = nh[npi];
-                                dll_append(atlas_partition_sentinel, new_partition);
-                            }
-
-                            partition->occupied = true;
-                            partition->w = w2;
-                            partition->h = h2;
-
-                            // @Todo: Check dll op.
-                            //        Move to the end of the list so search might be faster.
-                            partition->prev->next = partition->next;
-                            partition->next->prev = partition->prev;
-                            partition->prev = atlas_partition_sentinel->prev;
-                            partition->next = atlas_partition_sentinel;
-                            atlas_partition_sentinel->prev->next = partition;
-                            atlas_partition_sentinel->prev = partition;
-
-                            break;
-                        }
-                    }
-                }
-
-                if (fit)
-                {
-                    // RGB to RGBA
-                    for (U32 r = 0; r < blackbox_height; ++r)
-                    {
-                        for (U32 c = 0; c < blackbox_width; ++c)
-                        {
-                            U8 *dst = atlas.data + (y1+r+margin)*atlas.pitch + (x1+c+margin)*4;
-                            U8 *src = bitmap_data_rgb + r*blackbox_width*3 + c*3;
-                            *(U32 *)dst = *(U32 *)src;
-#if 0
-                            if (src[0] == 0 && src[1] == 0  && src[2] == 0)
-                            {
-                                dst[3] = 0x00; 
-                            }
-                            else
-                            {
-                                dst[3] = 0xff; 
-                            }
-#else
-                            dst[3] = 0xff; 
-#endif
-                        }
-                    }
-                }
-                else
-                {
-                    assume(! "Couldn't fit in the atlas");
-                }
-
-                cel.is_empty     = false;
-                cel.uv_min       = {(F32)(x1 + margin) / (F32)atlas.width, (F32)(y1 + margin) / (F32)atlas.height};
-                cel.uv_max       = {(F32)(x2 - margin) / (F32)atlas.width, (F32)(y2 - margin) / (F32)atlas.height};
-                cel.width_px     = (F32)blackbox_width;
-                cel.height_px    = (F32)blackbox_height;
-                cel.offset_px.x  = (F32)bounds.left;
-                cel.offset_px.y  = (F32)-bounds.top;
-            }
-            else
+    for (U32 bi = 0; bi < arrlenu(r->batches); ++bi)
+    {
+        Render_Batch *batch = r->batches + bi;
+        B32 is_instance = (batch->state.shader == RENDER_SHADER_GLYPH);
+        D3d11_Ring *ring = (is_instance) ? &p->instance_ring : &p->vertex_ring;
+        U32 ring_elements_per_element = (is_instance) ? 1 : 4;
+
+        U32 max_count = ring->capacity / ring_elements_per_element;
+        for (U32 done = 0; done < batch->element_count;)
+        {
+            U32 count = min(batch->element_count - done, max_count);
+            U32 first = 0;
             {
-                cel.is_empty     = true;
-                cel.uv_min       = V2{0.0f, 0.0f};
-                cel.uv_max       = V2{0.0f, 0.0f};
-                cel.width_px     = 0.0f;
-                cel.height_px    = 0.0f;
-                cel.offset_px.x  = 0.0f;
-                cel.offset_px.y  = 0.0f;
+                profile_scope(PROFILE_STAGE_UPLOAD_BATCHES);
+                void *dst = d3d11_ring_map(ring, count*ring_elements_per_element, &first, &r->stats);
+                render_gather_batch(r, batch, done, count, dst);
+                d3d11_ring_unmap(ring);
             }
 
-            dar_push(glyph_cels, cel);
-            dwrite_insert_glyph_cel_to_table(glyph_table, glyph_index, cel);
+            D3d11_Draw draw = {batch->state, first, count, ring->generation};
+            arrput(p->draws, draw);
+            d3d11_issue_draw(p, &draw, width, height, &r->stats);
+
+            done += count;
+        }
+    }
+}
+
+// @Note: False once a ring wrapped over what the last frame drew from.
+function B32
+d3d11_draws_are_resident(D3d11_Pipeline *p)
+{
+    for (U32 di = 0; di < arrlenu(p->draws); ++di)
+    {
+        D3d11_Draw *draw = p->draws + di;
+        D3d11_Ring *ring = (draw->state.shader == RENDER_SHADER_GLYPH) ? &p->instance_ring : &p->vertex_ring;
+        if (draw->ring_generation != ring->generation)
+        { return false; }
+    }
+    return true;
+}
+
+function void
+d3d11_reissue_draws(D3d11_Pipeline *p, U32 width, U32 height, Render_Stats *stats)
+{
+    for (U32 di = 0; di < arrlenu(p->draws); ++di)
+    { d3d11_issue_draw(p, p->draws + di, width, height, stats); }
+}
+
+// @Note: Shaping, rasterization, layout and command recording of one frame,
+// on the worker. Only the builder and the slot are touched.
+function void
+frame_build(Frame_Builder *b, Frame_Slot *slot)
+{
+    profile_scope(PROFILE_STAGE_FRAME_BUILD);
+
+    U64 begin_counter = os_read_timer();
+
+    Frame_Input input = slot->input;
+    Renderer *r = &slot->renderer;
+    Paragraph_Cache *paragraph_cache = &b->engine->paragraph_cache;
+    Glyph_Atlas *glyph_atlas = &b->engine->glyph_atlas;
+
+    arena_clear(slot->arena);
+    render_begin_frame(r, slot->arena);
+
+    AABB2 box_container = AABB2{input.container_origin_px + V2{0.0f, -input.container_height_px},
+                                input.container_origin_px + V2{input.container_width_px, 0.0f}};
+
+    { // @Temporary: Draw container
+        render_set_state(r, Render_State{RENDER_LAYER_BACKGROUND, RENDER_SHADER_PANEL, RENDER_BLEND_ALPHA, 0, RENDER_CLIP_NONE});
+        render_quad_px_min_max(r, box_container.min, box_container.max);
+    }
+
+    // @Note: Scrolling is anchored to a paragraph, since paragraphs that
+    //        were never shaped have no known height. Moving the anchor
+    //        only shapes the paragraphs it passes over.
+    b->top_offset_px += input.scroll_px;
+    while (b->top_offset_px < 0.0f && b->top_line > 0)
+    {
+        --b->top_line;
+        b->top_offset_px += paragraph_cache_get(paragraph_cache, b->top_line, input.container_width_px)->wrap.height_px;
+    }
+    b->top_offset_px = max(b->top_offset_px, 0.0f);
 
-            analysis->Release();
+    for (;;)
+    {
+        Shaped_Paragraph *sp = paragraph_cache_get(paragraph_cache, b->top_line, input.container_width_px);
+        if (b->top_line + 1 < b->source->line_count && b->top_offset_px >= sp->wrap.height_px)
+        {
+            b->top_offset_px -= sp->wrap.height_px;
+            ++b->top_line;
+        }
+        else
+        {
+            b->top_offset_px = min(b->top_offset_px, sp->wrap.height_px);
+            break;
         }
-        else  // glyph index exists in the inner-table
+    }
+
+    // Glyphs are clipped on the CPU already, the scissor is only a backstop.
+    render_set_state(r, Render_State{RENDER_LAYER_TEXT, RENDER_SHADER_GLYPH, RENDER_BLEND_MAX, 0, box_container});
+
+    F32 paragraph_y_px = -b->top_offset_px;
+    U64 prefetched_end = b->top_line;
+    for (U64 line = b->top_line; line < b->source->line_count && paragraph_y_px < input.container_height_px; ++line)
+    {
+        if (line >= prefetched_end)
         {
-            Glyph_Cel cel = entry->cel;
-            dar_push(glyph_cels, cel);
+            paragraph_cache_prefetch(paragraph_cache, line, FRAME_PREFETCH_LINE_COUNT, input.container_width_px);
+            prefetched_end = line + FRAME_PREFETCH_LINE_COUNT;
         }
+
+        Shaped_Paragraph *sp = paragraph_cache_get(paragraph_cache, line, input.container_width_px);
+        render_paragraph(r, glyph_atlas, sp, paragraph_y_px, input.container_origin_px, input.container_width_px, input.container_height_px);
+        paragraph_y_px += sp->wrap.height_px;
+    }
+
+    if (b->terminal)
+    { // Terminal grid, 1% of the cells changing per frame. (--terminal-demo)
+        Terminal_Grid *terminal = b->terminal;
+        U16 alphabet[] = {'a', 'b', 'c', '-', '>', '=', '!', '<', '|', ' '};
+        U32 cell_count = terminal->column_count*terminal->row_count;
+        for (U32 i = 0; i < cell_count/100; ++i)
+        {
+            U32 cell = (U32)rand() % cell_count;
+            U16 c = alphabet[(U32)rand() % array_count(alphabet)];
+            terminal_grid_write(terminal, cell / terminal->column_count, cell % terminal->column_count, &c, 1);
+        }
+
+        terminal_grid_set_origin(terminal, V2{10.0f, (F32)input.window_height - 10.0f});
+        terminal_grid_update(terminal);
+
+        render_set_state(r, Render_State{RENDER_LAYER_TEXT, RENDER_SHADER_GLYPH, RENDER_BLEND_MAX, 0, RENDER_CLIP_NONE});
+        render_terminal_grid(r, terminal);
+    }
+
+    if (b->show_label_demo)
+    { // Label batch, a property grid down the left edge. (--label-demo)
+        U32 row_count = 40;
+        F32 row_height_px = b->pt_per_em*b->px_per_inch/72.0f*1.5f;
+        Label *labels = push_array(slot->arena, Label, row_count*2);
+        for (U32 row = 0; row < row_count; ++row)
+        {
+            wchar_t buf[64];
+            S32 key_length   = swprintf(buf, array_count(buf), L"property_%u", row);
+            labels[row*2 + 0].text = label_string_make(slot->arena, (U16 *)buf, (U32)key_length);
+            S32 value_length = swprintf(buf, array_count(buf), L"%.3f", input.time*(row + 1));
+            labels[row*2 + 1].text = label_string_make(slot->arena, (U16 *)buf, (U32)value_length);
+
+            F32 top_px = (F32)input.window_height - row*row_height_px;
+            for (U32 column = 0; column < 2; ++column)
+            {
+                Label *label = labels + row*2 + column;
+                label->style   = Label_Style{b->base_family, b->pt_per_em*0.75f};
+                label->rect_px = AABB2{V2{10.0f + column*160.0f, top_px - row_height_px}, V2{160.0f + column*160.0f, top_px}};
+            }
+        }
+
+        label_layout_batch(&b->engine->label_cache, labels, row_count*2, &b->label_glyphs);
+        render_set_state(r, Render_State{RENDER_LAYER_TEXT, RENDER_SHADER_GLYPH, RENDER_BLEND_MAX, 0, RENDER_CLIP_NONE});
+        render_label_glyphs(r, glyph_atlas, &b->label_glyphs, labels, row_count*2);
+    }
+
+    render_build_batches(r);
+
+    // The atlas keeps changing under the next build, so the slot takes a
+    // copy of it whenever it's behind.
+    U64 atlas_generation = glyph_atlas_get_generation(glyph_atlas);
+    if (slot->atlas_generation != atlas_generation)
+    {
+        memory_copy(slot->atlas.data, glyph_atlas->bitmap.data, glyph_atlas->bitmap.pitch*glyph_atlas->bitmap.height);
+        slot->atlas_generation = atlas_generation;
+    }
+
+    // Glyphs rasterized during this frame are part of its key, and the
+    // anchor may have been normalized.
+    slot->key = frame_key_make(input.window_width, input.window_height, box_container, b->top_line, b->top_offset_px, input.time, atlas_generation);
+    slot->build_seconds = (F64)(os_read_timer() - begin_counter)*b->counter_frequency_inverse;
+    slot->arena_high_water = max(slot->arena_high_water, arena_pos(slot->arena));
+}
+
+function DWORD WINAPI
+frame_pipeline_thread_proc(LPVOID param)
+{
+    Frame_Pipeline *pipeline = (Frame_Pipeline *)param;
+
+    for (;;)
+    {
+        WaitForSingleObject(pipeline->kick_semaphore, INFINITE);
+        if (pipeline->should_quit)
+        { break; }
+
+        frame_build(pipeline->builder, pipeline->building);
+        ReleaseSemaphore(pipeline->done_semaphore, 1, NULL);
+    }
+
+    return 0;
+}
+
+// @Note: The atlas copies come from the arena, frames from arenas of their own.
+function void
+frame_pipeline_start(Frame_Pipeline *pipeline, Frame_Builder *builder, Arena *arena)
+{
+    pipeline->builder = builder;
+
+    Bitmap atlas = builder->engine->glyph_atlas.bitmap;
+    for (U32 si = 0; si < array_count(pipeline->slots); ++si)
+    {
+        Frame_Slot *slot = pipeline->slots + si;
+        slot->arena = arena_alloc();
+        slot->atlas = atlas;
+        slot->atlas.data = (U8 *)push_size(arena, atlas.pitch*atlas.height);
+        slot->atlas_generation = (U64)-1;
+    }
+
+    pipeline->kick_semaphore = CreateSemaphoreW(NULL, 0, 1, NULL);
+    pipeline->done_semaphore = CreateSemaphoreW(NULL, 0, 1, NULL);
+    pipeline->thread = CreateThread(NULL, 0, frame_pipeline_thread_proc, pipeline, 0, NULL);
+    assume(pipeline->kick_semaphore && pipeline->done_semaphore && pipeline->thread);
+}
+
+// @Note: Hands the slot to the worker. The semaphores order everything the
+// main thread wrote before the kick before the build, and everything the
+// build wrote before the wait returns.
+function void
+frame_pipeline_kick(Frame_Pipeline *pipeline, Frame_Slot *slot, Frame_Input input)
+{
+    assert(! pipeline->building);
+    slot->input = input;
+    pipeline->building = slot;
+    ReleaseSemaphore(pipeline->kick_semaphore, 1, NULL);
+}
+
+function Frame_Slot *
+frame_pipeline_wait(Frame_Pipeline *pipeline)
+{
+    assert(pipeline->building);
+    WaitForSingleObject(pipeline->done_semaphore, INFINITE);
+    Frame_Slot *result = pipeline->building;
+    pipeline->building = NULL;
+    return result;
+}
+
+function void
+frame_pipeline_stop(Frame_Pipeline *pipeline)
+{
+    if (pipeline->building)
+    { frame_pipeline_wait(pipeline); }
+
+    pipeline->should_quit = true;
+    ReleaseSemaphore(pipeline->kick_semaphore, 1, NULL);
+    WaitForSingleObject(pipeline->thread, INFINITE);
+
+    CloseHandle(pipeline->thread);
+    CloseHandle(pipeline->kick_semaphore);
+    CloseHandle(pipeline->done_semaphore);
+}
+
+// @Note: Uploads and draws a built frame, on the main thread.
+function void
+d3d11_present_frame(D3d11_Pipeline *p, Frame_Slot *slot)
+{
+    profile_scope(PROFILE_STAGE_PRESENT);
+
+    Renderer *r = &slot->renderer;
+    U32 width  = slot->input.window_width;
+    U32 height = slot->input.window_height;
+
+    // ---------------------------
+    // @Note: Update view constants. px to NDC happens in the vertex shaders.
+    {
+        profile_scope(PROFILE_STAGE_UPLOAD_CONSTANTS);
+
+        View_Constants constants = {};
+        constants.px_to_ndc   = V2{2.0f / (F32)width, 2.0f / (F32)height};
+        constants.texel_to_uv = V2{1.0f / (F32)slot->atlas.width, 1.0f / (F32)slot->atlas.height};
+
+        D3D11_MAPPED_SUBRESOURCE mapped_subresource = {};
+        d3d11.device_ctx->Map(p->view_constant_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_subresource);
+        memory_copy(mapped_subresource.pData, &constants, sizeof(constants));
+        d3d11.device_ctx->Unmap(p->view_constant_buffer, 0);
+    }
+
+    // ---------------------------
+    // @Note: Update atlas, if a glyph was added since the last upload.
+    if (p->uploaded_atlas_generation != slot->atlas_generation)
+    {
+        profile_scope(PROFILE_STAGE_UPLOAD_ATLAS);
+
+        Bitmap *atlas = &slot->atlas;
+
+        D3D11_MAPPED_SUBRESOURCE mapped_subresource = {};
+        d3d11.device_ctx->Map(p->atlas_texture, 0/*index # of subresource*/, D3D11_MAP_WRITE_DISCARD, 0/*flags*/, &mapped_subresource);
+        memory_copy(mapped_subresource.pData, atlas->data, sizeof(atlas->data[0])*atlas->pitch*atlas->height);
+        d3d11.device_ctx->Unmap(p->atlas_texture, 0);
+
+        r->stats.upload_bytes += sizeof(atlas->data[0])*atlas->pitch*atlas->height;
+        p->uploaded_atlas_generation = slot->atlas_generation;
     }
 
-    scratch_end(scratch);
+    d3d11_begin_pass(p, width, height);
+    d3d11_submit_batches(p, r, width, height);
+
+    d3d11.swapchain->Present(1, 0);
 }
 
 function int
@@ -278,6 +719,10 @@ main_entry(void)
     Arena *permanent_arena = arena_alloc();
     F64 counter_frequency_inverse = (1.0 / (F64)os_query_timer_frequency());
 
+#if PROFILE_ENABLED
+    profile_init();
+#endif
+
     Os_Window *window = os_create_window(1920, 1080, L"fönster");
     if (! window)
     {
@@ -288,7 +733,9 @@ main_entry(void)
     F32 pt_per_em   = 20.0f;
     F32 px_per_inch = (F32)os_get_dpi(window);
 
-    dwrite_init();
+    Dwrite_State *dwrite = push_struct(permanent_arena, Dwrite_State);
+    dwrite_init(dwrite);
+    dwrite->use_word_cache = true;
 
     wchar_t *fonts[] = 
     {
@@ -302,38 +749,94 @@ main_entry(void)
     wchar_t *base_font_family_name = fonts[0];
 
     {
-        Dwrite_Get_Base_Font_Family_Index_Result family = dwrite_get_base_font_family_index(base_font_family_name);
+        Dwrite_Get_Base_Font_Family_Index_Result family = dwrite_get_base_font_family_index(dwrite, base_font_family_name);
         assume(family.exists);
     }
 
 
     B32 is_cleartype = TRUE;
-    DWRITE_GLYPH_RUN *glyph_runs = NULL;
 
-    Bitmap atlas = {};
-    {
-        atlas.width  = 1024;
-        atlas.height = 1024;
-        atlas.pitch  = (atlas.width << 2);
-        atlas.data   = (U8 *)push_size(permanent_arena, atlas.pitch*atlas.height);
-    }
+    Font_Backend font_backend = dwrite_font_backend(dwrite, px_per_inch, is_cleartype);
 
-    Bin *atlas_partition_sentinel = push_struct(permanent_arena, Bin);
+    // ------------------------------
+    // @Note: Open the file given on the command line, or fall back to the
+    //        sample texts, one paragraph each. Either way nothing is shaped
+    //        up front; paragraphs are shaped as they scroll into view.
+    //        With --trace-capture <path>, whatever DWrite answers is also
+    //        recorded there, for bench.exe --replay. --label-demo draws a
+    //        property grid of labels over the text, --terminal-demo a
+    //        terminal grid that keeps changing.
+    Text_Source source = {};
+    B32 show_label_demo = false;
+    B32 show_terminal_demo = false;
     {
-        Bin *head = push_struct(permanent_arena, Bin);
+        B32 opened = false;
+
+        int argc = 0;
+        wchar_t **argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+        for (int ai = 1; argv && ai < argc; ++ai)
+        {
+            if (wcscmp(argv[ai], L"--label-demo") == 0)
+            {
+                show_label_demo = true;
+                continue;
+            }
+            if (wcscmp(argv[ai], L"--terminal-demo") == 0)
+            {
+                show_terminal_demo = true;
+                continue;
+            }
+
+            B32 is_trace_capture = (wcscmp(argv[ai], L"--trace-capture") == 0 && ai + 1 < argc);
+            if (is_trace_capture)
+            { ai += 1; }
+
+            int length = WideCharToMultiByte(CP_UTF8, 0, argv[ai], -1, NULL, 0, NULL, NULL);
+            char *path = push_array(permanent_arena, char, length);
+            WideCharToMultiByte(CP_UTF8, 0, argv[ai], -1, path, length, NULL, NULL);
+
+            if (is_trace_capture)
+            {
+                // @Note: Owns the DWrite backend from here on, and finishes the trace when it's released.
+                Font_Trace_Recorder *recorder = push_struct(permanent_arena, Font_Trace_Recorder);
+                if (font_trace_recorder_init(recorder, font_backend, path))
+                { font_backend = font_trace_recorder_backend(recorder); }
+            }
+            else if (! opened)
+            {
+                opened = text_source_open_file(&source, path);
+            }
+        }
+        LocalFree(argv);
+
+        if (! opened)
         {
-            head->prev = atlas_partition_sentinel;
-            head->next = atlas_partition_sentinel;
-            head->occupied = false;
-            head->x = 0;
-            head->y = 0;
-            head->w = atlas.width;
-            head->h = atlas.height;
+            wchar_t *samples = NULL;
+            for (U32 i = 0; i < array_count(test_texts); ++i)
+            {
+                U64 len = wcslen(test_texts[i]);
+                U64 to = arrlenu(samples);
+                arrsetlen(samples, to + len + 1);
+                memory_copy(samples + to, test_texts[i], len*sizeof(wchar_t));
+                samples[to + len] = L'\n';
+            }
+            text_source_open_memory(&source, (U8 *)samples, arrlenu(samples)*sizeof(wchar_t), TEXT_ENCODING_UTF16LE);
         }
-        atlas_partition_sentinel->prev = head;
-        atlas_partition_sentinel->next = head;
     }
 
+    // @Note: Driven by the frame worker only, it's the one that shapes and rasterizes.
+    Job_System job_system = {};
+    job_system_init(&job_system, 0);
+
+    // @Note: The engine owns the DWrite state (and the trace recorder) from here on.
+    Engine engine = {};
+    {
+        Engine_Config config = engine_default_config(font_backend, &source, base_font_family_name, pt_per_em);
+        config.jobs = &job_system;
+        engine_init(&engine, &config);
+    }
+    Bitmap *atlas = &engine.glyph_atlas.bitmap;
+
 
     // @Hack: HWND
     d3d11_init(win32_get_hwnd(window));
@@ -357,6 +860,12 @@ main_entry(void)
     ID3D11PixelShader *panel_ps = NULL;
     { win32_assume_hr(d3d11.device->CreatePixelShader(g_panel_ps_main, sizeof(g_panel_ps_main), NULL, &panel_ps)); }
 
+    ID3D11VertexShader *glyph_vs = NULL;
+    { win32_assume_hr(d3d11.device->CreateVertexShader(g_glyph_vs_main, sizeof(g_glyph_vs_main), NULL, &glyph_vs)); }
+
+    ID3D11PixelShader *glyph_ps = NULL;
+    { win32_assume_hr(d3d11.device->CreatePixelShader(g_glyph_ps_main, sizeof(g_glyph_ps_main), NULL, &glyph_ps)); }
+
 
 
     // ----------------------------
@@ -371,57 +880,94 @@ main_entry(void)
         win32_assume_hr(d3d11.device->CreateInputLayout(desc, array_count(desc), g_vs_main, sizeof(g_vs_main), &input_layout));
     }
 
+    // @Note: Everything per instance, the corner comes from SV_VertexID.
+    ID3D11InputLayout *glyph_input_layout = NULL;
+    {
+        D3D11_INPUT_ELEMENT_DESC desc[] =
+        {
+            { "POS",   0, DXGI_FORMAT_R32G32_FLOAT,      0, 0,                            D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "RECT",  0, DXGI_FORMAT_R16G16B16A16_UINT, 0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM,    0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+            { "PAGE",  0, DXGI_FORMAT_R32_UINT,          0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_INSTANCE_DATA, 1 }
+        };
+        win32_assume_hr(d3d11.device->CreateInputLayout(desc, array_count(desc), g_glyph_vs_main, sizeof(g_glyph_vs_main), &glyph_input_layout));
+    }
+
 
     V2U client_size   = os_get_client_size(window);
     U32 window_width  = client_size.x;
     U32 window_height = client_size.y;
 
     //-------------------------------------
-    // @Note: Create Vertex Buffer
-    ID3D11Buffer *vertex_buffer = NULL;
+    // @Note: Create Vertex Ring. The index buffer below covers all of it.
+    D3d11_Ring vertex_ring = d3d11_ring_create(sizeof(Vertex), MAX_VERTEX_COUNT);
+
+
+
+    // -----------------------------
+    // @Note: Create Index Buffer. The quad pattern never changes.
+    ID3D11Buffer *index_buffer = NULL;
     {
+        U16 *indices = push_array(permanent_arena, U16, MAX_INDEX_COUNT);
+        render_fill_quad_indices(indices, MAX_QUAD_COUNT);
+
         D3D11_BUFFER_DESC desc = {};
         {
-            desc.ByteWidth       = sizeof(renderer.vertices[0])*MAX_VERTEX_COUNT;
-            desc.Usage           = D3D11_USAGE_DYNAMIC;
-            desc.BindFlags       = D3D11_BIND_VERTEX_BUFFER;
-            desc.CPUAccessFlags  = D3D11_CPU_ACCESS_WRITE;
-            desc.MiscFlags       = 0;
+            desc.Usage          = D3D11_USAGE_IMMUTABLE;
+            desc.ByteWidth      = sizeof(indices[0])*MAX_INDEX_COUNT;
+            desc.BindFlags      = D3D11_BIND_INDEX_BUFFER;
+            desc.CPUAccessFlags = 0;
+            desc.MiscFlags      = 0;
         }
 
         D3D11_SUBRESOURCE_DATA subresource = {};
         {
-            subresource.pSysMem          = renderer.vertices;
+            subresource.pSysMem          = indices;
             subresource.SysMemPitch      = 0;
             subresource.SysMemSlicePitch = 0;
         }
 
-        win32_assume_hr(d3d11.device->CreateBuffer(&desc, &subresource, &vertex_buffer));
+        win32_assume_hr(d3d11.device->CreateBuffer(&desc, &subresource, &index_buffer));
     }
 
 
 
     // -----------------------------
-    // @Note: Create Index Buffer
-    ID3D11Buffer *index_buffer = NULL;
+    // @Note: Create Instance Ring
+    D3d11_Ring instance_ring = d3d11_ring_create(sizeof(Glyph_Instance), INSTANCE_RING_COUNT);
+
+
+
+    // -----------------------------
+    // @Note: Create Constant Buffer
+    ID3D11Buffer *view_constant_buffer = NULL;
     {
         D3D11_BUFFER_DESC desc = {};
         {
             desc.Usage          = D3D11_USAGE_DYNAMIC;
-            desc.ByteWidth      = sizeof( renderer.indices[0] ) * MAX_INDEX_COUNT;
-            desc.BindFlags      = D3D11_BIND_INDEX_BUFFER;
+            desc.ByteWidth      = sizeof(View_Constants);
+            desc.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
             desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
             desc.MiscFlags      = 0;
         }
 
-        D3D11_SUBRESOURCE_DATA subresource = {};
+        win32_assume_hr(d3d11.device->CreateBuffer(&desc, NULL, &view_constant_buffer));
+    }
+
+
+
+    // ------------------------------
+    // @Note: Create Rasterizer State. Defaults, plus the scissor for clip rects.
+    ID3D11RasterizerState *rasterizer_state = NULL;
+    {
+        D3D11_RASTERIZER_DESC desc = {};
         {
-            subresource.pSysMem          = renderer.indices;
-            subresource.SysMemPitch      = 0;
-            subresource.SysMemSlicePitch = 0;
+            desc.FillMode        = D3D11_FILL_SOLID;
+            desc.CullMode        = D3D11_CULL_BACK;
+            desc.DepthClipEnable = TRUE;
+            desc.ScissorEnable   = TRUE;
         }
-
-        win32_assume_hr(d3d11.device->CreateBuffer(&desc, &subresource, &index_buffer));
+        win32_assume_hr(d3d11.device->CreateRasterizerState(&desc, &rasterizer_state));
     }
 
 
@@ -450,8 +996,8 @@ main_entry(void)
     {
         D3D11_TEXTURE2D_DESC texture_desc = {};
         {
-            texture_desc.Width              = atlas.width;
-            texture_desc.Height             = atlas.height;
+            texture_desc.Width              = atlas->width;
+            texture_desc.Height             = atlas->height;
             texture_desc.MipLevels          = 1;
             texture_desc.ArraySize          = 1;
             texture_desc.SampleDesc.Count   = 1;
@@ -465,8 +1011,8 @@ main_entry(void)
 
         D3D11_SUBRESOURCE_DATA texture_subresource_data = {};
         {
-            texture_subresource_data.pSysMem      = atlas.data;
-            texture_subresource_data.SysMemPitch  = atlas.pitch;
+            texture_subresource_data.pSysMem      = atlas->data;
+            texture_subresource_data.SysMemPitch  = atlas->pitch;
         }
 
         d3d11.device->CreateTexture2D(&texture_desc, &texture_subresource_data, &d3d_atlas);
@@ -475,6 +1021,22 @@ main_entry(void)
     ID3D11ShaderResourceView *texture_view = NULL;
     d3d11.device->CreateShaderResourceView(d3d_atlas, NULL, &texture_view);
 
+    // @Note: The glyph shader samples the atlas as an array of pages. There's
+    //        only the one page for now.
+    ID3D11ShaderResourceView *atlas_array_view = NULL;
+    {
+        D3D11_SHADER_RESOURCE_VIEW_DESC view_desc = {};
+        {
+            view_desc.Format                         = is_cleartype ? DXGI_FORMAT_R8G8B8A8_UNORM : DXGI_FORMAT_R8_UNORM;
+            view_desc.ViewDimension                  = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+            view_desc.Texture2DArray.MostDetailedMip = 0;
+            view_desc.Texture2DArray.MipLevels       = 1;
+            view_desc.Texture2DArray.FirstArraySlice = 0;
+            view_desc.Texture2DArray.ArraySize       = 1;
+        }
+        win32_assume_hr(d3d11.device->CreateShaderResourceView(d3d_atlas, &view_desc, &atlas_array_view));
+    }
+
 
     // ------------------------------
     // @Note: Create Blend State
@@ -523,42 +1085,65 @@ main_entry(void)
         assume(SUCCEEDED(d3d11.device->CreateBlendState(&blend_desc, &glyph_blend_state)));
     }
 
-    wchar_t *test_texts[] = 
-    {
-        L"  Korean-> 모든 인간은 태어날 때부터 자유로우며 그 존엄과 권리에 있어 동등하다. 인간은 천부적으로 이성과 양심을 부여받았으며 서로 형제애의 정신으로 행동하여야 한다.",
-        L"  Old English-> Hwæt! wē Gār-Dena in ġēar-dagum þēod-cyninga þrym gefrūnon, hūðā æþelingas ellen fremedon",
-        L"  Welsh-> Genir pawb yn rhydd ac yn gydradd â’i gilydd mewn urddas a hawliau. Fe’u cynysgaeddir â rheswm a chydwybod, a dylai pawb ymddwyn y naill at y llall mewn ysbryd cymodlon.",
-        L"  vietnamese-> Mọi người đều có quyền rời khỏi bất cứ nước nào, kể cả nước mình, cũng như có quyền trở về nước mình.",
-        L"  Greek-> Όλοι οι άνθρωποι γεννιούνται ελεύθεροι και ίσοι στην αξιοπρέπεια και τα δικαιώματα. Είναι προικισμένοι με λογική και συνείδηση, και οφείλουν να συμπεριφέρονται μεταξύ τους με πνεύμα αδελφοσύνης.",
-        L"  Anatolian hieroglyphs-> 𔗷𔗬𔑈𔓯𔐤𔗷𔖶𔔆𔗐𔓱𔑣𔓢𔑈𔓷𔖻𔗔𔑏𔖱𔗷𔖶𔑦𔗬𔓯𔓷",
-        L"  Egpytion Hieroglyphs-> 𓇋𓅱𓐷𓄙𓐱𓅓𓐸𓐰𓈖𓎿𓊃𓐰𓏏𓀁𓐍𓐰𓂋𓇓𓏏𓐰𓈖𓋴𓉼𓐷𓎵𓐱𓏤𓐸𓐰𓂋𓇋𓏏𓐰𓆑𓀀𓏪𓆣𓐰𓂋𓅱𓂋𓐰𓄂𓐰𓏏𓀀𓇋𓅱",
-        L"  Armenian-> Բոլոր մարդիկ ծնվում են ազատ ու հավասար իրենց արժանապատվությամբ ու իրավունքներով։ Նրանք ունեն բանականություն ու խիղճ և միմյանց պետք է եղբայրաբար վերաբերվեն։",
-        L"  Russian-> Все люди рождаются свободными и равными в своем достоинстве и правах. Они наделены разумом и совестью и должны поступать в отношении друг друга в духе братства.",
-        L"  Ukrainian-> Всі люди народжуються вільними і рівними у своїй гідності та правах. Вони наділені розумом і совістю і повинні діяти у відношенні один до одного в дусі братерства.",
-        L"  Simplified Chinese-> 人人生而自由,在尊严和权利上一律平等。他们赋有理性和良心,并应以兄弟关系的精神相对待。",
-        L"  Traditional Chinese-> 人人生而自由，在尊嚴和權利上一律平等。他們賦有理性和良心，並應以兄弟關係的精神相對待。",
-        L"  Japanese-> すべての人間は、生まれながらにして自由であり、かつ、尊厳と権利とについて平等である。人間は、理性と良心とを授けられており、互いに同胞の精神をもって行動しなければならない。",
-        L"  Old Persian-> 𐏐𐎠𐎭𐎶𐏐𐎭𐎠𐎼𐎹𐎺𐎢𐏁𐏐𐎧𐏁𐎠𐎹𐎰𐎡𐎹𐏐𐎺𐏀𐎼𐎣𐏐𐎧𐏁𐎠𐎹𐎰𐎡𐎹𐏐𐎧𐏁𐎠𐎹𐎰𐎡𐎹𐎠𐎴𐎠𐎶𐏐𐎧𐏁𐎠𐎹𐎰𐎡𐎹𐏐𐎱𐎠𐎼𐎿𐎡𐎹𐏐𐎧𐏁𐎠𐎹𐎰𐎡𐎹𐏐𐎭𐏃𐎹𐎢𐎴𐎠𐎶𐏐𐎻𐏁𐎫𐎠𐎿𐎱𐏃𐎹𐎠𐏐𐎱𐎢𐏂𐏐𐎠𐎼𐏁𐎠𐎶𐏃𐎹𐎠𐏐𐎴𐎱𐎠𐏐𐏃𐎧𐎠𐎶𐎴𐎡𐏁𐎡𐎹",
-        L"  Sinhala-> සියලු මනුෂ්‍යයෝ නිදහස්ව උපත ලබා ඇත. ගරුත්වයෙන් හා අයිතිවාසිකම්වලින් සමාන වෙති. යුක්ති අයුක්ති පිළිබඳ හැඟීමෙන් හා හෘදය සාක්ෂියෙන් යුත් ඔවුන්, ඔවුනොවුන්ට සැළකිය යුත්තේ සහෝදරත්වය පිළිබඳ හැඟීමෙනි.",
-        L"  Runic-> ᚢᚴ᛬​ᛋᛁᛘ᛬​ᛚᛅᛁᚦ᛬​ᛅᛏ᛬​ᛁᚢᛚᚢᛘ᛬​ᚴᚢᚱᚦᚢᛋᚴ᛬​ᛘᛁᚾ᛬​ᚦᛅᚱ᛬​ᚢᚴᛅᛏᛁᚱ",
-    };
-#if 0
-    wchar_t *text = test_texts[2];
-#else
-    U64 to = 0;
-    wchar_t *text = push_array(permanent_arena, wchar_t, 1677216);
-    for (U32 i = 0; i < array_count(test_texts); ++i)
+    Terminal_Font terminal_font = {&engine.backend, &engine.glyph_atlas, fonts[0], pt_per_em*0.75f};
+    Terminal_Grid terminal = {};
+    if (show_terminal_demo)
+    { terminal_grid_init_font(&terminal, &terminal_font, 120, 30); }
+
+    D3d11_Pipeline pipeline = {};
     {
-        U64 len = wcslen(test_texts[i]);
-        memory_copy(text + to, test_texts[i], len*sizeof(wchar_t));
-        to += len;
+        pipeline.vertex_shaders[RENDER_SHADER_PANEL]   = panel_vs;
+        pipeline.vertex_shaders[RENDER_SHADER_TEXTURE] = vertex_shader;
+        pipeline.vertex_shaders[RENDER_SHADER_GLYPH]   = glyph_vs;
+        pipeline.pixel_shaders[RENDER_SHADER_PANEL]    = panel_ps;
+        pipeline.pixel_shaders[RENDER_SHADER_TEXTURE]  = pixel_shader;
+        pipeline.pixel_shaders[RENDER_SHADER_GLYPH]    = glyph_ps;
+        pipeline.quad_input_layout                     = input_layout;
+        pipeline.instance_input_layout                 = glyph_input_layout;
+        pipeline.blend_states[RENDER_BLEND_ALPHA]      = blend_state;
+        pipeline.blend_states[RENDER_BLEND_MAX]        = glyph_blend_state;
+        pipeline.texture_view                          = texture_view;
+        pipeline.atlas_array_view                      = atlas_array_view;
+        pipeline.sampler_state                         = sampler_state;
+        pipeline.rasterizer_state                      = rasterizer_state;
+        pipeline.index_buffer                          = index_buffer;
+        pipeline.view_constant_buffer                  = view_constant_buffer;
+        pipeline.vertex_ring                           = vertex_ring;
+        pipeline.instance_ring                         = instance_ring;
+        pipeline.atlas_texture                         = d3d_atlas;
+        pipeline.uploaded_atlas_generation             = (U64)-1;
     }
-#endif
-    U32 text_length = (U32)wcslen(text);
+
+    // ------------------------------
+    // @Note: From here on shaping, rasterization and layout happen on the
+    //        frame worker, see frame_build().
+    Frame_Builder builder = {};
+    {
+        builder.engine                    = &engine;
+        builder.source                    = &source;
+        builder.counter_frequency_inverse = counter_frequency_inverse;
+        builder.base_family               = base_font_family_name;
+        builder.pt_per_em                 = pt_per_em;
+        builder.px_per_inch               = px_per_inch;
+        builder.show_label_demo           = show_label_demo;
+        builder.terminal                  = (show_terminal_demo) ? &terminal : NULL;
+    }
+
+    Frame_Pipeline frame_pipeline = {};
+    frame_pipeline_start(&frame_pipeline, &builder, permanent_arena);
 
     // ------------------------------
     // @Note: Main Loop
-    Arena *frame_arena = arena_alloc();
+    //
+    // Each iteration samples input, kicks the build of a frame and presents
+    // one. A frame that built within FRAME_BUILD_BUDGET_SECONDS is presented
+    // right away, like it was before there was a worker. One that didn't is
+    // held and presented next iteration while the next frame builds, so a
+    // heavy document costs a frame of latency instead of every other vsync.
+    U32 build_slot_index = 0;
+    Frame_Slot *pending_slot = NULL;    // built, not yet presented.
+    Frame_Slot *last_slot = NULL;       // presented last.
+    F32 scroll_px = 0.0f;               // wheel movement not yet handed to a build.
     U64 last_counter = os_read_timer();
     while (! window->should_close)
     {
@@ -570,6 +1155,11 @@ main_entry(void)
                     should_accumulate_time = !should_accumulate_time;
                 } break;
 
+                case WM_MOUSEWHEEL: {
+                    F32 notches = (F32)GET_WHEEL_DELTA_WPARAM(msg.wParam) / (F32)WHEEL_DELTA;
+                    scroll_px -= notches * 3.0f * pt_per_em;
+                } break;
+
                 default: {
                     TranslateMessage(&msg);
                     DispatchMessageW(&msg);
@@ -583,24 +1173,46 @@ main_entry(void)
         F64 dt = (F64)(new_counter - last_counter) * counter_frequency_inverse;
         last_counter = new_counter;
 
-        char buf[256];
-        snprintf(buf, sizeof(buf), "dt: %.6f\n", dt);
-        OutputDebugString(buf);
+        // ---------------------------
+        // @Note: Stats, once a second. The worker is idle here, so the
+        //        engine can be read and the profiler can fold in what the
+        //        last frame recorded.
+#if PROFILE_ENABLED
+        profile_frame_end();
+#endif
+        local_persist F64 report_seconds = 0.0;
+        report_seconds += dt;
+        if (last_slot && report_seconds >= 1.0)
+        {
+            report_seconds = 0.0;
+
+            char buf[256];
+            Engine_Stats engine_stats = engine_get_stats(&engine);
+            Word_Cache_Stats word_stats = engine_stats.backend.word_cache;
+            Render_Stats render_stats = last_slot->renderer.stats;     // of the last frame.
+            snprintf(buf, sizeof(buf), "dt: %.6f, build: %.3fms, word cache hit: %.2f%%, shaping saved: %.3fms, draws: %u%s, state changes: %u, frame: %.1fKB, upload: %.1fKB\n",
+                     dt, last_slot->build_seconds*1000.0, word_cache_hit_rate(word_stats)*100.0, (F64)word_stats.saved_shape_ticks*counter_frequency_inverse*1000.0,
+                     render_stats.draw_count, (render_stats.is_reused) ? " (reused)" : "", render_stats.state_change_count,
+                     (F64)render_stats.frame_bytes/1024.0, (F64)render_stats.upload_bytes/1024.0);
+            OutputDebugString(buf);
+
+            char table[2048];
+            U32 table_length = engine_format_stats(&engine_stats, table, sizeof(table));
+            U64 frame_high_water = max(frame_pipeline.slots[0].arena_high_water, frame_pipeline.slots[1].arena_high_water);
+            snprintf(table + table_length, sizeof(table) - table_length, "  frame arena: %.1fKB at most\n", (F64)frame_high_water/1024.0);
+            OutputDebugString(table);
+
+#if PROFILE_ENABLED
+            char summary[2048];
+            profile_format_summary(summary, sizeof(summary));
+            OutputDebugString(summary);
+#endif
+        }
 
         local_persist F64 time = 0.0;
         if (should_accumulate_time)
         { time += dt; }
 
-        // ---------------------------
-        // @Note: Update
-        arena_clear(frame_arena);
-
-        renderer.vertex_count = 0;
-        renderer.index_count  = 0;
-
-        Glyph_Cel_Array glyph_cels = {};
-        dar_init(&glyph_cels, frame_arena);
-
         // -----------------------------
         // @Temporary: Text Container
 #if 1
@@ -614,253 +1226,82 @@ main_entry(void)
 
         V2 container_origin_px  = V2{((F32)window_width - container_width_px)*0.5f, ((F32)window_height + container_height_px)*0.5f};
 
-        if (glyph_runs)
-        {
-            arrfree(glyph_runs); 
-        }
-        glyph_runs = dwrite_map_text_to_glyphs(dwrite.font_fallback1, dwrite.font_collection, dwrite.text_analyzer1, dwrite.locale, base_font_family_name, pt_per_em, px_per_inch, text, text_length);
-
-
-        U64 run_count = arrlenu(glyph_runs);
-
-        for (U32 run_idx = 0; run_idx < run_count; ++run_idx)
-        {
-            DWRITE_GLYPH_RUN run = glyph_runs[run_idx];
-            IDWriteFontFace5 *font_face = (IDWriteFontFace5 *)run.fontFace;
-
-            Dwrite_Font_Table_Entry *font_entry = dwrite_get_entry_from_font_table(font_face);
-            assert(font_entry);
-            Dwrite_Font_Metrics font_metrics = font_entry->metrics;
-
-            // @Note: Create rendering mode of a font face.
-            DWRITE_RENDERING_MODE1 rendering_mode = DWRITE_RENDERING_MODE1_NATURAL;
-            DWRITE_MEASURING_MODE measuring_mode  = DWRITE_MEASURING_MODE_NATURAL;
-            DWRITE_GRID_FIT_MODE grid_fit_mode    = DWRITE_GRID_FIT_MODE_DEFAULT;
-
-            win32_assume_hr(font_face->GetRecommendedRenderingMode(run.fontEmSize,
-                                                                   px_per_inch, px_per_inch,
-                                                                   NULL, // transform
-                                                                   run.isSideways,
-                                                                   DWRITE_OUTLINE_THRESHOLD_ANTIALIASED,
-                                                                   measuring_mode,
-                                                                   dwrite.rendering_params,
-                                                                   &rendering_mode,
-                                                                   &grid_fit_mode));
-
-
-            dwrite_pack_glyphs_in_run_to_atlas(is_cleartype, run,
-                                               rendering_mode, measuring_mode, grid_fit_mode,
-                                               &font_entry->glyph_table, atlas, atlas_partition_sentinel, &glyph_cels);
-        }
-
-        // -----------------------------------------
-        // @Note: Render text per container.
-
-        F32 max_advance_height_px = 0.0f;
-        for (U32 ri = 0; ri < run_count; ++ri)
+        Frame_Input input = {};
         {
-            DWRITE_GLYPH_RUN run = glyph_runs[ri];
-            Dwrite_Font_Table_Entry *font_entry = dwrite_get_entry_from_font_table(run.fontFace);
-            assert(font_entry);
-            Dwrite_Font_Metrics font_metrics = font_entry->metrics;
-            // @Hack:
-            max_advance_height_px = max(max_advance_height_px, font_metrics.advance_height_px);
+            input.window_width        = window_width;
+            input.window_height       = window_height;
+            input.container_origin_px = container_origin_px;
+            input.container_width_px  = container_width_px;
+            input.container_height_px = container_height_px;
+            input.scroll_px           = scroll_px;
+            input.time                = time;
         }
 
-        V2 origin_translate_px = container_origin_px;
-        origin_translate_px.y -= max_advance_height_px;
-
-        { // @Temporary: Draw container
-            V2 min_x = container_origin_px + V2{0.0f, -container_height_px};
-            V2 max_x = min_x + V2{container_width_px, container_height_px}; 
-            render_quad_px_min_max(min_x, max_x);
-        }
-
-        U32 global_gi = 0;
-
-        // @Temporary:
-        V2 origin_local_px = {};
-        if (run_count > 0)
-        {
-            if (glyph_runs[0].glyphCount > 0)
-            {
-                origin_local_px.x -= ((Glyph_Cel *)glyph_cels.base)[0].offset_px.x;
-            }
-        }
-        for (U32 ri = 0; ri < run_count; ++ri)
+        // ---------------------------
+        // @Note: Retained frame. If nothing the frame depends on changed, and
+        //        the rings still hold what the last frame drew from, its
+        //        draws are issued again and nothing is built or uploaded.
+        //        The worker is idle here, so the last frame's key is its state.
+        if (last_slot && ! pending_slot && scroll_px == 0.0f && ! builder.terminal)
         {
-            DWRITE_GLYPH_RUN run = glyph_runs[ri];
-            U32 glyph_count_in_run = run.glyphCount;
-
-            Dwrite_Font_Table_Entry *font_entry = dwrite_get_entry_from_font_table(run.fontFace);
-            assert(font_entry);
-            Dwrite_Font_Metrics metrics = font_entry->metrics;
-
-            F32 advance_height_px = metrics.advance_height_px;
-
-            for (U32 local_gi = 0; local_gi < glyph_count_in_run; ++local_gi, ++global_gi)
+            AABB2 box_container = AABB2{container_origin_px + V2{0.0f, -container_height_px},
+                                        container_origin_px + V2{container_width_px, 0.0f}};
+            Frame_Key last_key = last_slot->key;
+            Frame_Key frame_key = frame_key_make(window_width, window_height, box_container, last_key.top_line, last_key.top_offset_px, time, last_key.atlas_generation);
+            if (frame_key_equals(&frame_key, &last_key) && d3d11_draws_are_resident(&pipeline))
             {
-                Glyph_Cel cel = *((Glyph_Cel *)glyph_cels.base + global_gi);
-                F32 advance_x_px = run.glyphAdvances[local_gi];
-
-                // If not empty glyph,
-                if (! cel.is_empty)
-                {
-                    // @Todo: line wrap by grapheme.
-                    F32 left_px  = origin_local_px.x + cel.offset_px.x;
-                    F32 right_px = left_px + cel.width_px;
-                    if (right_px >= container_width_px)
-                    {
-                        origin_local_px.x = -cel.offset_px.x;
-                        origin_local_px.y -= advance_height_px;
-                    }
-
-                    // Translate to global(container) coordinates.
-                    V2 origin_global_px = origin_local_px + origin_translate_px;
-
-                    // @Todo: Understand those and decide if I should hoist them out.
-                    //origin_global_px.x += run.glyphOffsets[local_gi].advanceOffset;
-                    //origin_global_px.y += run.glyphOffsets[local_gi].ascenderOffset;
-
-                    V2 min_px, max_px;
-                    {
-                        min_px = max_px = origin_global_px;
-                        min_px.x += cel.offset_px.x;
-                        max_px.x = min_px.x + cel.width_px;
-                        max_px.y += cel.offset_px.y;
-                        min_px.y = max_px.y - cel.height_px;
-                    }
-
-                    // Culling/Clipping.
-                    AABB2 box_container = AABB2{container_origin_px, container_origin_px};
-                    {
-                        box_container.min.y -= container_height_px;
-                        box_container.max.x += container_width_px;
-                    }
-
-                    AABB2 box_cel = AABB2{min_px, max_px};
-
-                    // @Todo: We are not wrapping line by graphemes currently. Thus, it'll sometimes look like 
-                    //        glyphs are disappearing by nowhere.
-                    if (intersects(box_container, box_cel))
-                    {
-                        // @Todo: intersection() does some duplicate operations to intersects().
-                        AABB2 overlap = intersection(box_container, box_cel);
-
-                        V2 uv_min      = V2{cel.uv_min.x, cel.uv_max.y};
-                        V2 uv_max      = V2{cel.uv_max.x, cel.uv_min.y};
-                        V2 uv_range_x  = V2{cel.uv_min.x, cel.uv_max.x};
-                        V2 uv_range_y  = V2{cel.uv_min.y, cel.uv_max.y};
-                        V2 box_range_x = V2{box_cel.min.x, box_cel.max.x};
-                        V2 box_range_y = V2{box_cel.min.y, box_cel.max.y};
-
-                        uv_min.x = lerp(uv_range_x,  normalize01(box_range_x, overlap.min.x));
-                        uv_max.x = lerp(uv_range_x,  normalize01(box_range_x, overlap.max.x));
-                        uv_min.y = lerp(uv_range_y, -normalize01(box_range_y, overlap.min.y) + 1.0f);
-                        uv_max.y = lerp(uv_range_y, -normalize01(box_range_y, overlap.max.y) + 1.0f);
-
-                        render_texture(overlap.min, overlap.max, uv_min, uv_max); 
-                    }
-                }
-
-                // Advance
-                origin_local_px.x += advance_x_px;
+                Render_Stats *stats = &last_slot->renderer.stats;
+                stats->upload_bytes       = 0;
+                stats->draw_count         = 0;
+                stats->state_change_count = 0;
+                stats->is_reused          = true;
+
+                d3d11_begin_pass(&pipeline, window_width, window_height);
+                d3d11_reissue_draws(&pipeline, window_width, window_height, stats);
+                d3d11.swapchain->Present(1, 0);
+                continue;
             }
         }
 
-        // -----------------------
-        // @Note: D3D11 Pass
-
-        // @Hack: Convert to NDC on CPU-side.
-        for (U32 i = 0; i < renderer.vertex_count; ++i)
-        {
-            renderer.vertices[i].pos.x = (renderer.vertices[i].pos.x * 2.0f / window_width) - 1.0f;
-            renderer.vertices[i].pos.y = (renderer.vertices[i].pos.y * 2.0f / window_height) - 1.0f;
-        }
-
         // ---------------------------
-        // @Note: Update vertex buffer.
-        {
-            D3D11_MAPPED_SUBRESOURCE mapped_subresource = {};
-            d3d11.device_ctx->Map(vertex_buffer, 0/*index # of subresource*/, D3D11_MAP_WRITE_DISCARD, 0/*flags*/, &mapped_subresource);
-            memory_copy(mapped_subresource.pData, renderer.vertices, sizeof(renderer.vertices[0])*renderer.vertex_count);
-            d3d11.device_ctx->Unmap(vertex_buffer, 0);
-        }
+        // @Note: Kick the build, and present the held frame meanwhile.
+        Frame_Slot *build_slot = frame_pipeline.slots + build_slot_index;
+        build_slot_index ^= 1;
+        assert(build_slot != pending_slot);
 
-        // ---------------------------
-        // @Note: Update index buffer.
-        {
-            D3D11_MAPPED_SUBRESOURCE mapped_subresource = {};
-            d3d11.device_ctx->Map(index_buffer, 0/*index # of subresource*/, D3D11_MAP_WRITE_DISCARD, 0/*flags*/, &mapped_subresource);
-            memory_copy(mapped_subresource.pData, renderer.indices, sizeof(renderer.indices[0])*renderer.index_count);
-            d3d11.device_ctx->Unmap(index_buffer, 0);
-        }
+        frame_pipeline_kick(&frame_pipeline, build_slot, input);
+        scroll_px = 0.0f;
 
-        // ---------------------------
-        // @Note: Update atlas.
+        if (pending_slot)
         {
-            D3D11_MAPPED_SUBRESOURCE mapped_subresource = {};
-            d3d11.device_ctx->Map(d3d_atlas, 0/*index # of subresource*/, D3D11_MAP_WRITE_DISCARD, 0/*flags*/, &mapped_subresource);
-            memory_copy(mapped_subresource.pData, atlas.data, sizeof(atlas.data[0])*atlas.pitch*atlas.height);
-            d3d11.device_ctx->Unmap(d3d_atlas, 0);
+            d3d11_present_frame(&pipeline, pending_slot);
+            last_slot = pending_slot;
+            pending_slot = NULL;
         }
 
-
-        FLOAT background_color[4] = {0.12f, 0.12f, 0.12f, 1.0f};
-        d3d11.device_ctx->ClearRenderTargetView(d3d11.framebuffer_view, background_color);
-
-        D3D11_VIEWPORT viewport = {};
+        Frame_Slot *built_slot = frame_pipeline_wait(&frame_pipeline);
+        if (built_slot->build_seconds > FRAME_BUILD_BUDGET_SECONDS)
         {
-            viewport.TopLeftX = 0.0f;
-            viewport.TopLeftY = 0.0f;
-            viewport.Width    = (FLOAT)(window_width);
-            viewport.Height   = (FLOAT)(window_height);
-            viewport.MinDepth = 0.0f;
-            viewport.MaxDepth = 1.0f;
+            pending_slot = built_slot;
         }
-        d3d11.device_ctx->RSSetViewports(1, &viewport);
-
+        else
         {
-            UINT stride = sizeof(renderer.vertices[0]);
-            UINT offset = 0;
-            d3d11.device_ctx->IASetVertexBuffers(0, 1, &vertex_buffer, &stride, &offset);
+            d3d11_present_frame(&pipeline, built_slot);
+            last_slot = built_slot;
         }
-        d3d11.device_ctx->IASetIndexBuffer(index_buffer, DXGI_FORMAT_R32_UINT, 0/*offset*/);
-        d3d11.device_ctx->IASetInputLayout(input_layout);
-        d3d11.device_ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-        { // Panel shader
-            d3d11.device_ctx->VSSetShader(panel_vs, NULL, 0);
-            d3d11.device_ctx->PSSetShader(panel_ps, NULL, 0);
-
-            d3d11.device_ctx->OMSetRenderTargets(1, &d3d11.framebuffer_view, NULL/*Depth-Stencil View*/);
-            d3d11.device_ctx->OMSetBlendState(blend_state, NULL, 0xffffffff);
-
-            // @Hack:
-            d3d11.device_ctx->DrawIndexed(6, 0/*StartIndexLocation*/, 0/*BaseVertexLocation*/);
-        }
-
-        { // Glyph shader
-            d3d11.device_ctx->VSSetShader(vertex_shader, NULL, 0);
-            d3d11.device_ctx->PSSetShader(pixel_shader, NULL, 0);
-
-            d3d11.device_ctx->PSSetShaderResources(0, 1, &texture_view);
-            d3d11.device_ctx->PSSetSamplers(0, 1, &sampler_state);
-
-            d3d11.device_ctx->OMSetRenderTargets(1, &d3d11.framebuffer_view, NULL/*Depth-Stencil View*/);
-            d3d11.device_ctx->OMSetBlendState(glyph_blend_state, NULL, 0xffffffff);
+    }
 
-            // @Hack:
-#if 1
-            d3d11.device_ctx->DrawIndexed(renderer.index_count - 6, 6/*StartIndexLocation*/, 0/*BaseVertexLocation*/);
-#else
-            d3d11.device_ctx->DrawIndexed(6, 6, 0/*BaseVertexLocation*/);
-            d3d11.device_ctx->DrawIndexed(6, 12, 0/*BaseVertexLocation*/);
+    frame_pipeline_stop(&frame_pipeline);
+    if (builder.terminal)
+    { terminal_grid_release(builder.terminal); }
+#if PROFILE_ENABLED
+    profile_write_chrome_trace("profile_trace.json");
+#endif
+    engine_release(&engine);
+    job_system_release(&job_system);
+#if PROFILE_ENABLED
+    profile_release();
 #endif
-        }
-
-        d3d11.swapchain->Present(1, 0);
-    }
 
     os_close_window(window);
 
@@ -0,0 +1,255 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+#if PROFILE_ENABLED
+
+function void
+profile_init(void)
+{
+    profile.arena = arena_alloc();
+    job_mutex_init(&profile.mutex);
+    profile.begin_counter = os_read_timer();
+    profile.ms_per_tick = 1000.0 / (F64)os_query_timer_frequency();
+}
+
+// @Note: After every thread that recorded is done with it.
+function void
+profile_release(void)
+{
+    job_mutex_release(&profile.mutex);
+    arena_release(profile.arena);
+    profile = {};
+}
+
+// @Note: A thread's ring is made the first time it records.
+function Profile_Thread *
+profile_get_thread(void)
+{
+    if (! profile_thread)
+    {
+        job_mutex_lock(&profile.mutex);
+        S64 index = job_atomic_load(&profile.thread_count);
+        assume(index < PROFILE_MAX_THREAD_COUNT);
+
+        Profile_Thread *thread = push_struct(profile.arena, Profile_Thread);
+        thread->index = (U32)index;
+        profile.threads[index] = thread;
+        job_atomic_store(&profile.thread_count, index + 1);
+        job_mutex_unlock(&profile.mutex);
+
+        profile_thread = thread;
+    }
+    return profile_thread;
+}
+
+function void
+profile_record(Profile_Stage stage, U64 begin, U64 end)
+{
+    Profile_Thread *thread = profile_get_thread();
+    Profile_Event *event = thread->events + (thread->event_count & (PROFILE_RING_CAPACITY - 1));
+    event->begin    = begin;
+    event->duration = (U32)min(end - begin, (U64)0xffffffff);
+    event->stage    = (U32)stage;
+    thread->event_count += 1;
+}
+
+Profile_Scope::Profile_Scope(Profile_Stage stage)
+{
+    this->stage = stage;
+    this->begin = os_read_timer();
+}
+
+Profile_Scope::~Profile_Scope()
+{
+    profile_record(stage, begin, os_read_timer());
+}
+
+// @Note: Events that were overwritten before they were folded are lost to
+// the summary.
+function void
+profile_frame_end(void)
+{
+    U32 frame = (U32)(profile.frame_count % PROFILE_SUMMARY_FRAME_COUNT);
+    U64 *ticks  = profile.frame_ticks[frame];
+    U32 *counts = profile.frame_event_counts[frame];
+    for (U32 si = 0; si < PROFILE_STAGE_COUNT; ++si)
+    {
+        ticks[si]  = 0;
+        counts[si] = 0;
+    }
+
+    S64 thread_count = job_atomic_load(&profile.thread_count);
+    for (S64 ti = 0; ti < thread_count; ++ti)
+    {
+        Profile_Thread *thread = profile.threads[ti];
+        U64 first = thread->event_count - min(thread->event_count, (U64)PROFILE_RING_CAPACITY);
+        first = max(first, thread->folded_count);
+        for (U64 ei = first; ei < thread->event_count; ++ei)
+        {
+            Profile_Event *event = thread->events + (ei & (PROFILE_RING_CAPACITY - 1));
+            ticks[event->stage]  += event->duration;
+            counts[event->stage] += 1;
+        }
+        thread->folded_count = thread->event_count;
+    }
+
+    profile.frame_count += 1;
+}
+
+// @Note: Over the last PROFILE_SUMMARY_FRAME_COUNT frames.
+function Profile_Stage_Summary
+profile_get_stage_summary(Profile_Stage stage)
+{
+    Profile_Stage_Summary result = {};
+
+    U64 frame_count = min(profile.frame_count, (U64)PROFILE_SUMMARY_FRAME_COUNT);
+    if (frame_count)
+    {
+        U64 total_ticks = 0;
+        U64 max_ticks   = 0;
+        U64 total_count = 0;
+        for (U64 fi = 0; fi < frame_count; ++fi)
+        {
+            U64 ticks = profile.frame_ticks[fi][stage];
+            total_ticks += ticks;
+            max_ticks    = max(max_ticks, ticks);
+            total_count += profile.frame_event_counts[fi][stage];
+        }
+
+        result.average_ms    = (F64)total_ticks*profile.ms_per_tick / (F64)frame_count;
+        result.max_ms        = (F64)max_ticks*profile.ms_per_tick;
+        result.average_count = (F64)total_count / (F64)frame_count;
+    }
+
+    return result;
+}
+
+// @Note: A line per stage that ran, truncated to the buffer. Returns the
+// length written.
+function U32
+profile_format_summary(char *buffer, U32 size)
+{
+    U32 used = 0;
+    if (size)
+    { buffer[0] = 0; }
+
+    for (U32 si = 0; si < PROFILE_STAGE_COUNT && used + 1 < size; ++si)
+    {
+        Profile_Stage_Summary summary = profile_get_stage_summary((Profile_Stage)si);
+        if (summary.average_count > 0.0)
+        {
+            int length = snprintf(buffer + used, size - used, "  %-16s %8.3fms avg %8.3fms max %8.1f/frame\n",
+                                  profile_stage_names[si], summary.average_ms, summary.max_ms, summary.average_count);
+            if (length < 0)
+            { break; }
+            used = min(used + (U32)length, size - 1);
+        }
+    }
+
+    return used;
+}
+
+// -----------------------------------------
+// @Note: Chrome trace
+
+function void
+profile_writer_flush(Profile_Writer *writer)
+{
+    if (writer->used && ! writer->failed)
+    {
+#if defined(OS_WINDOWS)
+        DWORD written = 0;
+        if (! WriteFile(writer->file, writer->buffer, writer->used, &written, NULL) || written != writer->used)
+        { writer->failed = true; }
+#else
+        if (write(writer->file, writer->buffer, writer->used) != (ssize_t)writer->used)
+        { writer->failed = true; }
+#endif
+    }
+    writer->used = 0;
+}
+
+function void
+profile_writer_print(Profile_Writer *writer, char *format, ...)
+{
+    for (U32 attempt = 0; attempt < 2; ++attempt)
+    {
+        U32 room = sizeof(writer->buffer) - writer->used;
+
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(writer->buffer + writer->used, room, format, args);
+        va_end(args);
+
+        if (length >= 0 && (U32)length < room)
+        {
+            writer->used += (U32)length;
+            return;
+        }
+        profile_writer_flush(writer);
+    }
+    writer->failed = true;
+}
+
+// @Note: Complete ("X") events, one track per thread, with times in
+// microseconds since profile_init().
+function B32
+profile_write_chrome_trace(char *path)
+{
+    Temporary_Arena scratch = scratch_begin();
+    Profile_Writer *writer = push_struct(scratch.arena, Profile_Writer);
+
+#if defined(OS_WINDOWS)
+    int wide_length = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    wchar_t *wide_path = push_array(scratch.arena, wchar_t, wide_length);
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path, wide_length);
+
+    writer->file = CreateFileW(wide_path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    B32 is_open = (writer->file != INVALID_HANDLE_VALUE);
+#else
+    writer->file = open(path, O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    B32 is_open = (writer->file >= 0);
+#endif
+
+    B32 result = false;
+    if (is_open)
+    {
+        F64 us_per_tick = profile.ms_per_tick*1000.0;
+        char *separator = "";
+
+        profile_writer_print(writer, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+        S64 thread_count = job_atomic_load(&profile.thread_count);
+        for (S64 ti = 0; ti < thread_count; ++ti)
+        {
+            Profile_Thread *thread = profile.threads[ti];
+            profile_writer_print(writer, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                                 separator, thread->index, thread->index);
+            separator = ",\n";
+
+            U64 first = thread->event_count - min(thread->event_count, (U64)PROFILE_RING_CAPACITY);
+            for (U64 ei = first; ei < thread->event_count; ++ei)
+            {
+                Profile_Event *event = thread->events + (ei & (PROFILE_RING_CAPACITY - 1));
+                F64 ts  = (F64)(S64)(event->begin - profile.begin_counter)*us_per_tick;
+                F64 dur = (F64)event->duration*us_per_tick;
+                profile_writer_print(writer, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                                     profile_stage_names[event->stage], thread->index, ts, dur);
+            }
+        }
+
+        profile_writer_print(writer, "\n]}\n");
+        profile_writer_flush(writer);
+        result = (! writer->failed);
+
+#if defined(OS_WINDOWS)
+        CloseHandle(writer->file);
+#else
+        close(writer->file);
+#endif
+    }
+
+    scratch_end(scratch);
+    return result;
+}
+
+#endif // PROFILE_ENABLED
@@ -0,0 +1,171 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef PROFILE_H
+#define PROFILE_H
+
+/* --------------------------------------
+   @Note: Scoped timers around the hot paths.
+
+   profile_scope(stage) times the rest of the enclosing block. Every thread
+   appends what it times to a ring of its own, without locking, and the last
+   PROFILE_RING_CAPACITY events of each thread are kept.
+
+   profile_frame_end() folds what was recorded since the last call into the
+   frame it ends, and profile_get_stage_summary() averages the last
+   PROFILE_SUMMARY_FRAME_COUNT frames. profile_write_chrome_trace() writes
+   every event still in the rings as Chrome trace JSON, for chrome://tracing
+   or Perfetto.
+
+   Both read the other threads' rings, so they're only called while no other
+   thread is recording, e.g. between frames.
+
+   Unless PROFILE_ENABLED is defined to 1, none of it is compiled and
+   profile_scope() expands to nothing.
+   --------------------------------------- */
+
+#if ! defined(PROFILE_ENABLED)
+#  define PROFILE_ENABLED 0
+#endif
+
+typedef enum Profile_Stage
+{
+    PROFILE_STAGE_FRAME_BUILD,
+    PROFILE_STAGE_PRESENT,
+    PROFILE_STAGE_SHAPE,                // a paragraph, through any backend.
+    PROFILE_STAGE_FALLBACK,
+    PROFILE_STAGE_COMPLEXITY,
+    PROFILE_STAGE_SCRIPT_ANALYSIS,
+    PROFILE_STAGE_GET_GLYPHS,
+    PROFILE_STAGE_PLACEMENTS,
+    PROFILE_STAGE_RASTERIZE,
+    PROFILE_STAGE_PACK,
+    PROFILE_STAGE_LAYOUT,
+    PROFILE_STAGE_VERTEX_BUILD,
+    PROFILE_STAGE_UPLOAD_CONSTANTS,
+    PROFILE_STAGE_UPLOAD_ATLAS,
+    PROFILE_STAGE_UPLOAD_BATCHES,
+    PROFILE_STAGE_COUNT,
+} Profile_Stage;
+
+#if PROFILE_ENABLED
+
+#include <stdarg.h>
+#if ! defined(OS_WINDOWS)
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+#define PROFILE_RING_CAPACITY       65536   // events per thread, power of two.
+#define PROFILE_MAX_THREAD_COUNT    64
+#define PROFILE_SUMMARY_FRAME_COUNT 64
+
+typedef struct Profile_Event Profile_Event;
+struct Profile_Event
+{
+    U64 begin;
+    U32 duration;                       // timer ticks, saturated.
+    U32 stage;
+};
+
+typedef struct Profile_Thread Profile_Thread;
+struct Profile_Thread
+{
+    U32 index;
+    U64 event_count;                    // ever recorded.
+    U64 folded_count;                   // of those, in a frame of the summary.
+    Profile_Event events[PROFILE_RING_CAPACITY];
+};
+
+// Times are summed over threads, so a stage that runs on the job system
+// can take longer per frame than the frame did.
+typedef struct Profile_Stage_Summary Profile_Stage_Summary;
+struct Profile_Stage_Summary
+{
+    F64 average_ms;
+    F64 max_ms;
+    F64 average_count;
+};
+
+typedef struct Profile_State Profile_State;
+struct Profile_State
+{
+    Arena *arena;
+    Job_Mutex mutex;                    // for threads recording the first time.
+    Profile_Thread *threads[PROFILE_MAX_THREAD_COUNT];
+    volatile S64 thread_count;
+
+    U64 begin_counter;
+    F64 ms_per_tick;
+
+    U64 frame_count;
+    U64 frame_ticks[PROFILE_SUMMARY_FRAME_COUNT][PROFILE_STAGE_COUNT];
+    U32 frame_event_counts[PROFILE_SUMMARY_FRAME_COUNT][PROFILE_STAGE_COUNT];
+};
+
+typedef struct Profile_Scope Profile_Scope;
+struct Profile_Scope
+{
+    Profile_Stage stage;
+    U64 begin;
+
+    Profile_Scope(Profile_Stage stage);
+    ~Profile_Scope();
+};
+
+// Chrome trace JSON, written out a buffer at a time.
+typedef struct Profile_Writer Profile_Writer;
+struct Profile_Writer
+{
+#if defined(OS_WINDOWS)
+    HANDLE file;
+#else
+    int file;
+#endif
+    B32 failed;
+    U32 used;
+    char buffer[KB(64)];
+};
+
+#define PROFILE_GLUE_(a, b) a##b
+#define PROFILE_GLUE(a, b)  PROFILE_GLUE_(a, b)
+#define profile_scope(stage) Profile_Scope PROFILE_GLUE(profile_scope_, __LINE__)(stage)
+
+function void profile_init(void);
+function void profile_release(void);
+function Profile_Thread *profile_get_thread(void);
+function void profile_record(Profile_Stage stage, U64 begin, U64 end);
+function void profile_frame_end(void);
+function Profile_Stage_Summary profile_get_stage_summary(Profile_Stage stage);
+function U32 profile_format_summary(char *buffer, U32 size);
+function void profile_writer_flush(Profile_Writer *writer);
+function void profile_writer_print(Profile_Writer *writer, char *format, ...);
+function B32 profile_write_chrome_trace(char *path);
+
+// -------------------------------------
+// @Note: Data
+global Profile_State profile;
+global thread_local Profile_Thread *profile_thread;
+global char *profile_stage_names[PROFILE_STAGE_COUNT] = {
+    "frame_build",
+    "present",
+    "shape",
+    "fallback",
+    "complexity",
+    "script_analysis",
+    "get_glyphs",
+    "placements",
+    "rasterize",
+    "pack",
+    "layout",
+    "vertex_build",
+    "upload_constants",
+    "upload_atlas",
+    "upload_batches",
+};
+
+#else
+
+#define profile_scope(stage)
+
+#endif // PROFILE_ENABLED
+
+#endif // PROFILE_H
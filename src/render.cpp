@@ -1,61 +1,340 @@
 // Copyright (c) 2025 Seong Woo Lee. All rights reserved.
 
+// @Note: 0-1-2 0-2-3 for every quad, written once into an immutable buffer.
+// MAX_VERTEX_COUNT is what keeps the indices within 16 bits.
 function void
-render_quad_px_min_max(V2 min, V2 max)
+render_fill_quad_indices(U16 *indices, U32 quad_count)
 {
-    Renderer &r = renderer;
+    assume(quad_count*4 <= 65536);
+    for (U32 qi = 0; qi < quad_count; ++qi)
+    {
+        U16 first = (U16)(qi*4);
+        U16 *out = indices + qi*6;
+        out[0] = first + 0;
+        out[1] = first + 1;
+        out[2] = first + 2;
+        out[3] = first + 0;
+        out[4] = first + 2;
+        out[5] = first + 3;
+    }
+}
+
+function void
+render_begin_frame(Renderer *r, Arena *frame_arena)
+{
+    // The stb_ds arrays are kept from frame to frame.
+    AABB2 *clips = r->clips;
+    Render_Command *commands = r->commands;
+    Render_Command *sorted_commands = r->sorted_commands;
+    Render_Batch *batches = r->batches;
+
+    *r = {};
+    r->arena           = frame_arena;
+    r->clips           = clips;
+    r->commands        = commands;
+    r->sorted_commands = sorted_commands;
+    r->batches         = batches;
+    arrsetlen(r->clips, 0);
+    arrsetlen(r->commands, 0);
+    arrsetlen(r->sorted_commands, 0);
+    arrsetlen(r->batches, 0);
+
+    render_set_state(r, Render_State{0, RENDER_SHADER_PANEL, RENDER_BLEND_ALPHA, 0, RENDER_CLIP_NONE});
+}
+
+// @Note: The sort key is layer, shader, blend, page and clip from the most
+// significant bits down, the clip being its index among the frame's clips.
+function void
+render_set_state(Renderer *r, Render_State state)
+{
+    assert(state.layer < (1 << 16) && state.page < (1 << 16));
+
+    U32 clip_count = (U32)arrlenu(r->clips);
+    U32 clip_id = 0;
+    while (clip_id < clip_count && ! memory_equal(r->clips + clip_id, &state.clip_px, sizeof(AABB2)))
+    { ++clip_id; }
+    if (clip_id == clip_count)
+    { arrput(r->clips, state.clip_px); }
+    assert(clip_id < (1 << 24));
+
+    r->state = state;
+    r->state_key = (((U64)state.layer  << 48) |
+                    ((U64)state.shader << 44) |
+                    ((U64)state.blend  << 40) |
+                    ((U64)state.page   << 24) |
+                    (U64)clip_id);
+}
+
+function Render_State
+render_state_from_key(Renderer *r, U64 key)
+{
+    Render_State result = {};
+    result.layer   = (U32)(key >> 48);
+    result.shader  = (Render_Shader)((key >> 44) & 0xf);
+    result.blend   = (Render_Blend)((key >> 40) & 0xf);
+    result.page    = (U32)((key >> 24) & 0xffff);
+    result.clip_px = r->clips[key & 0xffffff];
+    return result;
+}
+
+// @Note: Appends the quad or instance at `index` to the last command if it
+// continues it under the same state.
+function void
+render_record(Renderer *r, U32 index)
+{
+    U32 command_count = (U32)arrlenu(r->commands);
+    Render_Command *last = (command_count) ? r->commands + command_count - 1 : NULL;
+    if (last && last->key == r->state_key && last->first + last->count == index)
+    {
+        last->count += 1;
+    }
+    else
+    {
+        Render_Command command = {r->state_key, index, 1};
+        arrput(r->commands, command);
+    }
+}
+
+function Vertex *
+render_push_quad(Renderer *r)
+{
+    assert(r->state.shader != RENDER_SHADER_GLYPH);
+
+    Render_Vertex_Chunk *chunk = r->last_vertex_chunk;
+    if (! chunk || chunk->count == RENDER_VERTEX_CHUNK_COUNT)
+    {
+        chunk = push_struct(r->arena, Render_Vertex_Chunk);
+        chunk->next  = NULL;
+        chunk->count = 0;
+        if (r->last_vertex_chunk)
+        { r->last_vertex_chunk->next = chunk; }
+        else
+        { r->first_vertex_chunk = chunk; }
+        r->last_vertex_chunk = chunk;
+        r->stats.frame_bytes += sizeof(Render_Vertex_Chunk);
+    }
+
+    Vertex *result = chunk->vertices + chunk->count;
+    chunk->count += 4;
+    render_record(r, r->vertex_count/4);
+    r->vertex_count += 4;
+    return result;
+}
+
+function void
+render_quad_px_min_max(Renderer *r, V2 min, V2 max)
+{
+    Vertex *v = render_push_quad(r);
+
+    v[0].uv  = V2{0,1};
+    v[0].pos = V2{min.x, min.y};
+
+    v[1].uv  = V2{0,0};
+    v[1].pos = V2{min.x, max.y};
 
-    assume(r.index_count + 6 <= MAX_INDEX_COUNT);
-    assume(r.vertex_count + 4 <= MAX_VERTEX_COUNT);
+    v[2].uv  = V2{1,0};
+    v[2].pos = V2{max.x, max.y};
 
-    U32 start_index = r.vertex_count;
+    v[3].uv  = V2{1,1};
+    v[3].pos = V2{max.x, min.y};
+}
+
+function void
+render_texture(Renderer *r, V2 min, V2 max, V2 uv_min, V2 uv_max)
+{
+    Vertex *v = render_push_quad(r);
+
+    v[0].uv  = V2{uv_min.x, uv_min.y};
+    v[0].pos = V2{min.x, min.y};
+
+    v[1].uv  = V2{uv_min.x, uv_max.y};
+    v[1].pos = V2{min.x, max.y};
+
+    v[2].uv  = V2{uv_max.x, uv_max.y};
+    v[2].pos = V2{max.x, max.y};
+
+    v[3].uv  = V2{uv_max.x, uv_min.y};
+    v[3].pos = V2{max.x, min.y};
+}
+
+function void
+render_glyph_instance(Renderer *r, Glyph_Instance glyph)
+{
+    assert(r->state.shader == RENDER_SHADER_GLYPH);
+
+    Render_Instance_Chunk *chunk = r->last_instance_chunk;
+    if (! chunk || chunk->count == RENDER_INSTANCE_CHUNK_COUNT)
+    {
+        chunk = push_struct(r->arena, Render_Instance_Chunk);
+        chunk->next  = NULL;
+        chunk->count = 0;
+        if (r->last_instance_chunk)
+        { r->last_instance_chunk->next = chunk; }
+        else
+        { r->first_instance_chunk = chunk; }
+        r->last_instance_chunk = chunk;
+        r->stats.frame_bytes += sizeof(Render_Instance_Chunk);
+    }
+
+    chunk->instances[chunk->count++] = glyph;
+    render_record(r, r->instance_count);
+    r->instance_count += 1;
+}
 
-    r.vertices[r.vertex_count].uv    = V2{0,1};
-    r.vertices[r.vertex_count++].pos = V2{min.x, min.y};
+// @Note: Keeps the texels whose centers are inside box_clip. An instance can
+// only address whole texels, so unlike remapping UVs the clipped edge may be
+// off by up to half a pixel. Only glyphs on the edge of a box come here.
+function void
+render_glyph_instance_clipped(Renderer *r, Glyph_Instance glyph, AABB2 box_clip)
+{
+    S32 width  = glyph.width;
+    S32 height = glyph.height;
+
+    // Columns from the left, rows from the bottom.
+    S32 first_column = max(0,     (S32)ceilf(box_clip.min.x - glyph.min_px.x - 0.5f));
+    S32 end_column   = min(width, (S32)ceilf(box_clip.max.x - glyph.min_px.x - 0.5f));
+    S32 first_row    = max(0,      (S32)ceilf(box_clip.min.y - glyph.min_px.y - 0.5f));
+    S32 end_row      = min(height, (S32)ceilf(box_clip.max.y - glyph.min_px.y - 0.5f));
+
+    if (first_column < end_column && first_row < end_row)
+    {
+        glyph.min_px.x += (F32)first_column;
+        glyph.min_px.y += (F32)first_row;
+        glyph.atlas_x  += (U16)first_column;
+        glyph.atlas_y  += (U16)(height - end_row);     // texel rows run downwards.
+        glyph.width     = (U16)(end_column - first_column);
+        glyph.height    = (U16)(end_row - first_row);
+        render_glyph_instance(r, glyph);
+    }
+}
 
-    r.vertices[r.vertex_count].uv    = V2{0,0};
-    r.vertices[r.vertex_count++].pos = V2{min.x, max.y};
+// @Note: Bottom-up merge sort by key. It's stable, so commands of the same
+// state stay in the order they were recorded.
+function void
+render_sort_commands(Render_Command *commands, U32 count, Render_Command *temp)
+{
+    Render_Command *src = commands;
+    Render_Command *dst = temp;
 
-    r.vertices[r.vertex_count].uv    = V2{1,0};
-    r.vertices[r.vertex_count++].pos = V2{max.x, max.y};
+    for (U32 width = 1; width < count; width *= 2)
+    {
+        for (U32 lo = 0; lo < count; lo += 2*width)
+        {
+            U32 mid = min(lo + width, count);
+            U32 hi  = min(lo + 2*width, count);
+            U32 a = lo;
+            U32 b = mid;
+            U32 o = lo;
+            while (a < mid && b < hi)
+            { dst[o++] = (src[b].key < src[a].key) ? src[b++] : src[a++]; }
+            while (a < mid)
+            { dst[o++] = src[a++]; }
+            while (b < hi)
+            { dst[o++] = src[b++]; }
+        }
 
-    r.vertices[r.vertex_count].uv    = V2{1,1};
-    r.vertices[r.vertex_count++].pos = V2{max.x, min.y};
+        Render_Command *swap = src;
+        src = dst;
+        dst = swap;
+    }
 
-    r.indices[r.index_count++] = start_index + 0;
-    r.indices[r.index_count++] = start_index + 1;
-    r.indices[r.index_count++] = start_index + 2;
-    r.indices[r.index_count++] = start_index + 0;
-    r.indices[r.index_count++] = start_index + 2;
-    r.indices[r.index_count++] = start_index + 3;
+    if (src != commands)
+    { memory_copy(commands, src, count*sizeof(Render_Command)); }
 }
 
+// @Note: Commands are sorted by state and every run of the same state
+// becomes one batch, however far apart its commands were recorded. The
+// backend gathers a batch's quads or instances with render_gather_batch().
 function void
-render_texture(V2 min, V2 max, V2 uv_min, V2 uv_max)
+render_build_batches(Renderer *r)
 {
-    Renderer &r = renderer;
+    profile_scope(PROFILE_STAGE_VERTEX_BUILD);
+
+    U32 command_count = (U32)arrlenu(r->commands);
+    arrsetlen(r->sorted_commands, command_count);
+    arrsetlen(r->batches, 0);
 
-    assume(r.index_count + 6 <= MAX_INDEX_COUNT);
-    assume(r.vertex_count + 4 <= MAX_VERTEX_COUNT);
+    if (command_count)
+    {
+        Temporary_Arena scratch = scratch_begin();
+        Render_Command *temp = push_array(scratch.arena, Render_Command, command_count);
+        memory_copy(r->sorted_commands, r->commands, command_count*sizeof(Render_Command));
+        render_sort_commands(r->sorted_commands, command_count, temp);
+        scratch_end(scratch);
+    }
 
-    U32 start_index = r.vertex_count;
+    for (U32 ci = 0; ci < command_count; ++ci)
+    {
+        Render_Command *command = r->sorted_commands + ci;
+        U32 batch_count = (U32)arrlenu(r->batches);
+        Render_Batch *last = (batch_count) ? r->batches + batch_count - 1 : NULL;
+        if (last && r->sorted_commands[last->first_command].key == command->key)
+        {
+            last->command_count += 1;
+            last->element_count += command->count;
+        }
+        else
+        {
+            Render_Batch batch = {render_state_from_key(r, command->key), ci, 1, command->count};
+            arrput(r->batches, batch);
+        }
+    }
+
+    // Chunks by index, for gathering.
+    U32 vertex_chunk_count = (r->vertex_count + RENDER_VERTEX_CHUNK_COUNT - 1) / RENDER_VERTEX_CHUNK_COUNT;
+    r->vertex_chunk_table = push_array(r->arena, Render_Vertex_Chunk *, vertex_chunk_count + 1);
+    U32 chunk_index = 0;
+    for (Render_Vertex_Chunk *chunk = r->first_vertex_chunk; chunk; chunk = chunk->next)
+    { r->vertex_chunk_table[chunk_index++] = chunk; }
+
+    U32 instance_chunk_count = (r->instance_count + RENDER_INSTANCE_CHUNK_COUNT - 1) / RENDER_INSTANCE_CHUNK_COUNT;
+    r->instance_chunk_table = push_array(r->arena, Render_Instance_Chunk *, instance_chunk_count + 1);
+    chunk_index = 0;
+    for (Render_Instance_Chunk *chunk = r->first_instance_chunk; chunk; chunk = chunk->next)
+    { r->instance_chunk_table[chunk_index++] = chunk; }
+
+    r->stats.command_count = command_count;
+    r->stats.batch_count   = (U32)arrlenu(r->batches);
+}
+
+// @Note: Copies `count` quads (four vertices each) or instances of the batch,
+// starting `skip` in, to out. Lets the backend split a batch that doesn't
+// fit in its buffer.
+function void
+render_gather_batch(Renderer *r, Render_Batch *batch, U32 skip, U32 count, void *out)
+{
+    B32 is_instance = (batch->state.shader == RENDER_SHADER_GLYPH);
+    U32 chunk_element_count = (is_instance) ? RENDER_INSTANCE_CHUNK_COUNT : RENDER_VERTEX_CHUNK_COUNT/4;
+    U64 element_size = (is_instance) ? sizeof(Glyph_Instance) : 4*sizeof(Vertex);
 
-    r.vertices[r.vertex_count].uv    = V2{uv_min.x, uv_min.y};
-    r.vertices[r.vertex_count++].pos = V2{min.x, min.y};
+    U8 *dst = (U8 *)out;
+    for (U32 ci = batch->first_command; count && ci < batch->first_command + batch->command_count; ++ci)
+    {
+        Render_Command command = r->sorted_commands[ci];
+        if (skip >= command.count)
+        {
+            skip -= command.count;
+            continue;
+        }
 
-    r.vertices[r.vertex_count].uv    = V2{uv_min.x, uv_max.y};
-    r.vertices[r.vertex_count++].pos = V2{min.x, max.y};
+        U32 index = command.first + skip;
+        U32 left  = min(command.count - skip, count);
+        skip   = 0;
+        count -= left;
 
-    r.vertices[r.vertex_count].uv    = V2{uv_max.x, uv_max.y};
-    r.vertices[r.vertex_count++].pos = V2{max.x, max.y};
+        while (left)
+        {
+            U32 chunk_index = index / chunk_element_count;
+            U32 offset      = index % chunk_element_count;
+            U32 run         = min(left, chunk_element_count - offset);
 
-    r.vertices[r.vertex_count].uv    = V2{uv_max.x, uv_min.y};
-    r.vertices[r.vertex_count++].pos = V2{max.x, min.y};
+            U8 *src = (is_instance) ? (U8 *)(r->instance_chunk_table[chunk_index]->instances + offset)
+                                    : (U8 *)(r->vertex_chunk_table[chunk_index]->vertices + offset*4);
+            memory_copy(dst, src, run*element_size);
 
-    r.indices[r.index_count++] = start_index + 0;
-    r.indices[r.index_count++] = start_index + 1;
-    r.indices[r.index_count++] = start_index + 2;
-    r.indices[r.index_count++] = start_index + 0;
-    r.indices[r.index_count++] = start_index + 2;
-    r.indices[r.index_count++] = start_index + 3;
+            dst   += run*element_size;
+            index += run;
+            left  -= run;
+        }
+    }
 }
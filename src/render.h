@@ -28,8 +28,17 @@
 
    --------------------------------------- */
 
+// @Note: What one GPU draw can take, not what a frame can. A frame's quads
+// and instances are kept in chunks and the backend splits them into as many
+// draws as needed.
 #define MAX_VERTEX_COUNT    65536
-#define MAX_INDEX_COUNT     65536 
+#define MAX_QUAD_COUNT      (MAX_VERTEX_COUNT/4)
+#define MAX_INDEX_COUNT     (MAX_QUAD_COUNT*6)
+
+#define RENDER_VERTEX_CHUNK_COUNT   4096    // multiple of 4, so a quad never straddles chunks.
+#define RENDER_INSTANCE_CHUNK_COUNT 4096
+
+#define RENDER_CLIP_NONE AABB2{V2{-65536.0f, -65536.0f}, V2{65536.0f, 65536.0f}}
 
 typedef struct Vertex Vertex;
 struct Vertex 
@@ -38,19 +47,143 @@ struct Vertex
     V2 uv;
 };
 
-typedef struct Renderer Renderer;
-struct Renderer
+// @Note: One record per glyph, expanded into a quad by glyph_vs_main. The
+// size on screen is the size in the atlas, since glyphs are drawn 1:1, so
+// the texel rect gives both. 24 bytes, against 88 for four Vertex and six
+// indices.
+typedef struct Glyph_Instance Glyph_Instance;
+struct Glyph_Instance
+{
+    V2  min_px;         // bottom-left corner.
+    U16 atlas_x;        // top-left texel of the ink.
+    U16 atlas_y;
+    U16 width;          // in texels, which are also px.
+    U16 height;
+    U32 color;          // RGBA8, multiplies the coverage.
+    U32 page;           // atlas array slice.
+};
+static_assert(sizeof(Glyph_Instance) == 24, "Glyph_Instance must match the instance input layout.");
+
+#define GLYPH_COLOR_WHITE 0xffffffff
+
+typedef enum Render_Shader
 {
-    U32 vertex_count = 0;
-    Vertex vertices[MAX_VERTEX_COUNT];
+    RENDER_SHADER_PANEL,        // flat quads.
+    RENDER_SHADER_TEXTURE,      // textured quads, sampling the state's page.
+    RENDER_SHADER_GLYPH,        // glyph instances, each naming its own page.
+    RENDER_SHADER_COUNT,
+} Render_Shader;
 
-    U32 index_count = 0;
-    U32 indices[MAX_INDEX_COUNT];
+typedef enum Render_Blend
+{
+    RENDER_BLEND_ALPHA,
+    RENDER_BLEND_MAX,           // ClearType coverage. Order doesn't matter.
+    RENDER_BLEND_COUNT,
+} Render_Blend;
+
+// @Note: Layers are drawn back to front. Within a layer draws are sorted by
+// state, so they must either not overlap or blend regardless of order.
+typedef struct Render_State Render_State;
+struct Render_State
+{
+    U32 layer;
+    Render_Shader shader;
+    Render_Blend blend;
+    U32 page;
+    AABB2 clip_px;              // scissor, RENDER_CLIP_NONE for none.
 };
 
-global Renderer renderer;
+// A run of quads or instances (by shader) recorded under one state.
+typedef struct Render_Command Render_Command;
+struct Render_Command
+{
+    U64 key;                    // see render_set_state().
+    U32 first;
+    U32 count;
+};
+
+// Sorted commands of one state, drawn together.
+typedef struct Render_Batch Render_Batch;
+struct Render_Batch
+{
+    Render_State state;
+    U32 first_command;
+    U32 command_count;
+    U32 element_count;          // quads or instances.
+};
+
+typedef struct Render_Vertex_Chunk Render_Vertex_Chunk;
+struct Render_Vertex_Chunk
+{
+    Render_Vertex_Chunk *next;
+    U32 count;
+    Vertex vertices[RENDER_VERTEX_CHUNK_COUNT];
+};
+
+typedef struct Render_Instance_Chunk Render_Instance_Chunk;
+struct Render_Instance_Chunk
+{
+    Render_Instance_Chunk *next;
+    U32 count;
+    Glyph_Instance instances[RENDER_INSTANCE_CHUNK_COUNT];
+};
+
+typedef struct Render_Stats Render_Stats;
+struct Render_Stats
+{
+    U64 frame_bytes;        // chunks taken from the frame arena.
+    U64 upload_bytes;       // copied into GPU buffers, counted by the backend.
+    U32 command_count;
+    U32 batch_count;
+    U32 draw_count;         // counted by the backend, a batch may take several.
+    U32 state_change_count; // counted by the backend.
+    B32 is_reused;          // the backend drew the last frame again.
+};
+
+// @Note: Chunks live in the frame arena, so render_begin_frame() after the
+// arena is cleared. Quads and instances are recorded under the current
+// state, and render_build_batches() sorts and merges them for the backend.
+typedef struct Renderer Renderer;
+struct Renderer
+{
+    Arena *arena;
+
+    Render_State state;
+    U64 state_key;
+    AABB2 *clips;                   // stb_ds array, distinct clip rects of the frame.
+    Render_Command *commands;       // stb_ds array, in the order recorded.
+    Render_Command *sorted_commands;// stb_ds array.
+    Render_Batch *batches;          // stb_ds array.
+
+    // Four vertices per quad. The indices are the same every frame, see
+    // render_fill_quad_indices().
+    U32 vertex_count;
+    Render_Vertex_Chunk *first_vertex_chunk;
+    Render_Vertex_Chunk *last_vertex_chunk;
+
+    U32 instance_count;
+    Render_Instance_Chunk *first_instance_chunk;
+    Render_Instance_Chunk *last_instance_chunk;
+
+    // Chunks by index, made by render_build_batches().
+    Render_Vertex_Chunk **vertex_chunk_table;
+    Render_Instance_Chunk **instance_chunk_table;
+
+    Render_Stats stats;
+};
 
-function void render_quad_px_min_max(V2 min, V2 max);
+function void render_fill_quad_indices(U16 *indices, U32 quad_count);
+function void render_begin_frame(Renderer *r, Arena *frame_arena);
+function void render_set_state(Renderer *r, Render_State state);
+function void render_record(Renderer *r, U32 index);
+function Vertex *render_push_quad(Renderer *r);
+function void render_quad_px_min_max(Renderer *r, V2 min, V2 max);
+function void render_texture(Renderer *r, V2 min, V2 max, V2 uv_min, V2 uv_max);
+function void render_glyph_instance(Renderer *r, Glyph_Instance glyph);
+function void render_glyph_instance_clipped(Renderer *r, Glyph_Instance glyph, AABB2 box_clip);
+function void render_sort_commands(Render_Command *commands, U32 count, Render_Command *temp);
+function void render_build_batches(Renderer *r);
+function void render_gather_batch(Renderer *r, Render_Batch *batch, U32 skip, U32 count, void *out);
 
 
 #endif // RENDER_H
@@ -0,0 +1,484 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function U16
+simple_text_read_u16be(U8 *at)
+{
+    U16 result = (U16)((at[0] << 8) | at[1]);
+    return result;
+}
+
+function U32
+simple_text_read_u32be(U8 *at)
+{
+    U32 result = ((U32)at[0] << 24) | ((U32)at[1] << 16) | ((U32)at[2] << 8) | (U32)at[3];
+    return result;
+}
+
+function U32
+simple_text_tag(char a, char b, char c, char d)
+{
+    U32 result = ((U32)(U8)a << 24) | ((U32)(U8)b << 16) | ((U32)(U8)c << 8) | (U32)(U8)d;
+    return result;
+}
+
+// @Note: Only formats 4 (BMP segments) and 12 (segmented coverage) are handled.
+// Everything else returns 0 (.notdef), which keeps the face off the fast path.
+function U16
+simple_text_cmap_subtable_lookup(U8 *subtable, U64 size, U32 codepoint)
+{
+    U16 result = 0;
+
+    if (size < 4)
+    { return result; }
+
+    U16 format = simple_text_read_u16be(subtable);
+    if (format == 4)
+    {
+        if (size < 14)
+        { return result; }
+
+        U32 seg_count = simple_text_read_u16be(subtable + 6) / 2;
+        U8 *end_codes        = subtable + 14;
+        U8 *start_codes      = end_codes + 2*seg_count + 2; // skip reservedPad
+        U8 *id_deltas        = start_codes + 2*seg_count;
+        U8 *id_range_offsets = id_deltas + 2*seg_count;
+
+        if ((U64)(id_range_offsets + 2*seg_count - subtable) > size)
+        { return result; }
+
+        for (U32 seg = 0; seg < seg_count; ++seg)
+        {
+            U16 end_code = simple_text_read_u16be(end_codes + 2*seg);
+            if (codepoint <= end_code)
+            {
+                U16 start_code = simple_text_read_u16be(start_codes + 2*seg);
+                if (codepoint >= start_code)
+                {
+                    U16 id_delta        = simple_text_read_u16be(id_deltas + 2*seg);
+                    U16 id_range_offset = simple_text_read_u16be(id_range_offsets + 2*seg);
+
+                    if (id_range_offset == 0)
+                    {
+                        result = (U16)(codepoint + id_delta);
+                    }
+                    else
+                    {
+                        U8 *glyph_at = id_range_offsets + 2*seg + id_range_offset + 2*(codepoint - start_code);
+                        if ((U64)(glyph_at + 2 - subtable) <= size)
+                        {
+                            U16 glyph_index = simple_text_read_u16be(glyph_at);
+                            if (glyph_index)
+                            { result = (U16)(glyph_index + id_delta); }
+                        }
+                    }
+                }
+                break;
+            }
+        }
+    }
+    else if (format == 12)
+    {
+        if (size < 16)
+        { return result; }
+
+        U32 group_count = simple_text_read_u32be(subtable + 12);
+        if (16 + (U64)group_count*12 > size)
+        { return result; }
+
+        for (U32 gi = 0; gi < group_count; ++gi)
+        {
+            U8 *group = subtable + 16 + gi*12;
+            U32 start_char = simple_text_read_u32be(group);
+            U32 end_char   = simple_text_read_u32be(group + 4);
+            if (codepoint >= start_char && codepoint <= end_char)
+            {
+                U32 glyph_index = simple_text_read_u32be(group + 8) + (codepoint - start_char);
+                result = (glyph_index <= 0xffff) ? (U16)glyph_index : 0;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// @Note: Picks the best Unicode subtable the same way most shapers do:
+// Windows full repertoire (3,10) > Windows BMP (3,1) > Unicode platform (0,*).
+function B32
+simple_text_parse_cmap(Simple_Text_Table *table, U8 *cmap, U64 cmap_size)
+{
+    B32 result = false;
+
+    if (cmap_size < 4)
+    { return result; }
+
+    U32 record_count = simple_text_read_u16be(cmap + 2);
+    if (4 + (U64)record_count*8 > cmap_size)
+    { return result; }
+
+    U8 *best_subtable = NULL;
+    U64 best_size = 0;
+    S32 best_rank = 0;
+
+    for (U32 ri = 0; ri < record_count; ++ri)
+    {
+        U8 *record = cmap + 4 + ri*8;
+        U16 platform_id = simple_text_read_u16be(record);
+        U16 encoding_id = simple_text_read_u16be(record + 2);
+        U32 offset      = simple_text_read_u32be(record + 4);
+
+        S32 rank = 0;
+        if (platform_id == 3 && encoding_id == 10)     { rank = 3; }
+        else if (platform_id == 3 && encoding_id == 1) { rank = 2; }
+        else if (platform_id == 0)                     { rank = 1; }
+
+        if (rank > best_rank && offset < cmap_size)
+        {
+            best_rank     = rank;
+            best_subtable = cmap + offset;
+            best_size     = cmap_size - offset;
+        }
+    }
+
+    if (best_subtable)
+    {
+        for (U32 cp = 0; cp < SIMPLE_TEXT_CODEPOINT_COUNT; ++cp)
+        {
+            table->glyph_indices[cp] = simple_text_cmap_subtable_lookup(best_subtable, best_size, cp);
+        }
+        result = true;
+    }
+
+    return result;
+}
+
+// @Note: Checks the FeatureList of a GSUB/GPOS table for default-on features
+// that would make the shaped result differ from a plain cmap lookup. A table
+// that's cut short counts as having them, so the analyzer deals with it.
+function B32
+simple_text_has_shaping_features(U8 *layout_table, U64 layout_table_size)
+{
+    B32 result = false;
+
+    if (layout_table_size < 10)
+    { return true; }
+
+    U32 feature_list_offset = simple_text_read_u16be(layout_table + 6);
+    if (feature_list_offset + 2 > layout_table_size)
+    { return true; }
+
+    U8 *feature_list = layout_table + feature_list_offset;
+    U32 feature_count = simple_text_read_u16be(feature_list);
+    if (feature_list_offset + 2 + (U64)feature_count*6 > layout_table_size)
+    { return true; }
+
+    U32 tags[] =
+    {
+        simple_text_tag('l','i','g','a'),
+        simple_text_tag('c','l','i','g'),
+        simple_text_tag('c','a','l','t'),
+        simple_text_tag('r','l','i','g'),
+        simple_text_tag('k','e','r','n'),
+    };
+
+    for (U32 fi = 0; fi < feature_count && !result; ++fi)
+    {
+        U32 tag = simple_text_read_u32be(feature_list + 2 + fi*6);
+        for (U32 ti = 0; ti < array_count(tags); ++ti)
+        {
+            if (tag == tags[ti])
+            {
+                result = true;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// @Note: Bounds-checked read relative to the start of a table. Out-of-range
+// reads yield 0, which every caller below treats as "nothing there".
+function U16
+simple_text_u16_at(U8 *table, U64 table_size, U64 offset)
+{
+    U16 result = 0;
+    if (offset + 2 <= table_size)
+    { result = simple_text_read_u16be(table + offset); }
+    return result;
+}
+
+function B32
+simple_text_coverage_contains(U8 *table, U64 table_size, U64 coverage_offset, U16 glyph_index)
+{
+    B32 result = false;
+
+    U16 format = simple_text_u16_at(table, table_size, coverage_offset);
+    U16 count  = simple_text_u16_at(table, table_size, coverage_offset + 2);
+
+    if (format == 1)
+    {
+        for (U32 i = 0; i < count && !result; ++i)
+        { result = (simple_text_u16_at(table, table_size, coverage_offset + 4 + 2*i) == glyph_index); }
+    }
+    else if (format == 2)
+    {
+        for (U32 i = 0; i < count && !result; ++i)
+        {
+            U64 record = coverage_offset + 4 + 6*i;
+            U16 start = simple_text_u16_at(table, table_size, record);
+            U16 end   = simple_text_u16_at(table, table_size, record + 2);
+            result = (glyph_index >= start && glyph_index <= end);
+        }
+    }
+
+    return result;
+}
+
+function U16
+simple_text_class_of(U8 *table, U64 table_size, U64 class_def_offset, U16 glyph_index)
+{
+    U16 result = 0;
+
+    U16 format = simple_text_u16_at(table, table_size, class_def_offset);
+    if (format == 1)
+    {
+        U16 start_glyph = simple_text_u16_at(table, table_size, class_def_offset + 2);
+        U16 glyph_count = simple_text_u16_at(table, table_size, class_def_offset + 4);
+        if (glyph_index >= start_glyph && glyph_index < start_glyph + glyph_count)
+        { result = simple_text_u16_at(table, table_size, class_def_offset + 6 + 2*(glyph_index - start_glyph)); }
+    }
+    else if (format == 2)
+    {
+        U16 range_count = simple_text_u16_at(table, table_size, class_def_offset + 2);
+        for (U32 i = 0; i < range_count; ++i)
+        {
+            U64 record = class_def_offset + 4 + 6*i;
+            U16 start = simple_text_u16_at(table, table_size, record);
+            U16 end   = simple_text_u16_at(table, table_size, record + 2);
+            if (glyph_index >= start && glyph_index <= end)
+            {
+                result = simple_text_u16_at(table, table_size, record + 4);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// @Note: Conservative check whether a lookup subtable can match the glyph in any
+// position. Coverage tables, class definitions and chained-context coverages are
+// inspected. Glyph ids spelled out inside format 1 context rules are not, since
+// those rules are keyed by their first glyph's coverage anyway.
+function B32
+simple_text_subtable_touches_glyph(U8 *table, U64 table_size, U64 subtable_offset,
+                                   U32 lookup_type, B32 is_gpos, U16 glyph_index)
+{
+    B32 result = false;
+
+    U16 format = simple_text_u16_at(table, table_size, subtable_offset);
+    U32 extension_type = is_gpos ? 9 : 7;
+    U32 context_type   = is_gpos ? 7 : 5;
+    U32 chained_type   = is_gpos ? 8 : 6;
+
+    if (lookup_type == extension_type)
+    {
+        if (subtable_offset + 8 <= table_size)
+        {
+            U32 real_type   = simple_text_u16_at(table, table_size, subtable_offset + 2);
+            U64 real_offset = subtable_offset + simple_text_read_u32be(table + subtable_offset + 4);
+            if (real_type != extension_type)
+            { result = simple_text_subtable_touches_glyph(table, table_size, real_offset, real_type, is_gpos, glyph_index); }
+        }
+    }
+    else if (lookup_type == context_type && format == 3)
+    {
+        U16 glyph_count = simple_text_u16_at(table, table_size, subtable_offset + 2);
+        for (U32 i = 0; i < glyph_count && !result; ++i)
+        {
+            U64 coverage = subtable_offset + simple_text_u16_at(table, table_size, subtable_offset + 6 + 2*i);
+            result = simple_text_coverage_contains(table, table_size, coverage, glyph_index);
+        }
+    }
+    else if (lookup_type == chained_type && format == 3)
+    {
+        U64 at = subtable_offset + 2;
+        for (U32 sequence = 0; sequence < 3 && !result; ++sequence) // backtrack, input, lookahead
+        {
+            U16 glyph_count = simple_text_u16_at(table, table_size, at);
+            for (U32 i = 0; i < glyph_count && !result; ++i)
+            {
+                U64 coverage = subtable_offset + simple_text_u16_at(table, table_size, at + 2 + 2*i);
+                result = simple_text_coverage_contains(table, table_size, coverage, glyph_index);
+            }
+            at += 2 + 2*(U64)glyph_count;
+        }
+    }
+    else
+    {
+        U64 coverage = subtable_offset + simple_text_u16_at(table, table_size, subtable_offset + 2);
+        result = simple_text_coverage_contains(table, table_size, coverage, glyph_index);
+
+        if (!result && is_gpos && lookup_type >= 4 && lookup_type <= 6)
+        {
+            // Mark attachment: the base/ligature/mark2 coverage sits right after.
+            U64 coverage2 = subtable_offset + simple_text_u16_at(table, table_size, subtable_offset + 4);
+            result = simple_text_coverage_contains(table, table_size, coverage2, glyph_index);
+        }
+        else if (!result && is_gpos && lookup_type == 2 && format == 2)
+        {
+            U64 class_def2 = subtable_offset + simple_text_u16_at(table, table_size, subtable_offset + 10);
+            result = (simple_text_class_of(table, table_size, class_def2, glyph_index) != 0);
+        }
+        else if (!result && is_gpos && lookup_type == 2 && format == 1)
+        {
+            U16 value_format1 = simple_text_u16_at(table, table_size, subtable_offset + 4);
+            U16 value_format2 = simple_text_u16_at(table, table_size, subtable_offset + 6);
+            U16 pair_set_count = simple_text_u16_at(table, table_size, subtable_offset + 8);
+
+            U32 value_size1 = 0, value_size2 = 0;
+            for (U32 bit = 0; bit < 8; ++bit)
+            {
+                value_size1 += ((value_format1 >> bit) & 1) * 2;
+                value_size2 += ((value_format2 >> bit) & 1) * 2;
+            }
+            U32 record_size = 2 + value_size1 + value_size2;
+
+            for (U32 psi = 0; psi < pair_set_count && !result; ++psi)
+            {
+                U64 pair_set = subtable_offset + simple_text_u16_at(table, table_size, subtable_offset + 10 + 2*psi);
+                U16 pair_count = simple_text_u16_at(table, table_size, pair_set);
+                for (U32 pi = 0; pi < pair_count && !result; ++pi)
+                { result = (simple_text_u16_at(table, table_size, pair_set + 2 + pi*record_size) == glyph_index); }
+            }
+        }
+        else if (!result && (lookup_type == context_type || lookup_type == chained_type) && format == 2)
+        {
+            U32 class_def_count = (lookup_type == chained_type) ? 3 : 1;
+            for (U32 ci = 0; ci < class_def_count && !result; ++ci)
+            {
+                U64 class_def = subtable_offset + simple_text_u16_at(table, table_size, subtable_offset + 4 + 2*ci);
+                result = (simple_text_class_of(table, table_size, class_def, glyph_index) != 0);
+            }
+        }
+    }
+
+    return result;
+}
+
+function B32
+simple_text_layout_touches_glyph(U8 *layout_table, U64 layout_table_size, B32 is_gpos, U16 glyph_index)
+{
+    B32 result = false;
+
+    U64 lookup_list = simple_text_u16_at(layout_table, layout_table_size, 8);
+    U16 lookup_count = simple_text_u16_at(layout_table, layout_table_size, lookup_list);
+
+    for (U32 li = 0; li < lookup_count && !result; ++li)
+    {
+        U64 lookup = lookup_list + simple_text_u16_at(layout_table, layout_table_size, lookup_list + 2 + 2*li);
+        U32 lookup_type = simple_text_u16_at(layout_table, layout_table_size, lookup);
+        U16 subtable_count = simple_text_u16_at(layout_table, layout_table_size, lookup + 4);
+
+        for (U32 si = 0; si < subtable_count && !result; ++si)
+        {
+            U64 subtable = lookup + simple_text_u16_at(layout_table, layout_table_size, lookup + 6 + 2*si);
+            result = simple_text_subtable_touches_glyph(layout_table, layout_table_size, subtable, lookup_type, is_gpos, glyph_index);
+        }
+    }
+
+    return result;
+}
+
+// @Note: Printable ASCII and printable Latin-1. Controls (C0, DEL, C1) and
+// U+00AD SOFT HYPHEN are left to the analyzer: they don't necessarily map to
+// a visible glyph, and the cmap gives the soft hyphen a visible one.
+function B32
+simple_text_is_simple_char(U16 c)
+{
+    B32 result = ((c >= 0x20 && c <= 0x7e) || (c >= 0xa0 && c <= 0xff && c != 0xad));
+    return result;
+}
+
+function U32
+simple_text_ctz32(U32 x)
+{
+#if defined(_MSC_VER)
+    unsigned long result;
+    _BitScanForward(&result, x);
+    return (U32)result;
+#else
+    return (U32)__builtin_ctz(x);
+#endif
+}
+
+// @Note: Returns the length of the leading span of simple characters.
+// If the span doesn't reach the end of the text, the last character is handed
+// back to the analyzer, since a following combining mark has to be shaped
+// together with its base.
+function U32
+simple_text_scan(U16 *text, U32 text_length)
+{
+    U32 length = 0;
+
+#if SIMPLE_TEXT_SSE2
+    __m128i lo_a   = _mm_set1_epi16(0x20);
+    __m128i span_a = _mm_set1_epi16(0x7e - 0x20);
+    __m128i lo_b   = _mm_set1_epi16(0xa0);
+    __m128i span_b = _mm_set1_epi16(0xff - 0xa0);
+    __m128i shy    = _mm_set1_epi16(0xad);
+    __m128i zero   = _mm_setzero_si128();
+
+    while (length + 8 <= text_length)
+    {
+        __m128i c = _mm_loadu_si128((__m128i *)(text + length));
+
+        // (c - lo) <= span, unsigned: saturating subtract leaves zero iff in range.
+        __m128i in_a = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(c, lo_a), span_a), zero);
+        __m128i in_b = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(c, lo_b), span_b), zero);
+        __m128i is_shy = _mm_cmpeq_epi16(c, shy);
+        U32 mask = (U32)_mm_movemask_epi8(_mm_andnot_si128(is_shy, _mm_or_si128(in_a, in_b)));
+
+        if (mask != 0xffff)
+        {
+            length += simple_text_ctz32(~mask & 0xffff) / 2;
+            break;
+        }
+        length += 8;
+    }
+#endif
+
+    while (length < text_length && simple_text_is_simple_char(text[length]))
+    { ++length; }
+
+    if (length < text_length && length > 0)
+    { --length; }
+
+    return length;
+}
+
+// @Note: Maps a span found by simple_text_scan(). Stops early at the first
+// character the face doesn't cover, returning the count actually mapped.
+function U32
+simple_text_map(Simple_Text_Table *table,
+                U16 *text, U32 text_length, F32 px_per_du,
+                U16 *out_indices, F32 *out_advances)
+{
+    U32 result = 0;
+
+    for (; result < text_length; ++result)
+    {
+        U16 c = text[result];
+        assert(c < SIMPLE_TEXT_CODEPOINT_COUNT);
+
+        U16 glyph_index = table->glyph_indices[c];
+        if (glyph_index == 0)
+        { break; }
+
+        out_indices[result]  = glyph_index;
+        out_advances[result] = (F32)table->advances_du[c] * px_per_du;
+    }
+
+    return result;
+}
@@ -0,0 +1,54 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef SIMPLE_TEXT_H
+#define SIMPLE_TEXT_H
+
+/* --------------------------------------
+   @Note: Table-driven fast path for simple text.
+
+   Pure ASCII/Latin-1 text in a face without default-on ligature or kerning
+   features maps 1:1 from characters to glyphs. For that case we don't need
+   the text analyzer at all: the face's cmap and design advances for the
+   first 256 codepoints are cached in dense tables, and a span is mapped with
+   two table lookups per character.
+
+   Everything here works on raw OpenType table bytes and UTF-16 code units,
+   so it doesn't depend on any particular font backend.
+   --------------------------------------- */
+
+#if defined(_M_X64) || defined(__SSE2__)
+#  include <emmintrin.h>
+#  define SIMPLE_TEXT_SSE2 1
+#else
+#  define SIMPLE_TEXT_SSE2 0
+#endif
+
+#define SIMPLE_TEXT_CODEPOINT_COUNT 256
+
+typedef struct Simple_Text_Table Simple_Text_Table;
+struct Simple_Text_Table
+{
+    B32 is_eligible; // cmap was parsed and no ligature/kerning feature is present.
+    B32 space_is_contextual; // the space glyph takes part in some GSUB/GPOS lookup.
+    U16 glyph_indices[SIMPLE_TEXT_CODEPOINT_COUNT];
+    S32 advances_du[SIMPLE_TEXT_CODEPOINT_COUNT];
+};
+
+function U16 simple_text_read_u16be(U8 *at);
+function U32 simple_text_read_u32be(U8 *at);
+function U32 simple_text_tag(char a, char b, char c, char d);
+
+function U16 simple_text_cmap_subtable_lookup(U8 *subtable, U64 size, U32 codepoint);
+function B32 simple_text_parse_cmap(Simple_Text_Table *table, U8 *cmap, U64 cmap_size);
+function B32 simple_text_has_shaping_features(U8 *layout_table, U64 layout_table_size);
+
+function U16 simple_text_u16_at(U8 *table, U64 table_size, U64 offset);
+function B32 simple_text_coverage_contains(U8 *table, U64 table_size, U64 coverage_offset, U16 glyph_index);
+function U16 simple_text_class_of(U8 *table, U64 table_size, U64 class_def_offset, U16 glyph_index);
+function B32 simple_text_subtable_touches_glyph(U8 *table, U64 table_size, U64 subtable_offset, U32 lookup_type, B32 is_gpos, U16 glyph_index);
+function B32 simple_text_layout_touches_glyph(U8 *layout_table, U64 layout_table_size, B32 is_gpos, U16 glyph_index);
+
+function B32 simple_text_is_simple_char(U16 c);
+function U32 simple_text_scan(U16 *text, U32 text_length);
+function U32 simple_text_map(Simple_Text_Table *table, U16 *text, U32 text_length, F32 px_per_du, U16 *out_indices, F32 *out_advances);
+
+#endif // SIMPLE_TEXT_H
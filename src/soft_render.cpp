@@ -0,0 +1,451 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function void
+soft_render_fill_span(U32 *dst, U32 count, U32 color)
+{
+    U32 i = 0;
+#if SOFT_RENDER_AVX2
+    __m256i c8 = _mm256_set1_epi32((int)color);
+    for (; i + 8 <= count; i += 8)
+    { _mm256_storeu_si256((__m256i *)(dst + i), c8); }
+#endif
+#if SIMPLE_TEXT_SSE2
+    __m128i c4 = _mm_set1_epi32((int)color);
+    for (; i + 4 <= count; i += 4)
+    { _mm_storeu_si128((__m128i *)(dst + i), c4); }
+#endif
+    for (; i < count; ++i)
+    { dst[i] = color; }
+}
+
+// @Note: dst = max(dst, src*color) per channel, which is glyph_ps_main under
+// glyph_blend_state. round(t*c/255) is exact as (x + 128 + ((x + 128) >> 8)) >> 8
+// for x = t*c, and the float math of the GPU can't land on a tie for 8-bit t and c.
+function void
+soft_render_max_span(U32 *dst, U32 *src, U32 count, U32 color)
+{
+    U32 i = 0;
+
+    if (color == GLYPH_COLOR_WHITE)
+    {
+#if SOFT_RENDER_AVX2
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i d = _mm256_loadu_si256((__m256i *)(dst + i));
+            __m256i s = _mm256_loadu_si256((__m256i *)(src + i));
+            _mm256_storeu_si256((__m256i *)(dst + i), _mm256_max_epu8(d, s));
+        }
+#endif
+#if SIMPLE_TEXT_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i d = _mm_loadu_si128((__m128i *)(dst + i));
+            __m128i s = _mm_loadu_si128((__m128i *)(src + i));
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_max_epu8(d, s));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            U32 d = dst[i];
+            U32 s = src[i];
+            U32 result = 0;
+            for (U32 shift = 0; shift < 32; shift += 8)
+            { result |= max((d >> shift) & 0xff, (s >> shift) & 0xff) << shift; }
+            dst[i] = result;
+        }
+        return;
+    }
+
+#if SIMPLE_TEXT_SSE2
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i c16  = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero);
+        __m128i half = _mm_set1_epi16(128);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i d = _mm_loadu_si128((__m128i *)(dst + i));
+            __m128i s = _mm_loadu_si128((__m128i *)(src + i));
+
+            __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), c16), half);
+            __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), c16), half);
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_max_epu8(d, _mm_packus_epi16(lo, hi)));
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        U32 d = dst[i];
+        U32 s = src[i];
+        U32 result = 0;
+        for (U32 shift = 0; shift < 32; shift += 8)
+        {
+            U32 x = ((s >> shift) & 0xff)*((color >> shift) & 0xff) + 128;
+            x = (x + (x >> 8)) >> 8;
+            result |= max((d >> shift) & 0xff, x) << shift;
+        }
+        dst[i] = result;
+    }
+}
+
+// @Note: Per pixel, for the quads that aren't flat or 1:1. ALPHA is
+// alpha_blend_state: src*a + dst*(1-a) in color, src + dst in alpha.
+function U32
+soft_render_blend_pixel(U32 dst, U32 src, Render_Blend blend)
+{
+    U32 result = 0;
+    if (blend == RENDER_BLEND_MAX)
+    {
+        for (U32 shift = 0; shift < 32; shift += 8)
+        { result |= max((dst >> shift) & 0xff, (src >> shift) & 0xff) << shift; }
+    }
+    else
+    {
+        F32 a = (F32)(src >> 24) / 255.0f;
+        for (U32 shift = 0; shift < 24; shift += 8)
+        {
+            F32 c = (F32)((src >> shift) & 0xff)*a + (F32)((dst >> shift) & 0xff)*(1.0f - a);
+            result |= (U32)(c + 0.5f) << shift;
+        }
+        result |= min((src >> 24) + (dst >> 24), 255u) << 24;
+    }
+    return result;
+}
+
+// The rasterizer's 8 bits of subpixel precision.
+function F32
+soft_render_snap(F32 px)
+{
+    F32 result = floorf(px*256.0f + 0.5f) / 256.0f;
+    return result;
+}
+
+// @Note: Pixels whose centers are inside, with the top and left edges
+// inclusive. Our y goes up and the target's rows go down.
+function Soft_Render_Rect
+soft_render_rect_from_px(F32 min_x, F32 min_y, F32 max_x, F32 max_y, U32 target_height)
+{
+    F32 h = (F32)target_height;
+
+    Soft_Render_Rect result = {};
+    result.left   = (S32)ceilf(soft_render_snap(min_x) - 0.5f);
+    result.right  = (S32)ceilf(soft_render_snap(max_x) - 0.5f);
+    result.top    = (S32)ceilf(h - soft_render_snap(max_y) - 0.5f);
+    result.bottom = (S32)ceilf(h - soft_render_snap(min_y) - 0.5f);
+    return result;
+}
+
+// Same rounding as d3d11_scissor_from_clip().
+function Soft_Render_Rect
+soft_render_rect_from_clip(AABB2 clip_px, U32 target_width, U32 target_height)
+{
+    F32 w = (F32)target_width;
+    F32 h = (F32)target_height;
+
+    Soft_Render_Rect result = {};
+    result.left   = (S32)max(0.0f, min(w, floorf(clip_px.min.x)));
+    result.right  = (S32)max(0.0f, min(w, ceilf(clip_px.max.x)));
+    result.top    = (S32)max(0.0f, min(h, h - ceilf(clip_px.max.y)));
+    result.bottom = (S32)max(0.0f, min(h, h - floorf(clip_px.min.y)));
+    return result;
+}
+
+function Soft_Render_Rect
+soft_render_rect_intersect(Soft_Render_Rect a, Soft_Render_Rect b)
+{
+    Soft_Render_Rect result = {};
+    result.left   = max(a.left, b.left);
+    result.top    = max(a.top, b.top);
+    result.right  = max(result.left, min(a.right, b.right));
+    result.bottom = max(result.top, min(a.bottom, b.bottom));
+    return result;
+}
+
+// An array index past the end is clamped, like the GPU does.
+function Bitmap *
+soft_render_page(Soft_Render_Frame *frame, U32 page)
+{
+    Bitmap *result = frame->atlas_pages + min(page, frame->atlas_page_count - 1);
+    return result;
+}
+
+// @Note: A glyph is 1:1 and its size is whole texels, so its rect is exactly
+// width x height pixels and pixel (left + c, top + r) samples texel
+// (atlas_x + c, atlas_y + r). Texels past the atlas are border, i.e. zero,
+// which never wins a MAX, so they're cut instead.
+function U64
+soft_render_glyph(Soft_Render_Frame *frame, Glyph_Instance *glyph, Soft_Render_Rect rect, Soft_Render_Rect clip)
+{
+    Bitmap *target = frame->target;
+    Bitmap *atlas = soft_render_page(frame, glyph->page);
+
+    Soft_Render_Rect atlas_rect = {};
+    atlas_rect.left   = rect.left - (S32)glyph->atlas_x;
+    atlas_rect.top    = rect.top - (S32)glyph->atlas_y;
+    atlas_rect.right  = atlas_rect.left + (S32)atlas->width;
+    atlas_rect.bottom = atlas_rect.top + (S32)atlas->height;
+
+    Soft_Render_Rect draw = soft_render_rect_intersect(soft_render_rect_intersect(rect, clip), atlas_rect);
+    U32 width = (U32)(draw.right - draw.left);
+    if (! width || draw.top == draw.bottom)
+    { return 0; }
+
+    U32 texel_x = (U32)(draw.left - atlas_rect.left);
+    U32 texel_y = (U32)(draw.top - atlas_rect.top);
+    for (S32 row = draw.top; row < draw.bottom; ++row, ++texel_y)
+    {
+        U32 *dst = (U32 *)(target->data + row*target->pitch) + draw.left;
+        U32 *src = (U32 *)(atlas->data + texel_y*atlas->pitch) + texel_x;
+        soft_render_max_span(dst, src, width, glyph->color);
+    }
+
+    return (U64)width*(U64)(draw.bottom - draw.top);
+}
+
+// @Note: Vertices in render_push_quad() order: v[0] at min, v[2] at max.
+// Textured quads interpolate the uv at each pixel center and point-sample.
+function U64
+soft_render_quad(Soft_Render_Frame *frame, Vertex *v, Render_State *state, Soft_Render_Rect clip)
+{
+    Bitmap *target = frame->target;
+
+    Soft_Render_Rect rect = soft_render_rect_from_px(v[0].pos.x, v[0].pos.y, v[2].pos.x, v[2].pos.y, target->height);
+    Soft_Render_Rect draw = soft_render_rect_intersect(rect, clip);
+    U32 width = (U32)(draw.right - draw.left);
+    if (! width || draw.top == draw.bottom)
+    { return 0; }
+
+    if (state->shader == RENDER_SHADER_PANEL)
+    {
+        for (S32 row = draw.top; row < draw.bottom; ++row)
+        {
+            U32 *dst = (U32 *)(target->data + row*target->pitch) + draw.left;
+            if (state->blend == RENDER_BLEND_ALPHA)
+            {
+                soft_render_fill_span(dst, width, SOFT_RENDER_PANEL_COLOR);
+            }
+            else
+            {
+                for (U32 i = 0; i < width; ++i)
+                { dst[i] = soft_render_blend_pixel(dst[i], SOFT_RENDER_PANEL_COLOR, state->blend); }
+            }
+        }
+    }
+    else
+    {
+        Bitmap *texture = soft_render_page(frame, state->page);
+        F32 x0 = soft_render_snap(v[0].pos.x);
+        F32 y0 = soft_render_snap(v[0].pos.y);
+        F32 x1 = soft_render_snap(v[2].pos.x);
+        F32 y1 = soft_render_snap(v[2].pos.y);
+        F32 h  = (F32)target->height;
+
+        for (S32 row = draw.top; row < draw.bottom; ++row)
+        {
+            F32 t_y = (h - ((F32)row + 0.5f) - y0) / (y1 - y0);
+            F32 uv_y = v[0].uv.y + t_y*(v[1].uv.y - v[0].uv.y);
+            S32 texel_y = (S32)floorf(uv_y*(F32)texture->height);
+
+            U32 *dst = (U32 *)(target->data + row*target->pitch);
+            for (S32 column = draw.left; column < draw.right; ++column)
+            {
+                F32 t_x = ((F32)column + 0.5f - x0) / (x1 - x0);
+                F32 uv_x = v[0].uv.x + t_x*(v[2].uv.x - v[0].uv.x);
+                S32 texel_x = (S32)floorf(uv_x*(F32)texture->width);
+
+                U32 texel = 0;
+                if (texel_x >= 0 && texel_x < (S32)texture->width && texel_y >= 0 && texel_y < (S32)texture->height)
+                { texel = ((U32 *)(texture->data + texel_y*texture->pitch))[texel_x]; }
+
+                dst[column] = soft_render_blend_pixel(dst[column], texel, state->blend);
+            }
+        }
+    }
+
+    return (U64)width*(U64)(draw.bottom - draw.top);
+}
+
+function void
+soft_render_band(Soft_Render_Task *task, Soft_Render_Rect band)
+{
+    Soft_Render_Frame *frame = task->frame;
+    Renderer *r = frame->renderer;
+    Bitmap *target = frame->target;
+
+    for (U32 bi = 0; bi < (U32)arrlenu(r->batches); ++bi)
+    {
+        Render_Batch *batch = r->batches + bi;
+        Soft_Render_Rect scissor = soft_render_rect_from_clip(batch->state.clip_px, target->width, target->height);
+        Soft_Render_Rect clip = soft_render_rect_intersect(scissor, band);
+        if (clip.left == clip.right || clip.top == clip.bottom)
+        { continue; }
+
+        U32 first = frame->batch_firsts[bi];
+        if (batch->state.shader == RENDER_SHADER_GLYPH)
+        {
+            for (U32 ei = first; ei < first + batch->element_count; ++ei)
+            {
+                Soft_Render_Rect rect = frame->glyph_rects[ei];
+                if (rect.bottom > clip.top && rect.top < clip.bottom)
+                { task->stats.pixel_count += soft_render_glyph(frame, frame->instances + ei, rect, clip); }
+            }
+        }
+        else
+        {
+            for (U32 ei = 0; ei < batch->element_count; ++ei)
+            { task->stats.pixel_count += soft_render_quad(frame, frame->vertices + 4*(first + ei), &batch->state, clip); }
+        }
+    }
+}
+
+// Bands first_band, first_band + band_step, ... so text-heavy regions are
+// shared out instead of landing on one thread.
+function void
+soft_render_task(Soft_Render_Task *task)
+{
+    Bitmap *target = task->frame->target;
+    U32 band_count = (target->height + SOFT_RENDER_BAND_HEIGHT - 1) / SOFT_RENDER_BAND_HEIGHT;
+    for (U32 band_index = task->first_band; band_index < band_count; band_index += task->band_step)
+    {
+        Soft_Render_Rect band = {};
+        band.left   = 0;
+        band.right  = (S32)target->width;
+        band.top    = (S32)(band_index*SOFT_RENDER_BAND_HEIGHT);
+        band.bottom = (S32)min(target->height, (band_index + 1)*SOFT_RENDER_BAND_HEIGHT);
+
+        for (S32 row = band.top; row < band.bottom; ++row)
+        { soft_render_fill_span((U32 *)(target->data + row*target->pitch), target->width, task->frame->clear_color); }
+
+        soft_render_band(task, band);
+    }
+}
+
+#if defined(OS_WINDOWS)
+function DWORD WINAPI
+soft_render_thread_proc(LPVOID param)
+{
+    soft_render_task((Soft_Render_Task *)param);
+    return 0;
+}
+#else
+function void *
+soft_render_thread_proc(void *param)
+{
+    soft_render_task((Soft_Render_Task *)param);
+    return NULL;
+}
+#endif
+
+// @Note: Clears the target and draws the renderer's batches into it, like
+// d3d11_begin_pass() followed by d3d11_submit_batches(). Call it after
+// render_build_batches().
+function void
+soft_render_frame(Renderer *r, Bitmap *target, Bitmap *atlas_pages, U32 atlas_page_count,
+                  U32 clear_color, U32 thread_count, Soft_Render_Stats *out_stats)
+{
+    assert(atlas_page_count > 0);
+
+    Temporary_Arena scratch = scratch_begin();
+
+    Soft_Render_Frame frame = {};
+    frame.renderer         = r;
+    frame.target           = target;
+    frame.atlas_pages      = atlas_pages;
+    frame.atlas_page_count = atlas_page_count;
+    frame.clear_color      = clear_color;
+
+    // Gathered up front, so the threads read plain arrays.
+    U32 batch_count = (U32)arrlenu(r->batches);
+    U32 quad_count = 0;
+    U32 instance_count = 0;
+    frame.batch_firsts = push_array(scratch.arena, U32, batch_count + 1);
+    for (U32 bi = 0; bi < batch_count; ++bi)
+    {
+        Render_Batch *batch = r->batches + bi;
+        if (batch->state.shader == RENDER_SHADER_GLYPH)
+        {
+            frame.batch_firsts[bi] = instance_count;
+            instance_count += batch->element_count;
+        }
+        else
+        {
+            frame.batch_firsts[bi] = quad_count;
+            quad_count += batch->element_count;
+        }
+    }
+
+    frame.vertices  = push_array(scratch.arena, Vertex, 4*quad_count + 4);
+    frame.instances = push_array(scratch.arena, Glyph_Instance, instance_count + 1);
+    for (U32 bi = 0; bi < batch_count; ++bi)
+    {
+        Render_Batch *batch = r->batches + bi;
+        void *out = (batch->state.shader == RENDER_SHADER_GLYPH) ?
+                    (void *)(frame.instances + frame.batch_firsts[bi]) :
+                    (void *)(frame.vertices + 4*frame.batch_firsts[bi]);
+        render_gather_batch(r, batch, 0, batch->element_count, out);
+    }
+
+    // Every thread tests every glyph against its bands, so that test is
+    // made cheap by finding the rects once.
+    frame.glyph_rects = push_array(scratch.arena, Soft_Render_Rect, instance_count + 1);
+    for (U32 gi = 0; gi < instance_count; ++gi)
+    {
+        Glyph_Instance *glyph = frame.instances + gi;
+        F32 min_x = glyph->min_px.x;
+        F32 min_y = glyph->min_px.y;
+        frame.glyph_rects[gi] = soft_render_rect_from_px(min_x, min_y, min_x + glyph->width, min_y + glyph->height, target->height);
+    }
+
+    U32 band_count = (target->height + SOFT_RENDER_BAND_HEIGHT - 1) / SOFT_RENDER_BAND_HEIGHT;
+    U32 task_count = min(thread_count, (U32)SOFT_RENDER_MAX_THREAD_COUNT);
+    task_count = min(task_count, band_count);
+    task_count = max(task_count, 1u);
+
+    Soft_Render_Task tasks[SOFT_RENDER_MAX_THREAD_COUNT] = {};
+    for (U32 ti = 0; ti < task_count; ++ti)
+    {
+        tasks[ti].frame      = &frame;
+        tasks[ti].first_band = ti;
+        tasks[ti].band_step  = task_count;
+    }
+
+    // The calling thread takes the first task.
+#if defined(OS_WINDOWS)
+    HANDLE threads[SOFT_RENDER_MAX_THREAD_COUNT] = {};
+    for (U32 ti = 1; ti < task_count; ++ti)
+    {
+        threads[ti] = CreateThread(NULL, 0, soft_render_thread_proc, tasks + ti, 0, NULL);
+        assume(threads[ti]);
+    }
+    soft_render_task(tasks + 0);
+    for (U32 ti = 1; ti < task_count; ++ti)
+    {
+        WaitForSingleObject(threads[ti], INFINITE);
+        CloseHandle(threads[ti]);
+    }
+#else
+    pthread_t threads[SOFT_RENDER_MAX_THREAD_COUNT] = {};
+    for (U32 ti = 1; ti < task_count; ++ti)
+    {
+        int error = pthread_create(threads + ti, NULL, soft_render_thread_proc, tasks + ti);
+        assume(error == 0);
+    }
+    soft_render_task(tasks + 0);
+    for (U32 ti = 1; ti < task_count; ++ti)
+    { pthread_join(threads[ti], NULL); }
+#endif
+
+    if (out_stats)
+    {
+        *out_stats = {};
+        out_stats->quad_count  = quad_count;
+        out_stats->glyph_count = instance_count;
+        for (U32 ti = 0; ti < task_count; ++ti)
+        { out_stats->pixel_count += tasks[ti].stats.pixel_count; }
+    }
+
+    scratch_end(scratch);
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef SOFT_RENDER_H
+#define SOFT_RENDER_H
+
+/* --------------------------------------
+   @Note: Software compositor for the Renderer's batches.
+
+   Draws what the D3D11 pass draws into a Bitmap in memory, so rendering
+   can be checked and measured without a GPU or a window. It follows the
+   rasterization rules of D3D11 to the pixel: vertices are snapped to 1/256
+   px, a pixel is covered when its center is inside (top-left rule) and
+   textures are point-sampled at the center with a zero border.
+
+   Glyphs are drawn 1:1, which makes every glyph a blit of its texel rect
+   at a whole-pixel offset, blended with MAX like glyph_blend_state. Those
+   span blends are SIMD. Panels are the flat color of panel.hlsl.
+
+   The target is split into bands of rows, shared out between threads.
+   Every thread walks all the batches, in order, within its own bands.
+
+   Only the RGBA8 (ClearType) atlas is supported. The alpha channel of
+   glyph draws is a MAX too; on the GPU it comes from a dual-source factor
+   the pixel shader never writes, so there is nothing to match.
+   --------------------------------------- */
+
+#if defined(OS_WINDOWS)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+#  define SOFT_RENDER_AVX2 1
+#else
+#  define SOFT_RENDER_AVX2 0
+#endif
+
+#define SOFT_RENDER_MAX_THREAD_COUNT    16
+#define SOFT_RENDER_BAND_HEIGHT         32
+#define SOFT_RENDER_CLEAR_COLOR         0xff1f1f1f // background_color of d3d11_begin_pass(), as RGBA8.
+#define SOFT_RENDER_PANEL_COLOR         0xff333333 // float4(0.2, 0.2, 0.2, 1) of panel.hlsl, as RGBA8.
+
+typedef struct Soft_Render_Stats Soft_Render_Stats;
+struct Soft_Render_Stats
+{
+    U64 quad_count;
+    U64 glyph_count;
+    U64 pixel_count;            // written, summed over all draws.
+};
+
+// Whole pixels, rows counting down from the top like D3D11. Exclusive max.
+typedef struct Soft_Render_Rect Soft_Render_Rect;
+struct Soft_Render_Rect
+{
+    S32 left;
+    S32 top;
+    S32 right;
+    S32 bottom;
+};
+
+typedef struct Soft_Render_Frame Soft_Render_Frame;
+struct Soft_Render_Frame
+{
+    Renderer *renderer;         // with its batches built.
+    Bitmap *target;             // RGBA8, top row first.
+    Bitmap *atlas_pages;        // RGBA8, one per atlas array slice.
+    U32 atlas_page_count;
+    U32 clear_color;
+
+    // Gathered once, batch after batch.
+    Vertex *vertices;
+    Glyph_Instance *instances;
+    Soft_Render_Rect *glyph_rects;  // per instance, see soft_render_rect_from_px().
+    U32 *batch_firsts;          // into vertices/4 or instances, per batch.
+};
+
+typedef struct Soft_Render_Task Soft_Render_Task;
+struct Soft_Render_Task
+{
+    Soft_Render_Frame *frame;
+    U32 first_band;
+    U32 band_step;
+    Soft_Render_Stats stats;
+};
+
+function void soft_render_fill_span(U32 *dst, U32 count, U32 color);
+function void soft_render_max_span(U32 *dst, U32 *src, U32 count, U32 color);
+function U32 soft_render_blend_pixel(U32 dst, U32 src, Render_Blend blend);
+function F32 soft_render_snap(F32 px);
+function Soft_Render_Rect soft_render_rect_from_px(F32 min_x, F32 min_y, F32 max_x, F32 max_y, U32 target_height);
+function Soft_Render_Rect soft_render_rect_from_clip(AABB2 clip_px, U32 target_width, U32 target_height);
+function Soft_Render_Rect soft_render_rect_intersect(Soft_Render_Rect a, Soft_Render_Rect b);
+function Bitmap *soft_render_page(Soft_Render_Frame *frame, U32 page);
+function U64 soft_render_glyph(Soft_Render_Frame *frame, Glyph_Instance *glyph, Soft_Render_Rect rect, Soft_Render_Rect clip);
+function U64 soft_render_quad(Soft_Render_Frame *frame, Vertex *v, Render_State *state, Soft_Render_Rect clip);
+function void soft_render_band(Soft_Render_Task *task, Soft_Render_Rect band);
+function void soft_render_task(Soft_Render_Task *task);
+function void soft_render_frame(Renderer *r, Bitmap *target, Bitmap *atlas_pages, U32 atlas_page_count,
+                                U32 clear_color, U32 thread_count, Soft_Render_Stats *out_stats);
+
+#endif // SOFT_RENDER_H
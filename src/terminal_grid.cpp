@@ -0,0 +1,143 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function void
+terminal_grid_init(Terminal_Grid *grid, U32 column_count, U32 row_count, F32 cell_width_px, F32 cell_height_px,
+                   Terminal_Shape_Row_Proc *shape_row, void *shape_user_data,
+                   Terminal_Get_Quad_Proc *get_quad, void *quad_user_data)
+{
+    *grid = {};
+    grid->arena           = arena_alloc();
+    grid->column_count    = column_count;
+    grid->row_count       = row_count;
+    grid->cell_width_px   = cell_width_px;
+    grid->cell_height_px  = cell_height_px;
+    grid->shape_row       = shape_row;
+    grid->shape_user_data = shape_user_data;
+    grid->get_quad        = get_quad;
+    grid->quad_user_data  = quad_user_data;
+
+    U32 cell_count = column_count*row_count;
+    grid->text            = push_array(grid->arena, U16, cell_count);
+    grid->glyph_indices   = push_array(grid->arena, U16, cell_count);
+    grid->faces           = push_array(grid->arena, U64, cell_count);
+    grid->quads           = push_array(grid->arena, Terminal_Quad, cell_count);
+    grid->quad_is_visible = push_array(grid->arena, B8, cell_count);
+    grid->cell_is_dirty   = push_array(grid->arena, B8, cell_count);
+    grid->row_is_dirty    = push_array(grid->arena, B8, row_count);
+
+    // Blank cells. Every row gets shaped once on the first update.
+    for (U32 ci = 0; ci < cell_count; ++ci)
+    { grid->text[ci] = ' '; }
+    for (U32 row = 0; row < row_count; ++row)
+    { grid->row_is_dirty[row] = true; }
+}
+
+function void
+terminal_grid_release(Terminal_Grid *grid)
+{
+    arrfree(grid->dirty_cells);
+    arena_release(grid->arena);
+    *grid = {};
+}
+
+function void
+terminal_grid_mark_cell(Terminal_Grid *grid, U32 cell)
+{
+    if (! grid->cell_is_dirty[cell])
+    {
+        grid->cell_is_dirty[cell] = true;
+        arrput(grid->dirty_cells, cell);
+    }
+}
+
+// @Note: Moving the grid moves every quad.
+function void
+terminal_grid_set_origin(Terminal_Grid *grid, V2 origin_px)
+{
+    if (grid->origin_px.x != origin_px.x || grid->origin_px.y != origin_px.y)
+    {
+        grid->origin_px = origin_px;
+        for (U32 ci = 0; ci < grid->column_count*grid->row_count; ++ci)
+        { terminal_grid_mark_cell(grid, ci); }
+    }
+}
+
+// @Note: Text past the end of the row is cut.
+function void
+terminal_grid_write(Terminal_Grid *grid, U32 row, U32 column, U16 *text, U32 text_length)
+{
+    assert(row < grid->row_count);
+    if (column >= grid->column_count)
+    { return; }
+
+    text_length = min(text_length, grid->column_count - column);
+    U16 *cells = grid->text + row*grid->column_count + column;
+    if (! memory_equal(cells, text, text_length*sizeof(U16)))
+    {
+        memory_copy(cells, text, text_length*sizeof(U16));
+        grid->row_is_dirty[row] = true;
+    }
+}
+
+function void
+terminal_grid_update(Terminal_Grid *grid)
+{
+    Temporary_Arena scratch = scratch_begin();
+
+    U32 column_count = grid->column_count;
+    U16 *glyph_indices = push_array(scratch.arena, U16, column_count);
+    U64 *faces = push_array(scratch.arena, U64, column_count);
+
+    grid->shaped_row_count   = 0;
+    grid->rebuilt_cell_count = 0;
+
+    // Reshape dirty rows, and keep only the cells whose glyph changed.
+    for (U32 row = 0; row < grid->row_count; ++row)
+    {
+        if (! grid->row_is_dirty[row])
+        { continue; }
+
+        grid->row_is_dirty[row] = false;
+        grid->shaped_row_count += 1;
+
+        U32 first_cell = row*column_count;
+        for (U32 column = 0; column < column_count; ++column)
+        {
+            glyph_indices[column] = 0;
+            faces[column] = 0;
+        }
+        grid->shape_row(grid->shape_user_data, grid->text + first_cell, column_count, glyph_indices, faces);
+
+        for (U32 column = 0; column < column_count; ++column)
+        {
+            U32 cell = first_cell + column;
+            if (grid->glyph_indices[cell] != glyph_indices[column] || grid->faces[cell] != faces[column])
+            {
+                grid->glyph_indices[cell] = glyph_indices[column];
+                grid->faces[cell] = faces[column];
+                terminal_grid_mark_cell(grid, cell);
+            }
+        }
+    }
+
+    // Rebuild quads of dirty cells. The baseline sits at the bottom of the
+    // cell, like in the paragraph layout.
+    for (U32 di = 0; di < arrlenu(grid->dirty_cells); ++di)
+    {
+        U32 cell = grid->dirty_cells[di];
+        U32 row = cell / column_count;
+        U32 column = cell % column_count;
+
+        V2 baseline_origin_px = V2{grid->origin_px.x + column*grid->cell_width_px,
+                                   grid->origin_px.y - (row + 1)*grid->cell_height_px};
+
+        grid->quad_is_visible[cell] = (grid->glyph_indices[cell] &&
+                                       grid->get_quad(grid->quad_user_data, grid->faces[cell], grid->glyph_indices[cell],
+                                                      baseline_origin_px, grid->quads + cell));
+        grid->cell_is_dirty[cell] = false;
+    }
+    grid->rebuilt_cell_count = (U32)arrlenu(grid->dirty_cells);
+    arrsetlen(grid->dirty_cells, 0);
+
+    scratch_end(scratch);
+}
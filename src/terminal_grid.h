@@ -0,0 +1,81 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef TERMINAL_GRID_H
+#define TERMINAL_GRID_H
+
+/* --------------------------------------
+   @Note: Monospace cell grid, e.g. a terminal.
+
+   Every cell is one code unit. Positions come from (row, column) and the
+   cell size from the font metrics, so there's no line breaking or advance
+   accumulation at all.
+
+   Writing a cell only marks its row dirty if the text actually changed.
+   Dirty rows are shaped again as a whole, since a ligature (Fira Code's
+   "->", "!=", ...) can change the glyphs of the neighbouring cells. The
+   new glyphs are diffed against the old ones, and only cells whose glyph
+   changed get their quad rebuilt. The rest keep the quad from before.
+
+   Shaping and glyph lookup are the caller's procs.
+   --------------------------------------- */
+
+// Drawn 1:1, so the size in px is the size of the atlas rect.
+typedef struct Terminal_Quad Terminal_Quad;
+struct Terminal_Quad
+{
+    V2 min_px;
+    U16 atlas_x;    // top-left texel.
+    U16 atlas_y;
+    U16 width;
+    U16 height;
+    U32 page;
+};
+
+// One glyph per cell. A shaper that produces fewer glyphs than cells leaves
+// glyph index 0 in the cells that didn't get one.
+typedef void Terminal_Shape_Row_Proc(void *user_data, U16 *text, U32 column_count, U16 *out_glyph_indices, U64 *out_faces);
+
+// Returns false for glyphs with no ink.
+typedef B32 Terminal_Get_Quad_Proc(void *user_data, U64 face, U16 glyph_index, V2 baseline_origin_px, Terminal_Quad *out);
+
+typedef struct Terminal_Grid Terminal_Grid;
+struct Terminal_Grid
+{
+    Arena *arena;
+
+    U32 column_count;
+    U32 row_count;
+    F32 cell_width_px;
+    F32 cell_height_px;
+    V2 origin_px;               // top-left of the grid.
+
+    // Per cell, row-major.
+    U16 *text;
+    U16 *glyph_indices;
+    U64 *faces;
+    Terminal_Quad *quads;
+    B8 *quad_is_visible;
+    B8 *cell_is_dirty;
+
+    B8 *row_is_dirty;
+    U32 *dirty_cells;           // stb_ds array.
+
+    Terminal_Shape_Row_Proc *shape_row;
+    void *shape_user_data;
+    Terminal_Get_Quad_Proc *get_quad;
+    void *quad_user_data;
+
+    // Of the last terminal_grid_update().
+    U32 shaped_row_count;
+    U32 rebuilt_cell_count;
+};
+
+function void terminal_grid_init(Terminal_Grid *grid, U32 column_count, U32 row_count, F32 cell_width_px, F32 cell_height_px,
+                                 Terminal_Shape_Row_Proc *shape_row, void *shape_user_data,
+                                 Terminal_Get_Quad_Proc *get_quad, void *quad_user_data);
+function void terminal_grid_release(Terminal_Grid *grid);
+function void terminal_grid_mark_cell(Terminal_Grid *grid, U32 cell);
+function void terminal_grid_set_origin(Terminal_Grid *grid, V2 origin_px);
+function void terminal_grid_write(Terminal_Grid *grid, U32 row, U32 column, U16 *text, U32 text_length);
+function void terminal_grid_update(Terminal_Grid *grid);
+
+#endif // TERMINAL_GRID_H
@@ -0,0 +1,461 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function U16 *
+text_buffer_source_text(Text_Buffer *buffer, U32 source)
+{
+    U16 *result = (source == TEXT_BUFFER_ORIGINAL) ? buffer->original : buffer->added;
+    return result;
+}
+
+// @Note: Newlines in [0, position) of a backing buffer.
+function U64
+text_buffer_newlines_before(Text_Buffer *buffer, U32 source, U64 position)
+{
+    U16 *text = text_buffer_source_text(buffer, source);
+    U64 *prefix = (source == TEXT_BUFFER_ORIGINAL) ? buffer->original_newline_prefix : buffer->added_newline_prefix;
+
+    U64 block = position / TEXT_BUFFER_NEWLINE_BLOCK;
+    U64 result = prefix[block];
+    for (U64 i = block*TEXT_BUFFER_NEWLINE_BLOCK; i < position; ++i)
+    { result += (text[i] == '\n'); }
+
+    return result;
+}
+
+function U64
+text_buffer_count_newlines(Text_Buffer *buffer, U32 source, U64 start, U64 length)
+{
+    U64 result = (text_buffer_newlines_before(buffer, source, start + length) -
+                  text_buffer_newlines_before(buffer, source, start));
+    return result;
+}
+
+// @Note: Position of the nth (1-based) newline at or after start. The prefix
+// table narrows it down to one block.
+function U64
+text_buffer_source_find_newline(Text_Buffer *buffer, U32 source, U64 start, U64 nth)
+{
+    U16 *text = text_buffer_source_text(buffer, source);
+    U64 *prefix = (source == TEXT_BUFFER_ORIGINAL) ? buffer->original_newline_prefix : buffer->added_newline_prefix;
+    U64 block_count = (source == TEXT_BUFFER_ORIGINAL) ? (buffer->original_length / TEXT_BUFFER_NEWLINE_BLOCK + 1) : arrlenu(buffer->added_newline_prefix);
+
+    U64 target = text_buffer_newlines_before(buffer, source, start) + nth;
+
+    // Last block that starts with fewer than target newlines before it.
+    U64 lo = 0;
+    U64 hi = block_count;
+    while (lo < hi)
+    {
+        U64 mid = lo + (hi - lo)/2;
+        if (prefix[mid] < target) { lo = mid + 1; }
+        else                      { hi = mid; }
+    }
+    U64 block = lo - 1;
+
+    U64 position = max(block*TEXT_BUFFER_NEWLINE_BLOCK, start);
+    U64 count = (position == start) ? (target - nth) : prefix[block];
+    for (;; ++position)
+    {
+        if (text[position] == '\n' && ++count == target)
+        { break; }
+    }
+
+    return position;
+}
+
+function void
+text_buffer_append_added(Text_Buffer *buffer, U16 *text, U64 text_length)
+{
+    U64 position = arrlenu(buffer->added);
+    arrsetlen(buffer->added, position + text_length);
+    memory_copy(buffer->added + position, text, text_length*sizeof(U16));
+
+    for (U64 i = 0; i < text_length; ++i)
+    {
+        buffer->added_newline_count += (text[i] == '\n');
+        if (++position % TEXT_BUFFER_NEWLINE_BLOCK == 0)
+        { arrput(buffer->added_newline_prefix, buffer->added_newline_count); }
+    }
+}
+
+function U32
+text_buffer_random(Text_Buffer *buffer)
+{
+    U32 x = buffer->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    buffer->random_state = x;
+    return x;
+}
+
+function Text_Buffer_Piece *
+text_buffer_alloc_piece(Text_Buffer *buffer, U32 source, U64 start, U64 length, U64 newline_count)
+{
+    Text_Buffer_Piece *result = buffer->free_pieces;
+    if (result)
+    { buffer->free_pieces = result->right; }
+    else
+    { result = push_struct(buffer->arena, Text_Buffer_Piece); }
+
+    *result = {};
+    result->priority              = text_buffer_random(buffer);
+    result->source                = source;
+    result->start                 = start;
+    result->length                = length;
+    result->newline_count         = newline_count;
+    result->subtree_length        = length;
+    result->subtree_newline_count = newline_count;
+    return result;
+}
+
+function void
+text_buffer_free_pieces(Text_Buffer *buffer, Text_Buffer_Piece *node)
+{
+    if (node)
+    {
+        text_buffer_free_pieces(buffer, node->left);
+        Text_Buffer_Piece *right = node->right;
+        node->right = buffer->free_pieces;
+        buffer->free_pieces = node;
+        text_buffer_free_pieces(buffer, right);
+    }
+}
+
+function void
+text_buffer_update(Text_Buffer_Piece *node)
+{
+    node->subtree_length        = node->length;
+    node->subtree_newline_count = node->newline_count;
+    if (node->left)
+    {
+        node->subtree_length        += node->left->subtree_length;
+        node->subtree_newline_count += node->left->subtree_newline_count;
+    }
+    if (node->right)
+    {
+        node->subtree_length        += node->right->subtree_length;
+        node->subtree_newline_count += node->right->subtree_newline_count;
+    }
+}
+
+// @Note: Splits the tree into [0, offset) and [offset, end). A piece that
+// straddles offset is cut in two.
+function void
+text_buffer_split(Text_Buffer *buffer, Text_Buffer_Piece *node, U64 offset,
+                  Text_Buffer_Piece **out_left, Text_Buffer_Piece **out_right)
+{
+    if (! node)
+    {
+        *out_left = *out_right = NULL;
+        return;
+    }
+
+    U64 left_length = (node->left) ? node->left->subtree_length : 0;
+
+    if (offset <= left_length)
+    {
+        text_buffer_split(buffer, node->left, offset, out_left, &node->left);
+        text_buffer_update(node);
+        *out_right = node;
+    }
+    else if (offset >= left_length + node->length)
+    {
+        text_buffer_split(buffer, node->right, offset - left_length - node->length, &node->right, out_right);
+        text_buffer_update(node);
+        *out_left = node;
+    }
+    else
+    {
+        U64 head_length = offset - left_length;
+        U64 head_newlines = text_buffer_count_newlines(buffer, node->source, node->start, head_length);
+
+        // The tail takes over the right subtree. Same priority keeps the heap valid.
+        Text_Buffer_Piece *tail = text_buffer_alloc_piece(buffer, node->source, node->start + head_length,
+                                                          node->length - head_length, node->newline_count - head_newlines);
+        tail->priority = node->priority;
+        tail->right = node->right;
+        text_buffer_update(tail);
+
+        node->length        = head_length;
+        node->newline_count = head_newlines;
+        node->right = NULL;
+        text_buffer_update(node);
+
+        *out_left  = node;
+        *out_right = tail;
+    }
+}
+
+function Text_Buffer_Piece *
+text_buffer_merge(Text_Buffer_Piece *left, Text_Buffer_Piece *right)
+{
+    if (! left)  { return right; }
+    if (! right) { return left; }
+
+    if (left->priority >= right->priority)
+    {
+        left->right = text_buffer_merge(left->right, right);
+        text_buffer_update(left);
+        return left;
+    }
+    else
+    {
+        right->left = text_buffer_merge(left, right->left);
+        text_buffer_update(right);
+        return right;
+    }
+}
+
+// @Note: text is borrowed and must outlive the buffer.
+function void
+text_buffer_init(Text_Buffer *buffer, U16 *text, U64 text_length)
+{
+    *buffer = {};
+    buffer->arena           = arena_alloc();
+    buffer->original        = text;
+    buffer->original_length = text_length;
+    buffer->random_state    = 0x9e3779b9;
+
+    U64 block_count = text_length / TEXT_BUFFER_NEWLINE_BLOCK + 1;
+    buffer->original_newline_prefix = push_array(buffer->arena, U64, block_count);
+
+    U64 count = 0;
+    for (U64 block = 0; block < block_count; ++block)
+    {
+        buffer->original_newline_prefix[block] = count;
+
+        U64 begin = block*TEXT_BUFFER_NEWLINE_BLOCK;
+        U64 end   = min(begin + TEXT_BUFFER_NEWLINE_BLOCK, text_length);
+        U64 i = begin;
+        for (; i + 8 <= end; i += 8)
+        { count += text_source_popcount32(text_source_newline_mask16((U8 *)(text + i), TEXT_ENCODING_UTF16LE)); }
+        for (; i < end; ++i)
+        { count += (text[i] == '\n'); }
+    }
+
+    arrput(buffer->added_newline_prefix, 0);
+
+    if (text_length)
+    {
+        buffer->root = text_buffer_alloc_piece(buffer, TEXT_BUFFER_ORIGINAL, 0, text_length, count);
+    }
+}
+
+function void
+text_buffer_release(Text_Buffer *buffer)
+{
+    arrfree(buffer->added);
+    arrfree(buffer->added_newline_prefix);
+    arrfree(buffer->changes);
+    arena_release(buffer->arena);
+    *buffer = {};
+}
+
+function U64
+text_buffer_length(Text_Buffer *buffer)
+{
+    U64 result = (buffer->root) ? buffer->root->subtree_length : 0;
+    return result;
+}
+
+function U64
+text_buffer_line_count(Text_Buffer *buffer)
+{
+    U64 result = ((buffer->root) ? buffer->root->subtree_newline_count : 0) + 1;
+    return result;
+}
+
+function void
+text_buffer_insert(Text_Buffer *buffer, U64 offset, U16 *text, U64 text_length)
+{
+    assert(offset <= text_buffer_length(buffer));
+    if (! text_length)
+    { return; }
+
+    Text_Buffer_Change change = {};
+    change.offset     = offset;
+    change.inserted   = text_length;
+    change.first_line = text_buffer_line_of_offset(buffer, offset);
+
+    U64 start = arrlenu(buffer->added);
+    U64 newlines_before = buffer->added_newline_count;
+    text_buffer_append_added(buffer, text, text_length);
+    change.inserted_newlines = buffer->added_newline_count - newlines_before;
+
+    // @Todo: Typing one character at a time makes one piece per character.
+    //        Could grow the previous piece when it ends at `start`.
+    Text_Buffer_Piece *piece = text_buffer_alloc_piece(buffer, TEXT_BUFFER_ADDED, start, text_length, change.inserted_newlines);
+
+    Text_Buffer_Piece *left, *right;
+    text_buffer_split(buffer, buffer->root, offset, &left, &right);
+    buffer->root = text_buffer_merge(text_buffer_merge(left, piece), right);
+
+    buffer->version += 1;
+    arrput(buffer->changes, change);
+}
+
+function void
+text_buffer_delete(Text_Buffer *buffer, U64 offset, U64 length)
+{
+    assert(offset + length <= text_buffer_length(buffer));
+    if (! length)
+    { return; }
+
+    Text_Buffer_Change change = {};
+    change.offset     = offset;
+    change.removed    = length;
+    change.first_line = text_buffer_line_of_offset(buffer, offset);
+
+    Text_Buffer_Piece *left, *middle, *right;
+    text_buffer_split(buffer, buffer->root, offset, &left, &right);
+    text_buffer_split(buffer, right, length, &middle, &right);
+
+    change.removed_newlines = middle->subtree_newline_count;
+    text_buffer_free_pieces(buffer, middle);
+
+    buffer->root = text_buffer_merge(left, right);
+
+    buffer->version += 1;
+    arrput(buffer->changes, change);
+}
+
+function void
+text_buffer_clear_changes(Text_Buffer *buffer)
+{
+    arrsetlen(buffer->changes, 0);
+}
+
+function U64
+text_buffer_copy_node(Text_Buffer *buffer, Text_Buffer_Piece *node, U64 offset, U64 length, U16 *out)
+{
+    U64 result = 0;
+
+    if (node && length)
+    {
+        U64 left_length = (node->left) ? node->left->subtree_length : 0;
+
+        if (offset < left_length)
+        {
+            result += text_buffer_copy_node(buffer, node->left, offset, length, out);
+        }
+
+        U64 piece_begin = left_length;
+        U64 piece_end   = left_length + node->length;
+        U64 copy_begin  = max(offset, piece_begin);
+        U64 copy_end    = min(offset + length, piece_end);
+        if (copy_begin < copy_end)
+        {
+            U16 *text = text_buffer_source_text(buffer, node->source) + node->start + (copy_begin - piece_begin);
+            memory_copy(out + result, text, (copy_end - copy_begin)*sizeof(U16));
+            result += copy_end - copy_begin;
+        }
+
+        if (offset + length > piece_end)
+        {
+            U64 right_offset = (offset > piece_end) ? offset - piece_end : 0;
+            result += text_buffer_copy_node(buffer, node->right, right_offset, offset + length - piece_end - right_offset, out + result);
+        }
+    }
+
+    return result;
+}
+
+// @Note: Copies [offset, offset + length), clamped to the text. Returns the count copied.
+function U64
+text_buffer_copy(Text_Buffer *buffer, U64 offset, U64 length, U16 *out)
+{
+    U64 total = text_buffer_length(buffer);
+    offset = min(offset, total);
+    length = min(length, total - offset);
+    U64 result = text_buffer_copy_node(buffer, buffer->root, offset, length, out);
+    return result;
+}
+
+// @Note: Offset of the first code unit of a line, i.e. one past its preceding newline.
+function U64
+text_buffer_line_start(Text_Buffer *buffer, U64 line)
+{
+    assert(line < text_buffer_line_count(buffer));
+    if (! line)
+    { return 0; }
+
+    U64 result = 0;
+    U64 nth = line;
+    Text_Buffer_Piece *node = buffer->root;
+    while (node)
+    {
+        U64 left_length   = (node->left) ? node->left->subtree_length : 0;
+        U64 left_newlines = (node->left) ? node->left->subtree_newline_count : 0;
+
+        if (nth <= left_newlines)
+        {
+            node = node->left;
+        }
+        else if (nth <= left_newlines + node->newline_count)
+        {
+            U64 position = text_buffer_source_find_newline(buffer, node->source, node->start, nth - left_newlines);
+            result += left_length + (position - node->start) + 1;
+            break;
+        }
+        else
+        {
+            result += left_length + node->length;
+            nth    -= left_newlines + node->newline_count;
+            node = node->right;
+        }
+    }
+
+    return result;
+}
+
+// @Note: Newlines before offset.
+function U64
+text_buffer_line_of_offset(Text_Buffer *buffer, U64 offset)
+{
+    U64 result = 0;
+    Text_Buffer_Piece *node = buffer->root;
+    while (node)
+    {
+        U64 left_length   = (node->left) ? node->left->subtree_length : 0;
+        U64 left_newlines = (node->left) ? node->left->subtree_newline_count : 0;
+
+        if (offset < left_length)
+        {
+            node = node->left;
+        }
+        else if (offset < left_length + node->length)
+        {
+            result += left_newlines + text_buffer_count_newlines(buffer, node->source, node->start, offset - left_length);
+            break;
+        }
+        else
+        {
+            result += left_newlines + node->newline_count;
+            offset -= left_length + node->length;
+            node = node->right;
+        }
+    }
+
+    return result;
+}
+
+// @Note: Same contract as text_source_get_line(): no newline, no trailing
+// '\r', cut at TEXT_SOURCE_MAX_LINE_LENGTH, zero-terminated.
+function U16 *
+text_buffer_get_line(Text_Buffer *buffer, Arena *arena, U64 line, U32 *length)
+{
+    U64 begin = text_buffer_line_start(buffer, line);
+    U64 end   = (line + 1 < text_buffer_line_count(buffer)) ? text_buffer_line_start(buffer, line + 1) - 1 : text_buffer_length(buffer);
+
+    U64 count = min(end - begin, (U64)TEXT_SOURCE_MAX_LINE_LENGTH);
+    U16 *result = push_array(arena, U16, count + 1);
+    count = text_buffer_copy(buffer, begin, count, result);
+
+    if (count && result[count - 1] == '\r')
+    { --count; }
+
+    result[count] = 0;
+    *length = (U32)count;
+    return result;
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef TEXT_BUFFER_H
+#define TEXT_BUFFER_H
+
+/* --------------------------------------
+   @Note: Editable UTF-16 text storage. (piece table)
+
+   The text is a sequence of pieces, each a span of either the original
+   text (borrowed, never written) or the append-only added buffer. Pieces
+   live in a treap ordered by position. Every node caches the length and
+   newline count of its subtree, so both a code unit offset and a line
+   number can be found by descending the tree.
+
+   Inserting or deleting splits at most two pieces and touches O(log n)
+   nodes. The document is never copied. Splitting a piece has to count the
+   newlines on each side; a sparse newline prefix per backing buffer keeps
+   that to at most one TEXT_BUFFER_NEWLINE_BLOCK of scanning.
+
+   Each edit appends a change record describing which paragraphs (lines)
+   it replaced, so shaping and layout caches can drop exactly those and
+   shift the rest.
+   --------------------------------------- */
+
+#define TEXT_BUFFER_NEWLINE_BLOCK 1024
+
+enum
+{
+    TEXT_BUFFER_ORIGINAL,
+    TEXT_BUFFER_ADDED,
+};
+
+typedef struct Text_Buffer_Piece Text_Buffer_Piece;
+struct Text_Buffer_Piece
+{
+    Text_Buffer_Piece *left;
+    Text_Buffer_Piece *right;
+    U32 priority;
+
+    U32 source;             // TEXT_BUFFER_ORIGINAL or TEXT_BUFFER_ADDED.
+    U64 start;
+    U64 length;
+    U64 newline_count;
+
+    U64 subtree_length;
+    U64 subtree_newline_count;
+};
+
+// @Note: Paragraphs [first_line, first_line + removed_newlines] before the
+// edit became [first_line, first_line + inserted_newlines] after it.
+// Paragraphs after those are shifted by inserted_newlines - removed_newlines.
+typedef struct Text_Buffer_Change Text_Buffer_Change;
+struct Text_Buffer_Change
+{
+    U64 offset;
+    U64 removed;
+    U64 inserted;
+
+    U64 first_line;
+    U64 removed_newlines;
+    U64 inserted_newlines;
+};
+
+typedef struct Text_Buffer Text_Buffer;
+struct Text_Buffer
+{
+    Arena *arena;                   // pieces.
+
+    U16 *original;
+    U64 original_length;
+    U64 *original_newline_prefix;   // newlines before each block.
+
+    U16 *added;                     // stb_ds array, append-only.
+    U64 *added_newline_prefix;      // stb_ds array.
+    U64 added_newline_count;
+
+    Text_Buffer_Piece *root;
+    Text_Buffer_Piece *free_pieces; // linked through .right.
+    U32 random_state;
+
+    U64 version;                    // bumped by every edit.
+    Text_Buffer_Change *changes;    // stb_ds array, since the last text_buffer_clear_changes().
+};
+
+function void text_buffer_init(Text_Buffer *buffer, U16 *text, U64 text_length);
+function void text_buffer_release(Text_Buffer *buffer);
+
+function U64 text_buffer_length(Text_Buffer *buffer);
+function U64 text_buffer_line_count(Text_Buffer *buffer);
+
+function void text_buffer_insert(Text_Buffer *buffer, U64 offset, U16 *text, U64 text_length);
+function void text_buffer_delete(Text_Buffer *buffer, U64 offset, U64 length);
+function void text_buffer_clear_changes(Text_Buffer *buffer);
+
+function U64 text_buffer_copy(Text_Buffer *buffer, U64 offset, U64 length, U16 *out);
+function U64 text_buffer_line_start(Text_Buffer *buffer, U64 line);
+function U64 text_buffer_line_of_offset(Text_Buffer *buffer, U64 offset);
+function U16 *text_buffer_get_line(Text_Buffer *buffer, Arena *arena, U64 line, U32 *length);
+
+#endif // TEXT_BUFFER_H
@@ -0,0 +1,585 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function void
+paragraph_cache_init(Paragraph_Cache *cache, U32 capacity, Text_Source *source, Font_Backend *backend, Job_System *jobs, wchar_t *base_family, F32 pt_per_em)
+{
+    cache->arena       = arena_alloc();
+    cache->sentinel    = push_struct(cache->arena, Shaped_Paragraph);
+    cache->sentinel->prev = cache->sentinel;
+    cache->sentinel->next = cache->sentinel;
+    cache->count       = 0;
+    cache->capacity    = capacity;
+    cache->source      = source;
+    cache->buffer      = NULL;
+    cache->backend     = backend;
+    cache->jobs        = jobs;
+    cache->base_family = base_family;
+    cache->pt_per_em   = pt_per_em;
+    cache->hit_count          = 0;
+    cache->miss_count         = 0;
+    cache->eviction_count     = 0;
+    cache->invalidation_count = 0;
+}
+
+function void
+paragraph_cache_release(Paragraph_Cache *cache)
+{
+    dll_for(cache->sentinel, sp)
+    {
+        font_free_runs(sp->runs);
+        arrfree(sp->wrap.lines);
+        arena_release(sp->arena);
+    }
+    arena_release(cache->arena);
+    *cache = {};
+}
+
+// @Note: Unshapes a linked paragraph and moves it to the front of the LRU
+// list, so it's the first one paragraph_cache_take() reuses.
+function void
+paragraph_cache_drop(Paragraph_Cache *cache, Shaped_Paragraph *sp)
+{
+    sp->prev->next = sp->next;
+    sp->next->prev = sp->prev;
+
+    font_free_runs(sp->runs);
+    sp->runs = NULL;
+    arena_clear(sp->arena);
+    sp->line = (U64)-1;
+    sp->paragraph = {};
+    sp->wrap.width_px = -1.0f;
+
+    sp->prev = cache->sentinel;
+    sp->next = cache->sentinel->next;
+    sp->prev->next = sp;
+    sp->next->prev = sp;
+}
+
+// @Note: Lines come from the buffer from now on, or from the source again if
+// it's NULL. Nothing shaped from the other one is kept.
+function void
+paragraph_cache_set_buffer(Paragraph_Cache *cache, Text_Buffer *buffer)
+{
+    Shaped_Paragraph *next = NULL;
+    for (Shaped_Paragraph *sp = cache->sentinel->next; sp != cache->sentinel; sp = next)
+    {
+        next = sp->next;
+        if (sp->line != (U64)-1)
+        { paragraph_cache_drop(cache, sp); }
+    }
+    cache->buffer = buffer;
+}
+
+function U64
+paragraph_cache_line_count(Paragraph_Cache *cache)
+{
+    U64 result = (cache->buffer) ? text_buffer_line_count(cache->buffer) : cache->source->line_count;
+    return result;
+}
+
+// @Note: Replays the buffer's change records, in the order they were made.
+// A paragraph an edit replaced is dropped, a later one keeps its shaping and
+// wrap under its new line number. Call it before the next prefetch or get,
+// then text_buffer_clear_changes().
+function void
+paragraph_cache_apply_changes(Paragraph_Cache *cache, Text_Buffer_Change *changes, U64 change_count)
+{
+    for (U64 ci = 0; ci < change_count; ++ci)
+    {
+        Text_Buffer_Change *change = changes + ci;
+        U64 last_replaced = change->first_line + change->removed_newlines;
+
+        Shaped_Paragraph *next = NULL;
+        for (Shaped_Paragraph *sp = cache->sentinel->next; sp != cache->sentinel; sp = next)
+        {
+            next = sp->next;
+            if (sp->line == (U64)-1 || sp->line < change->first_line)
+            { continue; }
+
+            if (sp->line <= last_replaced)
+            {
+                paragraph_cache_drop(cache, sp);
+                cache->invalidation_count += 1;
+            }
+            else
+            {
+                sp->line = sp->line - change->removed_newlines + change->inserted_newlines;
+            }
+        }
+    }
+}
+
+function void
+paragraph_cache_shape(Paragraph_Cache *cache, Shaped_Paragraph *sp, U64 line)
+{
+    Font_Backend *backend = cache->backend;
+
+    sp->line = line;
+
+    U32 text_length = 0;
+    U16 *text = (cache->buffer) ? text_buffer_get_line(cache->buffer, sp->arena, line, &text_length)
+                                : text_source_get_line(cache->source, sp->arena, line, &text_length);
+    if (! text_length)
+    {
+        // An empty paragraph still takes up a line.
+        text[0] = ' ';
+        text_length = 1;
+    }
+
+    U32 *glyph_text_positions = NULL;
+    sp->runs = font_map_text(backend, cache->jobs, cache->base_family, cache->pt_per_em, text, text_length, &glyph_text_positions);
+    U64 run_count = arrlenu(sp->runs);
+
+    F32 *glyph_advances = NULL;
+    U32 *run_glyph_counts = push_array(sp->arena, U32, run_count);
+    F32 *run_heights_px = push_array(sp->arena, F32, run_count);
+    for (U32 ri = 0; ri < run_count; ++ri)
+    {
+        Font_Run *run = sp->runs + ri;
+        for (U32 gi = 0; gi < run->glyph_count; ++gi)
+        { arrput(glyph_advances, run->glyph_advances[gi]); }
+
+        run_glyph_counts[ri] = run->glyph_count;
+        run_heights_px[ri]   = backend->get_metrics(backend->user_data, run->face, run->em_size_px).advance_height_px;
+    }
+
+    U8 *text_breaks = backend->analyze_breaks(backend->user_data, text, text_length);
+    sp->paragraph = layout_build_paragraph(sp->arena, glyph_advances, glyph_text_positions, (U32)arrlenu(glyph_advances), text_breaks, text_length,
+                                           run_glyph_counts, run_heights_px, (U32)run_count);
+
+    arrfree(text_breaks);
+    arrfree(glyph_advances);
+    arrfree(glyph_text_positions);
+
+    sp->wrap.width_px = -1.0f;
+}
+
+// @Note: Unlinks the paragraph of the line, if it's cached.
+function Shaped_Paragraph *
+paragraph_cache_find(Paragraph_Cache *cache, U64 line)
+{
+    Shaped_Paragraph *result = NULL;
+
+    dll_for(cache->sentinel, sp)
+    {
+        if (sp->line == line)
+        {
+            result = sp;
+            break;
+        }
+    }
+
+    if (result)
+    {
+        result->prev->next = result->next;
+        result->next->prev = result->prev;
+    }
+    return result;
+}
+
+// @Note: An unlinked paragraph to shape into, new while under capacity, the
+// least recently used one otherwise.
+function Shaped_Paragraph *
+paragraph_cache_take(Paragraph_Cache *cache)
+{
+    Shaped_Paragraph *result = NULL;
+
+    if (cache->count < cache->capacity)
+    {
+        result = push_struct(cache->arena, Shaped_Paragraph);
+        result->arena = arena_alloc();
+        cache->count += 1;
+    }
+    else
+    {
+        result = cache->sentinel->next;
+        result->prev->next = result->next;
+        result->next->prev = result->prev;
+        cache->eviction_count += 1;
+
+        font_free_runs(result->runs);
+        result->runs = NULL;
+        arena_clear(result->arena);
+    }
+    return result;
+}
+
+function void
+paragraph_cache_shape_proc(void *user_data, U32 worker_index, U64 begin, U64 end)
+{
+    Paragraph_Cache_Task *task = (Paragraph_Cache_Task *)user_data;
+    for (U64 pi = begin; pi < end; ++pi)
+    {
+        Shaped_Paragraph *sp = task->paragraphs[pi];
+        paragraph_cache_shape(task->cache, sp, sp->line);
+    }
+}
+
+function void
+paragraph_cache_wrap_proc(void *user_data, U32 worker_index, U64 begin, U64 end)
+{
+    Paragraph_Cache_Task *task = (Paragraph_Cache_Task *)user_data;
+    for (U64 pi = begin; pi < end; ++pi)
+    {
+        Shaped_Paragraph *sp = task->paragraphs[pi];
+        layout_wrap(&sp->paragraph, task->width_px, &sp->wrap);
+    }
+}
+
+// @Note: Makes sure the lines are shaped and wrapped at width_px, so the
+// paragraph_cache_get()s that follow are hits. Misses are shaped on the job
+// system if the backend allows it, wraps always are. line_count is clamped
+// to the capacity, or the prefetch would evict itself.
+function void
+paragraph_cache_prefetch(Paragraph_Cache *cache, U64 first_line, U64 line_count, F32 width_px)
+{
+    U64 source_line_count = paragraph_cache_line_count(cache);
+    first_line = min(first_line, source_line_count);
+    line_count = min(line_count, source_line_count - first_line);
+    line_count = min(line_count, (U64)cache->capacity);
+    if (! line_count)
+    { return; }
+
+    Temporary_Arena scratch = scratch_begin();
+
+    Shaped_Paragraph **misses = push_array(scratch.arena, Shaped_Paragraph *, line_count);
+    Shaped_Paragraph **unwrapped = push_array(scratch.arena, Shaped_Paragraph *, line_count);
+    U64 miss_count = 0;
+    U64 unwrapped_count = 0;
+
+    for (U64 line = first_line; line < first_line + line_count; ++line)
+    {
+        Shaped_Paragraph *sp = paragraph_cache_find(cache, line);
+        if (! sp)
+        {
+            sp = paragraph_cache_take(cache);
+            sp->line = line;
+            sp->wrap.width_px = -1.0f;
+            misses[miss_count++] = sp;
+        }
+        dll_append(cache->sentinel, sp);
+
+        if (sp->wrap.width_px != width_px)
+        { unwrapped[unwrapped_count++] = sp; }
+    }
+
+    cache->hit_count  += line_count - miss_count;
+    cache->miss_count += miss_count;
+
+    Paragraph_Cache_Task shape_task = {cache, misses, width_px};
+    if (cache->backend->can_shape_concurrently)
+    {
+        job_parallel_for(cache->jobs, miss_count, 1, paragraph_cache_shape_proc, &shape_task);
+    }
+    else
+    {
+        paragraph_cache_shape_proc(&shape_task, job_current_worker_index(cache->jobs), 0, miss_count);
+    }
+
+    Paragraph_Cache_Task wrap_task = {cache, unwrapped, width_px};
+    job_parallel_for(cache->jobs, unwrapped_count, 1, paragraph_cache_wrap_proc, &wrap_task);
+
+    scratch_end(scratch);
+}
+
+// @Note: Returns the paragraph shaped and wrapped at width_px. On a miss the
+// least recently used paragraph is evicted and its memory reused.
+function Shaped_Paragraph *
+paragraph_cache_get(Paragraph_Cache *cache, U64 line, F32 width_px)
+{
+    Shaped_Paragraph *result = paragraph_cache_find(cache, line);
+    if (result)
+    {
+        cache->hit_count += 1;
+    }
+    else
+    {
+        result = paragraph_cache_take(cache);
+        paragraph_cache_shape(cache, result, line);
+        cache->miss_count += 1;
+    }
+
+    dll_append(cache->sentinel, result);
+
+    if (result->wrap.width_px != width_px)
+    {
+        layout_wrap(&result->paragraph, width_px, &result->wrap);
+    }
+
+    return result;
+}
+
+// @Note: Counts what the cached paragraphs take up, stb_ds arrays by their
+// capacity, so a paragraph that keeps growing one shows up.
+function Paragraph_Cache_Stats
+paragraph_cache_get_stats(Paragraph_Cache *cache)
+{
+    Paragraph_Cache_Stats result = {};
+    result.hit_count          = cache->hit_count;
+    result.miss_count         = cache->miss_count;
+    result.eviction_count     = cache->eviction_count;
+    result.invalidation_count = cache->invalidation_count;
+    result.count              = cache->count;
+    result.capacity           = cache->capacity;
+    result.arena_bytes        = arena_pos(cache->arena);
+
+    dll_for(cache->sentinel, sp)
+    {
+        result.glyph_count += sp->paragraph.glyph_count;
+        result.arena_bytes += arena_pos(sp->arena);
+        result.heap_bytes  += arrcap(sp->runs)*sizeof(Font_Run) + arrcap(sp->wrap.lines)*sizeof(Layout_Line);
+        for (U32 ri = 0; ri < arrlenu(sp->runs); ++ri)
+        {
+            Font_Run *run = sp->runs + ri;
+            result.heap_bytes += arrcap(run->glyph_indices)*sizeof(U16) + arrcap(run->glyph_advances)*sizeof(F32);
+        }
+    }
+
+    return result;
+}
+
+// @Note: Terminal_Shape_Row_Proc. Each cell gets the first glyph of its cluster.
+function void
+terminal_shape_row_font(void *user_data, U16 *text, U32 column_count, U16 *out_glyph_indices, U64 *out_faces)
+{
+    Terminal_Font *terminal = (Terminal_Font *)user_data;
+
+    U32 *glyph_text_positions = NULL;
+    Font_Run *runs = font_map_text(terminal->backend, NULL, terminal->family, terminal->pt_per_em, text, column_count, &glyph_text_positions);
+
+    U32 gi = 0;
+    for (U32 ri = 0; ri < arrlenu(runs); ++ri)
+    {
+        for (U32 i = 0; i < runs[ri].glyph_count; ++i, ++gi)
+        {
+            U32 column = glyph_text_positions[gi];
+            if (column < column_count && ! out_glyph_indices[column])
+            {
+                out_glyph_indices[column] = runs[ri].glyph_indices[i];
+                out_faces[column] = runs[ri].face;
+            }
+        }
+    }
+
+    font_free_runs(runs);
+    arrfree(glyph_text_positions);
+}
+
+// @Note: Terminal_Get_Quad_Proc.
+function B32
+terminal_get_quad_font(void *user_data, U64 face, U16 glyph_index, V2 baseline_origin_px, Terminal_Quad *out)
+{
+    Terminal_Font *terminal = (Terminal_Font *)user_data;
+
+    F32 em_size_px = font_px_per_em(terminal->backend, terminal->pt_per_em);
+    Glyph_Cel cel = glyph_atlas_get(terminal->atlas, face, em_size_px, glyph_index);
+
+    B32 result = ! cel.is_empty;
+    if (result)
+    {
+        out->min_px.x = baseline_origin_px.x + cel.offset_px.x;
+        out->min_px.y = baseline_origin_px.y + cel.offset_px.y - cel.height_px;
+        out->atlas_x  = cel.atlas_x;
+        out->atlas_y  = cel.atlas_y;
+        out->width    = (U16)cel.width_px;
+        out->height   = (U16)cel.height_px;
+        out->page     = 0;
+    }
+
+    return result;
+}
+
+// @Note: A grid shaped and drawn with the font. The cell size is the advance
+// of '0' by the face's advance height.
+function void
+terminal_grid_init_font(Terminal_Grid *grid, Terminal_Font *font, U32 column_count, U32 row_count)
+{
+    U16 zero = '0';
+    U32 *glyph_text_positions = NULL;
+    Font_Run *runs = font_map_text(font->backend, NULL, font->family, font->pt_per_em, &zero, 1, &glyph_text_positions);
+    Font_Metrics metrics = font->backend->get_metrics(font->backend->user_data, runs[0].face, runs[0].em_size_px);
+
+    terminal_grid_init(grid, column_count, row_count, runs[0].glyph_advances[0], metrics.advance_height_px,
+                       terminal_shape_row_font, font, terminal_get_quad_font, font);
+
+    font_free_runs(runs);
+    arrfree(glyph_text_positions);
+}
+
+// @Note: The instance of a glyph whose ink box has its bottom-left at min_px.
+function Glyph_Instance
+glyph_instance_from_cel(Glyph_Cel cel, V2 min_px)
+{
+    Glyph_Instance result = {};
+    result.min_px  = min_px;
+    result.atlas_x = cel.atlas_x;
+    result.atlas_y = cel.atlas_y;
+    result.width   = (U16)cel.width_px;
+    result.height  = (U16)cel.height_px;
+    result.color   = GLYPH_COLOR_WHITE;
+    result.page    = 0;
+    return result;
+}
+
+// @Note: Emits the lines of a paragraph that overlap the container, and only
+// their glyphs get looked up (and rasterized on a miss). top_y_px is where the
+// paragraph starts, measured from the container's top, growing downwards.
+//
+// Clipping is decided per line. The cels of a line are gathered first, noting
+// whether all of their ink is inside the container. That's the case for every
+// line but the ones on its edges, and their instances are emitted straight
+// from the cels. Otherwise each glyph is clipped in texels.
+function void
+render_paragraph(Renderer *r, Glyph_Atlas *atlas, Shaped_Paragraph *sp, F32 top_y_px,
+                 V2 container_origin_px, F32 container_width_px, F32 container_height_px)
+{
+    profile_scope(PROFILE_STAGE_VERTEX_BUILD);
+
+    Layout_Paragraph *paragraph = &sp->paragraph;
+    Layout_Wrap *wrap = &sp->wrap;
+    Font_Run *runs = sp->runs;
+
+    V2 origin_translate_px = container_origin_px;
+
+    AABB2 box_container = AABB2{container_origin_px, container_origin_px};
+    {
+        box_container.min.y -= container_height_px;
+        box_container.max.x += container_width_px;
+    }
+
+    Temporary_Arena scratch = scratch_begin();
+
+    U32 line_count = (U32)arrlenu(wrap->lines);
+    for (U32 li = layout_first_visible_line(wrap, -top_y_px); li < line_count; ++li)
+    {
+        Layout_Line line = wrap->lines[li];
+        if (top_y_px + line.y_px >= container_height_px)
+        { break; }
+
+        F32 line_x_px = paragraph->x[line.first_glyph];
+        F32 baseline_y_px = -(top_y_px + line.y_px + line.height_px);
+
+        U32 ri = layout_run_of_glyph(paragraph, line.first_glyph);
+
+        // Gather the cels of the line, all at once so the misses get
+        // rasterized together, and their pen positions.
+        Glyph_Atlas_Key *keys = push_array(scratch.arena, Glyph_Atlas_Key, line.glyph_count);
+        Glyph_Cel *cels       = push_array(scratch.arena, Glyph_Cel, line.glyph_count);
+        F32 *pen_x_px         = push_array(scratch.arena, F32, line.glyph_count);
+        AABB2 *boxes          = push_array(scratch.arena, AABB2, line.glyph_count);
+
+        for (U32 gi = line.first_glyph; gi < line.first_glyph + line.glyph_count; ++gi)
+        {
+            while (gi >= paragraph->run_first_glyphs[ri + 1])
+            { ++ri; }
+
+            Font_Run *run = runs + ri;
+            Glyph_Atlas_Key *key = keys + (gi - line.first_glyph);
+            key->face        = run->face;
+            key->em_size_px  = run->em_size_px;
+            key->glyph_index = run->glyph_indices[gi - paragraph->run_first_glyphs[ri]];
+        }
+
+        glyph_atlas_fill(atlas, keys, line.glyph_count, cels);
+
+        // Drop the empty glyphs.
+        U32 quad_count = 0;
+        for (U32 ci = 0; ci < line.glyph_count; ++ci)
+        {
+            if (! cels[ci].is_empty)
+            {
+                cels[quad_count]     = cels[ci];
+                pen_x_px[quad_count] = paragraph->x[line.first_glyph + ci];
+                ++quad_count;
+            }
+        }
+
+        // Quad corners in bulk, translated to global(container) coordinates,
+        // along with whether all of the line's ink is inside the container.
+        V2 line_origin_px = V2{origin_translate_px.x - line_x_px, origin_translate_px.y + baseline_y_px};
+        B32 is_inside = true;
+        for (U32 qi = 0; qi < quad_count; ++qi)
+        {
+            Glyph_Cel *cel = cels + qi;
+            AABB2 box;
+            box.min.x = line_origin_px.x + pen_x_px[qi] + cel->offset_px.x;
+            box.max.x = box.min.x + cel->width_px;
+            box.max.y = line_origin_px.y + cel->offset_px.y;
+            box.min.y = box.max.y - cel->height_px;
+            boxes[qi] = box;
+
+            is_inside &= (box.min.x >= box_container.min.x && box.max.x <= box_container.max.x &&
+                          box.min.y >= box_container.min.y && box.max.y <= box_container.max.y);
+        }
+
+        if (is_inside)
+        {
+            for (U32 qi = 0; qi < quad_count; ++qi)
+            {
+                render_glyph_instance(r, glyph_instance_from_cel(cels[qi], boxes[qi].min));
+            }
+        }
+        else
+        {
+            for (U32 qi = 0; qi < quad_count; ++qi)
+            {
+                render_glyph_instance_clipped(r, glyph_instance_from_cel(cels[qi], boxes[qi].min), box_container);
+            }
+        }
+    }
+
+    scratch_end(scratch);
+}
+
+// @Note: Emits a laid-out label batch, each glyph clipped to its label's rect.
+function void
+render_label_glyphs(Renderer *r, Glyph_Atlas *atlas, Label_Glyphs *glyphs, Label *labels, U32 label_count)
+{
+    profile_scope(PROFILE_STAGE_VERTEX_BUILD);
+
+    for (U32 li = 0; li < label_count; ++li)
+    {
+        AABB2 box_clip = labels[li].rect_px;
+
+        for (U32 gi = glyphs->label_first_glyphs[li]; gi < glyphs->label_first_glyphs[li + 1]; ++gi)
+        {
+            Label_Font font = glyphs->fonts[glyphs->font_indices[gi]];
+            Glyph_Cel cel = glyph_atlas_get(atlas, font.face, font.em_size_px, glyphs->glyph_indices[gi]);
+            if (cel.is_empty)
+            { continue; }
+
+            AABB2 box_cel;
+            box_cel.min.x = glyphs->x_px[gi] + cel.offset_px.x;
+            box_cel.max.x = box_cel.min.x + cel.width_px;
+            box_cel.max.y = glyphs->y_px[gi] + cel.offset_px.y;
+            box_cel.min.y = box_cel.max.y - cel.height_px;
+
+            Glyph_Instance glyph = glyph_instance_from_cel(cel, box_cel.min);
+            if (box_cel.min.x >= box_clip.min.x && box_cel.max.x <= box_clip.max.x &&
+                box_cel.min.y >= box_clip.min.y && box_cel.max.y <= box_clip.max.y)
+            {
+                render_glyph_instance(r, glyph);
+            }
+            else
+            {
+                render_glyph_instance_clipped(r, glyph, box_clip);
+            }
+        }
+    }
+}
+
+// @Note: The quads as of the last terminal_grid_update(), in the current state.
+function void
+render_terminal_grid(Renderer *r, Terminal_Grid *grid)
+{
+    U32 cell_count = grid->column_count*grid->row_count;
+    for (U32 ci = 0; ci < cell_count; ++ci)
+    {
+        if (grid->quad_is_visible[ci])
+        {
+            Terminal_Quad quad = grid->quads[ci];
+            Glyph_Instance glyph = {quad.min_px, quad.atlas_x, quad.atlas_y, quad.width, quad.height, GLYPH_COLOR_WHITE, quad.page};
+            render_glyph_instance(r, glyph);
+        }
+    }
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef TEXT_RENDER_H
+#define TEXT_RENDER_H
+
+/* --------------------------------------
+   @Note: Text source paragraphs and label batches into glyph instances.
+
+   Paragraphs are shaped through a Font_Backend as they come near the
+   viewport and kept in an LRU cache. Only the glyphs that are about to be
+   drawn are looked up in the Glyph_Atlas, and rasterized on a miss. Nothing
+   here knows which backend or which GPU API is underneath.
+
+   A frame's worth of paragraphs is prefetched at once, so their misses can
+   be shaped and wrapped on the job system. Touching the LRU list stays on
+   the calling thread.
+
+   A Terminal_Font plugs the same backend and atlas into a Terminal_Grid.
+
+   Lines come from a Text_Buffer instead of the Text_Source once one is set.
+   Its change records tell which paragraphs an edit replaced: those are
+   dropped, the ones after them are renumbered and stay shaped.
+   --------------------------------------- */
+
+typedef struct Shaped_Paragraph Shaped_Paragraph;
+struct Shaped_Paragraph
+{
+    Shaped_Paragraph *prev;
+    Shaped_Paragraph *next;
+
+    U64 line;
+    Arena *arena;                           // text and layout.
+    Font_Run *runs;                         // stb_ds array.
+    Layout_Paragraph paragraph;
+    Layout_Wrap wrap;
+};
+
+// @Note: Paragraphs of the text source are shaped only once they come near
+// the viewport, and only the last `capacity` of them are kept.
+typedef struct Paragraph_Cache Paragraph_Cache;
+struct Paragraph_Cache
+{
+    Arena *arena;
+    Shaped_Paragraph *sentinel;             // least recently used first.
+    U32 count;
+    U32 capacity;
+
+    Text_Source *source;
+    Text_Buffer *buffer;                    // or NULL. Lines come from here instead of source.
+    Font_Backend *backend;
+    Job_System *jobs;                       // or NULL.
+    wchar_t *base_family;
+    F32 pt_per_em;
+
+    U64 hit_count;                          // of paragraph_cache_get() and _prefetch().
+    U64 miss_count;
+    U64 eviction_count;
+    U64 invalidation_count;                 // paragraphs dropped by edits.
+};
+
+typedef struct Paragraph_Cache_Stats Paragraph_Cache_Stats;
+struct Paragraph_Cache_Stats
+{
+    U64 hit_count;
+    U64 miss_count;
+    U64 eviction_count;
+    U64 invalidation_count;
+
+    U32 count;
+    U32 capacity;
+    U64 glyph_count;                        // shaped, over the cached paragraphs.
+    U64 arena_bytes;                        // the cache's and its paragraphs'.
+    U64 heap_bytes;                         // stb_ds arrays the paragraphs hold on to.
+};
+
+// Paragraphs of one paragraph_cache_prefetch() to shape, or to wrap.
+typedef struct Paragraph_Cache_Task Paragraph_Cache_Task;
+struct Paragraph_Cache_Task
+{
+    Paragraph_Cache *cache;
+    Shaped_Paragraph **paragraphs;
+    F32 width_px;
+};
+
+// @Note: Font side of a terminal grid.
+typedef struct Terminal_Font Terminal_Font;
+struct Terminal_Font
+{
+    Font_Backend *backend;
+    Glyph_Atlas *atlas;
+    wchar_t *family;
+    F32 pt_per_em;
+};
+
+function void paragraph_cache_init(Paragraph_Cache *cache, U32 capacity, Text_Source *source, Font_Backend *backend, Job_System *jobs, wchar_t *base_family, F32 pt_per_em);
+function void paragraph_cache_release(Paragraph_Cache *cache);
+function void paragraph_cache_drop(Paragraph_Cache *cache, Shaped_Paragraph *sp);
+function void paragraph_cache_set_buffer(Paragraph_Cache *cache, Text_Buffer *buffer);
+function U64 paragraph_cache_line_count(Paragraph_Cache *cache);
+function void paragraph_cache_apply_changes(Paragraph_Cache *cache, Text_Buffer_Change *changes, U64 change_count);
+function void paragraph_cache_shape(Paragraph_Cache *cache, Shaped_Paragraph *sp, U64 line);
+function Shaped_Paragraph *paragraph_cache_find(Paragraph_Cache *cache, U64 line);
+function Shaped_Paragraph *paragraph_cache_take(Paragraph_Cache *cache);
+function void paragraph_cache_shape_proc(void *user_data, U32 worker_index, U64 begin, U64 end);
+function void paragraph_cache_wrap_proc(void *user_data, U32 worker_index, U64 begin, U64 end);
+function void paragraph_cache_prefetch(Paragraph_Cache *cache, U64 first_line, U64 line_count, F32 width_px);
+function Shaped_Paragraph *paragraph_cache_get(Paragraph_Cache *cache, U64 line, F32 width_px);
+function Paragraph_Cache_Stats paragraph_cache_get_stats(Paragraph_Cache *cache);
+
+function void terminal_shape_row_font(void *user_data, U16 *text, U32 column_count, U16 *out_glyph_indices, U64 *out_faces);
+function B32 terminal_get_quad_font(void *user_data, U64 face, U16 glyph_index, V2 baseline_origin_px, Terminal_Quad *out);
+function void terminal_grid_init_font(Terminal_Grid *grid, Terminal_Font *font, U32 column_count, U32 row_count);
+
+function Glyph_Instance glyph_instance_from_cel(Glyph_Cel cel, V2 min_px);
+function void render_paragraph(Renderer *r, Glyph_Atlas *atlas, Shaped_Paragraph *sp, F32 top_y_px, V2 container_origin_px, F32 container_width_px, F32 container_height_px);
+function void render_label_glyphs(Renderer *r, Glyph_Atlas *atlas, Label_Glyphs *glyphs, Label *labels, U32 label_count);
+function void render_terminal_grid(Renderer *r, Terminal_Grid *grid);
+
+#endif // TEXT_RENDER_H
@@ -0,0 +1,544 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function U32
+text_source_popcount32(U32 x)
+{
+    x = x - ((x >> 1) & 0x55555555);
+    x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+    x = (x + (x >> 4)) & 0x0f0f0f0f;
+    return (x * 0x01010101) >> 24;
+}
+
+// @Note: Whether the code unit at data is a whole '\n': 0x0A 0x00 in
+// UTF-16LE and 0x00 0x0A in UTF-16BE, not any unit with a 0x0A byte.
+function B32
+text_source_is_newline(U8 *data, Text_Encoding encoding)
+{
+    B32 result = false;
+    if      (encoding == TEXT_ENCODING_UTF8)    { result = (data[0] == '\n'); }
+    else if (encoding == TEXT_ENCODING_UTF16LE) { result = (data[0] == '\n' && data[1] == 0); }
+    else                                        { result = (data[0] == 0 && data[1] == '\n'); }
+    return result;
+}
+
+// @Note: One bit per newline in the 16 bytes at data, at the newline's first byte.
+function U32
+text_source_newline_mask16(U8 *data, Text_Encoding encoding)
+{
+    U32 result = 0;
+
+#if SIMPLE_TEXT_SSE2
+    __m128i v = _mm_loadu_si128((__m128i *)data);
+    if (encoding == TEXT_ENCODING_UTF8)
+    {
+        result = (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+    }
+    else
+    {
+        // Loaded little-endian, a big-endian '\n' reads as 0x0A00.
+        S16 newline = (encoding == TEXT_ENCODING_UTF16LE) ? 0x000a : 0x0a00;
+        result = (U32)_mm_movemask_epi8(_mm_cmpeq_epi16(v, _mm_set1_epi16(newline))) & 0x5555;
+    }
+#else
+    U32 unit_size = (encoding == TEXT_ENCODING_UTF8) ? 1 : 2;
+    for (U32 i = 0; i < 16; i += unit_size)
+    { result |= (U32)text_source_is_newline(data + i, encoding) << i; }
+#endif
+
+    return result;
+}
+
+// @Note: Byte offset of the first newline, or size if there is none.
+function U64
+text_source_find_newline(U8 *data, U64 size, Text_Encoding encoding)
+{
+    U64 unit_size = (encoding == TEXT_ENCODING_UTF8) ? 1 : 2;
+    size -= (size % unit_size);
+
+    U64 at = 0;
+    for (; at + 16 <= size; at += 16)
+    {
+        U32 mask = text_source_newline_mask16(data + at, encoding);
+        if (mask)
+        { return at + simple_text_ctz32(mask); }
+    }
+
+    for (; at < size; at += unit_size)
+    {
+        if (text_source_is_newline(data + at, encoding))
+        { return at; }
+    }
+
+    return size;
+}
+
+// @Note: Drops pages of the mapped view from the working set. They are clean,
+// so this costs nothing but a refault if they're read again.
+function void
+text_source_trim_resident(Text_Source *source, U64 begin, U64 end)
+{
+    if (! source->is_mapped || end <= begin)
+    { return; }
+
+    begin &= ~(U64)4095;
+
+#if defined(OS_WINDOWS)
+    // Unlocking pages that aren't locked fails, but removes them from the working set.
+    VirtualUnlock(source->data + begin, end - begin);
+#else
+    madvise(source->data + begin, end - begin, MADV_DONTNEED);
+#endif
+}
+
+function void
+text_source_scan(Text_Source_Scan_Task *task)
+{
+    Text_Source *source = task->source;
+    Text_Encoding encoding = source->encoding;
+    U64 unit_size = (encoding == TEXT_ENCODING_UTF8) ? 1 : 2;
+
+    U64 count = 0;
+    for (U64 window = task->begin; window < task->end; window += TEXT_SOURCE_SCAN_WINDOW_SIZE)
+    {
+        U64 window_end = min(window + TEXT_SOURCE_SCAN_WINDOW_SIZE, task->end);
+
+        U64 at = window;
+        for (; at + 16 <= window_end; at += 16)
+        {
+            U32 mask = text_source_newline_mask16(source->data + at, encoding);
+            if (! mask)
+            { continue; }
+
+            U32 n = text_source_popcount32(mask);
+            if ((count % TEXT_SOURCE_LINE_STRIDE) + n < TEXT_SOURCE_LINE_STRIDE)
+            {
+                count += n;
+                continue;
+            }
+
+            // A checkpoint falls inside this block. Find the exact newline.
+            while (mask)
+            {
+                U32 bit = simple_text_ctz32(mask);
+                mask &= (mask - 1);
+                if ((++count % TEXT_SOURCE_LINE_STRIDE) == 0)
+                {
+                    Text_Source_Checkpoint checkpoint = {count, at + bit + unit_size};
+                    arrput(task->checkpoints, checkpoint);
+                }
+            }
+        }
+
+        for (; at + unit_size <= window_end; at += unit_size)
+        {
+            if (text_source_is_newline(source->data + at, encoding))
+            {
+                if ((++count % TEXT_SOURCE_LINE_STRIDE) == 0)
+                {
+                    Text_Source_Checkpoint checkpoint = {count, at + unit_size};
+                    arrput(task->checkpoints, checkpoint);
+                }
+            }
+        }
+
+        text_source_trim_resident(source, window, window_end);
+    }
+
+    task->newline_count = count;
+}
+
+#if defined(OS_WINDOWS)
+function DWORD WINAPI
+text_source_scan_thread_proc(LPVOID param)
+{
+    text_source_scan((Text_Source_Scan_Task *)param);
+    return 0;
+}
+#else
+function void *
+text_source_scan_thread_proc(void *param)
+{
+    text_source_scan((Text_Source_Scan_Task *)param);
+    return NULL;
+}
+#endif
+
+function U32
+text_source_get_processor_count(void)
+{
+#if defined(OS_WINDOWS)
+    SYSTEM_INFO info = {};
+    GetSystemInfo(&info);
+    U32 result = (U32)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    U32 result = (count > 0) ? (U32)count : 1;
+#endif
+    return max(result, 1u);
+}
+
+// @Note: Splits the text into one chunk per thread. Each thread records a
+// checkpoint every TEXT_SOURCE_LINE_STRIDE newlines of its own chunk, and the
+// line numbers are made global afterwards from the per-chunk newline counts.
+function void
+text_source_build_index(Text_Source *source)
+{
+    U64 text_size = source->size - source->text_begin;
+
+    U64 min_chunk_size = ((U64)4 << 20);
+    U64 task_count = min((U64)text_source_get_processor_count(), (U64)TEXT_SOURCE_MAX_THREAD_COUNT);
+    task_count = min(task_count, text_size / min_chunk_size);
+    task_count = max(task_count, (U64)1);
+
+    // Keeps chunks page-aligned and UTF-16 chunks on code unit boundaries.
+    U64 chunk_size = ((text_size / task_count) + 0xffff) & ~0xffffull;
+
+    Text_Source_Scan_Task tasks[TEXT_SOURCE_MAX_THREAD_COUNT] = {};
+    for (U64 ti = 0; ti < task_count; ++ti)
+    {
+        tasks[ti].source = source;
+        tasks[ti].begin  = min(source->text_begin + ti*chunk_size, source->size);
+        tasks[ti].end    = min(source->text_begin + (ti + 1)*chunk_size, source->size);
+    }
+    tasks[task_count - 1].end = source->size;
+
+    // The calling thread takes the first chunk.
+#if defined(OS_WINDOWS)
+    HANDLE threads[TEXT_SOURCE_MAX_THREAD_COUNT] = {};
+    for (U64 ti = 1; ti < task_count; ++ti)
+    {
+        threads[ti] = CreateThread(NULL, 0, text_source_scan_thread_proc, tasks + ti, 0, NULL);
+        assume(threads[ti]);
+    }
+    text_source_scan(tasks + 0);
+    for (U64 ti = 1; ti < task_count; ++ti)
+    {
+        WaitForSingleObject(threads[ti], INFINITE);
+        CloseHandle(threads[ti]);
+    }
+#else
+    pthread_t threads[TEXT_SOURCE_MAX_THREAD_COUNT] = {};
+    for (U64 ti = 1; ti < task_count; ++ti)
+    {
+        int error = pthread_create(threads + ti, NULL, text_source_scan_thread_proc, tasks + ti);
+        assume(error == 0);
+    }
+    text_source_scan(tasks + 0);
+    for (U64 ti = 1; ti < task_count; ++ti)
+    { pthread_join(threads[ti], NULL); }
+#endif
+
+    U64 checkpoint_count = 1;
+    for (U64 ti = 0; ti < task_count; ++ti)
+    { checkpoint_count += arrlenu(tasks[ti].checkpoints); }
+
+    source->checkpoints = push_array(source->arena, Text_Source_Checkpoint, checkpoint_count);
+    source->checkpoints[0] = Text_Source_Checkpoint{0, source->text_begin};
+    source->checkpoint_count = 1;
+
+    U64 line_base = 0;
+    for (U64 ti = 0; ti < task_count; ++ti)
+    {
+        Text_Source_Scan_Task *task = tasks + ti;
+
+        for (U64 ci = 0; ci < arrlenu(task->checkpoints); ++ci)
+        {
+            Text_Source_Checkpoint checkpoint = task->checkpoints[ci];
+            checkpoint.line += line_base;
+
+            // A trailing newline doesn't start another line.
+            if (checkpoint.offset < source->size)
+            { source->checkpoints[source->checkpoint_count++] = checkpoint; }
+        }
+
+        line_base += task->newline_count;
+        arrfree(task->checkpoints);
+    }
+
+    source->line_count = line_base + 1;
+
+    // A stray odd byte at the end isn't a unit.
+    U64 unit_size = (source->encoding == TEXT_ENCODING_UTF8) ? 1 : 2;
+    U64 end = source->size - (source->size - source->text_begin) % unit_size;
+    if (line_base && end >= source->text_begin + unit_size &&
+        text_source_is_newline(source->data + end - unit_size, source->encoding))
+    {
+        source->line_count -= 1;
+    }
+}
+
+// @Note: Detects the BOM and builds the index. data and size must be set.
+function void
+text_source_init(Text_Source *source)
+{
+    source->arena = arena_alloc();
+    source->text_begin = 0;
+
+    U8 *d = source->data;
+    if (source->size >= 3 && d[0] == 0xef && d[1] == 0xbb && d[2] == 0xbf)
+    {
+        source->encoding   = TEXT_ENCODING_UTF8;
+        source->text_begin = 3;
+    }
+    else if (source->size >= 2 && d[0] == 0xff && d[1] == 0xfe)
+    {
+        source->encoding   = TEXT_ENCODING_UTF16LE;
+        source->text_begin = 2;
+    }
+    else if (source->size >= 2 && d[0] == 0xfe && d[1] == 0xff)
+    {
+        source->encoding   = TEXT_ENCODING_UTF16BE;
+        source->text_begin = 2;
+    }
+
+    text_source_build_index(source);
+}
+
+function B32
+text_source_open_file(Text_Source *source, char *path)
+{
+    *source = {};
+    source->encoding = TEXT_ENCODING_UTF8;
+
+    B32 result = false;
+    U64 size = 0;
+
+#if defined(OS_WINDOWS)
+    Temporary_Arena scratch = scratch_begin();
+    int wide_length = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+    wchar_t *wide_path = push_array(scratch.arena, wchar_t, wide_length);
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, wide_path, wide_length);
+
+    HANDLE file = CreateFileW(wide_path, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    scratch_end(scratch);
+
+    LARGE_INTEGER file_size = {};
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &file_size))
+    {
+        size = (U64)file_size.QuadPart;
+        if (size)
+        {
+            // Zero-length files can't be mapped.
+            HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            void *data = (mapping) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+            if (data)
+            {
+                source->file      = file;
+                source->mapping   = mapping;
+                source->data      = (U8 *)data;
+                source->size      = size;
+                source->is_mapped = true;
+                result = true;
+            }
+            else if (mapping)
+            { CloseHandle(mapping); }
+        }
+        else
+        { result = true; }
+    }
+
+    if (file != INVALID_HANDLE_VALUE && ! source->is_mapped)
+    { CloseHandle(file); }
+#else
+    int file = open(path, O_RDONLY);
+    struct stat st = {};
+    if (file >= 0 && fstat(file, &st) == 0)
+    {
+        size = (U64)st.st_size;
+        if (size)
+        {
+            void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                source->file      = file;
+                source->data      = (U8 *)data;
+                source->size      = size;
+                source->is_mapped = true;
+                result = true;
+            }
+        }
+        else
+        { result = true; }
+    }
+
+    if (file >= 0 && ! source->is_mapped)
+    { close(file); }
+#endif
+
+    if (result)
+    { text_source_init(source); }
+
+    return result;
+}
+
+// @Note: data must outlive the source.
+function void
+text_source_open_memory(Text_Source *source, U8 *data, U64 size, Text_Encoding encoding)
+{
+    *source = {};
+    source->encoding = encoding;
+    source->data     = data;
+    source->size     = size;
+    text_source_init(source);
+}
+
+function void
+text_source_close(Text_Source *source)
+{
+    if (source->is_mapped)
+    {
+#if defined(OS_WINDOWS)
+        UnmapViewOfFile(source->data);
+        CloseHandle(source->mapping);
+        CloseHandle(source->file);
+#else
+        munmap(source->data, source->size);
+        close(source->file);
+#endif
+    }
+
+    if (source->arena)
+    { arena_release(source->arena); }
+
+    *source = {};
+}
+
+// @Note: Byte range of a line, without its newline.
+function void
+text_source_get_line_range(Text_Source *source, U64 line, U64 *begin, U64 *end)
+{
+    assert(line < source->line_count);
+
+    // Last checkpoint at or before the line.
+    U64 lo = 0;
+    U64 hi = source->checkpoint_count;
+    while (lo < hi)
+    {
+        U64 mid = lo + (hi - lo)/2;
+        if (source->checkpoints[mid].line <= line) { lo = mid + 1; }
+        else                                       { hi = mid; }
+    }
+    Text_Source_Checkpoint checkpoint = source->checkpoints[lo - 1];
+
+    U64 unit_size = (source->encoding == TEXT_ENCODING_UTF8) ? 1 : 2;
+    U64 offset = checkpoint.offset;
+    for (U64 skip = line - checkpoint.line; skip > 0; --skip)
+    {
+        offset += text_source_find_newline(source->data + offset, source->size - offset, source->encoding) + unit_size;
+        offset = min(offset, source->size);
+    }
+
+    *begin = offset;
+    *end   = offset + text_source_find_newline(source->data + offset, source->size - offset, source->encoding);
+}
+
+// @Note: Invalid UTF-8 becomes U+FFFD. Stops at TEXT_SOURCE_MAX_LINE_LENGTH
+// code units and drops a trailing '\r'.
+function U16 *
+text_source_transcode(Arena *arena, U8 *data, U64 size, Text_Encoding encoding, U32 *length)
+{
+    U32 capacity = (U32)min(size, (U64)TEXT_SOURCE_MAX_LINE_LENGTH);
+    U16 *result = push_array(arena, U16, capacity + 1);
+    U32 count = 0;
+
+    if (encoding == TEXT_ENCODING_UTF16LE)
+    {
+        count = (U32)min(size / 2, (U64)capacity);
+        memory_copy(result, data, count*sizeof(U16));
+    }
+    else if (encoding == TEXT_ENCODING_UTF16BE)
+    {
+        count = (U32)min(size / 2, (U64)capacity);
+        U32 at = 0;
+#if SIMPLE_TEXT_SSE2
+        for (; at + 8 <= count; at += 8)
+        {
+            __m128i v = _mm_loadu_si128((__m128i *)(data + at*2));
+            _mm_storeu_si128((__m128i *)(result + at), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+        }
+#endif
+        for (; at < count; ++at)
+        { result[at] = (U16)((data[at*2] << 8) | data[at*2 + 1]); }
+    }
+    else
+    {
+        U64 at = 0;
+        while (at < size && count < capacity)
+        {
+#if SIMPLE_TEXT_SSE2
+            // ASCII fast path: widen 16 bytes at a time.
+            if (at + 16 <= size && count + 16 <= capacity)
+            {
+                __m128i v = _mm_loadu_si128((__m128i *)(data + at));
+                if (_mm_movemask_epi8(v) == 0)
+                {
+                    __m128i zero = _mm_setzero_si128();
+                    _mm_storeu_si128((__m128i *)(result + count),     _mm_unpacklo_epi8(v, zero));
+                    _mm_storeu_si128((__m128i *)(result + count + 8), _mm_unpackhi_epi8(v, zero));
+                    at    += 16;
+                    count += 16;
+                    continue;
+                }
+            }
+#endif
+
+            U32 c = data[at];
+            U32 n = 1;
+            U32 codepoint = 0xfffd;
+            U32 min_codepoint = 0;
+            if      (c < 0x80)           { n = 1; codepoint = c; }
+            else if ((c & 0xe0) == 0xc0) { n = 2; codepoint = c & 0x1f; min_codepoint = 0x80; }
+            else if ((c & 0xf0) == 0xe0) { n = 3; codepoint = c & 0x0f; min_codepoint = 0x800; }
+            else if ((c & 0xf8) == 0xf0) { n = 4; codepoint = c & 0x07; min_codepoint = 0x10000; }
+            else                         { n = 0; }
+
+            B32 is_valid = (n > 0 && at + n <= size);
+            for (U32 i = 1; is_valid && i < n; ++i)
+            {
+                U8 b = data[at + i];
+                is_valid = ((b & 0xc0) == 0x80);
+                codepoint = (codepoint << 6) | (b & 0x3f);
+            }
+            is_valid = (is_valid && codepoint >= min_codepoint && codepoint <= 0x10ffff &&
+                        ! (codepoint >= 0xd800 && codepoint <= 0xdfff));
+
+            if (! is_valid)
+            {
+                codepoint = 0xfffd;
+                n = 1;
+            }
+
+            if (codepoint >= 0x10000)
+            {
+                if (count + 2 > capacity)
+                { break; }
+                codepoint -= 0x10000;
+                result[count++] = (U16)(0xd800 + (codepoint >> 10));
+                result[count++] = (U16)(0xdc00 + (codepoint & 0x3ff));
+            }
+            else
+            {
+                result[count++] = (U16)codepoint;
+            }
+
+            at += n;
+        }
+    }
+
+    if (count && result[count - 1] == '\r')
+    { --count; }
+
+    result[count] = 0;
+    *length = count;
+    return result;
+}
+
+function U16 *
+text_source_get_line(Text_Source *source, Arena *arena, U64 line, U32 *length)
+{
+    U64 begin, end;
+    text_source_get_line_range(source, line, &begin, &end);
+    U16 *result = text_source_transcode(arena, source->data + begin, end - begin, source->encoding, length);
+    return result;
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef TEXT_SOURCE_H
+#define TEXT_SOURCE_H
+
+/* --------------------------------------
+   @Note: Text source backed by a memory-mapped file.
+
+   Opening never copies or transcodes the file. The whole file is mapped
+   read-only, so pages only become resident once something reads them, and
+   a sparse line index is built by scanning for '\n' with SIMD on several
+   threads. The scan maps its own windows and drops them as it goes, so it
+   doesn't leave the file resident either.
+
+   The index keeps one checkpoint every TEXT_SOURCE_LINE_STRIDE lines.
+   Finding the start of a line is a binary search over the checkpoints plus
+   a forward scan over at most that many lines.
+
+   Paragraphs (= lines) are transcoded to UTF-16 on demand by the caller,
+   typically only those near the viewport. The encoding comes from the BOM:
+   UTF-8, UTF-16LE or UTF-16BE, and UTF-8 without one.
+   --------------------------------------- */
+
+#if defined(OS_WINDOWS)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <pthread.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#define TEXT_SOURCE_LINE_STRIDE         256
+#define TEXT_SOURCE_SCAN_WINDOW_SIZE    ((U64)64 << 20)
+#define TEXT_SOURCE_MAX_THREAD_COUNT    16
+#define TEXT_SOURCE_MAX_LINE_LENGTH     65536 // in UTF-16 code units. Longer lines are cut.
+
+typedef enum Text_Encoding
+{
+    TEXT_ENCODING_UTF8,
+    TEXT_ENCODING_UTF16LE,
+    TEXT_ENCODING_UTF16BE,
+} Text_Encoding;
+
+typedef struct Text_Source_Checkpoint Text_Source_Checkpoint;
+struct Text_Source_Checkpoint
+{
+    U64 line;
+    U64 offset; // file offset of the line's first byte.
+};
+
+typedef struct Text_Source Text_Source;
+
+// One per scanning thread.
+typedef struct Text_Source_Scan_Task Text_Source_Scan_Task;
+struct Text_Source_Scan_Task
+{
+    Text_Source *source;
+    U64 begin;
+    U64 end;
+    U64 newline_count;
+    Text_Source_Checkpoint *checkpoints; // stb_ds array. .line is relative to the task.
+};
+
+struct Text_Source
+{
+    Arena *arena;
+
+    Text_Encoding encoding;
+    U8 *data;              // whole file, read-only.
+    U64 size;
+    U64 text_begin;        // past the BOM.
+
+    U64 line_count;
+    U64 checkpoint_count;
+    Text_Source_Checkpoint *checkpoints;
+
+    B32 is_mapped;         // false: data points at caller-owned memory.
+#if defined(OS_WINDOWS)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int file;
+#endif
+};
+
+function B32 text_source_open_file(Text_Source *source, char *path);
+function void text_source_open_memory(Text_Source *source, U8 *data, U64 size, Text_Encoding encoding);
+function void text_source_close(Text_Source *source);
+
+function U32 text_source_popcount32(U32 x);
+function B32 text_source_is_newline(U8 *data, Text_Encoding encoding);
+function U32 text_source_newline_mask16(U8 *data, Text_Encoding encoding);
+function U64 text_source_find_newline(U8 *data, U64 size, Text_Encoding encoding);
+function void text_source_trim_resident(Text_Source *source, U64 begin, U64 end);
+function void text_source_scan(Text_Source_Scan_Task *task);
+function U32 text_source_get_processor_count(void);
+function void text_source_build_index(Text_Source *source);
+function void text_source_init(Text_Source *source);
+
+function void text_source_get_line_range(Text_Source *source, U64 line, U64 *begin, U64 *end);
+function U16 *text_source_transcode(Arena *arena, U8 *data, U64 size, Text_Encoding encoding, U32 *length);
+function U16 *text_source_get_line(Text_Source *source, Arena *arena, U64 line, U32 *length);
+
+#endif // TEXT_SOURCE_H
@@ -1,33 +1,34 @@
 // ---------------------------------
-// @Note: 2nd Tier Glyph Hash Table
+// @Note: FontFace Hash Table (Outer Hash Table)
 function U64
-dwrite_hash_glyph_index(U16 idx)
+dwrite_hash_font(IDWriteFontFace *key)
 {
     // @Todo: Better hash
-    U64 result = (U64)idx * 16;
+    U64 result = u64_from_ptr(key) + 1234;
     return result;
 }
 
-function Dwrite_Glyph_Table_Entry *
-dwrite_get_glyph_entry_from_table(Dwrite_Glyph_Table glyph_table, U16 glyph_index)
+function Dwrite_Font_Table_Entry *
+dwrite_get_entry_from_font_table(Dwrite_State *dwrite, IDWriteFontFace *font_face)
 {
-    Dwrite_Glyph_Table_Entry *result = NULL;
+    Dwrite_Font_Table_Entry *result = NULL;
 
-    U64 hashed = dwrite_hash_glyph_index(glyph_index);
-    U64 entry_count = glyph_table.entry_count;
+    U64 hashed = dwrite_hash_font(font_face);
+    U64 entry_count = dwrite->font_table.entry_count;
     U64 home_position = (hashed % entry_count);
 
+    // Nothing is ever removed, so the first empty entry ends the search.
     for (U64 i = 0; i < entry_count; ++i)
     {
         U64 idx = (home_position + i) % entry_count;
 
-        if (glyph_table.entries[idx].occupied)
-        { 
-            if (glyph_table.entries[idx].idx == glyph_index)
-            {
-                result = glyph_table.entries + idx;
-                break;
-            }
+        if (! job_atomic_load(&dwrite->font_table.entries[idx].occupied))
+        { break; }
+
+        if (dwrite->font_table.entries[idx].key == font_face)
+        {
+            result = dwrite->font_table.entries + idx;
+            break;
         }
     }
 
@@ -35,10 +36,12 @@ dwrite_get_glyph_entry_from_table(Dwrite_Glyph_Table glyph_table, U16 glyph_inde
 }
 
 function void
-dwrite_insert_glyph_cel_to_table(Dwrite_Glyph_Table *glyph_table, U16 glyph_index, Glyph_Cel cel)
+dwrite_insert_font_to_table(Dwrite_State *dwrite, IDWriteFontFace *font_face, Dwrite_Font_Metrics metrics)
 {
-    U64 hashed = dwrite_hash_glyph_index(glyph_index);
-    U64 entry_count = glyph_table->entry_count;
+    job_mutex_lock(&dwrite->font_table.write_mutex);
+
+    U64 hashed = dwrite_hash_font(font_face);
+    U64 entry_count = dwrite->font_table.entry_count;
     U64 home_position = (hashed % entry_count);
 
     U64 idx_to_insert = home_position;
@@ -49,18 +52,19 @@ dwrite_insert_glyph_cel_to_table(Dwrite_Glyph_Table *glyph_table, U16 glyph_inde
     {
         U64 idx = (home_position + i) % entry_count;
 
-        if (glyph_table->entries[idx].occupied)
+        if (dwrite->font_table.entries[idx].occupied)
         { 
-            if (glyph_table->entries[idx].idx == glyph_index)
+            if (dwrite->font_table.entries[idx].key == font_face)
             {
                 exists_already = true;
                 break;
             }
         }
-        else if (! found_place_to_insert)
+        else
         {
             idx_to_insert = idx;
             found_place_to_insert = true;
+            break;
         }
     }
 
@@ -68,100 +72,86 @@ dwrite_insert_glyph_cel_to_table(Dwrite_Glyph_Table *glyph_table, U16 glyph_inde
     {
         if (found_place_to_insert)
         {
-            Dwrite_Glyph_Table_Entry *entry = glyph_table->entries + idx_to_insert;
-            entry->idx      = glyph_index;
-            entry->cel      = cel;
-            entry->occupied = true;
+            Dwrite_Font_Table_Entry *entry = dwrite->font_table.entries + idx_to_insert;
+            entry->key      = font_face;
+            entry->metrics  = metrics;
+            entry->simple_text = dwrite_build_simple_text_table(dwrite, font_face);
+            job_atomic_store(&entry->occupied, true);
         }
         else
         {
             assume(! "Insufficient hash table entries.");
         }
     }
-}
 
-// ---------------------------------
-// @Note: FontFace Hash Table (Outer Hash Table)
-function U64
-dwrite_hash_font(IDWriteFontFace *key)
-{
-    // @Todo: Better hash
-    U64 result = u64_from_ptr(key) + 1234;
-    return result;
+    job_mutex_unlock(&dwrite->font_table.write_mutex);
 }
 
-function Dwrite_Font_Table_Entry *
-dwrite_get_entry_from_font_table(IDWriteFontFace *font_face)
+// @Note: Caches the face's cmap and design advances for the first 256 codepoints
+// so that plain ASCII/Latin-1 can skip GetTextComplexity() entirely.
+function Simple_Text_Table *
+dwrite_build_simple_text_table(Dwrite_State *dwrite, IDWriteFontFace *font_face)
 {
-    Dwrite_Font_Table_Entry *result = NULL;
+    Simple_Text_Table *result = push_struct(dwrite->arena, Simple_Text_Table);
 
-    U64 hashed = dwrite_hash_font(font_face);
-    U64 entry_count = dwrite.font_table.entry_count;
-    U64 home_position = (hashed % entry_count);
+    B32 has_cmap = false;
+    B32 has_shaping_features = false;
+    result->space_is_contextual = true; // until the cmap tells us which glyph a space is.
 
-    for (U64 i = 0; i < entry_count; ++i)
+    UINT32 tags[] =
     {
-        U64 idx = (home_position + i) % entry_count;
+        DWRITE_MAKE_OPENTYPE_TAG('c','m','a','p'),
+        DWRITE_MAKE_OPENTYPE_TAG('G','S','U','B'),
+        DWRITE_MAKE_OPENTYPE_TAG('G','P','O','S'),
+        DWRITE_MAKE_OPENTYPE_TAG('k','e','r','n'),
+    };
 
-        if (dwrite.font_table.entries[idx].occupied)
-        { 
-            if (dwrite.font_table.entries[idx].key == font_face)
-            {
-                result = dwrite.font_table.entries + idx;
-                break;
-            }
-        }
-    }
-
-    return result;
-}
-
-function void
-dwrite_insert_font_to_table(IDWriteFontFace *font_face, Dwrite_Font_Metrics metrics)
-{
-    U64 hashed = dwrite_hash_font(font_face);
-    U64 entry_count = dwrite.font_table.entry_count;
-    U64 home_position = (hashed % entry_count);
-
-    U64 idx_to_insert = home_position;
-    B32 found_place_to_insert = false;
-    B32 exists_already = false;
-
-    for (U64 i = 0; i < entry_count; ++i)
+    for (U32 ti = 0; ti < array_count(tags); ++ti)
     {
-        U64 idx = (home_position + i) % entry_count;
+        const void *data = NULL;
+        UINT32 size = 0;
+        void *context = NULL;
+        BOOL exists = FALSE;
 
-        if (dwrite.font_table.entries[idx].occupied)
-        { 
-            if (dwrite.font_table.entries[idx].key == font_face)
+        if (SUCCEEDED(font_face->TryGetFontTable(tags[ti], &data, &size, &context, &exists)) && exists)
+        {
+            switch (ti)
             {
-                exists_already = true;
-                break;
+                case 0: {
+                    has_cmap = simple_text_parse_cmap(result, (U8 *)data, size);
+                    result->space_is_contextual = !has_cmap;
+                } break;
+
+                case 1:
+                case 2: {
+                    has_shaping_features |= simple_text_has_shaping_features((U8 *)data, size);
+                    if (has_cmap)
+                    {
+                        B32 is_gpos = (ti == 2);
+                        result->space_is_contextual |= simple_text_layout_touches_glyph((U8 *)data, size, is_gpos, result->glyph_indices[' ']);
+                    }
+                } break;
+
+                case 3: {
+                    // Legacy 'kern' table. The analyzer applies it, so we can't.
+                    has_shaping_features = true;
+                } break;
             }
-        }
-        else if (! found_place_to_insert)
-        {
-            idx_to_insert = idx;
-            found_place_to_insert = true;
+
+            font_face->ReleaseFontTable(context);
         }
     }
 
-    if (! exists_already)
+    if (has_cmap && !has_shaping_features)
     {
-        if (found_place_to_insert)
-        {
-            Dwrite_Font_Table_Entry *entry = dwrite.font_table.entries + idx_to_insert;
-            entry->key      = font_face;
-            entry->metrics  = metrics;
-            entry->glyph_table.entry_count = 256;
-            entry->glyph_table.entries = push_array(dwrite.arena, Dwrite_Glyph_Table_Entry, entry->glyph_table.entry_count); // @Todo: Proper arena
-            entry->occupied = true;
-        }
-        else
+        IDWriteFontFace5 *font_face5 = (IDWriteFontFace5 *)font_face;
+        if (SUCCEEDED(font_face5->GetDesignGlyphAdvances(SIMPLE_TEXT_CODEPOINT_COUNT, result->glyph_indices, result->advances_du, FALSE /*RetrieveVerticalAdvance*/)))
         {
-            assume(! "Insufficient hash table entries.");
+            result->is_eligible = true;
         }
     }
+
+    return result;
 }
 
 // @Note: Determines the longest run of characters that map 1:1 to glyphs without
@@ -172,6 +162,8 @@ dwrite_map_complexity(IDWriteTextAnalyzer1 *text_analyzer,
                       IDWriteFontFace *font_face,
                       WCHAR *text, U32 text_length)
 {
+    profile_scope(PROFILE_STAGE_COMPLEXITY);
+
     Dwrite_Map_Complexity_Result result = {};
 
     B32 is_simple;
@@ -198,6 +190,8 @@ dwrite_font_fallback(IDWriteFontFallback1 *font_fallback,
                      WCHAR *base_family, WCHAR *locale,
                      WCHAR *text, U32 text_length)
 {
+    profile_scope(PROFILE_STAGE_FALLBACK);
+
     Dwrite_Font_Fallback_Result result = {};
 
     // @Note: It's safe to ignore scale in practice. -lhecker
@@ -216,222 +210,611 @@ dwrite_font_fallback(IDWriteFontFallback1 *font_fallback,
     return result;
 }
 
-function DWRITE_GLYPH_RUN *
-dwrite_map_text_to_glyphs(IDWriteFontFallback1 *font_fallback,
-                          IDWriteFontCollection *font_collection,
-                          IDWriteTextAnalyzer1 *text_analyzer,
-                          WCHAR *locale, WCHAR *base_family,
-                          FLOAT pt_per_em, FLOAT px_per_inch, WCHAR *text, U32 text_length)
+// @Note: Full shaping (GetGlyphs + GetGlyphPlacements) of one script run.
+// Glyphs are appended to the given arrays, along with the text position of the
+// cluster each glyph belongs to. Returns the number of glyphs added.
+function U32
+dwrite_shape_text(IDWriteTextAnalyzer1 *text_analyzer,
+                  IDWriteFontFace5 *font_face,
+                  DWRITE_SCRIPT_ANALYSIS analysis,
+                  WCHAR *locale, FLOAT px_per_em,
+                  WCHAR *text, U32 text_length, U32 text_position,
+                  U16 **indices, FLOAT **advances, U32 **text_positions)
 {
-    DWRITE_GLYPH_RUN *result = NULL;
-    F32 max_advance_height_px = 0.0f; // @Todo: return this
-
     HRESULT hr = S_OK;
 
-    U32 offset = 0;
-    while (offset < text_length)
+    Temporary_Arena scratch = scratch_begin();
+
+    U16 *cluster_map = push_array(scratch.arena, U16, text_length);
+    DWRITE_SHAPING_TEXT_PROPERTIES *text_props = push_array(scratch.arena, DWRITE_SHAPING_TEXT_PROPERTIES, text_length);
+    DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props = NULL;
+
+    U32 glyph_count_old = (U32)arrlenu(*indices);
+    U32 glyph_count_add = 0;
+    U32 estimated_glyph_count_add = (3 * text_length / 2 + 16);
+
+    U32 retry_count = 0;
+    while (retry_count < 8)
+    {
+        profile_scope(PROFILE_STAGE_GET_GLYPHS);
+
+        arrsetlen(*indices, glyph_count_old + estimated_glyph_count_add);
+        glyph_props = push_array(scratch.arena, DWRITE_SHAPING_GLYPH_PROPERTIES, estimated_glyph_count_add);
+
+        hr = text_analyzer->GetGlyphs(text,
+                                      text_length,
+                                      font_face,
+                                      FALSE,                       // isSideways
+                                      0,                           // isRightToLeft,
+                                      &analysis,
+                                      locale,
+                                      NULL,                        // numberSubstitution,
+                                      NULL,                        // features
+                                      NULL,                        // featureRangeLengths
+                                      0,                           // featureRanges
+                                      estimated_glyph_count_add,
+
+                                      /* Out */
+                                      cluster_map,
+                                      text_props,
+                                      *indices + glyph_count_old,
+                                      glyph_props,
+                                      &glyph_count_add);
+
+        if (hr == HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER))
+        {
+            estimated_glyph_count_add *= 2;
+            retry_count++;
+        }
+        else if (FAILED(hr))
+        {
+            assume(! "x");
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    U32 glyph_count_new = glyph_count_old + glyph_count_add;
+    arrsetlen(*indices,  glyph_count_new);
+    arrsetlen(*advances, glyph_count_new);
+
+    // @Note: text_positions spans every run of the paragraph, so it has its own length.
+    U32 position_count_old = (U32)arrlenu(*text_positions);
+    arrsetlen(*text_positions, position_count_old + glyph_count_add);
+    layout_text_positions_from_cluster_map(cluster_map, text_length, text_position,
+                                           *text_positions + position_count_old, glyph_count_add);
+
+    // @Note: A Font_Run has no offsets, but GetGlyphPlacements() won't take NULL.
+    DWRITE_GLYPH_OFFSET *offsets = push_array(scratch.arena, DWRITE_GLYPH_OFFSET, glyph_count_add);
+
     {
-        Dwrite_Font_Fallback_Result ff = dwrite_font_fallback(font_fallback, font_collection, base_family, locale,
-                                                              text + offset, text_length - offset);
-        U32 run_length = ff.length;
-        IDWriteFontFace5 *run_font_face = ff.font_face;
-        assert(run_font_face);
+        profile_scope(PROFILE_STAGE_PLACEMENTS);
+        hr = text_analyzer->GetGlyphPlacements(text,
+                                               cluster_map,
+                                               text_props,
+                                               text_length,
+                                               *indices + glyph_count_old,
+                                               glyph_props,
+                                               glyph_count_add,
+                                               font_face,
+                                               px_per_em,
+                                               FALSE, // isSideways
+                                               0,     // isRightToLeft
+                                               &analysis,
+                                               locale,
+                                               NULL,  // features
+                                               NULL,  // featureRangeLengths
+                                               0,     // featureRanges
+
+                                               /* out */
+                                               *advances + glyph_count_old, // @Todo: Unit consistency.
+                                               offsets);
+        assume(SUCCEEDED(hr));
+    }
+
+    scratch_end(scratch);
 
+    return glyph_count_add;
+}
+
+// @Note: Same as dwrite_shape_text(), but goes through the word cache. The
+// caller must have checked that the face's space glyph is context-free.
+function U32
+dwrite_shape_words(Word_Cache *word_cache,
+                   IDWriteTextAnalyzer1 *text_analyzer,
+                   IDWriteFontFace5 *font_face,
+                   DWRITE_SCRIPT_ANALYSIS analysis,
+                   WCHAR *locale, FLOAT px_per_em,
+                   WCHAR *text, U32 text_length, U32 text_position,
+                   U16 **indices, FLOAT **advances, U32 **text_positions)
+{
+    U32 glyph_count_old = (U32)arrlenu(*indices);
+
+    U32 at = 0;
+    while (at < text_length)
+    {
+        WCHAR *word = text + at;
+        U32 word_length = word_cache_next_word_length((U16 *)word, text_length - at);
+
+        if (word_length > WORD_CACHE_MAX_WORD_LENGTH)
+        {
+            word_cache->stats.uncacheable_count += 1;
+            dwrite_shape_text(text_analyzer, font_face, analysis, locale, px_per_em, word, word_length, text_position + at,
+                              indices, advances, text_positions);
+        }
+        else
+        {
+            Word_Cache_Key key = {};
+            {
+                key.face        = u64_from_ptr(font_face);
+                key.features    = 0;
+                key.script      = analysis.script | ((U32)analysis.shapes << 16);
+                key.em_size     = px_per_em;
+                key.text        = (U16 *)word;
+                key.text_length = word_length;
+            }
+            U64 hash = word_cache_hash(key);
+
+            Word_Cache_Entry *entry = word_cache_lookup(word_cache, key, hash);
+            if (entry)
+            {
+                U32 glyph_count = (U32)arrlenu(*indices);
+                arrsetlen(*indices,  glyph_count + entry->glyph_count);
+                arrsetlen(*advances, glyph_count + entry->glyph_count);
+                memory_copy(*indices + glyph_count,  entry->glyph_indices,  entry->glyph_count*sizeof(U16));
+                memory_copy(*advances + glyph_count, entry->glyph_advances, entry->glyph_count*sizeof(FLOAT));
+                for (U32 gi = 0; gi < entry->glyph_count; ++gi)
+                { arrput(*text_positions, text_position + at + entry->glyph_clusters[gi]); }
+            }
+            else
+            {
+                U32 glyph_count = (U32)arrlenu(*indices);
+                U32 position_count = (U32)arrlenu(*text_positions);
+
+                U64 begin = os_read_timer();
+                U32 glyph_count_add = dwrite_shape_text(text_analyzer, font_face, analysis, locale, px_per_em,
+                                                        word, word_length, text_position + at,
+                                                        indices, advances, text_positions);
+                U64 end = os_read_timer();
+
+                Word_Cache_Entry *inserted = word_cache_insert(word_cache, key, hash,
+                                                               *indices + glyph_count, *advances + glyph_count, glyph_count_add,
+                                                               end - begin);
+                for (U32 gi = 0; gi < glyph_count_add; ++gi)
+                { inserted->glyph_clusters[gi] = (U16)((*text_positions)[position_count + gi] - (text_position + at)); }
+            }
+        }
+
+        at += word_length;
+    }
+
+    U32 result = (U32)arrlenu(*indices) - glyph_count_old;
+    return result;
+}
+
+// @Note: Font_Resolve_Proc. Faces go into the font table the first time
+// they're seen, and are never released, so the pointer is the face's identity.
+function U32
+dwrite_font_resolve(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face)
+{
+    Dwrite_State *dwrite = (Dwrite_State *)user_data;
+
+    Dwrite_Font_Fallback_Result ff = dwrite_font_fallback(dwrite->font_fallback1, dwrite->font_collection, family, dwrite->locale,
+                                                          (WCHAR *)text, text_length);
+    IDWriteFontFace5 *font_face = ff.font_face;
+    assert(font_face);
+
+    if (! dwrite_get_entry_from_font_table(dwrite, font_face))
+    {
         DWRITE_FONT_METRICS dfm = {};
-        run_font_face->GetMetrics(&dfm);
-        F32 du_per_em = dfm.designUnitsPerEm;
-        F32 em_per_du = 1.0f / (F32)du_per_em;
-        F32 px_per_pt = px_per_inch / 72.0f;
-        F32 px_per_em = pt_per_em * px_per_pt;
-        F32 px_per_du = px_per_em * em_per_du;
-
-        F32 advance_height_px = (F32)(dfm.ascent + dfm.descent + dfm.lineGap) * px_per_du;
-        max_advance_height_px = max(max_advance_height_px, advance_height_px);
-
-        // --------------------------------------------------------------------
-        // @Important: Must not free a font face for this to work.
-        // @Note:      Update font table.
+        font_face->GetMetrics(&dfm);
+
         Dwrite_Font_Metrics metrics = {};
         {
-            metrics.du_per_em = du_per_em;
-            metrics.advance_height_px = advance_height_px;
+            metrics.du_per_em = (F32)dfm.designUnitsPerEm;
+            metrics.advance_height_du = (F32)(dfm.ascent + dfm.descent + dfm.lineGap);
         }
-        dwrite_insert_font_to_table(run_font_face, metrics);
+        dwrite_insert_font_to_table(dwrite, font_face, metrics);
+    }
 
-        U16 *indices                 = NULL;
-        FLOAT *advances              = NULL;
-        DWRITE_GLYPH_OFFSET *offsets = NULL;
+    *out_face = u64_from_ptr(font_face);
+    return ff.length;
+}
 
-        // Segment the run once again with identical complexity.
-        WCHAR *remain_text = text + offset;
-        U32 remain_length = run_length;
-        while (remain_length)
-        {
-            Dwrite_Map_Complexity_Result complexity = dwrite_map_complexity(text_analyzer, run_font_face, remain_text, remain_length);
+// @Note: Font_Shape_Proc. The text is segmented once again by complexity:
+// the simple text table first, then GetTextComplexity(), and full shaping
+// per script for what's left.
+function void
+dwrite_font_shape(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions)
+{
+    HRESULT hr = S_OK;
+
+    Dwrite_State *dwrite = (Dwrite_State *)user_data;
+
+    IDWriteTextAnalyzer1 *text_analyzer = dwrite->text_analyzer1;
+    WCHAR *locale = dwrite->locale;
+
+    IDWriteFontFace5 *run_font_face = (IDWriteFontFace5 *)run->face;
+    Dwrite_Font_Table_Entry *font_entry = dwrite_get_entry_from_font_table(dwrite, run_font_face);
+    assert(font_entry);
+    Simple_Text_Table *simple_text = font_entry->simple_text;
+
+    F32 px_per_em = run->em_size_px;
+    F32 em_per_du = 1.0f / font_entry->metrics.du_per_em;
+    F32 px_per_du = px_per_em * em_per_du;
 
+    U16 **indices = &run->glyph_indices;
+    FLOAT **advances = &run->glyph_advances;
 
-            if (complexity.is_simple)
+    WCHAR *remain_text = (WCHAR *)text;
+    U32 remain_length = text_length;
+    while (remain_length)
+    {
+        U32 remain_position = text_position + (U32)(remain_text - (WCHAR *)text);
+
+        // @Note: Table-driven fast path. Doesn't touch the analyzer at all.
+        if (simple_text->is_eligible)
+        {
+            U32 simple_length = simple_text_scan((U16 *)remain_text, remain_length);
+            if (simple_length)
             {
-                U32 glyph_count_add = complexity.mapped_length;
-                U32 glyph_count_old = (U32)arrlenu(indices);
-                U32 glyph_count_new = glyph_count_old + glyph_count_add;
+                U32 glyph_count_old = (U32)arrlenu(*indices);
+                U32 glyph_count_new = glyph_count_old + simple_length;
+
+                arrsetlen(*indices,  glyph_count_new);
+                arrsetlen(*advances, glyph_count_new);
 
-                arrsetlen(indices,  glyph_count_new);
-                arrsetlen(advances, glyph_count_new);
-                arrsetlen(offsets,  glyph_count_new);
+                U32 mapped_length = simple_text_map(simple_text, (U16 *)remain_text, simple_length, px_per_du,
+                                                    *indices + glyph_count_old, *advances + glyph_count_old);
+                for (U32 i = 0; i < mapped_length; ++i)
+                { arrput(*glyph_text_positions, remain_position + i); }
 
-                S32 *advances_du = NULL;
-                arrsetlen(advances_du, glyph_count_add);
-                run_font_face->GetDesignGlyphAdvances(glyph_count_add, complexity.glyph_indices, advances_du, FALSE /*RetrieveVerticalAdvance*/);
+                arrsetlen(*indices,  glyph_count_old + mapped_length);
+                arrsetlen(*advances, glyph_count_old + mapped_length);
 
-                for (U32 i = 0; i < glyph_count_add; ++i)
+                if (mapped_length)
                 {
-                    U32 idx = glyph_count_old + i;
-                    indices[idx]  = complexity.glyph_indices[i];
-                    advances[idx] = advances_du[i] * px_per_em * em_per_du; // @Todo: Unit?
-                    offsets[idx]  = {};
+                    remain_text   += mapped_length;
+                    remain_length -= mapped_length;
+                    continue;
                 }
             }
-            else // complex
+        }
+
+        Dwrite_Map_Complexity_Result complexity = dwrite_map_complexity(text_analyzer, run_font_face, remain_text, remain_length);
+
+        if (complexity.is_simple)
+        {
+            U32 glyph_count_add = complexity.mapped_length;
+            U32 glyph_count_old = (U32)arrlenu(*indices);
+            U32 glyph_count_new = glyph_count_old + glyph_count_add;
+
+            arrsetlen(*indices,  glyph_count_new);
+            arrsetlen(*advances, glyph_count_new);
+
+            S32 *advances_du = NULL;
+            arrsetlen(advances_du, glyph_count_add);
+            run_font_face->GetDesignGlyphAdvances(glyph_count_add, complexity.glyph_indices, advances_du, FALSE /*RetrieveVerticalAdvance*/);
+
+            for (U32 i = 0; i < glyph_count_add; ++i)
+            {
+                U32 idx = glyph_count_old + i;
+                (*indices)[idx]  = complexity.glyph_indices[i];
+                (*advances)[idx] = advances_du[i] * px_per_em * em_per_du; // @Todo: Unit?
+                arrput(*glyph_text_positions, remain_position + i);
+            }
+
+            arrfree(advances_du);
+        }
+        else // complex
+        {
+            U32 complex_length = complexity.mapped_length;
+
+            Dwrite_Text_Analysis_Source analysis_source = {locale, remain_text, complex_length};
+            Dwrite_Text_Analysis_Sink analysis_sink = {};
+
+            // Split the text into runs of the same script ("language"), bidi, etc.
             {
-                U32 text_length = complexity.mapped_length;
-
-                Dwrite_Text_Analysis_Source analysis_source = {locale, remain_text, text_length};
-                Dwrite_Text_Analysis_Sink analysis_sink = {};
-                U16 *cluster_map = NULL;
-                DWRITE_SHAPING_TEXT_PROPERTIES *text_props = NULL;
-                DWRITE_SHAPING_GLYPH_PROPERTIES *glyph_props = NULL;
-
-                U32 current_glyph_count = (U32)arrlenu(indices);
-                U32 estimated_glyph_count_final = current_glyph_count + (3 * text_length) / 2 + 16;
-                arrsetlen(indices, estimated_glyph_count_final);
-                arrsetlen(advances, estimated_glyph_count_final);
-                arrsetlen(offsets, estimated_glyph_count_final);
-
-                // Split the text into runs of the same script ("language"), bidi, etc.
-                hr = text_analyzer->AnalyzeScript(&analysis_source, 0/*textPosition*/, text_length, &analysis_sink);
+                profile_scope(PROFILE_STAGE_SCRIPT_ANALYSIS);
+                hr = text_analyzer->AnalyzeScript(&analysis_source, 0/*textPosition*/, complex_length, &analysis_sink);
                 assume(SUCCEEDED(hr));
+            }
+
+            // Shaping word by word is only exact if spaces never take part in a lookup.
+            B32 use_word_cache = (dwrite->use_word_cache && !simple_text->space_is_contextual);
 
-                for (U32 i = 0; i < arrlenu(analysis_sink.results); ++i)
+            for (U32 i = 0; i < arrlenu(analysis_sink.results); ++i)
+            {
+                Dwrite_Text_Analysis_Sink_Result analysis_sink_result = analysis_sink.results[i];
+                WCHAR *script_text = remain_text + analysis_sink_result.text_position;
+                U32 script_text_position = remain_position + analysis_sink_result.text_position;
+
+                if (use_word_cache)
+                {
+                    dwrite_shape_words(&dwrite->word_cache, text_analyzer, run_font_face, analysis_sink_result.analysis, locale, px_per_em,
+                                       script_text, analysis_sink_result.text_length, script_text_position,
+                                       indices, advances, glyph_text_positions);
+                }
+                else
                 {
-                    Dwrite_Text_Analysis_Sink_Result analysis_sink_result = analysis_sink.results[i];
+                    dwrite_shape_text(text_analyzer, run_font_face, analysis_sink_result.analysis, locale, px_per_em,
+                                      script_text, analysis_sink_result.text_length, script_text_position,
+                                      indices, advances, glyph_text_positions);
+                }
+            }
 
-                    U32 estimated_glyph_count_add = (3 * analysis_sink_result.text_length / 2 + 16);
-                    U32 estimated_glyph_count_next = current_glyph_count + estimated_glyph_count_add;
+            arrfree(analysis_sink.results);
+        }
 
-                    if (arrlenu(cluster_map) < analysis_sink_result.text_length)
-                    {
-                        arrsetlen(cluster_map, analysis_sink_result.text_length);
-                        arrsetlen(text_props, analysis_sink_result.text_length);
-                    }
+        arrfree(complexity.glyph_indices);
 
-                    if (arrlenu(indices) < estimated_glyph_count_next)
-                    { arrsetlen(indices, estimated_glyph_count_next); }
+        remain_text += complexity.mapped_length;
+        remain_length -= complexity.mapped_length;
+    }
+}
 
-                    if (arrlenu(glyph_props) < estimated_glyph_count_next)
-                    { arrsetlen(glyph_props, estimated_glyph_count_next); }
+// @Note: Rendering mode of a font face at a size. Depends on nothing else,
+// so it's asked for once per rasterized glyph, not once per glyph drawn.
+function Dwrite_Raster_Modes
+dwrite_get_raster_modes(IDWriteFontFace *font_face, FLOAT em_size_px, FLOAT px_per_inch, IDWriteRenderingParams *rendering_params)
+{
+    Dwrite_Raster_Modes result = {};
+    result.rendering_mode = DWRITE_RENDERING_MODE1_NATURAL;
+    result.measuring_mode = DWRITE_MEASURING_MODE_NATURAL;
+    result.grid_fit_mode  = DWRITE_GRID_FIT_MODE_DEFAULT;
+
+    IDWriteFontFace5 *font_face5 = (IDWriteFontFace5 *)font_face;
+    HRESULT hr = font_face5->GetRecommendedRenderingMode(em_size_px,
+                                                         px_per_inch, px_per_inch,
+                                                         NULL, // transform
+                                                         FALSE, // isSideways
+                                                         DWRITE_OUTLINE_THRESHOLD_ANTIALIASED,
+                                                         result.measuring_mode,
+                                                         rendering_params,
+                                                         &result.rendering_mode,
+                                                         &result.grid_fit_mode);
+    assume(SUCCEEDED(hr));
 
-                    U32 actual_glyph_count_add = 0; 
+    return result;
+}
 
-                    U32 retry_count = 0;
-                    while (retry_count < 8)
-                    {
-                        hr = text_analyzer->GetGlyphs(remain_text + analysis_sink_result.text_position,
-                                                      analysis_sink_result.text_length,
-                                                      run_font_face,
-                                                      FALSE,                       // isSideways
-                                                      0,                           // isRightToLeft,
-                                                      &analysis_sink_result.analysis,
-                                                      locale,
-                                                      NULL,                        // numberSubstitution,
-                                                      NULL,                        // features
-                                                      NULL,                        // featureRangeLengths
-                                                      0,                           // featureRanges
-                                                      (U32)arrlenu(indices),
-
-                                                      /* Out */
-                                                      cluster_map,
-                                                      text_props,
-                                                      indices + current_glyph_count,
-                                                      glyph_props,
-                                                      &actual_glyph_count_add);
-
-                        if (hr == HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER))
-                        {
-                            estimated_glyph_count_add *= 2;
-                            estimated_glyph_count_next = current_glyph_count + estimated_glyph_count_add;
-                            arrsetlen(indices, estimated_glyph_count_next);
-                            arrsetlen(glyph_props, estimated_glyph_count_add);
-                            retry_count++;
-                        }
-                        else if (FAILED(hr))
-                        {
-                            assume(! "x");
-                        }
-                        else
-                        {
-                            break;
-                        }
-                    }
+// @Note: Runs the line breaking analysis and flattens DWrite's before/after
+// conditions into one LAYOUT_BREAK_* flag set per code unit.
+function U8 *
+dwrite_analyze_line_breaks(IDWriteTextAnalyzer1 *text_analyzer, WCHAR *locale, WCHAR *text, U32 text_length)
+{
+    U8 *result = NULL;
 
-                    U32 actual_glyph_count_next = current_glyph_count + actual_glyph_count_add;
-                    if (arrlenu(advances) < actual_glyph_count_next)
-                    {
-                        U64 size = (arrlenu(advances) << 1);
-                        size = max(size, actual_glyph_count_add);
-                        arrsetlen(advances, size);
-                    }
+    Dwrite_Text_Analysis_Source analysis_source = {locale, text, text_length};
+    Dwrite_Text_Analysis_Sink analysis_sink = {};
 
-                    hr = text_analyzer->GetGlyphPlacements(remain_text + analysis_sink_result.text_position,
-                                                           cluster_map,
-                                                           text_props,
-                                                           analysis_sink_result.text_length,
-                                                           indices + current_glyph_count,
-                                                           glyph_props,
-                                                           actual_glyph_count_add,
-                                                           run_font_face,
-                                                           px_per_em,
-                                                           FALSE, // isSideways
-                                                           0,     // isRightToLeft
-                                                           &analysis_sink_result.analysis,
-                                                           locale,
-                                                           NULL,  // features
-                                                           NULL,  // featureRangeLengths
-                                                           0,     // featureRanges
-
-                                                           /* out */
-                                                           advances + current_glyph_count, // @Todo: Unit consistency.
-                                                           offsets + current_glyph_count);
-
-                    assume(SUCCEEDED(hr));
-
-                    current_glyph_count = actual_glyph_count_next;
-                }
+    HRESULT hr = text_analyzer->AnalyzeLineBreakpoints(&analysis_source, 0/*textPosition*/, text_length, &analysis_sink);
+    assume(SUCCEEDED(hr));
+    assume(arrlenu(analysis_sink.breakpoints) >= text_length);
 
-                arrsetlen(indices, current_glyph_count);
-                arrsetlen(advances, current_glyph_count);
-                arrsetlen(offsets, current_glyph_count);
-            }
+    arrsetlen(result, text_length);
+    for (U32 i = 0; i < text_length; ++i)
+    {
+        DWRITE_LINE_BREAKPOINT breakpoint = analysis_sink.breakpoints[i];
+        U8 flags = 0;
 
-            remain_text += complexity.mapped_length;
-            remain_length -= complexity.mapped_length;
+        if (i > 0)
+        {
+            U8 after  = analysis_sink.breakpoints[i - 1].breakConditionAfter;
+            U8 before = breakpoint.breakConditionBefore;
+
+            if (after == DWRITE_BREAK_CONDITION_MUST_BREAK || before == DWRITE_BREAK_CONDITION_MUST_BREAK)
+            {
+                flags |= LAYOUT_BREAK_MUST;
+            }
+            else if ((after == DWRITE_BREAK_CONDITION_CAN_BREAK || before == DWRITE_BREAK_CONDITION_CAN_BREAK) &&
+                     (after != DWRITE_BREAK_CONDITION_MAY_NOT_BREAK && before != DWRITE_BREAK_CONDITION_MAY_NOT_BREAK))
+            {
+                flags |= LAYOUT_BREAK_CAN;
+            }
         }
 
-        DWRITE_GLYPH_RUN run = {};
-        run.fontFace      = run_font_face;
-        run.fontEmSize    = px_per_em;
-        run.glyphCount    = (U32)arrlenu(indices);
-        run.glyphIndices  = indices;
-        run.glyphAdvances = advances;
-        run.glyphOffsets  = offsets;
-        arrput(result, run);
+        if (breakpoint.isWhitespace)
+        { flags |= LAYOUT_BREAK_WHITESPACE; }
+
+        result[i] = flags;
+    }
+
+    arrfree(analysis_sink.breakpoints);
+
+    return result;
+}
+
+function Font_Metrics
+dwrite_font_get_metrics(void *user_data, U64 face, F32 em_size_px)
+{
+    Dwrite_State *dwrite = (Dwrite_State *)user_data;
+    Dwrite_Font_Table_Entry *font_entry = dwrite_get_entry_from_font_table(dwrite, (IDWriteFontFace *)face);
+    assert(font_entry);
+
+    Font_Metrics result = {};
+    result.du_per_em         = font_entry->metrics.du_per_em;
+    result.advance_height_px = font_entry->metrics.advance_height_du * em_size_px / font_entry->metrics.du_per_em;
+    return result;
+}
+
+function U8 *
+dwrite_font_analyze_breaks(void *user_data, U16 *text, U32 text_length)
+{
+    Dwrite_State *dwrite = (Dwrite_State *)user_data;
+    U8 *result = dwrite_analyze_line_breaks(dwrite->text_analyzer1, dwrite->locale, (WCHAR *)text, text_length);
+    return result;
+}
+
+// @Note: Font_Rasterize_Proc. Grayscale coverage is spread over the three
+// channels, so the atlas always gets ClearType-shaped bitmaps.
+function void
+dwrite_font_rasterize(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out)
+{
+    HRESULT hr = S_OK;
+
+    Dwrite_State *dwrite = (Dwrite_State *)user_data;
+    *out = {};
+
+    IDWriteFontFace5 *font_face = (IDWriteFontFace5 *)face;
+    B32 is_cleartype = dwrite->is_cleartype;
+    DWRITE_TEXTURE_TYPE texture_type = (is_cleartype) ? DWRITE_TEXTURE_CLEARTYPE_3x1 : DWRITE_TEXTURE_ALIASED_1x1;
 
-        offset += run_length;
+    Dwrite_Raster_Modes modes = dwrite_get_raster_modes(font_face, em_size_px, dwrite->px_per_inch, dwrite->rendering_params);
+    DWRITE_RENDERING_MODE1 rendering_mode = modes.rendering_mode;
+    DWRITE_MEASURING_MODE measuring_mode  = modes.measuring_mode;
+    DWRITE_GRID_FIT_MODE grid_fit_mode    = modes.grid_fit_mode;
+
+    // CreateGlyphRunAnalysis() doesn't support DWRITE_RENDERING_MODE_OUTLINE.
+    // We won't bother big glyphs. (many hundreds of pt)
+    if (rendering_mode == DWRITE_RENDERING_MODE1_OUTLINE)
+    {
+        rendering_mode = DWRITE_RENDERING_MODE1_NATURAL_SYMMETRIC; 
+    }
+
+    DWRITE_GLYPH_RUN single_glyph_run = {};
+    {
+        single_glyph_run.fontFace      = font_face;
+        single_glyph_run.fontEmSize    = em_size_px;
+        single_glyph_run.glyphCount    = 1;
+        single_glyph_run.glyphIndices  = &glyph_index;
+        single_glyph_run.glyphAdvances = NULL;
+        single_glyph_run.glyphOffsets  = NULL;
+        single_glyph_run.isSideways    = FALSE;
+        single_glyph_run.bidiLevel     = 0;
+    }
+
+    IDWriteGlyphRunAnalysis *analysis = NULL;
+    hr = dwrite->factory->CreateGlyphRunAnalysis(&single_glyph_run,
+                                                NULL, // transform
+                                                rendering_mode,
+                                                measuring_mode,
+                                                grid_fit_mode,
+                                                is_cleartype ? DWRITE_TEXT_ANTIALIAS_MODE_CLEARTYPE : DWRITE_TEXT_ANTIALIAS_MODE_GRAYSCALE,
+                                                0.0f, // baselineOriginX
+                                                0.0f, // baselineOriginY
+                                                &analysis);
+    assume(SUCCEEDED(hr));
+
+    // @Note: GetAlphaTextureBounds() -> RECT exaplanation.
+    //
+    // bounds.top ------++-----######--+
+    //   (-7)           ||  ############
+    //                  ||####      ####
+    //                  |###       #####
+    //  baseline ______ |###      #####|
+    //   origin        \|############# |
+    //  (= 0,0)         \|###########  |
+    //                  ++-------###---+
+    //                  ##      ###    |
+    // bounds.bottom ---+#########-----+
+    //    (+2)          |              |
+    //             bounds.left     bounds.right
+    //                 (-1)           (+14)
+    //
+
+    RECT bounds = {};
+    hr = analysis->GetAlphaTextureBounds(texture_type, &bounds);
+    if (FAILED(hr))
+    {
+        // @Todo: The font doesn't support DWRITE_TEXTURE_CLEARTYPE_3x1.
+        // Retry with DWRITE_TEXTURE_ALIASED_1x1.
+        assume(! "x");
     }
 
+    if ((bounds.right > bounds.left) && (bounds.bottom > bounds.top))
+    {
+        out->left   = bounds.left;
+        out->top    = bounds.top;
+        out->width  = bounds.right - bounds.left;
+        out->height = bounds.bottom - bounds.top;
+        out->rgb    = push_array(arena, U8, out->width*out->height*3);
+
+        if (is_cleartype)
+        {
+            hr = analysis->CreateAlphaTexture(texture_type, &bounds, out->rgb, out->width*out->height*3);
+            assume(SUCCEEDED(hr));
+        }
+        else
+        {
+            // Alpha in the first third, spread backwards so no byte is read after it's written.
+            U32 pixel_count = out->width*out->height;
+            hr = analysis->CreateAlphaTexture(texture_type, &bounds, out->rgb, pixel_count);
+            assume(SUCCEEDED(hr));
+            for (U32 i = pixel_count; i > 0; --i)
+            {
+                U8 alpha = out->rgb[i - 1];
+                out->rgb[(i - 1)*3 + 0] = alpha;
+                out->rgb[(i - 1)*3 + 1] = alpha;
+                out->rgb[(i - 1)*3 + 2] = alpha;
+            }
+        }
+    }
+
+    analysis->Release();
+}
+
+// @Note: The backend over a DWrite state, after dwrite_init(). Whoever
+// owns the backend releases the state through it.
+function Font_Backend
+dwrite_font_backend(Dwrite_State *dwrite, F32 px_per_inch, B32 is_cleartype)
+{
+    dwrite->px_per_inch  = px_per_inch;
+    dwrite->is_cleartype = is_cleartype;
+
+    Font_Backend result = {};
+    result.user_data                  = dwrite;
+    result.px_per_inch                = px_per_inch;
+    result.can_shape_concurrently     = false;  // the word cache.
+    result.can_rasterize_concurrently = true;   // the factory is shared, which is thread-safe.
+    result.resolve                    = dwrite_font_resolve;
+    result.shape                      = dwrite_font_shape;
+    result.get_metrics                = dwrite_font_get_metrics;
+    result.analyze_breaks             = dwrite_font_analyze_breaks;
+    result.rasterize                  = dwrite_font_rasterize;
+    result.release                    = dwrite_font_release;
+    result.get_stats                  = dwrite_font_get_stats;
     return result;
 }
 
+function void
+dwrite_font_release(void *user_data)
+{
+    dwrite_release((Dwrite_State *)user_data);
+}
+
+function void
+dwrite_font_get_stats(void *user_data, Font_Backend_Stats *out)
+{
+    Dwrite_State *dwrite = (Dwrite_State *)user_data;
+    Dwrite_Font_Table *table = &dwrite->font_table;
+
+    *out = {};
+
+    job_mutex_lock(&table->write_mutex);
+    out->face_capacity = table->entry_count;
+    for (U32 ei = 0; ei < table->entry_count; ++ei)
+    {
+        Dwrite_Font_Table_Entry *entry = table->entries + ei;
+        if (entry->occupied)
+        {
+            U32 home_position = (U32)(dwrite_hash_font(entry->key) % table->entry_count);
+            U32 probe_length = (ei + table->entry_count - home_position) % table->entry_count + 1;
+            out->face_count += 1;
+            out->max_face_probe_length = max(out->max_face_probe_length, probe_length);
+        }
+    }
+    job_mutex_unlock(&table->write_mutex);
+
+    out->arena_bytes      = arena_pos(dwrite->arena);
+    out->word_cache       = dwrite->word_cache.stats;
+    out->word_count       = dwrite->word_cache.occupied_count;
+    out->word_capacity    = dwrite->word_cache.entry_count;
+    out->word_arena_bytes = arena_pos(dwrite->word_cache.arena);
+}
+
 function void
 dwrite_abort(wchar_t *message)
 {
@@ -439,47 +822,80 @@ dwrite_abort(wchar_t *message)
     os_abort();
 }
 
+// @Note: Everything below the factory is the state's own: its font table,
+// word cache and analyzers. The factory is DWrite's shared one.
 function void
-dwrite_init(void)
+dwrite_init(Dwrite_State *dwrite)
 {
-    dwrite.arena = arena_alloc();
-    dwrite.font_table.entry_count = 32;
-    dwrite.font_table.entries = push_array(dwrite.arena, Dwrite_Font_Table_Entry, dwrite.font_table.entry_count);
+    *dwrite = {};
+    dwrite->arena = arena_alloc();
+    job_mutex_init(&dwrite->font_table.write_mutex);
+    dwrite->font_table.entry_count = 32;
+    dwrite->font_table.entries = push_array(dwrite->arena, Dwrite_Font_Table_Entry, dwrite->font_table.entry_count);
+
+    dwrite->use_word_cache = false;
+    word_cache_init(&dwrite->word_cache, 8192);
 
-    if (FAILED(DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED, __uuidof(dwrite.factory), (IUnknown **)&dwrite.factory)))
+    if (FAILED(DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED, __uuidof(dwrite->factory), (IUnknown **)&dwrite->factory)))
     { dwrite_abort(L"DWriteCreateFactory() Error."); }
 
-    if (FAILED(dwrite.factory->GetSystemFontCollection(&dwrite.font_collection)))
+    if (FAILED(dwrite->factory->GetSystemFontCollection(&dwrite->font_collection)))
     { dwrite_abort(L"GetSystemFontCollection() Error."); }
 
-    if (FAILED(dwrite.factory->GetSystemFontFallback(&dwrite.font_fallback)))
+    if (FAILED(dwrite->factory->GetSystemFontFallback(&dwrite->font_fallback)))
     { dwrite_abort(L"GetSystemFontFallback() Error."); }
 
-    if (FAILED(dwrite.font_fallback->QueryInterface(__uuidof(dwrite.font_fallback1), (void **)&dwrite.font_fallback1)))
+    if (FAILED(dwrite->font_fallback->QueryInterface(__uuidof(dwrite->font_fallback1), (void **)&dwrite->font_fallback1)))
     { dwrite_abort(L"Error while querying IDWriteFontFallback1 interface."); }
 
-    if (FAILED(dwrite.factory->CreateTextAnalyzer(&dwrite.text_analyzer)))
+    if (FAILED(dwrite->factory->CreateTextAnalyzer(&dwrite->text_analyzer)))
     { dwrite_abort(L"CreateTextAnalyzer() Error."); }
 
-    if (FAILED(dwrite.text_analyzer->QueryInterface(__uuidof(dwrite.text_analyzer1), (void **)&dwrite.text_analyzer1)))
+    if (FAILED(dwrite->text_analyzer->QueryInterface(__uuidof(dwrite->text_analyzer1), (void **)&dwrite->text_analyzer1)))
     { dwrite_abort(L"Error while querying IDWriteTextAnalyzer1 interface."); }
 
 
     // Set locale.
     wchar_t *default_locale = L"en-US";
-    if (! GetUserDefaultLocaleName(dwrite.locale, array_count(dwrite.locale)))
-    { memory_copy(dwrite.locale, default_locale, sizeof(default_locale)); }
+    if (! GetUserDefaultLocaleName(dwrite->locale, array_count(dwrite->locale)))
+    { memory_copy(dwrite->locale, default_locale, sizeof(default_locale)); }
 
     // Create rendering paramters.
-    if (FAILED(dwrite.factory->CreateRenderingParams(&dwrite.rendering_params)))
+    if (FAILED(dwrite->factory->CreateRenderingParams(&dwrite->rendering_params)))
     { dwrite_abort(L"IDWriteFactroy::CreateRenderingParams() Error."); }
 }
 
+// @Note: The faces in the font table hold the reference fallback gave out
+// when they were first seen.
+function void
+dwrite_release(Dwrite_State *dwrite)
+{
+    for (U32 ei = 0; ei < dwrite->font_table.entry_count; ++ei)
+    {
+        Dwrite_Font_Table_Entry *entry = dwrite->font_table.entries + ei;
+        if (entry->occupied)
+        { entry->key->Release(); }
+    }
+
+    dwrite->rendering_params->Release();
+    dwrite->text_analyzer1->Release();
+    dwrite->text_analyzer->Release();
+    dwrite->font_fallback1->Release();
+    dwrite->font_fallback->Release();
+    dwrite->font_collection->Release();
+    dwrite->factory->Release();
+
+    word_cache_release(&dwrite->word_cache);
+    job_mutex_release(&dwrite->font_table.write_mutex);
+    arena_release(dwrite->arena);
+    *dwrite = {};
+}
+
 function Dwrite_Get_Base_Font_Family_Index_Result
-dwrite_get_base_font_family_index(wchar_t *base_font_family_name)
+dwrite_get_base_font_family_index(Dwrite_State *dwrite, wchar_t *base_font_family_name)
 {
     Dwrite_Get_Base_Font_Family_Index_Result result = {};
-    if (FAILED(dwrite.font_collection->FindFamilyName(base_font_family_name, &result.index, &result.exists))) 
+    if (FAILED(dwrite->font_collection->FindFamilyName(base_font_family_name, &result.index, &result.exists))) 
     { dwrite_abort(L"IDWriteFontCollection::FindFamilyName() Error."); }
     return result;
 }
@@ -86,6 +86,7 @@ typedef struct Dwrite_Text_Analysis_Sink Dwrite_Text_Analysis_Sink;
 struct Dwrite_Text_Analysis_Sink final : IDWriteTextAnalysisSink 
 {
     Dwrite_Text_Analysis_Sink_Result *results;
+    DWRITE_LINE_BREAKPOINT *breakpoints;
 
     ULONG STDMETHODCALLTYPE AddRef() noexcept override
     { return 1; } 
@@ -120,7 +121,14 @@ struct Dwrite_Text_Analysis_Sink final : IDWriteTextAnalysisSink
     }
 
     HRESULT STDMETHODCALLTYPE SetLineBreakpoints(UINT32 textPosition, UINT32 textLength, const DWRITE_LINE_BREAKPOINT* lineBreakpoints) noexcept override
-    { return E_NOTIMPL; }
+    {
+        if (arrlenu(breakpoints) < textPosition + textLength)
+        { arrsetlen(breakpoints, textPosition + textLength); }
+
+        memory_copy(breakpoints + textPosition, lineBreakpoints, textLength*sizeof(lineBreakpoints[0]));
+
+        return S_OK;
+    }
 
     HRESULT STDMETHODCALLTYPE SetBidiLevel(UINT32 textPosition, UINT32 textLength, UINT8 explicitLevel, UINT8 resolvedLevel) noexcept override
     { return E_NOTIMPL; }
@@ -145,23 +153,20 @@ struct Dwrite_Map_Complexity_Result
     BOOL is_simple;
 };
 
-typedef struct Glyph_Cel Glyph_Cel;
-struct Glyph_Cel
-{
-    B32 is_empty;
-    V2  uv_min;
-    V2  uv_max;
-    F32 width_px;
-    F32 height_px;
-    V2  offset_px; // offset of a pen from baseline origin of a glyph in px.
-};
-typedef Dynamic_Array(Glyph_Cel) Glyph_Cel_Array;
-
+// Design metrics, the same at every size.
 typedef struct Dwrite_Font_Metrics Dwrite_Font_Metrics;
 struct Dwrite_Font_Metrics
 {
     F32 du_per_em;
-    F32 advance_height_px;
+    F32 advance_height_du;
+};
+
+typedef struct Dwrite_Raster_Modes Dwrite_Raster_Modes;
+struct Dwrite_Raster_Modes
+{
+    DWRITE_RENDERING_MODE1 rendering_mode;
+    DWRITE_MEASURING_MODE  measuring_mode;
+    DWRITE_GRID_FIT_MODE   grid_fit_mode;
 };
 
 typedef struct Dwrite_Font_Fallback_Result Dwrite_Font_Fallback_Result;
@@ -171,42 +176,30 @@ struct Dwrite_Font_Fallback_Result
     IDWriteFontFace5 *font_face;
 };
 
-// -----------------------------------------
-// @Note: Inner Glyph Table
-struct Dwrite_Glyph_Table_Entry
-{
-    B8 occupied;
-    B8 tombstone;
-    UINT16      idx;
-    Glyph_Cel   cel;
-};
-
-struct Dwrite_Glyph_Table
-{
-    U32 entry_count;
-    Dwrite_Glyph_Table_Entry *entries;
-};
-
 // -----------------------------------------
 // @Note: Font Face Table
+//
+// Read without locking, from any thread, the same way as the glyph atlas:
+// an entry is filled in before `occupied` is stored and never changes or
+// goes away after. Inserts take the write mutex.
 struct Dwrite_Font_Table_Entry
 {
-    B8 occupied;
-    B8 tombstone;
+    volatile S64 occupied;
     IDWriteFontFace *key; // = 
     Dwrite_Font_Metrics metrics;
-    Dwrite_Glyph_Table glyph_table;
+    Simple_Text_Table *simple_text;
 };
 
 struct Dwrite_Font_Table
 {
+    Job_Mutex write_mutex;
     U32 entry_count;
     Dwrite_Font_Table_Entry *entries;
 };
 
 
 // -----------------------------------------
-// @Note: DWrite State
+// @Note: DWrite State, one per engine. See dwrite_init().
 typedef struct Dwrite_State Dwrite_State;
 struct Dwrite_State
 {
@@ -223,6 +216,13 @@ struct Dwrite_State
     IDWriteRenderingParams *rendering_params;
 
     Dwrite_Font_Table       font_table;
+
+    B32 use_word_cache;
+    Word_Cache word_cache;
+
+    // Of the Font_Backend, see dwrite_font_backend().
+    F32 px_per_inch;
+    B32 is_cleartype;
 };
 
 typedef struct 
@@ -233,23 +233,29 @@ typedef struct
 
 // -------------------------------------
 // @Note: Code
-function U64 dwrite_hash_glyph_index(U16 idx);
-function Dwrite_Glyph_Table_Entry *dwrite_get_glyph_entry_from_table(Dwrite_Glyph_Table glyph_table, U16 glyph_index);
-function void dwrite_insert_glyph_cel_to_table(Dwrite_Glyph_Table *glyph_table, U16 glyph_index, Glyph_Cel cel);
-
 function U64 dwrite_hash_font(IDWriteFontFace *key);
-function Dwrite_Font_Table_Entry *dwrite_get_entry_from_font_table(IDWriteFontFace *font_face);
-function void dwrite_insert_font_to_table(IDWriteFontFace *font_face, Dwrite_Font_Metrics metrics);
+function Dwrite_Font_Table_Entry *dwrite_get_entry_from_font_table(Dwrite_State *dwrite, IDWriteFontFace *font_face);
+function void dwrite_insert_font_to_table(Dwrite_State *dwrite, IDWriteFontFace *font_face, Dwrite_Font_Metrics metrics);
+function Simple_Text_Table *dwrite_build_simple_text_table(Dwrite_State *dwrite, IDWriteFontFace *font_face);
 
 function Dwrite_Map_Complexity_Result dwrite_map_complexity(IDWriteTextAnalyzer1 *text_analyzer, IDWriteFontFace *font_face, WCHAR *text, U32 text_length);
 function Dwrite_Font_Fallback_Result dwrite_font_fallback(IDWriteFontFallback *font_fallback, IDWriteFontCollection *font_collection, WCHAR *base_family, WCHAR *locale, WCHAR *text, UINT32 text_length);
-function DWRITE_GLYPH_RUN *dwrite_map_text_to_glyphs(IDWriteFontFallback1 *font_fallback, IDWriteFontCollection *font_collection, IDWriteTextAnalyzer1 *text_analyzer, WCHAR *locale, WCHAR *base_family, FLOAT pt_per_em, FLOAT px_per_inch, WCHAR *text, U32 text_length);
+function U32 dwrite_shape_text(IDWriteTextAnalyzer1 *text_analyzer, IDWriteFontFace5 *font_face, DWRITE_SCRIPT_ANALYSIS analysis, WCHAR *locale, FLOAT px_per_em, WCHAR *text, U32 text_length, U32 text_position, U16 **indices, FLOAT **advances, U32 **text_positions);
+function U32 dwrite_shape_words(Word_Cache *word_cache, IDWriteTextAnalyzer1 *text_analyzer, IDWriteFontFace5 *font_face, DWRITE_SCRIPT_ANALYSIS analysis, WCHAR *locale, FLOAT px_per_em, WCHAR *text, U32 text_length, U32 text_position, U16 **indices, FLOAT **advances, U32 **text_positions);
+function Dwrite_Raster_Modes dwrite_get_raster_modes(IDWriteFontFace *font_face, FLOAT em_size_px, FLOAT px_per_inch, IDWriteRenderingParams *rendering_params);
+function U8 *dwrite_analyze_line_breaks(IDWriteTextAnalyzer1 *text_analyzer, WCHAR *locale, WCHAR *text, U32 text_length);
+
+function U32 dwrite_font_resolve(void *user_data, wchar_t *family, U16 *text, U32 text_length, U64 *out_face);
+function void dwrite_font_shape(void *user_data, Font_Run *run, U16 *text, U32 text_length, U32 text_position, U32 **glyph_text_positions);
+function Font_Metrics dwrite_font_get_metrics(void *user_data, U64 face, F32 em_size_px);
+function U8 *dwrite_font_analyze_breaks(void *user_data, U16 *text, U32 text_length);
+function void dwrite_font_rasterize(void *user_data, Arena *arena, U64 face, F32 em_size_px, U16 glyph_index, Font_Glyph_Bitmap *out);
+function Font_Backend dwrite_font_backend(Dwrite_State *dwrite, F32 px_per_inch, B32 is_cleartype);
+function void dwrite_font_release(void *user_data);
+function void dwrite_font_get_stats(void *user_data, Font_Backend_Stats *out);
 function void dwrite_abort(wchar_t *message);
-function void dwrite_init(void);
-function Dwrite_Get_Base_Font_Family_Index_Result dwrite_get_base_font_family_index(wchar_t *base_font_family_name);
-
-// -------------------------------------
-// @Note: Data
-global Dwrite_State dwrite;
+function void dwrite_init(Dwrite_State *dwrite);
+function void dwrite_release(Dwrite_State *dwrite);
+function Dwrite_Get_Base_Font_Family_Index_Result dwrite_get_base_font_family_index(Dwrite_State *dwrite, wchar_t *base_font_family_name);
 
 #endif // LSW_DWRITE_H
@@ -0,0 +1,162 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+
+function void
+word_cache_init(Word_Cache *cache, U32 entry_count)
+{
+    cache->arena          = arena_alloc();
+    cache->entry_count    = entry_count;
+    cache->occupied_count = 0;
+    cache->entries        = push_array(cache->arena, Word_Cache_Entry, entry_count);
+    cache->stats          = {};
+}
+
+function void
+word_cache_release(Word_Cache *cache)
+{
+    arena_release(cache->arena);
+    *cache = {};
+}
+
+// @Note: Drops every cached word but keeps the stats running.
+function void
+word_cache_reset(Word_Cache *cache)
+{
+    arena_clear(cache->arena);
+    cache->occupied_count = 0;
+    cache->entries = push_array(cache->arena, Word_Cache_Entry, cache->entry_count);
+}
+
+function U64
+word_cache_hash(Word_Cache_Key key)
+{
+    // FNV-1a over the text, then the rest of the key mixed in.
+    U64 result = 0xcbf29ce484222325ull;
+    for (U32 i = 0; i < key.text_length; ++i)
+    {
+        result ^= key.text[i];
+        result *= 0x100000001b3ull;
+    }
+
+    U32 em_size_bits;
+    memory_copy(&em_size_bits, &key.em_size, sizeof(em_size_bits));
+
+    U64 extra[] = {key.face, key.features, key.script, em_size_bits};
+    for (U32 i = 0; i < array_count(extra); ++i)
+    {
+        result ^= extra[i] + 0x9e3779b97f4a7c15ull + (result << 6) + (result >> 2);
+    }
+
+    return result;
+}
+
+function B32
+word_cache_key_equals(Word_Cache_Key a, Word_Cache_Key b)
+{
+    B32 result = (a.face == b.face &&
+                  a.features == b.features &&
+                  a.script == b.script &&
+                  a.em_size == b.em_size &&
+                  a.text_length == b.text_length &&
+                  memory_equal(a.text, b.text, a.text_length*sizeof(a.text[0])));
+    return result;
+}
+
+function Word_Cache_Entry *
+word_cache_lookup(Word_Cache *cache, Word_Cache_Key key, U64 hash)
+{
+    Word_Cache_Entry *result = NULL;
+
+    U64 entry_count = cache->entry_count;
+    U64 home_position = (hash % entry_count);
+
+    for (U64 i = 0; i < entry_count; ++i)
+    {
+        U64 idx = (home_position + i) % entry_count;
+        Word_Cache_Entry *entry = cache->entries + idx;
+
+        if (! entry->occupied)
+        { break; }
+
+        if (entry->hash == hash && word_cache_key_equals(entry->key, key))
+        {
+            result = entry;
+            break;
+        }
+    }
+
+    if (result)
+    {
+        cache->stats.hit_count += 1;
+        cache->stats.saved_shape_ticks += result->shape_ticks;
+    }
+
+    return result;
+}
+
+// @Note: Nothing is ever removed one by one, so probing stops at the first
+// empty slot. Once the table is 3/4 full it's flushed as a whole.
+// glyph_clusters of the returned entry are left for the caller to fill.
+function Word_Cache_Entry *
+word_cache_insert(Word_Cache *cache, Word_Cache_Key key, U64 hash,
+                  U16 *glyph_indices, F32 *glyph_advances, U32 glyph_count,
+                  U64 shape_ticks)
+{
+    cache->stats.miss_count  += 1;
+    cache->stats.shape_ticks += shape_ticks;
+
+    if ((cache->occupied_count + 1)*4 > cache->entry_count*3)
+    { word_cache_reset(cache); }
+
+    U64 entry_count = cache->entry_count;
+    U64 home_position = (hash % entry_count);
+
+    Word_Cache_Entry *result = NULL;
+    for (U64 i = 0; i < entry_count; ++i)
+    {
+        U64 idx = (home_position + i) % entry_count;
+        if (! cache->entries[idx].occupied)
+        {
+            result = cache->entries + idx;
+            break;
+        }
+    }
+    assume(result);
+
+    result->occupied       = true;
+    result->hash           = hash;
+    result->key            = key;
+    result->key.text       = push_array(cache->arena, U16, key.text_length);
+    result->glyph_count    = glyph_count;
+    result->glyph_indices  = push_array(cache->arena, U16, glyph_count);
+    result->glyph_advances = push_array(cache->arena, F32, glyph_count);
+    result->glyph_clusters = push_array(cache->arena, U16, glyph_count);
+    result->shape_ticks    = shape_ticks;
+
+    memory_copy(result->key.text, key.text, key.text_length*sizeof(key.text[0]));
+    memory_copy(result->glyph_indices, glyph_indices, glyph_count*sizeof(glyph_indices[0]));
+    memory_copy(result->glyph_advances, glyph_advances, glyph_count*sizeof(glyph_advances[0]));
+
+    cache->occupied_count += 1;
+
+    return result;
+}
+
+// @Note: A word is everything up to and including its trailing spaces.
+function U32
+word_cache_next_word_length(U16 *text, U32 text_length)
+{
+    U32 result = 0;
+    while (result < text_length && text[result] != ' ')
+    { ++result; }
+    while (result < text_length && text[result] == ' ')
+    { ++result; }
+    return result;
+}
+
+function F64
+word_cache_hit_rate(Word_Cache_Stats stats)
+{
+    U64 lookup_count = stats.hit_count + stats.miss_count;
+    F64 result = (lookup_count) ? (F64)stats.hit_count / (F64)lookup_count : 0.0;
+    return result;
+}
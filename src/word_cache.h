@@ -0,0 +1,77 @@
+// Copyright (c) 2025 Seong Woo Lee. All rights reserved.
+#ifndef WORD_CACHE_H
+#define WORD_CACHE_H
+
+/* --------------------------------------
+   @Note: Word-level shaped-text cache.
+
+   Natural-language text repeats the same words over and over. Instead of
+   shaping a whole script run at once, the run is cut into words (a word
+   keeps its trailing spaces) and each (word, face, size, script, features)
+   tuple is shaped once. Every later occurrence copies the cached glyphs.
+
+   Cutting at spaces is only exact when the face's space glyph doesn't take
+   part in any lookup, so the caller checks that per face and shapes the
+   whole run when it does.
+   --------------------------------------- */
+
+#define WORD_CACHE_MAX_WORD_LENGTH 48
+
+typedef struct Word_Cache_Key Word_Cache_Key;
+struct Word_Cache_Key
+{
+    U64 face;      // opaque face identity. e.g. pointer.
+    U64 features;  // hash of the feature set, 0 for defaults.
+    U32 script;
+    F32 em_size;
+    U16 *text;
+    U32 text_length;
+};
+
+typedef struct Word_Cache_Entry Word_Cache_Entry;
+struct Word_Cache_Entry
+{
+    B8 occupied;
+    U64 hash;
+    Word_Cache_Key key; // key.text points to the cache's own copy.
+
+    U32 glyph_count;
+    U16 *glyph_indices;
+    F32 *glyph_advances;
+    U16 *glyph_clusters; // text position of each glyph's cluster, relative to the word.
+
+    U64 shape_ticks; // what it cost to shape this word the first time.
+};
+
+typedef struct Word_Cache_Stats Word_Cache_Stats;
+struct Word_Cache_Stats
+{
+    U64 hit_count;
+    U64 miss_count;
+    U64 uncacheable_count;
+    U64 shape_ticks;       // spent shaping misses.
+    U64 saved_shape_ticks; // what the hits would have cost.
+};
+
+typedef struct Word_Cache Word_Cache;
+struct Word_Cache
+{
+    Arena *arena;
+    U32 entry_count;
+    U32 occupied_count;
+    Word_Cache_Entry *entries;
+    Word_Cache_Stats stats;
+};
+
+function void word_cache_init(Word_Cache *cache, U32 entry_count);
+function void word_cache_release(Word_Cache *cache);
+function void word_cache_reset(Word_Cache *cache);
+function U64 word_cache_hash(Word_Cache_Key key);
+function Word_Cache_Entry *word_cache_lookup(Word_Cache *cache, Word_Cache_Key key, U64 hash);
+function Word_Cache_Entry *word_cache_insert(Word_Cache *cache, Word_Cache_Key key, U64 hash,
+                                             U16 *glyph_indices, F32 *glyph_advances, U32 glyph_count,
+                                             U64 shape_ticks);
+function U32 word_cache_next_word_length(U16 *text, U32 text_length);
+function F64 word_cache_hit_rate(Word_Cache_Stats stats);
+
+#endif // WORD_CACHE_H